@@ -0,0 +1,568 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "benchCorpus.hpp"
+
+#include <sstream>
+
+
+namespace
+{
+
+const char* const WORDS[] =
+{
+	"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "mail",
+	"message", "library", "header", "field", "body", "part", "server", "client",
+	"report", "meeting", "tomorrow", "project", "release", "version", "update",
+	"please", "find", "attached", "document", "regards", "thanks", "schedule",
+	"network", "protocol", "encoding", "charset", "address", "subject", "reply",
+	"forward", "urgent", "offer", "free", "limited", "time", "click", "here",
+	"account", "password", "security", "notice", "invoice", "payment", "order",
+	"delivery", "status", "question", "answer", "review", "change", "request"
+};
+
+const char* const ENCODED_WORDS[] =
+{
+	"=?UTF-8?B?Q2Fmw6kgY3LDqG1l?=",
+	"=?UTF-8?Q?na=C3=AFve_=C3=BCber?=",
+	"=?ISO-8859-1?Q?r=E9sum=E9?=",
+	"=?ISO-8859-1?B?R3Lf?=",
+	"=?UTF-8?B?0J/RgNC40LLQtdGC?=",
+	"=?UTF-8?Q?=E2=82=AC_100?=",
+	"=?windows-1252?Q?=93quoted=94?=",
+	"=?UTF-8?B?5pel5pys6Kqe?="
+};
+
+const unsigned int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+const unsigned int ENCODED_WORD_COUNT = sizeof(ENCODED_WORDS) / sizeof(ENCODED_WORDS[0]);
+
+const char* const CRLF = "\r\n";
+
+} // namespace
+
+
+benchCorpus::benchCorpus(const unsigned long seed)
+	: m_state(seed & 0xffffffffUL), m_counter(0)
+{
+}
+
+
+// static
+const char* benchCorpus::getKindName(const Kind kind)
+{
+	switch (kind)
+	{
+	case KIND_PLAIN: return "plain";
+	case KIND_HTML: return "html";
+	case KIND_NESTED: return "nested";
+	case KIND_ATTACHMENT: return "attachment";
+	case KIND_SPAM: return "spam";
+	default: break;
+	}
+
+	return "unknown";
+}
+
+
+unsigned long benchCorpus::nextRandom()
+{
+	// Use 32-bit arithmetic, so that the sequence does not
+	// depend on the size of 'unsigned long'
+	m_state = (m_state * 1103515245UL + 12345UL) & 0xffffffffUL;
+	return (m_state >> 8) & 0xffffffUL;
+}
+
+
+unsigned long benchCorpus::nextRandom(const unsigned long max)
+{
+	return nextRandom() % max;
+}
+
+
+const std::string benchCorpus::randomWord()
+{
+	return WORDS[nextRandom(WORD_COUNT)];
+}
+
+
+const std::string benchCorpus::randomAddress()
+{
+	std::ostringstream oss;
+	oss << randomWord() << '.' << randomWord() << '@' << randomWord() << ".example.com";
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::randomMessageId()
+{
+	std::ostringstream oss;
+	oss << '<' << nextRandom() << '.' << ++m_counter << '@' << randomWord() << ".example.com>";
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::randomBoundary()
+{
+	std::ostringstream oss;
+	oss << "----=_Part_" << ++m_counter << '_' << nextRandom();
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateText(const unsigned long length)
+{
+	std::string text;
+	std::string line;
+
+	while (text.length() < length)
+	{
+		const std::string word = randomWord();
+
+		if (line.length() + word.length() + 1 > 72)
+		{
+			text += line;
+			text += CRLF;
+			line.clear();
+		}
+
+		if (!line.empty())
+			line += ' ';
+
+		line += word;
+	}
+
+	if (!line.empty())
+	{
+		text += line;
+		text += CRLF;
+	}
+
+	return text;
+}
+
+
+const std::string benchCorpus::generateBinary(const unsigned long length)
+{
+	std::string data;
+	data.reserve(length);
+
+	for (unsigned long i = 0 ; i < length ; ++i)
+		data += static_cast <char>(nextRandom() & 0xff);
+
+	return data;
+}
+
+
+const std::string benchCorpus::generateEncodedWords(const int count)
+{
+	std::string value;
+
+	for (int i = 0 ; i < count ; ++i)
+	{
+		if (i != 0)
+			value += ((i % 4) == 0 ? "\r\n " : " ");
+
+		if (nextRandom(3) == 0)
+			value += randomWord();
+		else
+			value += ENCODED_WORDS[nextRandom(ENCODED_WORD_COUNT)];
+	}
+
+	return value;
+}
+
+
+const std::string benchCorpus::commonHeader(const std::string& contentType)
+{
+	std::ostringstream oss;
+
+	oss << "Return-Path: <" << randomAddress() << ">" << CRLF
+	    << "Received: from " << randomWord() << ".example.com (" << randomWord()
+	    << ".example.com [192.0.2." << nextRandom(255) << "])" << CRLF
+	    << "\tby mx.example.org (Postfix) with ESMTP id " << nextRandom() << CRLF
+	    << "\tfor <" << randomAddress() << ">; Tue, 14 Feb 2012 10:23:45 +0100" << CRLF
+	    << "Message-ID: " << randomMessageId() << CRLF
+	    << "Date: Tue, 14 Feb 2012 10:23:" << (10 + nextRandom(50)) << " +0100" << CRLF
+	    << "From: \"" << randomWord() << ' ' << randomWord() << "\" <" << randomAddress() << ">" << CRLF
+	    << "To: " << randomAddress() << ", \"" << randomWord() << "\" <" << randomAddress() << ">" << CRLF
+	    << "Subject: " << randomWord() << ' ' << randomWord() << ' ' << randomWord() << CRLF
+	    << "MIME-Version: 1.0" << CRLF
+	    << "Content-Type: " << contentType << CRLF;
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generatePlain()
+{
+	return commonHeader("text/plain; charset=us-ascii")
+		+ "Content-Transfer-Encoding: 7bit\r\n\r\n"
+		+ generateText(4096);
+}
+
+
+const std::string benchCorpus::generateHTML()
+{
+	const std::string boundary = randomBoundary();
+	const std::string text = generateText(8192);
+
+	std::string html = "<html><head><meta http-equiv=\"Content-Type\" "
+		"content=\"text/html; charset=utf-8\"></head><body>\r\n";
+
+	for (std::string::size_type pos = 0 ; pos < text.length() ; )
+	{
+		const std::string::size_type eol = text.find(CRLF, pos);
+
+		html += "<p style=\"margin: 0; font-family: Arial\">";
+		html += text.substr(pos, eol - pos);
+		html += "</p>\r\n";
+
+		pos = eol + 2;
+	}
+
+	html += "</body></html>\r\n";
+
+	std::ostringstream oss;
+
+	oss << commonHeader("multipart/alternative; boundary=\"" + boundary + "\"")
+	    << CRLF
+	    << "--" << boundary << CRLF
+	    << "Content-Type: text/plain; charset=utf-8" << CRLF
+	    << "Content-Transfer-Encoding: 7bit" << CRLF
+	    << CRLF
+	    << text
+	    << "--" << boundary << CRLF
+	    << "Content-Type: text/html; charset=utf-8" << CRLF
+	    << "Content-Transfer-Encoding: quoted-printable" << CRLF
+	    << CRLF
+	    << encodeQuotedPrintable(html) << CRLF
+	    << "--" << boundary << "--" << CRLF;
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateNestedPart(const int depth)
+{
+	std::ostringstream oss;
+
+	if (depth == 0)
+	{
+		oss << "Content-Type: text/plain; charset=us-ascii" << CRLF
+		    << CRLF
+		    << generateText(256);
+
+		return oss.str();
+	}
+
+	const std::string boundary = randomBoundary();
+
+	oss << "Content-Type: multipart/mixed; boundary=\"" << boundary << "\"" << CRLF
+	    << CRLF
+	    << "This is a multi-part message in MIME format." << CRLF
+	    << "--" << boundary << CRLF
+	    << "Content-Type: text/plain; charset=us-ascii" << CRLF
+	    << CRLF
+	    << generateText(256)
+	    << "--" << boundary << CRLF
+	    << "Content-Type: application/octet-stream; name=\"part" << depth << ".bin\"" << CRLF
+	    << "Content-Disposition: attachment; filename=\"part" << depth << ".bin\"" << CRLF
+	    << "Content-Transfer-Encoding: base64" << CRLF
+	    << CRLF
+	    << encodeBase64(generateBinary(512))
+	    << "--" << boundary << CRLF
+	    << generateNestedPart(depth - 1)
+	    << "--" << boundary << "--" << CRLF;
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateNested()
+{
+	const std::string part = generateNestedPart(16);
+
+	// The first line of the part is the Content-Type field,
+	// which is merged into the message header
+	const std::string::size_type eol = part.find(CRLF);
+
+	return commonHeader(part.substr(14, eol - 14)) + part.substr(eol + 2);
+}
+
+
+const std::string benchCorpus::generateAttachment()
+{
+	const std::string boundary = randomBoundary();
+
+	std::ostringstream oss;
+
+	oss << commonHeader("multipart/mixed; boundary=\"" + boundary + "\"")
+	    << CRLF
+	    << "--" << boundary << CRLF
+	    << "Content-Type: text/plain; charset=us-ascii" << CRLF
+	    << CRLF
+	    << generateText(1024)
+	    << "--" << boundary << CRLF
+	    << "Content-Type: application/pdf; name=\"report.pdf\"" << CRLF
+	    << "Content-Disposition: attachment; filename=\"report.pdf\"" << CRLF
+	    << "Content-Transfer-Encoding: base64" << CRLF
+	    << CRLF
+	    << encodeBase64(generateBinary(4 * 1024 * 1024))
+	    << "--" << boundary << "--" << CRLF;
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateSpam()
+{
+	std::ostringstream oss;
+
+	for (int i = 0 ; i < 30 ; ++i)
+	{
+		oss << "Received: from " << randomWord() << nextRandom(1000) << ".example.net (["
+		    << "198.51.100." << nextRandom(255) << "])" << CRLF
+		    << "\tby relay" << i << ".example.org with SMTP id " << nextRandom() << CRLF
+		    << "\tfor <" << randomAddress() << ">; Tue, 14 Feb 2012 09:" << (10 + i) << ":00 -0000" << CRLF;
+	}
+
+	for (int i = 0 ; i < 60 ; ++i)
+		oss << "X-" << randomWord() << '-' << i << ": " << randomWord() << ' ' << nextRandom() << CRLF;
+
+	oss << "Message-ID: " << randomMessageId() << CRLF
+	    << "Date: Tue, 14 Feb 2012 10:23:45 +0100" << CRLF
+	    << "From: " << generateEncodedWords(3) << " <" << randomAddress() << ">" << CRLF
+	    << "Reply-To: " << generateEncodedWords(2) << " <" << randomAddress() << ">" << CRLF
+	    << "To: ";
+
+	for (int i = 0 ; i < 100 ; ++i)
+	{
+		if (i != 0)
+			oss << ',' << CRLF << ' ';
+
+		oss << generateEncodedWords(2) << " <" << randomAddress() << ">";
+	}
+
+	oss << CRLF
+	    << "Subject: " << generateEncodedWords(24) << CRLF
+	    << "Comments: " << generateEncodedWords(40) << CRLF
+	    << "MIME-Version: 1.0" << CRLF
+	    << "Content-Type: text/plain; charset=utf-8" << CRLF
+	    << "Content-Transfer-Encoding: 8bit" << CRLF
+	    << CRLF
+	    << generateText(512);
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateMessage(const Kind kind)
+{
+	switch (kind)
+	{
+	case KIND_PLAIN: return generatePlain();
+	case KIND_HTML: return generateHTML();
+	case KIND_NESTED: return generateNested();
+	case KIND_ATTACHMENT: return generateAttachment();
+	case KIND_SPAM: return generateSpam();
+	default: break;
+	}
+
+	return "";
+}
+
+
+const std::string benchCorpus::generateIMAPFetchResponse(const int count)
+{
+	std::ostringstream oss;
+
+	for (int i = 1 ; i <= count ; ++i)
+	{
+		oss << "* " << i << " FETCH (UID " << (1000 + i)
+		    << " FLAGS (\\Seen" << (nextRandom(2) ? " \\Answered" : "") << ")"
+		    << " RFC822.SIZE " << (1000 + nextRandom(100000))
+		    << " ENVELOPE (\"Tue, 14 Feb 2012 10:23:45 +0100\""
+		    << " \"" << randomWord() << ' ' << randomWord() << ' ' << randomWord() << "\""
+		    << " ((\"" << randomWord() << "\" NIL \"" << randomWord() << "\" \"example.com\"))"
+		    << " ((\"" << randomWord() << "\" NIL \"" << randomWord() << "\" \"example.com\"))"
+		    << " ((NIL NIL \"" << randomWord() << "\" \"example.com\"))"
+		    << " ((NIL NIL \"" << randomWord() << "\" \"example.org\")"
+		    << "(\"" << randomWord() << "\" NIL \"" << randomWord() << "\" \"example.org\"))"
+		    << " NIL NIL NIL \"" << randomMessageId() << "\")"
+		    << " BODYSTRUCTURE ((\"TEXT\" \"PLAIN\" (\"CHARSET\" \"UTF-8\") NIL NIL \"7BIT\" "
+		    << nextRandom(10000) << ' ' << nextRandom(200) << " NIL NIL NIL)"
+		    << "(\"TEXT\" \"HTML\" (\"CHARSET\" \"UTF-8\") NIL NIL \"QUOTED-PRINTABLE\" "
+		    << nextRandom(50000) << ' ' << nextRandom(1000) << " NIL NIL NIL)"
+		    << " \"ALTERNATIVE\" (\"BOUNDARY\" \"" << randomBoundary() << "\") NIL NIL))"
+		    << CRLF;
+	}
+
+	oss << "a001 OK FETCH completed" << CRLF;
+
+	return oss.str();
+}
+
+
+const std::string benchCorpus::generateIMAPMixedResponse(const int count)
+{
+	static const char* const months[] =
+	{
+		"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+		"Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+	};
+
+	std::ostringstream oss;
+
+	for (int i = 1 ; i <= count ; ++i)
+	{
+		switch (nextRandom(4))
+		{
+		case 0:
+
+			oss << "* LIST (\\HasNoChildren" << (nextRandom(2) ? " \\Marked" : "") << ")"
+			    << " \"/\" \"INBOX/" << randomWord() << '/' << randomWord() << "\"" << CRLF;
+			break;
+
+		case 1:
+
+			oss << "* STATUS \"" << randomWord() << "\" (MESSAGES " << nextRandom(5000)
+			    << " RECENT " << nextRandom(10) << " UIDNEXT " << (1000 + nextRandom(5000))
+			    << " UNSEEN " << nextRandom(100) << ")" << CRLF;
+			break;
+
+		case 2:
+		{
+			oss << "* SEARCH";
+
+			for (unsigned long j = 0, n = 1 + nextRandom(20) ; j < n ; ++j)
+				oss << ' ' << (1 + nextRandom(5000));
+
+			oss << CRLF;
+			break;
+		}
+		default:
+		{
+			const unsigned long day = 1 + nextRandom(28);
+			const unsigned long zoneHours = nextRandom(12);
+
+			oss << "* " << i << " FETCH (UID " << (1000 + i)
+			    << " INTERNALDATE \"" << (day < 10 ? " " : "") << day
+			    << '-' << months[nextRandom(12)] << '-' << (1990 + nextRandom(30))
+			    << ' ' << (10 + nextRandom(14)) << ':' << (10 + nextRandom(50)) << ':' << (10 + nextRandom(50))
+			    << ' ' << (nextRandom(2) ? '+' : '-') << (zoneHours / 10) << (zoneHours % 10) << "00\""
+			    << " FLAGS (\\Seen" << (nextRandom(2) ? " \\Flagged" : "") << "))" << CRLF;
+			break;
+		}
+
+		}
+	}
+
+	oss << "a001 OK Completed" << CRLF;
+
+	return oss.str();
+}
+
+
+// static
+const std::string benchCorpus::encodeBase64(const std::string& data)
+{
+	static const char alphabet[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string out;
+	out.reserve(data.length() * 4 / 3 + data.length() / 38 + 4);
+
+	int lineLength = 0;
+
+	for (std::string::size_type i = 0 ; i < data.length() ; i += 3)
+	{
+		const unsigned int b0 = static_cast <unsigned char>(data[i]);
+		const unsigned int b1 = (i + 1 < data.length() ? static_cast <unsigned char>(data[i + 1]) : 0);
+		const unsigned int b2 = (i + 2 < data.length() ? static_cast <unsigned char>(data[i + 2]) : 0);
+
+		out += alphabet[b0 >> 2];
+		out += alphabet[((b0 & 0x03) << 4) | (b1 >> 4)];
+		out += (i + 1 < data.length() ? alphabet[((b1 & 0x0f) << 2) | (b2 >> 6)] : '=');
+		out += (i + 2 < data.length() ? alphabet[b2 & 0x3f] : '=');
+
+		if ((lineLength += 4) >= 76)
+		{
+			out += CRLF;
+			lineLength = 0;
+		}
+	}
+
+	if (lineLength != 0)
+		out += CRLF;
+
+	return out;
+}
+
+
+// static
+const std::string benchCorpus::encodeQuotedPrintable(const std::string& data)
+{
+	static const char hex[] = "0123456789ABCDEF";
+
+	std::string out;
+	int lineLength = 0;
+
+	for (std::string::size_type i = 0 ; i < data.length() ; ++i)
+	{
+		const unsigned char c = static_cast <unsigned char>(data[i]);
+
+		if (c == '\r' && i + 1 < data.length() && data[i + 1] == '\n')
+		{
+			out += CRLF;
+			lineLength = 0;
+			++i;
+
+			continue;
+		}
+
+		if (lineLength >= 72)
+		{
+			out += "=\r\n";
+			lineLength = 0;
+		}
+
+		if (c == '=' || c < 32 || c > 126)
+		{
+			out += '=';
+			out += hex[c >> 4];
+			out += hex[c & 0x0f];
+
+			lineLength += 3;
+		}
+		else
+		{
+			out += static_cast <char>(c);
+			++lineLength;
+		}
+	}
+
+	return out;
+}
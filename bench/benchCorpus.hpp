@@ -0,0 +1,142 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+//
+// Reproducible generator of test messages for the benchmarks. The same
+// seed always produces the same corpus, on every platform, so that
+// results can be compared over time.
+//
+
+#ifndef VMIME_BENCH_BENCHCORPUS_HPP_INCLUDED
+#define VMIME_BENCH_BENCHCORPUS_HPP_INCLUDED
+
+
+#include <string>
+
+
+class benchCorpus
+{
+public:
+
+	/** Kinds of messages in the corpus.
+	  */
+	enum Kind
+	{
+		KIND_PLAIN,         /**< Small text/plain message. */
+		KIND_HTML,          /**< multipart/alternative message with a
+		                         quoted-printable HTML part. */
+		KIND_NESTED,        /**< Deeply nested multipart message. */
+		KIND_ATTACHMENT,    /**< Message with a huge base64 attachment. */
+		KIND_SPAM,          /**< Message with a lot of header fields and
+		                         encoded words. */
+
+		KIND_COUNT
+	};
+
+	/** @param seed seed of the pseudo-random generator
+	  */
+	benchCorpus(const unsigned long seed);
+
+	/** Return the name of a kind of message.
+	  *
+	  * @param kind kind of message
+	  * @return name (eg. "plain")
+	  */
+	static const char* getKindName(const Kind kind);
+
+	/** Generate a message.
+	  *
+	  * @param kind kind of message to generate
+	  * @return raw message data
+	  */
+	const std::string generateMessage(const Kind kind);
+
+	/** Generate the response of an IMAP server to a FETCH command
+	  * which requests the envelope and structure of messages. The
+	  * response is terminated by a tagged "OK" line with tag "a001".
+	  *
+	  * @param count number of messages in the response
+	  * @return raw response data
+	  */
+	const std::string generateIMAPFetchResponse(const int count);
+
+	/** Generate the response of an IMAP server made of a mix of
+	  * LIST, STATUS, SEARCH and FETCH (with internal date) untagged
+	  * responses. The response is terminated by a tagged "OK" line
+	  * with tag "a001".
+	  *
+	  * @param count number of untagged responses
+	  * @return raw response data
+	  */
+	const std::string generateIMAPMixedResponse(const int count);
+
+	/** Generate a header field value made of encoded words.
+	  *
+	  * @param count number of words
+	  * @return field value
+	  */
+	const std::string generateEncodedWords(const int count);
+
+	/** Generate random binary data.
+	  *
+	  * @param length number of bytes
+	  * @return data
+	  */
+	const std::string generateBinary(const unsigned long length);
+
+	/** Generate text made of lines of random words.
+	  *
+	  * @param length approximate number of bytes
+	  * @return text, with CRLF line endings
+	  */
+	const std::string generateText(const unsigned long length);
+
+private:
+
+	unsigned long nextRandom();
+	unsigned long nextRandom(const unsigned long max);
+
+	const std::string randomWord();
+	const std::string randomAddress();
+	const std::string randomMessageId();
+	const std::string randomBoundary();
+
+	const std::string commonHeader(const std::string& contentType);
+
+	const std::string generatePlain();
+	const std::string generateHTML();
+	const std::string generateNested();
+	const std::string generateNestedPart(const int depth);
+	const std::string generateAttachment();
+	const std::string generateSpam();
+
+	static const std::string encodeBase64(const std::string& data);
+	static const std::string encodeQuotedPrintable(const std::string& data);
+
+
+	unsigned long m_state;
+	unsigned long m_counter;
+};
+
+
+#endif // VMIME_BENCH_BENCHCORPUS_HPP_INCLUDED
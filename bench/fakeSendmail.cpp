@@ -0,0 +1,107 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+//
+// Stand-in for the 'sendmail' binary, used to benchmark the sendmail
+// transport without the cost of a real mail server. Messages are read
+// and discarded.
+//
+// Usage:
+//   fake-sendmail [-bs] [options] [recipients]
+//
+// With "-bs", a minimal SMTP dialog is held on standard input/output;
+// else, the message is read from standard input until end of file.
+//
+
+#include <iostream>
+#include <string>
+
+
+static void reply(const char* line)
+{
+	std::cout << line << "\r\n" << std::flush;
+}
+
+
+static int smtpSession()
+{
+	reply("220 localhost fake sendmail ready");
+
+	std::string line;
+
+	while (std::getline(std::cin, line))
+	{
+		if (!line.empty() && line[line.length() - 1] == '\r')
+			line.erase(line.length() - 1);
+
+		const std::string cmd = line.substr(0, 4);
+
+		if (cmd == "HELO" || cmd == "EHLO" || cmd == "MAIL" || cmd == "RCPT" ||
+		    cmd == "NOOP" || cmd == "RSET")
+		{
+			reply("250 OK");
+		}
+		else if (cmd == "DATA")
+		{
+			reply("354 Go ahead");
+
+			while (std::getline(std::cin, line))
+			{
+				if (line == ".\r" || line == ".")
+					break;
+			}
+
+			reply("250 Queued");
+		}
+		else if (cmd == "QUIT")
+		{
+			reply("221 Bye");
+			return 0;
+		}
+		else
+		{
+			reply("500 Unknown command");
+		}
+	}
+
+	return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::ios::sync_with_stdio(false);
+
+	for (int i = 1 ; i < argc ; ++i)
+	{
+		if (std::string(argv[i]) == "-bs")
+			return smtpSession();
+	}
+
+	char buffer[16384];
+
+	while (std::cin.read(buffer, sizeof(buffer)) || std::cin.gcount() != 0)
+		;
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+//
+// Measures the throughput of the sendmail transport, with one process
+// per message and in batch mode ("sendmail -bs").
+//
+// Usage:
+//   sendmail-bench <path to sendmail or fake-sendmail> [message count]
+//
+
+#include <iostream>
+#include <cstdlib>
+
+#include <sys/time.h>
+
+#include "vmime/vmime.hpp"
+#include "vmime/platforms/posix/posixHandler.hpp"
+
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return static_cast <double>(tv.tv_sec) + static_cast <double>(tv.tv_usec) / 1000000.0;
+}
+
+
+static void runBenchmark(const vmime::string& sendmailPath, const bool batch,
+	const int count, const vmime::string& data)
+{
+	vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+	sess->getProperties()["transport.sendmail.binpath"] = sendmailPath;
+	sess->getProperties()["transport.sendmail.options.batch"] = batch;
+
+	vmime::ref <vmime::net::transport> tr = sess->getTransport("sendmail");
+
+	const vmime::mailbox expeditor("me@somewhere.com");
+
+	vmime::mailboxList recipients;
+	recipients.appendMailbox(vmime::create <vmime::mailbox>("you@elsewhere.com"));
+
+	const double start = now();
+
+	tr->connect();
+
+	for (int i = 0 ; i < count ; ++i)
+	{
+		vmime::utility::inputStreamStringAdapter is(data);
+		tr->send(expeditor, recipients, is, data.length());
+	}
+
+	tr->disconnect();
+
+	const double elapsed = now() - start;
+
+	std::cout << (batch ? "batch   " : "process ")
+	          << count << " messages in " << elapsed << " s: "
+	          << (count / elapsed) << " msg/s, "
+	          << (static_cast <double>(count * data.length()) / elapsed / 1048576.0) << " MB/s"
+	          << std::endl;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <sendmail path> [message count]" << std::endl;
+		return 1;
+	}
+
+	vmime::platform::setHandler <vmime::platforms::posix::posixHandler>();
+
+	const vmime::string sendmailPath = argv[1];
+	const int count = (argc >= 3 ? std::atoi(argv[2]) : 1000);
+
+	// Build a typical small message
+	vmime::messageBuilder mb;
+
+	mb.setExpeditor(vmime::mailbox("me@somewhere.com"));
+	mb.getRecipients().appendAddress(vmime::create <vmime::mailbox>("you@elsewhere.com"));
+	mb.setSubject(vmime::text("Benchmark message"));
+
+	vmime::string body;
+
+	for (int i = 0 ; i < 50 ; ++i)
+		body += "The quick brown fox jumps over the lazy dog, again and again.\r\n";
+
+	mb.getTextPart()->setText(vmime::create <vmime::stringContentHandler>(body));
+
+	const vmime::string data = mb.construct()->generate();
+
+	try
+	{
+		runBenchmark(sendmailPath, false, count, data);
+		runBenchmark(sendmailPath, true, count, data);
+	}
+	catch (vmime::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,1053 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+//
+// Measures the throughput of message and header parsing, generation, encoders,
+// charset conversion, encoded word decoding, IMAP response parsing and
+// POP3 message retrieval on a reproducible corpus (see benchCorpus).
+//
+// Usage:
+//   vmime-bench [options]
+//
+// Options:
+//   --json             print the results in JSON format
+//   --filter <string>  only run the benchmarks whose name contains <string>
+//   --min-time <s>     run each benchmark for at least <s> seconds (default: 1)
+//   --seed <n>         seed of the corpus generator (default: 42)
+//   --list             list the benchmarks and exit
+//   --write-corpus <dir>  write the messages of the corpus to <dir> and exit
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include <sys/time.h>
+
+#include "vmime/vmime.hpp"
+#include "vmime/platforms/posix/posixHandler.hpp"
+
+#if VMIME_HAVE_MESSAGING_FEATURES && VMIME_BUILTIN_MESSAGING_PROTO_IMAP
+	#include "vmime/net/imap/IMAPParser.hpp"
+	#include "vmime/net/imap/IMAPTag.hpp"
+	#define VMIME_BENCH_IMAP 1
+#endif
+
+#if VMIME_HAVE_MESSAGING_FEATURES && VMIME_BUILTIN_MESSAGING_PROTO_POP3
+	#define VMIME_BENCH_POP3 1
+#endif
+
+#include "benchCorpus.hpp"
+#include "allocCounter.hpp"
+
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return static_cast <double>(tv.tv_sec) + static_cast <double>(tv.tv_usec) / 1000000.0;
+}
+
+
+/** Output stream which discards the data.
+  */
+class nullOutputStream : public vmime::utility::outputStream
+{
+public:
+
+	void write(const value_type* const /* data */, const size_type /* count */) { }
+	void flush() { }
+};
+
+
+/** A benchmark. run() is called repeatedly; it processes
+  * getBytesPerIteration() bytes each time.
+  */
+class benchmark
+{
+public:
+
+	benchmark(const std::string& name)
+		: m_name(name)
+	{
+	}
+
+	virtual ~benchmark() { }
+
+	const std::string& getName() const
+	{
+		return m_name;
+	}
+
+	virtual unsigned long getBytesPerIteration() const = 0;
+	virtual void run() = 0;
+
+private:
+
+	const std::string m_name;
+};
+
+
+class parseBenchmark : public benchmark
+{
+public:
+
+	parseBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::message msg;
+		msg.parse(m_data);
+	}
+
+private:
+
+	const std::string m_data;
+};
+
+
+class batchParseBenchmark : public benchmark, private vmime::batchParser::messageHandler
+{
+public:
+
+	batchParseBenchmark(const std::string& name, benchCorpus& corpus, const unsigned int threadCount)
+		: benchmark(name), m_threadCount(threadCount), m_length(0)
+	{
+		for (int i = 0 ; i < 200 ; ++i)
+		{
+			const std::string data = corpus.generateMessage
+				(static_cast <benchCorpus::Kind>(i % benchCorpus::KIND_ATTACHMENT));
+
+			m_sources.push_back(vmime::create <vmime::batchParser::stringSource>(data));
+			m_length += data.length();
+		}
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_length;
+	}
+
+	void run()
+	{
+		vmime::batchParser parser(m_threadCount);
+		parser.parse(m_sources, *this);
+	}
+
+private:
+
+	void onMessage(const vmime::batchParser::size_type /* index */, vmime::ref <vmime::message> /* msg */)
+	{
+	}
+
+	void onError(const vmime::batchParser::size_type /* index */, const vmime::exception& /* e */)
+	{
+	}
+
+
+	const unsigned int m_threadCount;
+	std::vector <vmime::ref <vmime::batchParser::source> > m_sources;
+	unsigned long m_length;
+};
+
+
+class streamingParseBenchmark : public benchmark
+{
+public:
+
+	streamingParseBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::streamingParser parser(vmime::create <vmime::utility::inputStreamStringAdapter>(m_data));
+
+		while (parser.nextEvent() != vmime::streamingParser::EVENT_END)
+			;
+	}
+
+private:
+
+	const std::string m_data;
+};
+
+
+class eventParseBenchmark : public benchmark, private vmime::mimeEventParser::handler
+{
+public:
+
+	eventParseBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data), m_bytes(0)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		m_parser.parse(m_data, *this);
+	}
+
+private:
+
+	void onPartBegin(const int /* depth */) { }
+	void onHeaderField(const char* /* name */, const vmime::string::size_type nameLength,
+		const char* /* value */, const vmime::string::size_type valueLength) { m_bytes += nameLength + valueLength; }
+	void onBodyChunk(const vmime::utility::stream::value_type* /* data */,
+		const vmime::utility::stream::size_type count) { m_bytes += count; }
+	void onPartEnd() { }
+
+	const std::string m_data;
+	vmime::mimeEventParser m_parser;
+	unsigned long m_bytes;
+};
+
+
+class headerBenchmark : public benchmark
+{
+public:
+
+	headerBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::header hdr;
+		hdr.parse(m_data);
+	}
+
+private:
+
+	const std::string m_data;
+};
+
+
+class generateBenchmark : public benchmark
+{
+public:
+
+	generateBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_msg(vmime::create <vmime::message>())
+	{
+		m_msg->parse(data);
+
+		// Generate once, so that the contents are not
+		// re-encoded for each iteration
+		m_length = m_msg->generate().length();
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_length;
+	}
+
+	void run()
+	{
+		nullOutputStream os;
+		m_msg->generate(os);
+	}
+
+private:
+
+	vmime::ref <vmime::message> m_msg;
+	unsigned long m_length;
+};
+
+
+class attachmentBenchmark : public benchmark
+{
+public:
+
+	attachmentBenchmark(const std::string& name, const std::string& data, const bool cached)
+		: benchmark(name), m_data(data), m_cached(cached)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		// Build a new message each time, as a newsletter sender would do
+		vmime::ref <const vmime::contentHandler> cts =
+			vmime::create <vmime::stringContentHandler>(m_data);
+
+		if (m_cached)
+			cts = vmime::create <vmime::cachedContentHandler>(cts, "bench-attachment");
+
+		vmime::messageBuilder mb;
+		mb.setExpeditor(vmime::mailbox("news@vmime.org"));
+		mb.getRecipients().appendAddress(vmime::create <vmime::mailbox>("reader@vmime.org"));
+		mb.setSubject(vmime::text("Newsletter"));
+		mb.getTextPart()->setText(vmime::create <vmime::stringContentHandler>("Hello"));
+		mb.appendAttachment(vmime::create <vmime::defaultAttachment>
+			(cts, vmime::encoding("base64"), vmime::mediaType("application/octet-stream")));
+
+		nullOutputStream os;
+		mb.construct()->generate(os);
+	}
+
+private:
+
+	const std::string m_data;
+	const bool m_cached;
+};
+
+
+class templateBenchmark : public benchmark
+{
+public:
+
+	templateBenchmark(const std::string& name, const std::string& data, const bool compiled)
+		: benchmark(name), m_data(data), m_compiled(compiled)
+	{
+		std::vector <vmime::string> fields;
+		fields.push_back(vmime::fields::TO);
+
+		m_template = vmime::create <vmime::messageTemplate>(construct("${name}"), fields);
+		m_length = m_template->getStaticSize();
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_length;
+	}
+
+	void run()
+	{
+		nullOutputStream os;
+
+		if (m_compiled)
+		{
+			vmime::messageTemplate::values vals;
+			vals.setField(vmime::fields::TO, vmime::create <vmime::mailbox>("reader@vmime.org"));
+			vals.setVariable("name", "Reader");
+
+			m_template->generate(os, vals);
+		}
+		else
+		{
+			construct("Reader")->generate(os);
+		}
+	}
+
+private:
+
+	vmime::ref <vmime::message> construct(const std::string& name) const
+	{
+		vmime::messageBuilder mb;
+		mb.setExpeditor(vmime::mailbox("news@vmime.org"));
+		mb.getRecipients().appendAddress(vmime::create <vmime::mailbox>("reader@vmime.org"));
+		mb.setSubject(vmime::text("Newsletter"));
+		mb.getTextPart()->setText(vmime::create <vmime::stringContentHandler>("Hello " + name + ",\r\n"));
+		mb.appendAttachment(vmime::create <vmime::defaultAttachment>
+			(vmime::create <vmime::stringContentHandler>(m_data),
+			 vmime::encoding("base64"), vmime::mediaType("application/octet-stream")));
+
+		return mb.construct();
+	}
+
+
+	const std::string m_data;
+	const bool m_compiled;
+
+	vmime::ref <vmime::messageTemplate> m_template;
+	unsigned long m_length;
+};
+
+
+class encoderBenchmark : public benchmark
+{
+public:
+
+	encoderBenchmark(const std::string& name, const std::string& encoding,
+	                 const std::string& data, const bool decode)
+		: benchmark(name), m_encoding(encoding), m_decode(decode)
+	{
+		if (decode)
+		{
+			vmime::ref <vmime::utility::encoder::encoder> enc =
+				vmime::utility::encoder::encoderFactory::getInstance()->create(encoding);
+
+			vmime::utility::inputStreamStringAdapter in(data);
+			vmime::utility::outputStreamStringAdapter out(m_data);
+
+			enc->encode(in, out);
+		}
+		else
+		{
+			m_data = data;
+		}
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::ref <vmime::utility::encoder::encoder> enc =
+			vmime::utility::encoder::encoderFactory::getInstance()->create(m_encoding);
+
+		vmime::utility::inputStreamStringAdapter in(m_data);
+		nullOutputStream out;
+
+		if (m_decode)
+			enc->decode(in, out);
+		else
+			enc->encode(in, out);
+	}
+
+private:
+
+	const std::string m_encoding;
+	std::string m_data;
+	const bool m_decode;
+};
+
+
+class charsetBenchmark : public benchmark
+{
+public:
+
+	charsetBenchmark(const std::string& name, const std::string& data,
+	                 const vmime::charset& source, const vmime::charset& dest)
+		: benchmark(name), m_data(data), m_source(source), m_dest(dest)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::charsetConverter conv(m_source, m_dest);
+
+		vmime::utility::inputStreamStringAdapter in(m_data);
+		nullOutputStream out;
+
+		conv.convert(in, out);
+	}
+
+private:
+
+	const std::string m_data;
+	const vmime::charset m_source;
+	const vmime::charset m_dest;
+};
+
+
+class wordBenchmark : public benchmark
+{
+public:
+
+	wordBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data)
+	{
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::text txt;
+		vmime::text::decodeAndUnfold(m_data, &txt);
+
+		txt.getConvertedText(vmime::charsets::UTF_8);
+	}
+
+private:
+
+	const std::string m_data;
+};
+
+
+#if VMIME_BENCH_IMAP
+
+/** Socket which receives data from a buffer.
+  */
+class memorySocket : public vmime::net::socket
+{
+public:
+
+	memorySocket(const std::string& data)
+		: m_data(data), m_pos(0)
+	{
+	}
+
+	void connect(const vmime::string& /* address */, const vmime::port_t /* port */) { }
+	void disconnect() { }
+	bool isConnected() const { return true; }
+
+	void receive(vmime::string& buffer)
+	{
+		// Simulate reads of at most 64 KB
+		const vmime::string::size_type count = std::min
+			(m_data.length() - m_pos, static_cast <vmime::string::size_type>(65536));
+
+		buffer.assign(m_data, m_pos, count);
+		m_pos += count;
+	}
+
+	int receiveRaw(char* buffer, const size_type count)
+	{
+		const size_type n = std::min(static_cast <size_type>(m_data.length() - m_pos), count);
+
+		std::memcpy(buffer, m_data.data() + m_pos, n);
+		m_pos += n;
+
+		return static_cast <int>(n);
+	}
+
+	void send(const vmime::string& /* buffer */) { }
+	void sendRaw(const char* /* buffer */, const size_type /* count */) { }
+
+	size_type getBlockSize() const { return 65536; }
+
+private:
+
+	const std::string& m_data;
+	vmime::string::size_type m_pos;
+};
+
+
+class imapBenchmark : public benchmark
+{
+public:
+
+	imapBenchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data), m_tag(vmime::create <vmime::net::imap::IMAPTag>())
+	{
+		++(*m_tag);
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_data.length();
+	}
+
+	void run()
+	{
+		vmime::ref <vmime::net::socket> sok = vmime::create <memorySocket>(m_data);
+
+		vmime::net::imap::IMAPParser parser(m_tag, sok, vmime::ref <vmime::net::timeoutHandler>());
+
+		vmime::utility::auto_ptr <vmime::net::imap::IMAPParser::response>
+			resp(parser.readResponse());
+	}
+
+private:
+
+	const std::string m_data;
+	vmime::ref <vmime::net::imap::IMAPTag> m_tag;
+};
+
+#endif // VMIME_BENCH_IMAP
+
+
+#if VMIME_BENCH_POP3
+
+/** Socket connected to a fake POP3 server, which holds a single message.
+  */
+class fakePOP3Socket : public vmime::net::socket
+{
+public:
+
+	fakePOP3Socket(const std::string& retrResponse)
+		: m_retrResponse(retrResponse), m_response(&m_reply), m_pos(0)
+	{
+	}
+
+	void connect(const vmime::string& /* address */, const vmime::port_t /* port */)
+	{
+		reply("+OK fake POP3 server ready\r\n");
+	}
+
+	void disconnect() { }
+	bool isConnected() const { return true; }
+
+	void receive(vmime::string& buffer)
+	{
+		char data[65536];
+		buffer.assign(data, receiveRaw(data, sizeof(data)));
+	}
+
+	int receiveRaw(char* buffer, const size_type count)
+	{
+		const size_type n = std::min
+			(static_cast <size_type>(m_response->length() - m_pos), count);
+
+		std::memcpy(buffer, m_response->data() + m_pos, n);
+		m_pos += n;
+
+		return static_cast <int>(n);
+	}
+
+	void send(const vmime::string& buffer)
+	{
+		if (buffer.compare(0, 4, "RETR") == 0)
+		{
+			m_response = &m_retrResponse;
+			m_pos = 0;
+		}
+		else if (buffer.compare(0, 4, "STAT") == 0 || buffer.compare(0, 4, "LIST") == 0)
+		{
+			std::ostringstream oss;
+			oss << "+OK 1 " << m_retrResponse.length() << "\r\n";
+
+			reply(oss.str());
+		}
+		else
+		{
+			reply("+OK\r\n");
+		}
+	}
+
+	void sendRaw(const char* buffer, const size_type count)
+	{
+		send(vmime::string(buffer, count));
+	}
+
+	size_type getBlockSize() const { return 65536; }
+
+private:
+
+	void reply(const std::string& response)
+	{
+		m_reply = response;
+		m_response = &m_reply;
+		m_pos = 0;
+	}
+
+
+	const std::string& m_retrResponse;
+	std::string m_reply;
+	const std::string* m_response;
+	std::string::size_type m_pos;
+};
+
+
+class fakePOP3SocketFactory : public vmime::net::socketFactory
+{
+public:
+
+	fakePOP3SocketFactory(const std::string& retrResponse)
+		: m_retrResponse(retrResponse)
+	{
+	}
+
+	vmime::ref <vmime::net::socket> create()
+	{
+		return vmime::create <fakePOP3Socket>(m_retrResponse);
+	}
+
+	vmime::ref <vmime::net::socket> create(vmime::ref <vmime::net::timeoutHandler> /* th */)
+	{
+		return create();
+	}
+
+private:
+
+	const std::string& m_retrResponse;
+};
+
+
+class pop3Benchmark : public benchmark
+{
+public:
+
+	pop3Benchmark(const std::string& name, const std::string& data)
+		: benchmark(name), m_data(data)
+	{
+		// Byte-stuff the message and terminate the multi-line response
+		std::ostringstream oss;
+		vmime::utility::outputStreamAdapter os(oss);
+		vmime::utility::dotFilteredOutputStream dos(os);
+
+		os.write("+OK message follows\r\n", 22);
+		dos.write(m_data.data(), m_data.length());
+		os.write("\r\n.\r\n", 5);
+
+		m_retrResponse = oss.str();
+
+		// Connect to the fake server
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		sess->getProperties()["store.pop3.options.sasl"] = false;
+		sess->getProperties()["store.pop3.options.apop"] = false;
+		sess->getProperties()["store.pop3.auth.username"] = "user";
+		sess->getProperties()["store.pop3.auth.password"] = "password";
+
+		m_store = sess->getStore(vmime::utility::url("pop3://localhost"));
+		m_store->setSocketFactory(vmime::create <fakePOP3SocketFactory>(m_retrResponse));
+		m_store->connect();
+
+		m_folder = m_store->getDefaultFolder();
+		m_folder->open(vmime::net::folder::MODE_READ_ONLY);
+	}
+
+	unsigned long getBytesPerIteration() const
+	{
+		return m_retrResponse.length();
+	}
+
+	void run()
+	{
+		nullOutputStream os;
+		m_folder->getMessage(1)->extract(os);
+	}
+
+private:
+
+	const std::string m_data;
+	std::string m_retrResponse;
+
+	vmime::ref <vmime::net::store> m_store;
+	vmime::ref <vmime::net::folder> m_folder;
+};
+
+#endif // VMIME_BENCH_POP3
+
+
+struct benchResult
+{
+	std::string name;
+	unsigned long iterations;
+	double seconds;
+	unsigned long bytes;
+	unsigned long allocs;
+};
+
+
+static const benchResult runBenchmark(benchmark& b, const double minTime)
+{
+	// Warm up
+	b.run();
+
+	benchResult res;
+	res.name = b.getName();
+	res.iterations = 0;
+	res.bytes = b.getBytesPerIteration();
+
+	const unsigned long initialAllocCount = getAllocCount();
+	const double start = now();
+
+	do
+	{
+		b.run();
+		++res.iterations;
+	}
+	while ((res.seconds = now() - start) < minTime);
+
+	res.allocs = getAllocCount() - initialAllocCount;
+
+	return res;
+}
+
+
+static double getThroughput(const benchResult& res)
+{
+	return static_cast <double>(res.bytes) * static_cast <double>(res.iterations) / res.seconds / 1048576.0;
+}
+
+
+static void printText(const std::vector <benchResult>& results)
+{
+	std::cout.setf(std::ios::fixed);
+	std::cout.precision(2);
+
+	std::cout << "benchmark                       iterations     MB/s      ops/s  allocs/op" << std::endl;
+
+	for (std::vector <benchResult>::const_iterator it = results.begin() ; it != results.end() ; ++it)
+	{
+		std::cout.width(32);
+		std::cout.setf(std::ios::left, std::ios::adjustfield);
+		std::cout << it->name;
+
+		std::cout.setf(std::ios::right, std::ios::adjustfield);
+
+		std::cout.width(10);
+		std::cout << it->iterations;
+		std::cout.width(9);
+		std::cout << getThroughput(*it);
+		std::cout.width(11);
+		std::cout << (static_cast <double>(it->iterations) / it->seconds);
+		std::cout.width(11);
+		std::cout << (static_cast <double>(it->allocs) / static_cast <double>(it->iterations));
+		std::cout << std::endl;
+	}
+}
+
+
+static void printJSON(const std::vector <benchResult>& results, const unsigned long seed)
+{
+	std::cout << "{" << std::endl
+	          << "  \"version\": \"" << VMIME_VERSION << "\"," << std::endl
+	          << "  \"seed\": " << seed << "," << std::endl
+	          << "  \"benchmarks\": [" << std::endl;
+
+	for (std::vector <benchResult>::const_iterator it = results.begin() ; it != results.end() ; ++it)
+	{
+		std::cout << "    {\"name\": \"" << it->name << "\""
+		          << ", \"iterations\": " << it->iterations
+		          << ", \"seconds\": " << it->seconds
+		          << ", \"bytes_per_op\": " << it->bytes
+		          << ", \"mb_per_s\": " << getThroughput(*it)
+		          << ", \"ops_per_s\": " << (static_cast <double>(it->iterations) / it->seconds)
+		          << ", \"allocs_per_op\": " << (static_cast <double>(it->allocs) / static_cast <double>(it->iterations))
+		          << "}" << (it + 1 != results.end() ? "," : "") << std::endl;
+	}
+
+	std::cout << "  ]" << std::endl
+	          << "}" << std::endl;
+}
+
+
+static void createBenchmarks(benchCorpus& corpus, std::vector <benchmark*>& benchmarks)
+{
+	for (int k = 0 ; k < benchCorpus::KIND_COUNT ; ++k)
+	{
+		const benchCorpus::Kind kind = static_cast <benchCorpus::Kind>(k);
+		const std::string data = corpus.generateMessage(kind);
+
+		benchmarks.push_back(new parseBenchmark
+			(std::string("parse/") + benchCorpus::getKindName(kind), data));
+		benchmarks.push_back(new streamingParseBenchmark
+			(std::string("streaming-parse/") + benchCorpus::getKindName(kind), data));
+		benchmarks.push_back(new eventParseBenchmark
+			(std::string("event-parse/") + benchCorpus::getKindName(kind), data));
+		benchmarks.push_back(new generateBenchmark
+			(std::string("generate/") + benchCorpus::getKindName(kind), data));
+
+		// Header only
+		std::string::size_type headerEnd = data.find("\r\n\r\n");
+
+		if (headerEnd != std::string::npos)
+		{
+			benchmarks.push_back(new headerBenchmark
+				(std::string("header/") + benchCorpus::getKindName(kind), data.substr(0, headerEnd + 2)));
+		}
+	}
+
+	benchmarks.push_back(new batchParseBenchmark("batch-parse/1-thread", corpus, 1));
+	benchmarks.push_back(new batchParseBenchmark("batch-parse/4-threads", corpus, 4));
+
+	const std::string binary = corpus.generateBinary(1024 * 1024);
+	const std::string text = corpus.generateText(1024 * 1024);
+
+	benchmarks.push_back(new encoderBenchmark("encode/base64", "base64", binary, false));
+
+	vmime::encodedContentCache::getInstance()->setMaxMemorySize(16 * 1024 * 1024);
+
+	benchmarks.push_back(new attachmentBenchmark("attachment/uncached", binary, false));
+	benchmarks.push_back(new attachmentBenchmark("attachment/cached", binary, true));
+
+	benchmarks.push_back(new templateBenchmark("newsletter/builder", binary.substr(0, 64 * 1024), false));
+	benchmarks.push_back(new templateBenchmark("newsletter/template", binary.substr(0, 64 * 1024), true));
+
+	benchmarks.push_back(new encoderBenchmark("decode/base64", "base64", binary, true));
+	benchmarks.push_back(new encoderBenchmark("encode/quoted-printable", "quoted-printable", text, false));
+	benchmarks.push_back(new encoderBenchmark("decode/quoted-printable", "quoted-printable", text, true));
+	benchmarks.push_back(new encoderBenchmark("encode/uuencode", "uuencode", binary, false));
+	benchmarks.push_back(new encoderBenchmark("decode/uuencode", "uuencode", binary, true));
+
+	// Latin text with accented letters
+	std::string latin1;
+
+	for (std::string::size_type i = 0 ; i < text.length() ; ++i)
+		latin1 += ((i % 7) == 0 ? static_cast <char>(0xe9) : text[i]);
+
+	std::string utf8;
+	vmime::charset::convert(latin1, utf8, vmime::charsets::ISO8859_1, vmime::charsets::UTF_8);
+
+	benchmarks.push_back(new charsetBenchmark("charset/iso-8859-1-to-utf-8",
+		latin1, vmime::charsets::ISO8859_1, vmime::charsets::UTF_8));
+	benchmarks.push_back(new charsetBenchmark("charset/utf-8-to-iso-8859-1",
+		utf8, vmime::charsets::UTF_8, vmime::charsets::ISO8859_1));
+	benchmarks.push_back(new charsetBenchmark("charset/utf-8-to-windows-1252",
+		utf8, vmime::charsets::UTF_8, vmime::charsets::WINDOWS_1252));
+
+	benchmarks.push_back(new wordBenchmark("word/decode", corpus.generateEncodedWords(1000)));
+
+#if VMIME_BENCH_IMAP
+	benchmarks.push_back(new imapBenchmark("imap/fetch", corpus.generateIMAPFetchResponse(500)));
+	benchmarks.push_back(new imapBenchmark("imap/mixed", corpus.generateIMAPMixedResponse(2000)));
+#endif // VMIME_BENCH_IMAP
+
+#if VMIME_BENCH_POP3
+	// Text with a lot of lines starting with a dot, which must be stuffed
+	std::string dotted = text;
+
+	for (std::string::size_type i = 0 ; (i = dotted.find("\n", i)) != std::string::npos ; i += 2)
+		dotted.insert(i + 1, ".");
+
+	benchmarks.push_back(new pop3Benchmark("pop3/retr", corpus.generateMessage(benchCorpus::KIND_ATTACHMENT)));
+	benchmarks.push_back(new pop3Benchmark("pop3/retr-dotted", dotted));
+#endif // VMIME_BENCH_POP3
+}
+
+
+static bool writeCorpus(benchCorpus& corpus, const std::string& dir)
+{
+	for (int k = 0 ; k < benchCorpus::KIND_COUNT ; ++k)
+	{
+		const benchCorpus::Kind kind = static_cast <benchCorpus::Kind>(k);
+		const std::string path = dir + "/" + benchCorpus::getKindName(kind) + ".eml";
+
+		std::ofstream ofs(path.c_str(), std::ios::out | std::ios::binary);
+		ofs << corpus.generateMessage(kind);
+
+		if (!ofs)
+		{
+			std::cerr << "Error: cannot write '" << path << "'" << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	bool list = false;
+	std::string filter;
+	std::string corpusDir;
+	double minTime = 1.0;
+	unsigned long seed = 42;
+
+	for (int i = 1 ; i < argc ; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if (arg == "--json")
+			json = true;
+		else if (arg == "--list")
+			list = true;
+		else if (arg == "--filter" && i + 1 < argc)
+			filter = argv[++i];
+		else if (arg == "--min-time" && i + 1 < argc)
+			minTime = std::atof(argv[++i]);
+		else if (arg == "--seed" && i + 1 < argc)
+			seed = std::strtoul(argv[++i], NULL, 10);
+		else if (arg == "--write-corpus" && i + 1 < argc)
+			corpusDir = argv[++i];
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--json] [--filter <string>] [--min-time <s>]"
+			          << " [--seed <n>] [--list] [--write-corpus <dir>]" << std::endl;
+			return 1;
+		}
+	}
+
+	vmime::platform::setHandler <vmime::platforms::posix::posixHandler>();
+
+	benchCorpus corpus(seed);
+
+	if (!corpusDir.empty())
+		return writeCorpus(corpus, corpusDir) ? 0 : 1;
+
+	std::vector <benchmark*> benchmarks;
+	std::vector <benchResult> results;
+
+	int ret = 0;
+
+	try
+	{
+		createBenchmarks(corpus, benchmarks);
+
+		for (std::vector <benchmark*>::iterator it = benchmarks.begin() ; it != benchmarks.end() ; ++it)
+		{
+			if (!filter.empty() && (*it)->getName().find(filter) == std::string::npos)
+				continue;
+
+			if (list)
+			{
+				std::cout << (*it)->getName() << std::endl;
+				continue;
+			}
+
+			if (!json)
+				std::cerr << "Running " << (*it)->getName() << "..." << std::endl;
+
+			results.push_back(runBenchmark(**it, minTime));
+		}
+	}
+	catch (vmime::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		ret = 1;
+	}
+
+	for (std::vector <benchmark*>::iterator it = benchmarks.begin() ; it != benchmarks.end() ; ++it)
+		delete *it;
+
+	if (ret == 0 && !list)
+	{
+		if (json)
+			printJSON(results, seed);
+		else
+			printText(results);
+	}
+
+	return ret;
+}
@@ -258,6 +258,12 @@ const std::vector <ref <component> > addressList::getChildComponents()
 }
 
 
+bool addressList::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_list, v);
+}
+
+
 ref <mailboxList> addressList::toMailboxList() const
 {
 	ref <mailboxList> res = vmime::create <mailboxList>();
@@ -0,0 +1,541 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/batchParser.hpp"
+#include "vmime/platform.hpp"
+#include "vmime/options.hpp"
+#include "vmime/headerFieldFactory.hpp"
+#include "vmime/textPartFactory.hpp"
+#include "vmime/charsetConverterPool.hpp"
+
+#include "vmime/utility/encoder/encoderFactory.hpp"
+#include "vmime/utility/instrumentation.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/streamUtils.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+
+
+namespace vmime
+{
+
+
+#ifndef VMIME_BUILDING_DOC
+
+/** Parses messages until all the messages have been parsed.
+  * The same task is run by all threads, each with its own queue.
+  */
+class batchParser::worker : public utility::sync::runnable
+{
+public:
+
+	worker(batchParser* parser, const unsigned int queue)
+		: m_parser(parser), m_queue(queue)
+	{
+	}
+
+	void run()
+	{
+		context ctx;
+		size_type index;
+
+		while (m_parser->waitForWork(m_queue, index))
+			m_parser->process(index, ctx);
+	}
+
+private:
+
+	batchParser* m_parser;
+	const unsigned int m_queue;
+};
+
+
+/** Records the parsing events of a message, so that they can be
+  * reported later in the calling thread.
+  */
+class batchParser::eventRecorder : public mimeEventParser::handler
+{
+public:
+
+	eventRecorder(result& res)
+		: m_result(res)
+	{
+	}
+
+	void onPartBegin(const int depth)
+	{
+		record(recordedEvent::PART_BEGIN, depth, 0, 0);
+	}
+
+	void onHeaderField
+		(const char* name, const string::size_type nameLength,
+		 const char* value, const string::size_type valueLength)
+	{
+		record(recordedEvent::HEADER_FIELD, 0, nameLength, valueLength);
+
+		m_result.eventData.append(name, nameLength);
+		m_result.eventData.append(value, valueLength);
+	}
+
+	void onBodyChunk
+		(const utility::stream::value_type* data, const utility::stream::size_type count)
+	{
+		record(recordedEvent::BODY_CHUNK, 0, count, 0);
+
+		m_result.eventData.append(data, count);
+	}
+
+	void onPartEnd()
+	{
+		record(recordedEvent::PART_END, 0, 0, 0);
+	}
+
+private:
+
+	void record(const recordedEvent::Type type, const int depth,
+		const string::size_type length, const string::size_type valueLength)
+	{
+		recordedEvent e;
+		e.type = type;
+		e.depth = depth;
+		e.offset = m_result.eventData.length();
+		e.length = length;
+		e.valueLength = valueLength;
+
+		m_result.events.push_back(e);
+	}
+
+	result& m_result;
+};
+
+#endif // VMIME_BUILDING_DOC
+
+
+
+//
+// batchParser::fileSource
+//
+
+batchParser::fileSource::fileSource(ref <utility::file> file)
+	: m_file(file)
+{
+}
+
+
+void batchParser::fileSource::read(string& data)
+{
+	ref <utility::inputStream> is = m_file->getFileReader()->getInputStream();
+
+	data.clear();
+	data.reserve(static_cast <string::size_type>(m_file->getLength()));
+
+	utility::outputStreamStringAdapter os(data);
+	utility::bufferedStreamCopy(*is, os);
+}
+
+
+
+//
+// batchParser::stringSource
+//
+
+batchParser::stringSource::stringSource(const string& data)
+	: m_data(data)
+{
+}
+
+
+void batchParser::stringSource::read(string& data)
+{
+	data.assign(m_data);
+}
+
+
+
+//
+// batchParser
+//
+
+batchParser::batchParser(const unsigned int threadCount)
+	: m_threadCount(threadCount != 0 ? threadCount : 1),
+	  m_maxPending(4 * m_threadCount), m_sources(NULL), m_events(false), m_stopping(false)
+{
+	m_cond = platform::getHandler()->createCondition();
+}
+
+
+batchParser::~batchParser()
+{
+}
+
+
+void batchParser::setMaxPendingMessages(const size_type count)
+{
+	m_maxPending = (count != 0 ? count : 1);
+}
+
+
+batchParser::size_type batchParser::getMaxPendingMessages() const
+{
+	return m_maxPending;
+}
+
+
+void batchParser::parse(const std::vector <ref <source> >& sources, messageHandler& h)
+{
+	run(sources, &h, NULL);
+}
+
+
+void batchParser::parse(const std::vector <ref <source> >& sources, eventHandler& h)
+{
+	run(sources, NULL, &h);
+}
+
+
+void batchParser::run(const std::vector <ref <source> >& sources, messageHandler* mh, eventHandler* eh)
+{
+	initializeSingletons();
+
+	m_sources = &sources;
+	m_events = (eh != NULL);
+	m_stopping = false;
+
+	m_queues.clear();
+	m_queues.resize(m_threadCount);
+
+	for (unsigned int i = 0 ; i < m_threadCount ; ++i)
+		m_queues[i].lock = platform::getHandler()->createCriticalSection();
+
+	result empty;
+	empty.ready = false;
+	empty.error = NULL;
+
+	m_results.clear();
+	m_results.resize(m_maxPending, empty);
+
+	const size_type count = sources.size();
+
+	for (size_type i = 0 ; i < count && i < m_maxPending ; ++i)
+		addWork(i);
+
+	// The calling thread also takes part in parsing, when it is
+	// waiting for the next message to report
+	std::vector <ref <utility::sync::thread> > threads;
+
+	for (unsigned int i = 1 ; i < m_threadCount && i < count ; ++i)
+	{
+		try
+		{
+			threads.push_back(platform::getHandler()->createThread
+				(vmime::create <worker>(this, i)));
+		}
+		catch (exceptions::system_error&)
+		{
+			// Continue with the threads already started
+			break;
+		}
+	}
+
+	context ctx;
+	result current = empty;
+
+	try
+	{
+		for (size_type next = 0 ; next < count ; ++next)
+		{
+			result& res = m_results[next % m_maxPending];
+
+			while (true)
+			{
+				size_type index;
+
+				{
+					utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+					if (res.ready)
+						break;
+				}
+
+				if (takeWork(0, index))
+				{
+					process(index, ctx);
+				}
+				else
+				{
+					// All remaining messages are being parsed by other threads
+					utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+					while (!res.ready)
+						m_cond->wait();
+
+					break;
+				}
+			}
+
+			// Take the result out of its slot, before the slot is reused
+			// for another message (the memory of the buffers is kept)
+			current.msg = res.msg;
+			current.events.swap(res.events);
+			current.eventData.swap(res.eventData);
+			current.error = res.error;
+
+			res.ready = false;
+			res.msg = NULL;
+			res.events.clear();
+			res.eventData.clear();
+			res.error = NULL;
+
+			if (next + m_maxPending < count)
+			{
+				addWork(next + m_maxPending);
+
+				utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+				m_cond->notifyAll();
+			}
+
+			report(next, current, mh, eh);
+		}
+	}
+	catch (...)
+	{
+		// Drop the messages which have not been parsed yet
+		for (unsigned int i = 0 ; i < m_threadCount ; ++i)
+		{
+			utility::sync::autoLock <utility::sync::criticalSection> lock(m_queues[i].lock);
+			m_queues[i].indexes.clear();
+		}
+
+		{
+			utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+			m_stopping = true;
+			m_cond->notifyAll();
+		}
+
+		for (std::vector <ref <utility::sync::thread> >::size_type i = 0 ; i < threads.size() ; ++i)
+			threads[i]->join();
+
+		for (std::vector <result>::size_type i = 0 ; i < m_results.size() ; ++i)
+			delete m_results[i].error;
+
+		m_results.clear();
+
+		throw;
+	}
+
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		m_stopping = true;
+		m_cond->notifyAll();
+	}
+
+	for (std::vector <ref <utility::sync::thread> >::size_type i = 0 ; i < threads.size() ; ++i)
+		threads[i]->join();
+
+	m_results.clear();
+}
+
+
+void batchParser::addWork(const size_type index)
+{
+	workQueue& q = m_queues[index % m_threadCount];
+
+	utility::sync::autoLock <utility::sync::criticalSection> lock(q.lock);
+	q.indexes.push_back(index);
+}
+
+
+bool batchParser::takeWork(const unsigned int queue, size_type& index)
+{
+	// Own queue first, then steal from the other threads. As messages
+	// are reported in order, the oldest message is always taken.
+	for (unsigned int i = 0 ; i < m_threadCount ; ++i)
+	{
+		workQueue& q = m_queues[(queue + i) % m_threadCount];
+
+		utility::sync::autoLock <utility::sync::criticalSection> lock(q.lock);
+
+		if (!q.indexes.empty())
+		{
+			index = q.indexes.front();
+			q.indexes.pop_front();
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool batchParser::waitForWork(const unsigned int queue, size_type& index)
+{
+	if (takeWork(queue, index))
+		return true;
+
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	while (!m_stopping)
+	{
+		// Work is only added by the calling thread, which notifies
+		// the condition after adding it
+		if (takeWork(queue, index))
+			return true;
+
+		m_cond->wait();
+	}
+
+	return false;
+}
+
+
+void batchParser::process(const size_type index, context& ctx)
+{
+	// This thread is the only one to use the slot until it is ready
+	result& res = m_results[index % m_maxPending];
+
+	try
+	{
+		ref <source> src = (*m_sources)[index];
+		src->read(ctx.data);
+
+		if (m_events)
+		{
+			eventRecorder recorder(res);
+			ctx.eventParser.parse(ctx.data, recorder);
+		}
+		else
+		{
+			ref <message> msg = vmime::create <message>();
+			msg->parse(ctx.data);
+
+			res.msg = msg;
+		}
+	}
+	catch (exception& e)
+	{
+		res.error = e.clone();
+	}
+	catch (std::exception& e)
+	{
+		res.error = new exceptions::system_error(e.what());
+	}
+	catch (...)
+	{
+		res.error = new exceptions::system_error("Unknown error");
+	}
+
+	if (res.error)
+	{
+		res.events.clear();
+		res.eventData.clear();
+	}
+
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	res.ready = true;
+	m_cond->notifyAll();
+}
+
+
+void batchParser::report(const size_type index, result& res, messageHandler* mh, eventHandler* eh)
+{
+	utility::auto_ptr <exception> error(res.error);
+	res.error = NULL;
+
+	if (error != NULL)
+	{
+		if (mh)
+			mh->onError(index, *error);
+		else
+			eh->onError(index, *error);
+
+		return;
+	}
+
+	if (mh)
+	{
+		ref <message> msg = res.msg;
+		res.msg = NULL;
+
+		mh->onMessage(index, msg);
+
+		return;
+	}
+
+	const char* data = res.eventData.data();
+
+	eh->onMessageBegin(index);
+
+	for (std::vector <recordedEvent>::const_iterator it = res.events.begin() ;
+	     it != res.events.end() ; ++it)
+	{
+		const recordedEvent& e = *it;
+
+		switch (e.type)
+		{
+		case recordedEvent::PART_BEGIN:
+
+			eh->onPartBegin(e.depth);
+			break;
+
+		case recordedEvent::HEADER_FIELD:
+
+			eh->onHeaderField(data + e.offset, e.length,
+				data + e.offset + e.length, e.valueLength);
+			break;
+
+		case recordedEvent::BODY_CHUNK:
+
+			eh->onBodyChunk(data + e.offset, e.length);
+			break;
+
+		case recordedEvent::PART_END:
+
+			eh->onPartEnd();
+			break;
+		}
+	}
+
+	eh->onMessageEnd(index);
+}
+
+
+// static
+void batchParser::initializeSingletons()
+{
+	// Before C++11, local static objects are not guaranteed to be
+	// constructed safely when several threads first use them at the
+	// same time: construct the ones used for parsing before the
+	// threads are started
+	options::getInstance();
+	headerFieldFactory::getInstance();
+	textPartFactory::getInstance();
+	charsetConverterPool::getInstance();
+	utility::encoder::encoderFactory::getInstance();
+	utility::instrumentation::getInstance();
+}
+
+
+} // vmime
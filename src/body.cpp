@@ -25,6 +25,7 @@
 #include "vmime/body.hpp"
 
 #include "vmime/options.hpp"
+#include "vmime/parallelGenerator.hpp"
 
 #include "vmime/contentTypeField.hpp"
 #include "vmime/text.hpp"
@@ -100,63 +101,7 @@ void body::parseImpl
 			{
 				// No "boundary" parameter specified: we can try to
 				// guess it by scanning the body contents...
-				utility::stream::size_type pos = position;
-
-				parser->seek(pos);
-
-				if (pos + 2 < end && parser->matchBytes("--", 2))
-				{
-					pos += 2;
-				}
-				else
-				{
-					pos = parser->findNext("\n--", position);
-
-					if ((pos != utility::stream::npos) && (pos + 3 < end))
-						pos += 3;  // skip \n--
-				}
-
-				if ((pos != utility::stream::npos) && (pos < end))
-				{
-					parser->seek(pos);
-
-					// Read some bytes after boundary separator
-					utility::stream::value_type buffer[256];
-					const utility::stream::size_type bufferLen =
-						parser->read(buffer, std::min(end - pos, sizeof(buffer) / sizeof(buffer[0])));
-
-					buffer[sizeof(buffer) / sizeof(buffer[0]) - 1] = '\0';
-
-					// Extract boundary from buffer (stop at first CR or LF).
-					// We have to stop after a reasonnably long boundary length (100)
-					// not to take the whole body contents for a boundary...
-					string::value_type boundaryBytes[100];
-					string::size_type boundaryLen = 0;
-
-					for (string::value_type c = buffer[0] ;
-					     boundaryLen < bufferLen && boundaryLen < 100 && !(c == '\r' || c == '\n') ;
-					     c = buffer[++boundaryLen])
-					{
-						boundaryBytes[boundaryLen] = buffer[boundaryLen];
-					}
-
-					if (boundaryLen >= 1 && boundaryLen < 100)
-					{
-						// RFC #1521, Page 31:
-						// "...the boundary parameter, which consists of 1 to 70
-						//  characters from a set of characters known to be very
-						//  robust through email gateways, and NOT ending with
-						//  white space..."
-						while (boundaryLen != 0 &&
-						       parserHelpers::isSpace(boundaryBytes[boundaryLen - 1]))
-						{
-							boundaryLen--;
-						}
-
-						if (boundaryLen >= 1)
-							boundary = string(boundaryBytes, boundaryBytes + boundaryLen);
-					}
-				}
+				boundary = guessBoundary(parser, position, end);
 			}
 		}
  	}
@@ -171,44 +116,10 @@ void body::parseImpl
 		const string boundarySep("--" + boundary);
 
 		utility::stream::size_type partStart = position;
-		utility::stream::size_type pos = position;
+		utility::stream::size_type pos = findNextBoundary(parser, boundarySep, position, end);
 
 		bool lastPart = false;
 
-		while (pos != utility::stream::npos && pos < end)
-		{
-			pos = parser->findNext(boundarySep, pos);
-
-			if (pos == utility::stream::npos)
-				break;  // not found
-
-			if (pos != 0)
-			{
-				parser->seek(pos - 1);
-
-				if (parser->peekByte() != '\n')
-				{
-					// Boundary is not at a beginning of a line
-					pos++;
-					continue;
-				}
-
-				parser->skip(1 + boundarySep.length());
-			}
-			else
-			{
-				parser->seek(pos + boundarySep.length());
-			}
-
-			const utility::stream::value_type next = parser->peekByte();
-
-			if (next == '\r' || next == '\n' || next == '-')
-				break;
-
-			// Boundary is a prefix of another, continue the search
-			pos++;
-		}
-
 		if (pos != utility::stream::npos && pos < end)
 		{
 			vmime::text text;
@@ -219,51 +130,8 @@ void body::parseImpl
 
 		for (int index = 0 ; !lastPart && (pos != utility::stream::npos) && (pos < end) ; ++index)
 		{
-			utility::stream::size_type partEnd = pos;
-
-			// Get rid of the [CR]LF just before the boundary string
-			if (pos >= (position + 1))
-			{
-				parser->seek(pos - 1);
-
-				if (parser->peekByte() == '\n')
-					--partEnd;
-			}
-
-			if (pos >= (position + 2))
-			{
-				parser->seek(pos - 2);
-
-				if (parser->peekByte() == '\r')
-					--partEnd;
-			}
-
-			// Check whether it is the last part (boundary terminated by "--")
-			pos += boundarySep.length();
-			parser->seek(pos);
-
-			if (pos + 1 < end && parser->matchBytes("--", 2))
-			{
-				lastPart = true;
-				pos += 2;
-			}
-
-			// RFC #1521, Page 31:
-			// "...(If a boundary appears to end with white space, the
-			//  white space must be presumed to have been added by a
-			//  gateway, and must be deleted.)..."
-			parser->seek(pos);
-			pos += parser->skipIf(parserHelpers::isSpaceOrTab, end);
-
-			// End of boundary line
-			if (pos + 1 < end && parser->matchBytes("\r\n", 2))
-			{
-				pos += 2;
-			}
-			else if (pos < end && parser->peekByte() == '\n')
-			{
-				++pos;
-			}
+			utility::stream::size_type partEnd = 0;
+			pos = skipBoundary(parser, boundarySep, position, pos, end, &partEnd, &lastPart);
 
 			if (index > 0)
 			{
@@ -282,39 +150,7 @@ void body::parseImpl
 
 			partStart = pos;
 
-			while (pos != utility::stream::npos && pos < end)
-			{
-				pos = parser->findNext(boundarySep, pos);
-
-				if (pos == utility::stream::npos)
-					break;  // not found
-
-				if (pos != 0)
-				{
-					parser->seek(pos - 1);
-
-					if (parser->peekByte() != '\n')
-					{
-						// Boundary is not at a beginning of a line
-						pos++;
-						continue;
-					}
-
-					parser->skip(1 + boundarySep.length());
-				}
-				else
-				{
-					parser->seek(pos + boundarySep.length());
-				}
-
-				const utility::stream::value_type next = parser->peekByte();
-
-				if (next == '\r' || next == '\n' || next == '-')
-					break;
-
-				// Boundary is a prefix of another, continue the search
-				pos++;
-			}
+			pos = findNextBoundary(parser, boundarySep, pos, end);
 		}
 
 		m_contents = vmime::create <emptyContentHandler>();
@@ -384,6 +220,183 @@ void body::parseImpl
 }
 
 
+// static
+const string body::guessBoundary
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end)
+{
+	utility::stream::size_type pos = position;
+
+	parser->seek(pos);
+
+	if (pos + 2 < end && parser->matchBytes("--", 2))
+	{
+		pos += 2;
+	}
+	else
+	{
+		pos = parser->findNext("\n--", position);
+
+		if ((pos != utility::stream::npos) && (pos + 3 < end))
+			pos += 3;  // skip \n--
+	}
+
+	if ((pos != utility::stream::npos) && (pos < end))
+	{
+		parser->seek(pos);
+
+		// Read some bytes after boundary separator
+		utility::stream::value_type buffer[256];
+		const utility::stream::size_type bufferLen =
+			parser->read(buffer, std::min(end - pos, sizeof(buffer) / sizeof(buffer[0])));
+
+		buffer[sizeof(buffer) / sizeof(buffer[0]) - 1] = '\0';
+
+		// Extract boundary from buffer (stop at first CR or LF).
+		// We have to stop after a reasonnably long boundary length (100)
+		// not to take the whole body contents for a boundary...
+		string::value_type boundaryBytes[100];
+		string::size_type boundaryLen = 0;
+
+		for (string::value_type c = buffer[0] ;
+		     boundaryLen < bufferLen && boundaryLen < 100 && !(c == '\r' || c == '\n') ;
+		     c = buffer[++boundaryLen])
+		{
+			boundaryBytes[boundaryLen] = buffer[boundaryLen];
+		}
+
+		if (boundaryLen >= 1 && boundaryLen < 100)
+		{
+			// RFC #1521, Page 31:
+			// "...the boundary parameter, which consists of 1 to 70
+			//  characters from a set of characters known to be very
+			//  robust through email gateways, and NOT ending with
+			//  white space..."
+			while (boundaryLen != 0 &&
+			       parserHelpers::isSpace(boundaryBytes[boundaryLen - 1]))
+			{
+				boundaryLen--;
+			}
+
+			if (boundaryLen >= 1)
+				return string(boundaryBytes, boundaryBytes + boundaryLen);
+		}
+	}
+
+	return "";
+}
+
+
+// static
+utility::stream::size_type body::findNextBoundary
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const string& boundarySep,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end)
+{
+	utility::stream::size_type pos = position;
+
+	while (pos != utility::stream::npos && pos < end)
+	{
+		pos = parser->findNext(boundarySep, pos);
+
+		if (pos == utility::stream::npos)
+			break;  // not found
+
+		if (pos != 0)
+		{
+			parser->seek(pos - 1);
+
+			if (parser->peekByte() != '\n')
+			{
+				// Boundary is not at a beginning of a line
+				pos++;
+				continue;
+			}
+
+			parser->skip(1 + boundarySep.length());
+		}
+		else
+		{
+			parser->seek(pos + boundarySep.length());
+		}
+
+		const utility::stream::value_type next = parser->peekByte();
+
+		if (next == '\r' || next == '\n' || next == '-')
+			break;
+
+		// Boundary is a prefix of another, continue the search
+		pos++;
+	}
+
+	return pos;
+}
+
+
+// static
+utility::stream::size_type body::skipBoundary
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const string& boundarySep,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type boundaryPos,
+	 const utility::stream::size_type end,
+	 utility::stream::size_type* partEnd,
+	 bool* lastPart)
+{
+	utility::stream::size_type pos = boundaryPos;
+
+	*partEnd = pos;
+
+	// Get rid of the [CR]LF just before the boundary string
+	if (pos >= (position + 1))
+	{
+		parser->seek(pos - 1);
+
+		if (parser->peekByte() == '\n')
+			--*partEnd;
+	}
+
+	if (pos >= (position + 2))
+	{
+		parser->seek(pos - 2);
+
+		if (parser->peekByte() == '\r')
+			--*partEnd;
+	}
+
+	// Check whether it is the last part (boundary terminated by "--")
+	pos += boundarySep.length();
+	parser->seek(pos);
+
+	if (pos + 1 < end && parser->matchBytes("--", 2))
+	{
+		*lastPart = true;
+		pos += 2;
+	}
+
+	// RFC #1521, Page 31:
+	// "...(If a boundary appears to end with white space, the
+	//  white space must be presumed to have been added by a
+	//  gateway, and must be deleted.)..."
+	parser->seek(pos);
+	pos += parser->skipIf(parserHelpers::isSpaceOrTab, end);
+
+	// End of boundary line
+	if (pos + 1 < end && parser->matchBytes("\r\n", 2))
+	{
+		pos += 2;
+	}
+	else if (pos < end && parser->peekByte() == '\n')
+	{
+		++pos;
+	}
+
+	return pos;
+}
+
+
 void body::generateImpl(utility::outputStream& os, const string::size_type maxLineLength,
 	const string::size_type /* curLinePos */, string::size_type* newLinePos) const
 {
@@ -473,8 +486,9 @@ void body::generateImpl(utility::outputStream& os, const string::size_type maxLi
 	// Simple body
 	else
 	{
-		// Generate the contents
-		m_contents->generate(os, getEncoding(), maxLineLength);
+		// Generate the contents, unless they have been encoded in advance
+		if (!parallelGenerator::generateEncodedContents(os, *this))
+			m_contents->generate(os, getEncoding(), maxLineLength);
 	}
 }
 
@@ -964,4 +978,10 @@ const std::vector <ref <component> > body::getChildComponents()
 }
 
 
+bool body::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_parts, v);
+}
+
+
 } // vmime
@@ -156,5 +156,11 @@ const std::vector <ref <component> > bodyPart::getChildComponents()
 }
 
 
+bool bodyPart::visitChildComponentsImpl(childVisitor& v)
+{
+	return v.visit(*m_header) && v.visit(*m_body);
+}
+
+
 } // vmime
 
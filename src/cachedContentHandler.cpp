@@ -0,0 +1,107 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/cachedContentHandler.hpp"
+#include "vmime/encodedContentCache.hpp"
+
+
+namespace vmime
+{
+
+
+cachedContentHandler::cachedContentHandler(ref <const contentHandler> cts, const string& contentKey)
+	: m_contents(cts), m_contentKey(contentKey)
+{
+}
+
+
+ref <contentHandler> cachedContentHandler::clone() const
+{
+	return vmime::create <cachedContentHandler>(m_contents->clone(), m_contentKey);
+}
+
+
+void cachedContentHandler::generate(utility::outputStream& os, const vmime::encoding& enc,
+	const string::size_type maxLineLength) const
+{
+	encodedContentCache::getInstance()->generate(m_contentKey, *m_contents, os, enc, maxLineLength);
+}
+
+
+void cachedContentHandler::extract(utility::outputStream& os,
+	utility::progressListener* progress) const
+{
+	m_contents->extract(os, progress);
+}
+
+
+void cachedContentHandler::extractRaw(utility::outputStream& os,
+	utility::progressListener* progress) const
+{
+	m_contents->extractRaw(os, progress);
+}
+
+
+string::size_type cachedContentHandler::getLength() const
+{
+	return m_contents->getLength();
+}
+
+
+bool cachedContentHandler::isEmpty() const
+{
+	return m_contents->isEmpty();
+}
+
+
+bool cachedContentHandler::isEncoded() const
+{
+	return m_contents->isEncoded();
+}
+
+
+const vmime::encoding& cachedContentHandler::getEncoding() const
+{
+	return m_contents->getEncoding();
+}
+
+
+bool cachedContentHandler::isBuffered() const
+{
+	return m_contents->isBuffered();
+}
+
+
+ref <const contentHandler> cachedContentHandler::getContents() const
+{
+	return m_contents;
+}
+
+
+const string& cachedContentHandler::getContentKey() const
+{
+	return m_contentKey;
+}
+
+
+} // vmime
@@ -148,6 +148,12 @@ const std::vector <ref <component> > charset::getChildComponents()
 }
 
 
+bool charset::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 
 // Explicitly force encoding for some charsets
 struct CharsetEncodingEntry
@@ -22,9 +22,12 @@
 //
 
 #include "vmime/charsetConverter.hpp"
+#include "vmime/charsetConverterPool.hpp"
+#include "vmime/nativeCharsetConverter.hpp"
 #include "vmime/exception.hpp"
 #include "vmime/utility/inputStreamStringAdapter.hpp"
 #include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/instrumentation.hpp"
 
 
 extern "C"
@@ -81,18 +84,14 @@ namespace vmime
 
 
 charsetConverter::charsetConverter(const charset& source, const charset& dest)
-	: m_desc(NULL), m_source(source), m_dest(dest)
+	: m_desc(NULL), m_source(source), m_dest(dest),
+	  m_native(nativeCharsetConverter::isSupported(source, dest))
 {
-	// Get an iconv descriptor
-	const iconv_t cd = iconv_open(dest.getName().c_str(), source.getName().c_str());
+	VMIME_INSTRUMENT_COUNT(COUNTER_CHARSET_CONVERTERS);
 
-	if (cd != reinterpret_cast <iconv_t>(-1))
-	{
-		iconv_t* p = new iconv_t;
-		*p= cd;
-
-		m_desc = p;
-	}
+	// Get an iconv descriptor, if the conversion cannot be done natively
+	if (!m_native)
+		m_desc = charsetConverterPool::getInstance()->acquire(source, dest);
 }
 
 
@@ -100,10 +99,8 @@ charsetConverter::~charsetConverter()
 {
 	if (m_desc != NULL)
 	{
-		// Close iconv handle
-		iconv_close(*static_cast <iconv_t*>(m_desc));
-
-		delete static_cast <iconv_t*>(m_desc);
+		// Give back iconv handle for later reuse
+		charsetConverterPool::getInstance()->release(m_source, m_dest, m_desc);
 		m_desc = NULL;
 	}
 }
@@ -111,6 +108,22 @@ charsetConverter::~charsetConverter()
 
 void charsetConverter::convert(utility::inputStream& in, utility::outputStream& out)
 {
+	if (m_native)
+	{
+		nativeCharsetConverter conv(m_source, m_dest);
+		char buffer[16384];
+
+		while (!in.eof())
+		{
+			const utility::stream::size_type count = in.read(buffer, sizeof(buffer));
+			conv.convert(buffer, count, out);
+		}
+
+		conv.flush(out);
+
+		return;
+	}
+
 	if (m_desc == NULL)
 		throw exceptions::charset_conv_error("Cannot initialize converter.");
 
@@ -149,7 +162,7 @@ void charsetConverter::convert(utility::inputStream& in, utility::outputStream&
 				outputInvalidChar(out, cd);
 
 				// Skip a byte and leave unconverted bytes in the input buffer
-				std::copy(const_cast <char*>(inPtr + 1), inBuffer + sizeof(inBuffer), inBuffer);
+				std::copy(inPtr + 1, inPtr + inLength, inBuffer);
 				inPos = inLength - 1;
 			}
 			else
@@ -158,7 +171,7 @@ void charsetConverter::convert(utility::inputStream& in, utility::outputStream&
 				out.write(outBuffer, sizeof(outBuffer) - outLength);
 
 				// Leave unconverted bytes in the input buffer
-				std::copy(const_cast <char*>(inPtr), inBuffer + sizeof(inBuffer), inBuffer);
+				std::copy(inPtr, inPtr + inLength, inBuffer);
 				inPos = inLength;
 
 				if (errno != E2BIG)
@@ -208,16 +221,12 @@ charsetFilteredOutputStream::charsetFilteredOutputStream
 	: m_desc(NULL), m_sourceCharset(source), m_destCharset(dest),
 	  m_stream(os), m_unconvCount(0)
 {
-	// Get an iconv descriptor
-	const iconv_t cd = iconv_open(dest.getName().c_str(), source.getName().c_str());
-
-	if (cd != reinterpret_cast <iconv_t>(-1))
-	{
-		iconv_t* p = new iconv_t;
-		*p= cd;
+	VMIME_INSTRUMENT_COUNT(COUNTER_CHARSET_CONVERTERS);
 
-		m_desc = p;
-	}
+	if (nativeCharsetConverter::isSupported(source, dest))
+		m_native = vmime::create <nativeCharsetConverter>(source, dest);
+	else  // Get an iconv descriptor
+		m_desc = charsetConverterPool::getInstance()->acquire(source, dest);
 }
 
 
@@ -225,10 +234,10 @@ charsetFilteredOutputStream::~charsetFilteredOutputStream()
 {
 	if (m_desc != NULL)
 	{
-		// Close iconv handle
-		iconv_close(*static_cast <iconv_t*>(m_desc));
+		// Give back iconv handle for later reuse
+		charsetConverterPool::getInstance()->release
+			(m_sourceCharset, m_destCharset, m_desc);
 
-		delete static_cast <iconv_t*>(m_desc);
 		m_desc = NULL;
 	}
 }
@@ -243,6 +252,12 @@ outputStream& charsetFilteredOutputStream::getNextOutputStream()
 void charsetFilteredOutputStream::write
 	(const value_type* const data, const size_type count)
 {
+	if (m_native)
+	{
+		m_native->convert(data, count, m_stream);
+		return;
+	}
+
 	if (m_desc == NULL)
 		throw exceptions::charset_conv_error("Cannot initialize converter.");
 
@@ -361,6 +376,14 @@ void charsetFilteredOutputStream::write
 
 void charsetFilteredOutputStream::flush()
 {
+	if (m_native)
+	{
+		m_native->flush(m_stream);
+		m_stream.flush();
+
+		return;
+	}
+
 	if (m_desc == NULL)
 		throw exceptions::charset_conv_error("Cannot initialize converter.");
 
@@ -0,0 +1,202 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/charsetConverterPool.hpp"
+
+#include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+#include "vmime/utility/instrumentation.hpp"
+
+
+extern "C"
+{
+#ifndef VMIME_BUILDING_DOC
+
+	#include <iconv.h>
+
+#endif // VMIME_BUILDING_DOC
+}
+
+
+namespace vmime
+{
+
+
+charsetConverterPool::charsetConverterPool()
+	: m_maxIdleCount(8), m_openCount(0), m_reuseCount(0)
+{
+	// The pool is used by charset conversions, which do not
+	// require a platform handler to be set
+	m_lock = vmime::create <utility::sync::builtinCriticalSection>();
+}
+
+
+charsetConverterPool::~charsetConverterPool()
+{
+	clear();
+}
+
+
+charsetConverterPool* charsetConverterPool::getInstance()
+{
+	static charsetConverterPool instance;
+	return (&instance);
+}
+
+
+// static
+const charsetConverterPool::key_type charsetConverterPool::makeKey
+	(const charset& source, const charset& dest)
+{
+	return key_type(utility::stringUtils::toLower(source.getName()),
+	                utility::stringUtils::toLower(dest.getName()));
+}
+
+
+// static
+void charsetConverterPool::closeDescriptor(void* desc)
+{
+	iconv_close(*static_cast <iconv_t*>(desc));
+	delete static_cast <iconv_t*>(desc);
+}
+
+
+void* charsetConverterPool::acquire(const charset& source, const charset& dest)
+{
+	const key_type key = makeKey(source, dest);
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		std::map <key_type, std::vector <void*> >::iterator it = m_idle.find(key);
+
+		if (it != m_idle.end() && !it->second.empty())
+		{
+			void* desc = it->second.back();
+			it->second.pop_back();
+
+			++m_reuseCount;
+
+			// Reset the conversion state left by the previous user
+			iconv(*static_cast <iconv_t*>(desc), NULL, NULL, NULL, NULL);
+
+			return desc;
+		}
+	}
+
+	// Open a new descriptor (outside of the lock, as this is
+	// the expensive part)
+	VMIME_INSTRUMENT_COUNT(COUNTER_ICONV_OPENS);
+
+	const iconv_t cd = iconv_open(dest.getName().c_str(), source.getName().c_str());
+
+	if (cd == reinterpret_cast <iconv_t>(-1))
+		return NULL;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+		++m_openCount;
+	}
+
+	iconv_t* p = new iconv_t;
+	*p = cd;
+
+	return p;
+}
+
+
+void charsetConverterPool::release(const charset& source, const charset& dest, void* desc)
+{
+	if (desc == NULL)
+		return;
+
+	const key_type key = makeKey(source, dest);
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		std::vector <void*>& idle = m_idle[key];
+
+		if (idle.size() < m_maxIdleCount)
+		{
+			idle.push_back(desc);
+			return;
+		}
+	}
+
+	closeDescriptor(desc);
+}
+
+
+void charsetConverterPool::clear()
+{
+	std::map <key_type, std::vector <void*> > idle;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+		idle.swap(m_idle);
+	}
+
+	for (std::map <key_type, std::vector <void*> >::iterator it = idle.begin() ;
+	     it != idle.end() ; ++it)
+	{
+		for (unsigned int i = 0 ; i < it->second.size() ; ++i)
+			closeDescriptor(it->second[i]);
+	}
+}
+
+
+void charsetConverterPool::setMaxIdleCount(const unsigned int count)
+{
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+		m_maxIdleCount = count;
+	}
+
+	clear();
+}
+
+
+unsigned int charsetConverterPool::getMaxIdleCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+	return m_maxIdleCount;
+}
+
+
+unsigned long charsetConverterPool::getOpenCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+	return m_openCount;
+}
+
+
+unsigned long charsetConverterPool::getReuseCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+	return m_reuseCount;
+}
+
+
+} // vmime
@@ -28,6 +28,7 @@
 #include "vmime/utility/inputStreamStringAdapter.hpp"
 #include "vmime/utility/outputStreamAdapter.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -35,6 +36,32 @@ namespace vmime
 {
 
 
+#ifndef VMIME_BUILDING_DOC
+
+// Offsets the parsed bounds of the visited components
+class component::offsetVisitor : public component::childVisitor
+{
+public:
+
+	offsetVisitor(const std::ptrdiff_t delta)
+		: m_delta(delta)
+	{
+	}
+
+	bool visit(component& child)
+	{
+		child.offsetParsedBounds(m_delta);
+		return true;
+	}
+
+private:
+
+	const std::ptrdiff_t m_delta;
+};
+
+#endif // VMIME_BUILDING_DOC
+
+
 component::component()
 	: m_parsedOffset(0), m_parsedLength(0)
 {
@@ -101,17 +128,34 @@ void component::parse
 }
 
 
-void component::offsetParsedBounds(const utility::stream::size_type offset)
+void component::offsetParsedBounds(const std::ptrdiff_t delta)
 {
 	// Offset parsed bounds of this component
 	if (m_parsedLength != 0)
-		m_parsedOffset += offset;
+	{
+		if (delta >= 0)
+			m_parsedOffset += static_cast <utility::stream::size_type>(delta);
+		else
+			m_parsedOffset -= static_cast <utility::stream::size_type>(-delta);
+	}
 
 	// Offset parsed bounds of our children
+	offsetVisitor v(delta);
+	visitChildComponentsImpl(v);
+}
+
+
+bool component::visitChildComponents(childVisitor& v)
+{
+	return visitChildComponentsImpl(v);
+}
+
+
+bool component::visitChildComponentsImpl(childVisitor& v)
+{
 	std::vector <ref <component> > children = getChildComponents();
 
-	for (unsigned int i = 0, n = children.size() ; i < n ; ++i)
-		children[i]->offsetParsedBounds(offset);
+	return visitComponents(children, v);
 }
 
 
@@ -119,12 +163,35 @@ void component::parseImpl
 	(ref <utility::parserInputStreamAdapter> parser, const utility::stream::size_type position,
 	 const utility::stream::size_type end, utility::stream::size_type* newPosition)
 {
+	utility::stream::size_type offset = 0, length = 0;
+	const string* streamBuffer = parser->getBuffer(offset, length);
+
+	// The contents of the stream are held in memory: parse them in place,
+	// without going past the end of the stream
+	if (streamBuffer != NULL)
+	{
+		const utility::stream::size_type regionEnd = std::min(end, length);
+		const utility::stream::size_type regionPos = std::min(position, regionEnd);
+
+		string::size_type newPos = 0;
+		parseImpl(*streamBuffer, offset + regionPos, offset + regionEnd, &newPos);
+
+		// Make parsed bounds relative to the stream
+		if (offset != 0)
+			offsetParsedBounds(-static_cast <std::ptrdiff_t>(offset));
+
+		if (newPosition != NULL)
+			*newPosition = newPos - offset;
+
+		return;
+	}
+
 	const std::string buffer = parser->extract(position, end);
 	parseImpl(buffer, 0, buffer.length(), newPosition);
 
 	// Recursivey offset parsed bounds on children
 	if (position != 0)
-		offsetParsedBounds(position);
+		offsetParsedBounds(static_cast <std::ptrdiff_t>(position));
 
 	if (newPosition != NULL)
 		*newPosition += position;
@@ -0,0 +1,433 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/componentInputStream.hpp"
+#include "vmime/exception.hpp"
+#include "vmime/platform.hpp"
+
+#include "vmime/utility/outputStream.hpp"
+#include "vmime/utility/outputStreamAdapter.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+#include "vmime/utility/sync/runnable.hpp"
+
+#include <sstream>
+
+
+namespace vmime
+{
+
+
+#ifndef VMIME_BUILDING_DOC
+
+namespace
+{
+
+
+/** Thrown in the generating thread when the reader has stopped reading. */
+class generationCancelled
+{
+};
+
+
+/** Discards generated data, only counting bytes. */
+class countingOutputStream : public utility::outputStream
+{
+public:
+
+	countingOutputStream()
+		: m_count(0)
+	{
+	}
+
+	void write(const value_type* const /* data */, const size_type count)
+	{
+		m_count += count;
+	}
+
+	void flush()
+	{
+		// Nothing to do
+	}
+
+	size_type getCount() const
+	{
+		return m_count;
+	}
+
+private:
+
+	size_type m_count;
+};
+
+
+} // namespace
+
+
+/** Bounded buffer between the generating thread and the reader.
+  */
+class componentInputStream::pipe : public object
+{
+public:
+
+	pipe()
+		: m_buffer(65536), m_readPos(0), m_count(0),
+		  m_finished(false), m_cancelled(false), m_error(NULL)
+	{
+		m_cond = platform::getHandler()->createCondition();
+	}
+
+	~pipe()
+	{
+		delete m_error;
+	}
+
+	/** Called by the generating thread. Blocks while the buffer is full. */
+	void write(const value_type* data, size_type count)
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		const size_type capacity = m_buffer.size();
+
+		while (count != 0)
+		{
+			while (m_count == capacity && !m_cancelled)
+				m_cond->wait();
+
+			if (m_cancelled)
+				throw generationCancelled();
+
+			const size_type writePos = (m_readPos + m_count) % capacity;
+			const size_type n = std::min(count, std::min(capacity - m_count, capacity - writePos));
+
+			std::copy(data, data + n, &m_buffer[writePos]);
+
+			data += n;
+			count -= n;
+			m_count += n;
+
+			m_cond->notifyAll();
+		}
+	}
+
+	/** Called by the generating thread when it is done. Takes ownership
+	  * of the exception, if any. */
+	void finish(exception* error)
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		m_error = error;
+		m_finished = true;
+
+		m_cond->notifyAll();
+	}
+
+	/** Called by the reader. Blocks until some data is available. */
+	size_type read(value_type* data, const size_type count)
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		while (m_count == 0 && !m_finished)
+			m_cond->wait();
+
+		if (m_count == 0 && m_error != NULL)
+			m_error->throwException();
+
+		const size_type capacity = m_buffer.size();
+		size_type total = 0;
+
+		while (total < count && m_count != 0)
+		{
+			const size_type n = std::min(count - total, std::min(m_count, capacity - m_readPos));
+
+			std::copy(&m_buffer[m_readPos], &m_buffer[m_readPos] + n, data + total);
+
+			total += n;
+			m_count -= n;
+			m_readPos = (m_readPos + n) % capacity;
+		}
+
+		m_cond->notifyAll();
+
+		return total;
+	}
+
+	/** Called by the reader to make the generating thread stop. */
+	void cancel()
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		m_cancelled = true;
+
+		m_cond->notifyAll();
+	}
+
+	bool eof() const
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		return m_finished && m_count == 0;
+	}
+
+private:
+
+	ref <utility::sync::condition> m_cond;
+
+	std::vector <value_type> m_buffer;
+	size_type m_readPos;
+	size_type m_count;
+
+	bool m_finished;
+	bool m_cancelled;
+	exception* m_error;
+};
+
+
+/** Generates the component into the pipe.
+  */
+class componentInputStream::generatorTask : public utility::sync::runnable
+{
+public:
+
+	generatorTask(ref <const component> comp, const string::size_type maxLineLength, ref <pipe> p)
+		: m_component(comp), m_maxLineLength(maxLineLength), m_pipe(p)
+	{
+	}
+
+	void run()
+	{
+		exception* error = NULL;
+
+		try
+		{
+			pipeOutputStream os(m_pipe);
+
+			m_component->generate(os, m_maxLineLength);
+
+			os.flush();
+		}
+		catch (generationCancelled&)
+		{
+			// The reader has stopped reading
+		}
+		catch (exception& e)
+		{
+			error = e.clone();
+		}
+		catch (std::exception& e)
+		{
+			error = new exceptions::system_error(e.what());
+		}
+		catch (...)
+		{
+			error = new exceptions::system_error("Unknown error");
+		}
+
+		m_pipe->finish(error);
+	}
+
+private:
+
+	/** Writes generated data to the pipe, in blocks rather than as
+	  * many small writes. */
+	class pipeOutputStream : public utility::outputStream
+	{
+	public:
+
+		pipeOutputStream(ref <pipe> p)
+			: m_pipe(p), m_bufferLength(0)
+		{
+		}
+
+		void write(const value_type* const data, const size_type count)
+		{
+			if (m_bufferLength + count > sizeof(m_buffer))
+			{
+				flush();
+
+				if (count >= sizeof(m_buffer))
+				{
+					m_pipe->write(data, count);
+					return;
+				}
+			}
+
+			std::copy(data, data + count, m_buffer + m_bufferLength);
+			m_bufferLength += count;
+		}
+
+		void flush()
+		{
+			if (m_bufferLength != 0)
+			{
+				m_pipe->write(m_buffer, m_bufferLength);
+				m_bufferLength = 0;
+			}
+		}
+
+	private:
+
+		ref <pipe> m_pipe;
+
+		value_type m_buffer[8192];
+		size_type m_bufferLength;
+	};
+
+
+	ref <const component> m_component;
+	string::size_type m_maxLineLength;
+
+	ref <pipe> m_pipe;
+};
+
+#endif // VMIME_BUILDING_DOC
+
+
+
+componentInputStream::componentInputStream(ref <const component> comp, const string::size_type maxLineLength)
+	: m_component(comp), m_maxLineLength(maxLineLength), m_size(0), m_sizeKnown(false),
+	  m_inMemory(false), m_dataPos(0)
+{
+}
+
+
+componentInputStream::~componentInputStream()
+{
+	stop();
+}
+
+
+componentInputStream::size_type componentInputStream::getSize()
+{
+	if (!m_sizeKnown)
+	{
+		countingOutputStream os;
+		m_component->generate(os, m_maxLineLength);
+
+		m_size = os.getCount();
+		m_sizeKnown = true;
+	}
+
+	return m_size;
+}
+
+
+void componentInputStream::start()
+{
+	try
+	{
+		m_pipe = vmime::create <pipe>();
+		m_thread = platform::getHandler()->createThread
+			(vmime::create <generatorTask>(m_component, m_maxLineLength, m_pipe));
+	}
+	catch (exceptions::system_error&)
+	{
+		// The platform handler does not support threads: generate
+		// the whole component in memory instead
+		m_pipe = NULL;
+
+		std::ostringstream oss;
+		utility::outputStreamAdapter osa(oss);
+
+		m_component->generate(osa, m_maxLineLength);
+
+		m_data = oss.str();
+		m_dataPos = 0;
+		m_inMemory = true;
+
+		m_size = m_data.length();
+		m_sizeKnown = true;
+	}
+}
+
+
+void componentInputStream::stop()
+{
+	if (m_thread != NULL)
+	{
+		m_pipe->cancel();
+		m_thread->join();
+	}
+
+	m_thread = NULL;
+	m_pipe = NULL;
+
+	m_data.clear();
+	m_dataPos = 0;
+	m_inMemory = false;
+}
+
+
+bool componentInputStream::eof() const
+{
+	if (m_inMemory)
+		return (m_dataPos >= m_data.length());
+
+	return (m_pipe != NULL && m_pipe->eof());
+}
+
+
+void componentInputStream::reset()
+{
+	stop();
+}
+
+
+componentInputStream::size_type componentInputStream::read(value_type* const data, const size_type count)
+{
+	if (m_pipe == NULL && !m_inMemory)
+		start();
+
+	if (m_inMemory)
+	{
+		const size_type n = std::min(count, static_cast <size_type>(m_data.length() - m_dataPos));
+
+		std::copy(m_data.begin() + m_dataPos, m_data.begin() + m_dataPos + n, data);
+		m_dataPos += n;
+
+		return n;
+	}
+
+	return m_pipe->read(data, count);
+}
+
+
+componentInputStream::size_type componentInputStream::skip(const size_type count)
+{
+	value_type buffer[4096];
+	size_type total = 0;
+
+	while (total < count && !eof())
+	{
+		const size_type n = read(buffer, std::min(count - total, static_cast <size_type>(sizeof(buffer))));
+
+		if (n == 0)
+			break;
+
+		total += n;
+	}
+
+	return total;
+}
+
+
+} // vmime
@@ -128,4 +128,10 @@ const std::vector <ref <component> > contentDisposition::getChildComponents()
 }
 
 
+bool contentDisposition::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
@@ -74,17 +74,17 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 	const string::value_type* p = buffer.data() + position;
 
 	// Parse the date and time value
-	while (p < pend && parserHelpers::isSpace(*p)) ++p;
+	p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 	if (p < pend)
 	{
 		if (parserHelpers::isAlpha(*p))
 		{
 			// Ignore week day
-			while (p < pend && parserHelpers::isAlpha(*p)) ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_ALPHA>(p, pend);
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			if (p < pend && *p == ',') ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 		}
 
 		bool dayParsed = false;
@@ -96,7 +96,7 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 		}
 		else
 		{
-			while (p < pend && !parserHelpers::isDigit(*p)) ++p;
+			p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_DIGIT>(p, pend);
 
 			if (p < pend && parserHelpers::isDigit(*p))
 			{
@@ -112,16 +112,16 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 				m_day = (day >= 1 && day <= 31) ? day : 1;
 
-				while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			}
 			else
 			{
 				m_day = 1;
 
 				// Skip everything to the next field
-				while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			}
 
 			dayParsed = true;
@@ -140,7 +140,7 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 			}
 			while (monthLength < 3 && p < pend && parserHelpers::isAlpha(*p));
 
-			while (p < pend && parserHelpers::isAlpha(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_ALPHA>(p, pend);
 
 			switch (month[0])
 			{
@@ -224,8 +224,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 			}
 
-			while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 		}
 		else
 		{
@@ -240,8 +240,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 			else
 			{
 				// Skip everything to the next field
-				while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			}
 		}
 
@@ -259,8 +259,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 			m_day = (day >= 1 && day <= 31) ? day : 1;
 
-			while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 		}
 
 		if (p < pend && parserHelpers::isDigit(*p))
@@ -288,8 +288,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 				else if (year < 1000)  m_year = year + 1900;
 				else                   m_year = year;
 
-				while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			}
 		}
 		else
@@ -297,8 +297,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 			m_year = 1970;
 
 			// Skip everything to the next field
-			while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 		}
 
 		if (p < pend && parserHelpers::isDigit(*p))
@@ -315,13 +315,13 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 			m_hour = (hour >= 0 && hour <= 23) ? hour : 0;
 
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 			if (p < pend && *p == ':')
 			{
 				++p;
 
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 				if (p < pend && parserHelpers::isDigit(*p))
 				{
@@ -337,13 +337,13 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 					m_minute = (minute >= 0 && minute <= 59) ? minute : 0;
 
-					while (p < pend && parserHelpers::isSpace(*p)) ++p;
+					p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 					if (p < pend && *p == ':')
 					{
 						++p;
 
-						while (p < pend && parserHelpers::isSpace(*p)) ++p;
+						p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 						if (p < pend && parserHelpers::isDigit(*p))
 						{
@@ -359,8 +359,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 
 							m_second = (second >= 0 && second <= 59) ? second : 0;
 
-							while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-							while (p < pend && parserHelpers::isSpace(*p)) ++p;
+							p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+							p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 						}
 						else
 						{
@@ -387,8 +387,8 @@ void datetime::parseImpl(const string& buffer, const string::size_type position,
 			m_hour = 0;
 
 			// Skip everything to the next field
-			while (p < pend && !parserHelpers::isSpace(*p)) ++p;
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 		}
 
 		if (p + 1 < pend && (*p == '+' || *p == '-') && parserHelpers::isDigit(*(p + 1)))
@@ -790,6 +790,12 @@ const std::vector <ref <component> > datetime::getChildComponents()
 }
 
 
+bool datetime::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 int datetime::getYear() const { return (m_year); }
 int datetime::getMonth() const { return (m_month); }
 int datetime::getDay() const { return (m_day); }
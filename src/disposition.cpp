@@ -85,6 +85,12 @@ const std::vector <ref <component> > disposition::getChildComponents()
 }
 
 
+bool disposition::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 void disposition::setActionMode(const string& mode)
 {
 	m_actionMode = mode;
@@ -0,0 +1,504 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/encodedContentCache.hpp"
+#include "vmime/platform.hpp"
+#include "vmime/exception.hpp"
+
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/random.hpp"
+#include "vmime/utility/streamUtils.hpp"
+#include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+
+
+namespace vmime
+{
+
+
+/** Encoded contents, kept either in memory or in a file. The file
+  * is deleted when the entry is destroyed, ie. when it has been
+  * evicted and is not being copied any more.
+  *
+  * Entries are not modified once created, as they are copied outside
+  * of the cache lock: moving an entry to a file creates a new entry.
+  */
+class encodedContentCache::entry : public object
+{
+public:
+
+	entry(const string& data)
+		: m_data(data), m_length(data.length())
+	{
+	}
+
+	entry(ref <utility::file> file, const utility::stream::size_type length)
+		: m_file(file), m_length(length)
+	{
+	}
+
+	~entry()
+	{
+		if (m_file != NULL)
+		{
+			try
+			{
+				m_file->remove();
+			}
+			catch (exceptions::filesystem_exception&)
+			{
+				// Ignore
+			}
+		}
+	}
+
+	void write(utility::outputStream& os)
+	{
+		if (m_file == NULL)
+		{
+			os.write(m_data.data(), m_data.length());
+		}
+		else
+		{
+			ref <utility::inputStream> is = m_file->getFileReader()->getInputStream();
+			utility::bufferedStreamCopy(*is, os);
+		}
+	}
+
+	const string& getData() const
+	{
+		return m_data;
+	}
+
+	bool isInMemory() const
+	{
+		return m_file == NULL;
+	}
+
+	utility::stream::size_type getLength() const
+	{
+		return m_length;
+	}
+
+private:
+
+	const string m_data;
+	ref <utility::file> m_file;
+	const utility::stream::size_type m_length;
+};
+
+
+
+encodedContentCache::encodedContentCache()
+	: m_maxMemorySize(0), m_memorySize(0), m_maxDiskSize(0), m_diskSize(0),
+	  m_hitCount(0), m_missCount(0)
+{
+	m_lock = vmime::create <utility::sync::builtinCriticalSection>();
+}
+
+
+encodedContentCache::~encodedContentCache()
+{
+	clear();
+}
+
+
+encodedContentCache* encodedContentCache::getInstance()
+{
+	static encodedContentCache instance;
+	return (&instance);
+}
+
+
+// static
+const encodedContentCache::key_type encodedContentCache::makeKey
+	(const string& contentKey, const encoding& enc, const string::size_type maxLineLength)
+{
+	std::ostringstream oss;
+	oss << enc.generate() << '/' << static_cast <int>(enc.getUsage())
+	    << '/' << maxLineLength << '/' << contentKey;
+
+	return oss.str();
+}
+
+
+void encodedContentCache::generate(const string& contentKey, const contentHandler& cts,
+	utility::outputStream& os, const encoding& enc, const string::size_type maxLineLength)
+{
+	if (!isEnabled())
+	{
+		cts.generate(os, enc, maxLineLength);
+		return;
+	}
+
+	const key_type key = makeKey(contentKey, enc, maxLineLength);
+
+	ref <entry> e;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		std::map <key_type, slot>::iterator it = m_entries.find(key);
+
+		if (it != m_entries.end())
+		{
+			e = it->second.data;
+
+			m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+
+			++m_hitCount;
+		}
+		else
+		{
+			++m_missCount;
+		}
+	}
+
+	// Copy or generate the contents outside of the lock: the entry
+	// is not destroyed while we hold a reference to it
+	if (e != NULL)
+	{
+		e->write(os);
+		return;
+	}
+
+	string data;
+	utility::outputStreamStringAdapter dataOut(data);
+
+	cts.generate(dataOut, enc, maxLineLength);
+
+	os.write(data.data(), data.length());
+
+	store(key, data);
+}
+
+
+void encodedContentCache::store(const key_type& key, const string& data)
+{
+	std::vector <pendingEntry> toSpill;
+	std::vector <ref <entry> > dropped;   // destroyed after the lock is released
+
+	utility::file::path dir;
+	bool toFile = false;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		// Already generated by another thread
+		if (m_entries.find(key) != m_entries.end())
+			return;
+
+		// Too large to be cached
+		if (data.length() > m_maxMemorySize && data.length() > m_maxDiskSize)
+			return;
+
+		// Larger than the memory cache: written directly to a file, so
+		// that it does not push the other entries out of memory
+		if (data.length() > m_maxMemorySize)
+		{
+			toFile = true;
+		}
+		else
+		{
+			insert(key, vmime::create <entry>(data), true);
+			evict(toSpill, dropped);
+		}
+
+		dir = m_spillDir;
+	}
+
+	if (toFile)
+	{
+		ref <entry> fileEntry = writeToFile(dir, data);
+
+		if (fileEntry != NULL)
+		{
+			utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+			if (m_entries.find(key) == m_entries.end())
+			{
+				insert(key, fileEntry, true);
+				evict(toSpill, dropped);
+			}
+			else
+			{
+				dropped.push_back(fileEntry);
+			}
+		}
+	}
+
+	spill(toSpill, dir);
+}
+
+
+void encodedContentCache::insert(const key_type& key, ref <entry> e, const bool mostRecent)
+{
+	if (mostRecent)
+		m_lru.push_front(key);
+	else
+		m_lru.push_back(key);
+
+	slot& sl = m_entries[key];
+	sl.data = e;
+	sl.lruPos = (mostRecent ? m_lru.begin() : --m_lru.end());
+
+	if (e->isInMemory())
+		m_memorySize += e->getLength();
+	else
+		m_diskSize += e->getLength();
+}
+
+
+void encodedContentCache::evict(std::vector <pendingEntry>& toSpill, std::vector <ref <entry> >& dropped)
+{
+	// Remove least recently used entries from memory until memory usage
+	// is under the limit; those which fit on disk are written to files
+	// by spill(), outside of the lock
+	std::list <key_type>::iterator it = m_lru.end();
+
+	while (m_memorySize > m_maxMemorySize && it != m_lru.begin())
+	{
+		--it;
+
+		ref <entry> e = m_entries[*it].data;
+
+		if (!e->isInMemory())
+			continue;
+
+		m_memorySize -= e->getLength();
+
+		if (e->getLength() <= m_maxDiskSize)
+		{
+			pendingEntry pe;
+			pe.key = *it;
+			pe.data = e;
+
+			toSpill.push_back(pe);
+		}
+		else
+		{
+			dropped.push_back(e);
+		}
+
+		m_entries.erase(*it);
+		it = m_lru.erase(it);
+	}
+
+	// Remove least recently used files until disk usage is under the limit
+	it = m_lru.end();
+
+	while (m_diskSize > m_maxDiskSize && it != m_lru.begin())
+	{
+		--it;
+
+		ref <entry> e = m_entries[*it].data;
+
+		if (e->isInMemory())
+			continue;
+
+		m_diskSize -= e->getLength();
+
+		dropped.push_back(e);
+
+		m_entries.erase(*it);
+		it = m_lru.erase(it);
+	}
+}
+
+
+void encodedContentCache::spill(std::vector <pendingEntry>& toSpill, const utility::file::path& dir)
+{
+	std::vector <ref <entry> > dropped;   // destroyed after the lock is released
+
+	// Entries are not in the cache while they are written: entries are
+	// never modified, a new file-backed entry is inserted instead
+	for (std::vector <pendingEntry>::size_type i = 0 ; i < toSpill.size() ; ++i)
+	{
+		ref <entry> fileEntry = writeToFile(dir, toSpill[i].data->getData());
+
+		if (fileEntry == NULL)
+			continue;
+
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		if (m_entries.find(toSpill[i].key) != m_entries.end() ||
+		    fileEntry->getLength() > m_maxDiskSize)
+		{
+			dropped.push_back(fileEntry);
+			continue;
+		}
+
+		insert(toSpill[i].key, fileEntry, false);
+		evict(toSpill, dropped);
+	}
+}
+
+
+// static
+ref <encodedContentCache::entry> encodedContentCache::writeToFile
+	(const utility::file::path& dir, const string& data)
+{
+	ref <entry> fileEntry;
+
+	try
+	{
+		ref <utility::fileSystemFactory> fsf =
+			platform::getHandler()->getFileSystemFactory();
+
+		utility::file::path path = dir;
+		path.appendComponent(utility::file::path::component
+			("vmime-cache-" + utility::random::getString(16)));
+
+		ref <utility::file> file = fsf->create(path);
+		file->createFile();
+
+		// The file is deleted with the new entry if it cannot be written
+		fileEntry = vmime::create <entry>(file, data.length());
+
+		ref <utility::outputStream> os = file->getFileWriter()->getOutputStream();
+		os->write(data.data(), data.length());
+	}
+	catch (exceptions::filesystem_exception&)
+	{
+		return NULL;
+	}
+
+	return fileEntry;
+}
+
+
+bool encodedContentCache::isEnabled() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_maxMemorySize != 0 || m_maxDiskSize != 0;
+}
+
+
+void encodedContentCache::setMaxMemorySize(const utility::stream::size_type size)
+{
+	std::vector <pendingEntry> toSpill;
+	std::vector <ref <entry> > dropped;
+
+	utility::file::path dir;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		m_maxMemorySize = size;
+
+		evict(toSpill, dropped);
+
+		dir = m_spillDir;
+	}
+
+	spill(toSpill, dir);
+}
+
+
+utility::stream::size_type encodedContentCache::getMaxMemorySize() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_maxMemorySize;
+}
+
+
+void encodedContentCache::setSpillDirectory(const utility::file::path& dir,
+	const utility::stream::size_type maxSize)
+{
+	std::vector <pendingEntry> toSpill;
+	std::vector <ref <entry> > dropped;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		m_spillDir = dir;
+		m_maxDiskSize = maxSize;
+
+		evict(toSpill, dropped);
+	}
+
+	spill(toSpill, dir);
+}
+
+
+utility::stream::size_type encodedContentCache::getMaxDiskSize() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_maxDiskSize;
+}
+
+
+void encodedContentCache::clear()
+{
+	// Files are deleted after the lock is released
+	std::map <key_type, slot> entries;
+
+	{
+		utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+		entries.swap(m_entries);
+		m_lru.clear();
+
+		m_memorySize = 0;
+		m_diskSize = 0;
+	}
+}
+
+
+utility::stream::size_type encodedContentCache::getMemorySize() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_memorySize;
+}
+
+
+utility::stream::size_type encodedContentCache::getDiskSize() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_diskSize;
+}
+
+
+unsigned long encodedContentCache::getHitCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_hitCount;
+}
+
+
+unsigned long encodedContentCache::getMissCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_missCount;
+}
+
+
+} // vmime
@@ -103,6 +103,49 @@ ref <utility::encoder::encoder> encoding::getEncoder() const
 }
 
 
+ref <const utility::encoder::encoder> encoding::getSharedEncoder() const
+{
+	utility::encoder::encoderFactory* factory =
+		utility::encoder::encoderFactory::getInstance();
+
+	const utility::encoder::encoderFactory::Encoding enc =
+		utility::encoder::encoderFactory::getEncodingByName(m_name);
+
+	if (enc != utility::encoder::encoderFactory::ENCODING_UNKNOWN)
+		return factory->getSharedEncoder(enc);
+
+	return factory->create(m_name);
+}
+
+
+const utility::encoder::encoder::options encoding::getEncoderOptions() const
+{
+	utility::encoder::encoder::options opts;
+
+	if (m_usage == USAGE_TEXT && m_name == encodingTypes::QUOTED_PRINTABLE)
+		opts.text = true;
+
+	return opts;
+}
+
+
+utility::stream::size_type encoding::encode(utility::inputStream& in, utility::outputStream& out,
+	const string::size_type maxLineLength, utility::progressListener* progress) const
+{
+	utility::encoder::encoder::options opts = getEncoderOptions();
+	opts.maxLineLength = maxLineLength;
+
+	return getSharedEncoder()->encode(in, out, opts, progress);
+}
+
+
+utility::stream::size_type encoding::decode(utility::inputStream& in, utility::outputStream& out,
+	utility::progressListener* progress) const
+{
+	return getSharedEncoder()->decode(in, out, getEncoderOptions(), progress);
+}
+
+
 encoding& encoding::operator=(const encoding& other)
 {
 	copyFrom(other);
@@ -274,4 +317,10 @@ const std::vector <ref <component> > encoding::getChildComponents()
 }
 
 
+bool encoding::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
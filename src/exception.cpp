@@ -88,6 +88,12 @@ exception* exception::clone() const
 }
 
 
+void exception::throwException() const
+{
+	throw *this;
+}
+
+
 
 namespace exceptions
 {
@@ -102,6 +108,7 @@ bad_field_type::bad_field_type(const exception& other)
 	: exception("Bad field type.", other) {}
 
 exception* bad_field_type::clone() const { return new bad_field_type(*this); }
+void bad_field_type::throwException() const { throw *this; }
 const char* bad_field_type::name() const throw() { return "bad_field_type"; }
 
 
@@ -115,6 +122,7 @@ charset_conv_error::charset_conv_error(const string& what, const exception& othe
 	: exception(what.empty() ? "Charset conversion error." : what, other) {}
 
 exception* charset_conv_error::clone() const { return new charset_conv_error(*this); }
+void charset_conv_error::throwException() const { throw *this; }
 const char* charset_conv_error::name() const throw() { return "charset_conv_error"; }
 
 
@@ -127,6 +135,7 @@ no_encoder_available::no_encoder_available(const string& name, const exception&
 	: exception("No encoder available: '" + name + "'.", other) {}
 
 exception* no_encoder_available::clone() const { return new no_encoder_available(*this); }
+void no_encoder_available::throwException() const { throw *this; }
 const char* no_encoder_available::name() const throw() { return "no_encoder_available"; }
 
 
@@ -139,6 +148,7 @@ no_digest_algorithm_available::no_digest_algorithm_available(const string& name,
 	: exception("No algorithm available: '" + name + "'.", other) {}
 
 exception* no_digest_algorithm_available::clone() const { return new no_digest_algorithm_available(*this); }
+void no_digest_algorithm_available::throwException() const { throw *this; }
 const char* no_digest_algorithm_available::name() const throw() { return "no_digest_algorithm_available"; }
 
 
@@ -151,6 +161,7 @@ no_such_parameter::no_such_parameter(const string& name, const exception& other)
 	: exception(string("Parameter not found: '") + name + string("'."), other) {}
 
 exception* no_such_parameter::clone() const { return new no_such_parameter(*this); }
+void no_such_parameter::throwException() const { throw *this; }
 const char* no_such_parameter::name() const throw() { return "no_such_parameter"; }
 
 
@@ -163,6 +174,7 @@ no_such_field::no_such_field(const exception& other)
 	: exception("Field not found.", other) {}
 
 exception* no_such_field::clone() const { return new no_such_field(*this); }
+void no_such_field::throwException() const { throw *this; }
 const char* no_such_field::name() const throw() { return "no_such_field"; }
 
 
@@ -175,6 +187,7 @@ no_such_part::no_such_part(const exception& other)
 	: exception("Part not found.", other) {}
 
 exception* no_such_part::clone() const { return new no_such_part(*this); }
+void no_such_part::throwException() const { throw *this; }
 const char* no_such_part::name() const throw() { return "no_such_part"; }
 
 
@@ -187,6 +200,7 @@ no_such_mailbox::no_such_mailbox(const exception& other)
 	: exception("Mailbox not found.", other) {}
 
 exception* no_such_mailbox::clone() const { return new no_such_mailbox(*this); }
+void no_such_mailbox::throwException() const { throw *this; }
 const char* no_such_mailbox::name() const throw() { return "no_such_mailbox"; }
 
 
@@ -199,6 +213,7 @@ no_such_message_id::no_such_message_id(const exception& other)
 	: exception("Message-Id not found.", other) {}
 
 exception* no_such_message_id::clone() const { return new no_such_message_id(*this); }
+void no_such_message_id::throwException() const { throw *this; }
 const char* no_such_message_id::name() const throw() { return "no_such_message_id"; }
 
 
@@ -211,6 +226,7 @@ no_such_address::no_such_address(const exception& other)
 	: exception("Address not found.", other) {}
 
 exception* no_such_address::clone() const { return new no_such_address(*this); }
+void no_such_address::throwException() const { throw *this; }
 const char* no_such_address::name() const throw() { return "no_such_address"; }
 
 
@@ -223,6 +239,7 @@ open_file_error::open_file_error(const exception& other)
 	: exception("Error opening file.", other) {}
 
 exception* open_file_error::clone() const { return new open_file_error(*this); }
+void open_file_error::throwException() const { throw *this; }
 const char* open_file_error::name() const throw() { return "open_file_error"; }
 
 
@@ -235,6 +252,7 @@ no_factory_available::no_factory_available(const exception& other)
 	: exception("No factory available.", other) {}
 
 exception* no_factory_available::clone() const { return new no_factory_available(*this); }
+void no_factory_available::throwException() const { throw *this; }
 const char* no_factory_available::name() const throw() { return "no_factory_available"; }
 
 
@@ -247,6 +265,7 @@ no_platform_handler::no_platform_handler(const exception& other)
 	: exception("No platform handler installed.", other) {}
 
 exception* no_platform_handler::clone() const { return new no_platform_handler(*this); }
+void no_platform_handler::throwException() const { throw *this; }
 const char* no_platform_handler::name() const throw() { return "no_platform_handler"; }
 
 
@@ -259,6 +278,7 @@ no_expeditor::no_expeditor(const exception& other)
 	: exception("No expeditor specified.", other) {}
 
 exception* no_expeditor::clone() const { return new no_expeditor(*this); }
+void no_expeditor::throwException() const { throw *this; }
 const char* no_expeditor::name() const throw() { return "no_expeditor"; }
 
 
@@ -271,6 +291,7 @@ no_recipient::no_recipient(const exception& other)
 	: exception("No recipient specified.", other) {}
 
 exception* no_recipient::clone() const { return new no_recipient(*this); }
+void no_recipient::throwException() const { throw *this; }
 const char* no_recipient::name() const throw() { return "no_recipient"; }
 
 
@@ -283,6 +304,7 @@ no_object_found::no_object_found(const exception& other)
 	: exception("No object found.", other) {}
 
 exception* no_object_found::clone() const { return new no_object_found(*this); }
+void no_object_found::throwException() const { throw *this; }
 const char* no_object_found::name() const throw() { return "no_object_found"; }
 
 
@@ -295,6 +317,7 @@ no_such_property::no_such_property(const string& name, const exception& other)
 	: exception(std::string("No such property: '") + name + string("'."), other) { }
 
 exception* no_such_property::clone() const { return new no_such_property(*this); }
+void no_such_property::throwException() const { throw *this; }
 const char* no_such_property::name() const throw() { return "no_such_property"; }
 
 
@@ -307,6 +330,7 @@ invalid_property_type::invalid_property_type(const exception& other)
 	: exception("Invalid property type.", other) {}
 
 exception* invalid_property_type::clone() const { return new invalid_property_type(*this); }
+void invalid_property_type::throwException() const { throw *this; }
 const char* invalid_property_type::name() const throw() { return "invalid_property_type"; }
 
 
@@ -319,6 +343,7 @@ invalid_argument::invalid_argument(const exception& other)
 	: exception("Invalid argument.", other) {}
 
 exception* invalid_argument::clone() const { return new invalid_argument(*this); }
+void invalid_argument::throwException() const { throw *this; }
 const char* invalid_argument::name() const throw() { return "invalid_argument"; }
 
 
@@ -331,6 +356,7 @@ system_error::system_error(const string& what, const exception& other)
 	: exception(what, other) {}
 
 exception* system_error::clone() const { return new system_error(*this); }
+void system_error::throwException() const { throw *this; }
 const char* system_error::name() const throw() { return "system_error"; }
 
 
@@ -347,6 +373,7 @@ net_exception::net_exception(const string& what, const exception& other)
 	: exception(what, other) {}
 
 exception* net_exception::clone() const { return new net_exception(*this); }
+void net_exception::throwException() const { throw *this; }
 const char* net_exception::name() const throw() { return "net_exception"; }
 
 
@@ -360,6 +387,7 @@ socket_exception::socket_exception(const string& what, const exception& other)
 		? "Socket error." : what, other) {}
 
 exception* socket_exception::clone() const { return new socket_exception(*this); }
+void socket_exception::throwException() const { throw *this; }
 const char* socket_exception::name() const throw() { return "socket_exception"; }
 
 
@@ -373,6 +401,7 @@ connection_error::connection_error(const string& what, const exception& other)
 		? "Connection error." : what, other) {}
 
 exception* connection_error::clone() const { return new connection_error(*this); }
+void connection_error::throwException() const { throw *this; }
 const char* connection_error::name() const throw() { return "connection_error"; }
 
 
@@ -387,6 +416,7 @@ connection_greeting_error::connection_greeting_error(const string& response, con
 const string& connection_greeting_error::response() const { return (m_response); }
 
 exception* connection_greeting_error::clone() const { return new connection_greeting_error(*this); }
+void connection_greeting_error::throwException() const { throw *this; }
 const char* connection_greeting_error::name() const throw() { return "connection_greeting_error"; }
 
 
@@ -401,6 +431,7 @@ authentication_error::authentication_error(const string& response, const excepti
 const string& authentication_error::response() const { return (m_response); }
 
 exception* authentication_error::clone() const { return new authentication_error(*this); }
+void authentication_error::throwException() const { throw *this; }
 const char* authentication_error::name() const throw() { return "authentication_error"; }
 
 
@@ -413,6 +444,7 @@ unsupported_option::unsupported_option(const exception& other)
 	: net_exception("Unsupported option.", other) {}
 
 exception* unsupported_option::clone() const { return new unsupported_option(*this); }
+void unsupported_option::throwException() const { throw *this; }
 const char* unsupported_option::name() const throw() { return "unsupported_option"; }
 
 
@@ -427,6 +459,7 @@ no_service_available::no_service_available(const string& proto, const exception&
 		: "No service available for this protocol: '" + proto + "'.", other) {}
 
 exception* no_service_available::clone() const { return new no_service_available(*this); }
+void no_service_available::throwException() const { throw *this; }
 const char* no_service_available::name() const throw() { return "no_service_available"; }
 
 
@@ -439,6 +472,7 @@ illegal_state::illegal_state(const string& state, const exception& other)
 	: net_exception("Illegal state to accomplish the operation: '" + state + "'.", other) {}
 
 exception* illegal_state::clone() const { return new illegal_state(*this); }
+void illegal_state::throwException() const { throw *this; }
 const char* illegal_state::name() const throw() { return "illegal_state"; }
 
 
@@ -451,6 +485,7 @@ folder_not_found::folder_not_found(const exception& other)
 	: net_exception("Folder not found.", other) {}
 
 exception* folder_not_found::clone() const { return new folder_not_found(*this); }
+void folder_not_found::throwException() const { throw *this; }
 const char* folder_not_found::name() const throw() { return "folder_not_found"; }
 
 
@@ -463,6 +498,7 @@ message_not_found::message_not_found(const exception& other)
 	: net_exception("Message not found.", other) {}
 
 exception* message_not_found::clone() const { return new message_not_found(*this); }
+void message_not_found::throwException() const { throw *this; }
 const char* message_not_found::name() const throw() { return "message_not_found"; }
 
 
@@ -475,6 +511,7 @@ operation_not_supported::operation_not_supported(const exception& other)
 	: net_exception("Operation not supported.", other) {}
 
 exception* operation_not_supported::clone() const { return new operation_not_supported(*this); }
+void operation_not_supported::throwException() const { throw *this; }
 const char* operation_not_supported::name() const throw() { return "operation_not_supported"; }
 
 
@@ -487,6 +524,7 @@ operation_timed_out::operation_timed_out(const exception& other)
 	: net_exception("Operation timed out.", other) {}
 
 exception* operation_timed_out::clone() const { return new operation_timed_out(*this); }
+void operation_timed_out::throwException() const { throw *this; }
 const char* operation_timed_out::name() const throw() { return "operation_timed_out"; }
 
 
@@ -499,6 +537,7 @@ operation_cancelled::operation_cancelled(const exception& other)
 	: net_exception("Operation cancelled by the user.", other) {}
 
 exception* operation_cancelled::clone() const { return new operation_cancelled(*this); }
+void operation_cancelled::throwException() const { throw *this; }
 const char* operation_cancelled::name() const throw() { return "operation_cancelled"; }
 
 
@@ -511,6 +550,7 @@ unfetched_object::unfetched_object(const exception& other)
 	: net_exception("Object not fetched.", other) {}
 
 exception* unfetched_object::clone() const { return new unfetched_object(*this); }
+void unfetched_object::throwException() const { throw *this; }
 const char* unfetched_object::name() const throw() { return "unfetched_object"; }
 
 
@@ -523,6 +563,7 @@ not_connected::not_connected(const exception& other)
 	: net_exception("Not connected to a service.", other) {}
 
 exception* not_connected::clone() const { return new not_connected(*this); }
+void not_connected::throwException() const { throw *this; }
 const char* not_connected::name() const throw() { return "not_connected"; }
 
 
@@ -535,6 +576,7 @@ already_connected::already_connected(const exception& other)
 	: net_exception("Already connected to a service. Disconnect and retry.", other) {}
 
 exception* already_connected::clone() const { return new already_connected(*this); }
+void already_connected::throwException() const { throw *this; }
 const char* already_connected::name() const throw() { return "already_connected"; }
 
 
@@ -551,6 +593,7 @@ illegal_operation::illegal_operation(const string& msg, const exception& other)
 	) {}
 
 exception* illegal_operation::clone() const { return new illegal_operation(*this); }
+void illegal_operation::throwException() const { throw *this; }
 const char* illegal_operation::name() const throw() { return "illegal_operation"; }
 
 
@@ -573,6 +616,7 @@ const string& command_error::command() const { return (m_command); }
 const string& command_error::response() const { return (m_response); }
 
 exception* command_error::clone() const { return new command_error(*this); }
+void command_error::throwException() const { throw *this; }
 const char* command_error::name() const throw() { return "command_error"; }
 
 
@@ -594,6 +638,7 @@ const string& invalid_response::command() const { return (m_command); }
 const string& invalid_response::response() const { return (m_response); }
 
 exception* invalid_response::clone() const { return new invalid_response(*this); }
+void invalid_response::throwException() const { throw *this; }
 const char* invalid_response::name() const throw() { return "invalid_response"; }
 
 
@@ -606,6 +651,7 @@ partial_fetch_not_supported::partial_fetch_not_supported(const exception& other)
 	: net_exception("Partial fetch not supported.", other) {}
 
 exception* partial_fetch_not_supported::clone() const { return new partial_fetch_not_supported(*this); }
+void partial_fetch_not_supported::throwException() const { throw *this; }
 const char* partial_fetch_not_supported::name() const throw() { return "partial_fetch_not_supported"; }
 
 
@@ -618,6 +664,7 @@ malformed_url::malformed_url(const string& error, const exception& other)
 	: net_exception("Malformed URL: " + error + ".", other) {}
 
 exception* malformed_url::clone() const { return new malformed_url(*this); }
+void malformed_url::throwException() const { throw *this; }
 const char* malformed_url::name() const throw() { return "malformed_url"; }
 
 
@@ -633,6 +680,7 @@ invalid_folder_name::invalid_folder_name(const string& error, const exception& o
 		other) {}
 
 exception* invalid_folder_name::clone() const { return new invalid_folder_name(*this); }
+void invalid_folder_name::throwException() const { throw *this; }
 const char* invalid_folder_name::name() const throw() { return "invalid_folder_name"; }
 
 
@@ -653,6 +701,7 @@ filesystem_exception::filesystem_exception(const string& what, const utility::pa
 const utility::path& filesystem_exception::path() const { return (m_path); }
 
 exception* filesystem_exception::clone() const { return new filesystem_exception(*this); }
+void filesystem_exception::throwException() const { throw *this; }
 const char* filesystem_exception::name() const throw() { return "filesystem_exception"; }
 
 
@@ -665,6 +714,7 @@ not_a_directory::not_a_directory(const utility::path& path, const exception& oth
 	: filesystem_exception("Operation failed: this is not a directory.", path, other) {}
 
 exception* not_a_directory::clone() const { return new not_a_directory(*this); }
+void not_a_directory::throwException() const { throw *this; }
 const char* not_a_directory::name() const throw() { return "not_a_directory"; }
 
 
@@ -677,6 +727,7 @@ file_not_found::file_not_found(const utility::path& path, const exception& other
 	: filesystem_exception("File not found.", path, other) {}
 
 exception* file_not_found::clone() const { return new file_not_found(*this); }
+void file_not_found::throwException() const { throw *this; }
 const char* file_not_found::name() const throw() { return "file_not_found"; }
 
 
@@ -692,6 +743,7 @@ authentication_exception::authentication_exception(const string& what, const exc
 	: exception(what, other) {}
 
 exception* authentication_exception::clone() const { return new authentication_exception(*this); }
+void authentication_exception::throwException() const { throw *this; }
 const char* authentication_exception::name() const throw() { return "authentication_exception"; }
 
 
@@ -704,6 +756,7 @@ no_auth_information::no_auth_information(const exception& other)
 	: authentication_exception("Information cannot be provided.", other) {}
 
 exception* no_auth_information::clone() const { return new no_auth_information(*this); }
+void no_auth_information::throwException() const { throw *this; }
 const char* no_auth_information::name() const throw() { return "no_auth_information"; }
 
 
@@ -719,6 +772,7 @@ sasl_exception::sasl_exception(const string& what, const exception& other)
 	: authentication_exception(what, other) {}
 
 exception* sasl_exception::clone() const { return new sasl_exception(*this); }
+void sasl_exception::throwException() const { throw *this; }
 const char* sasl_exception::name() const throw() { return "sasl_exception"; }
 
 
@@ -731,6 +785,7 @@ no_such_mechanism::no_such_mechanism(const string& name, const exception& other)
 	: sasl_exception("No such SASL mechanism: '" + name + "'.", other) {}
 
 exception* no_such_mechanism::clone() const { return new no_such_mechanism(*this); }
+void no_such_mechanism::throwException() const { throw *this; }
 const char* no_such_mechanism::name() const throw() { return "no_such_mechanism"; }
 
 
@@ -749,6 +804,7 @@ tls_exception::tls_exception(const string& what, const exception& other)
 	: exception(what, other) {}
 
 exception* tls_exception::clone() const { return new tls_exception(*this); }
+void tls_exception::throwException() const { throw *this; }
 const char* tls_exception::name() const throw() { return "tls_exception"; }
 
 
@@ -761,6 +817,7 @@ certificate_exception::certificate_exception(const string& what, const exception
 	: tls_exception(what, other) {}
 
 exception* certificate_exception::clone() const { return new certificate_exception(*this); }
+void certificate_exception::throwException() const { throw *this; }
 const char* certificate_exception::name() const throw() { return "certificate_exception"; }
 
 
@@ -773,6 +830,7 @@ certificate_verification_exception::certificate_verification_exception(const str
 	: certificate_exception(what, other) {}
 
 exception* certificate_verification_exception::clone() const { return new certificate_verification_exception(*this); }
+void certificate_verification_exception::throwException() const { throw *this; }
 const char* certificate_verification_exception::name() const throw() { return "certificate_verification_exception"; }
 
 
@@ -785,6 +843,7 @@ unsupported_certificate_type::unsupported_certificate_type(const string& type, c
 	: certificate_exception("Unsupported certificate type: '" + type + "'", other) {}
 
 exception* unsupported_certificate_type::clone() const { return new unsupported_certificate_type(*this); }
+void unsupported_certificate_type::throwException() const { throw *this; }
 const char* unsupported_certificate_type::name() const throw() { return "unsupported_certificate_type"; }
 
 
@@ -28,11 +28,14 @@
 #include "vmime/exception.hpp"
 
 #include "vmime/streamContentHandler.hpp"
+#include "vmime/cachedContentHandler.hpp"
+#include "vmime/encodedContentCache.hpp"
 #include "vmime/utility/inputStreamPointerAdapter.hpp"
 
 #include "vmime/contentDispositionField.hpp"
 
 #include "vmime/platform.hpp"
+#include "vmime/dateTime.hpp"
 #include "vmime/utility/file.hpp"
 
 
@@ -130,8 +133,37 @@ void fileAttachment::setData(const string& filepath)
 
 	setData(is);
 
-	utility::file::path path = platform::getHandler()->getFileSystemFactory()->stringToPath(filepath);
+	ref <utility::fileSystemFactory> fsf = platform::getHandler()->getFileSystemFactory();
+
+	utility::file::path path = fsf->stringToPath(filepath);
 	m_fileInfo.setFilename(path.getLastComponent());
+
+	// Encode the file only once if it is attached to several messages
+	if (encodedContentCache::getInstance()->isEnabled())
+	{
+		try
+		{
+			ref <utility::file> file = fsf->create(path);
+
+			const datetime modified = file->getLastModificationDate();
+
+			// The modification date has a resolution of one second: a file
+			// modified during the current second may be modified again
+			// without changing the key, so it is not cached yet
+			if (modified < datetime(platform::getHandler()->getUnixTime()))
+			{
+				std::ostringstream key;
+				key << "file:" << filepath << ':' << file->getLength()
+				    << ':' << modified.generate();
+
+				m_data = vmime::create <cachedContentHandler>(m_data, key.str());
+			}
+		}
+		catch (exceptions::filesystem_exception&)
+		{
+			// Contents will not be cached
+		}
+	}
 }
 
 
@@ -347,6 +347,12 @@ const std::vector <ref <component> > header::getChildComponents()
 }
 
 
+bool header::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_fields, v);
+}
+
+
 
 // Field search
 
@@ -75,6 +75,37 @@ headerField& headerField::operator=(const headerField& other)
 
 ref <headerField> headerField::parseNext(const string& buffer, const string::size_type position,
 	const string::size_type end, string::size_type* newPosition)
+{
+	string::size_type nameStart, nameEnd, contentsStart, contentsEnd, pos;
+
+	if (!findNext(buffer, position, end, &nameStart, &nameEnd, &contentsStart, &contentsEnd, &pos))
+	{
+		if (newPosition)
+			*newPosition = pos;
+
+		return NULL;
+	}
+
+	// Extract the field name
+	const string name(buffer.begin() + nameStart,
+	                  buffer.begin() + nameEnd);
+
+	// Return a new field
+	ref <headerField> field = headerFieldFactory::getInstance()->create(name);
+
+	field->parse(buffer, contentsStart, contentsEnd, NULL);
+	field->setParsedBounds(nameStart, pos);
+
+	if (newPosition)
+		*newPosition = pos;
+
+	return (field);
+}
+
+
+bool headerField::findNext(const string& buffer, const string::size_type position,
+	const string::size_type end, string::size_type* nameStart, string::size_type* nameEnd,
+	string::size_type* valueStart, string::size_type* valueEnd, string::size_type* newPosition)
 {
 	string::size_type pos = position;
 
@@ -87,37 +118,32 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 		// also check for LF for compatibility with broken implementations...
 		if (c == '\n')
 		{
-			if (newPosition)
-				*newPosition = pos + 1;   // LF: illegal
-
-			return (NULL);
+			*newPosition = pos + 1;   // LF: illegal
+			return false;
 		}
 		else if (c == '\r' && pos + 1 < end && buffer[pos + 1] == '\n')
 		{
-			if (newPosition)
-				*newPosition = pos + 2;   // CR+LF
-
-			return (NULL);
+			*newPosition = pos + 2;   // CR+LF
+			return false;
 		}
 
 		// This line may be a field description
 		if (!parserHelpers::isSpace(c))
 		{
-			const string::size_type nameStart = pos;  // remember the start position of the line
+			const string::size_type lineStart = pos;  // remember the start position of the line
 
-			while (pos < end && (buffer[pos] != ':' && !parserHelpers::isSpace(buffer[pos])))
-				++pos;
+			pos = parserHelpers::findFirstOf
+				<parserHelpers::CHAR_CLASS_COLON | parserHelpers::CHAR_CLASS_SPACE>(buffer, pos, end);
 
-			const string::size_type nameEnd = pos;
+			const string::size_type lineNameEnd = pos;
 
-			while (pos < end && (buffer[pos] == ' ' || buffer[pos] == '\t'))
-				++pos;
+			pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_BLANK>(buffer, pos, end);
 
 			if (buffer[pos] != ':')
 			{
 				// Humm...does not seem to be a valid header line.
 				// Skip this error and advance to the next line
-				pos = nameStart;
+				pos = lineStart;
 
 				while (pos < end && buffer[pos] != '\n')
 					++pos;
@@ -127,16 +153,11 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 			}
 			else
 			{
-				// Extract the field name
-				const string name(buffer.begin() + nameStart,
-				                  buffer.begin() + nameEnd);
-
 				// Skip ':' character
 				++pos;
 
 				// Skip spaces between ':' and the field contents
-				while (pos < end && (buffer[pos] == ' ' || buffer[pos] == '\t'))
-					++pos;
+				pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_BLANK>(buffer, pos, end);
 
 				const string::size_type contentsStart = pos;
 				string::size_type contentsEnd = 0;
@@ -166,25 +187,23 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 						break;
 					}
 
-					while (pos < end)
+					for (pos = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_EOL>(buffer, pos, end) ;
+					     pos < end ;
+					     pos = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_EOL>(buffer, pos + 1, end))
 					{
-						c = buffer[pos];
-
 						// Check for end of line
-						if (c == '\r' && pos + 1 < end && buffer[pos + 1] == '\n')
+						if (buffer[pos] == '\n')
 						{
 							contentsEnd = pos;
-							pos += 2;
+							++pos;
 							break;
 						}
-						else if (c == '\n')
+						else if (pos + 1 < end && buffer[pos + 1] == '\n')
 						{
 							contentsEnd = pos;
-							++pos;
+							pos += 2;
 							break;
 						}
-
-						++pos;
 					}
 
 					// Handle the case of folded lines
@@ -196,8 +215,7 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 						// If the line contains only space characters, we assume it is
 						// the end of the headers. This is not strictly standard-compliant
 						// but, hey, we can't fail when parsing some malformed mails...
-						while (pos < end && (buffer[pos] == ' ' || buffer[pos] == '\t'))
-							++pos;
+						pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_BLANK>(buffer, pos, end);
 
 						if ((pos < end && buffer[pos] == '\n') ||
 						    (pos + 1 < end && buffer[pos] == '\r' && buffer[pos + 1] == '\n'))
@@ -212,38 +230,30 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 					}
 				}
 
-				// Return a new field
-				ref <headerField> field = headerFieldFactory::getInstance()->create(name);
+				*nameStart = lineStart;
+				*nameEnd = lineNameEnd;
+				*valueStart = contentsStart;
+				*valueEnd = contentsEnd;
+				*newPosition = pos;
 
-				field->parse(buffer, contentsStart, contentsEnd, NULL);
-				field->setParsedBounds(nameStart, pos);
-
-				if (newPosition)
-					*newPosition = pos;
-
-				return (field);
+				return true;
 			}
 		}
 		else
 		{
 			// If the line contains only space characters, we assume it is
 			// the end of the headers.
-			while (pos < end && (buffer[pos] == ' ' || buffer[pos] == '\t'))
-				++pos;
+			pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_BLANK>(buffer, pos, end);
 
 			if (pos < end && buffer[pos] == '\n')
 			{
-				if (newPosition)
-					*newPosition = pos + 1;   // LF: illegal
-
-				return NULL;
+				*newPosition = pos + 1;   // LF: illegal
+				return false;
 			}
 			else if (pos + 1 < end && buffer[pos] == '\r' && buffer[pos + 1] == '\n')
 			{
-				if (newPosition)
-					*newPosition = pos + 2;   // CR+LF
-
-				return NULL;
+				*newPosition = pos + 2;   // CR+LF
+				return false;
 			}
 
 			// Skip this error and advance to the next line
@@ -255,10 +265,8 @@ ref <headerField> headerField::parseNext(const string& buffer, const string::siz
 		}
 	}
 
-	if (newPosition)
-		*newPosition = pos;
-
-	return (NULL);
+	*newPosition = pos;
+	return false;
 }
 
 
@@ -307,6 +315,12 @@ const std::vector <ref <component> > headerField::getChildComponents()
 }
 
 
+bool headerField::visitChildComponentsImpl(childVisitor& v)
+{
+	return (!m_value || v.visit(*m_value));
+}
+
+
 ref <const headerFieldValue> headerField::getValue() const
 {
 	return m_value;
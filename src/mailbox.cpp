@@ -73,7 +73,7 @@ void mailbox::parseImpl(const string& buffer, const string::size_type position,
 	const string::value_type* p = pstart;
 
 	// Ignore blank spaces at the beginning
-	while (p < pend && parserHelpers::isSpace(*p)) ++p;
+	p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 	// Current state for parsing machine
 	enum States
@@ -237,7 +237,7 @@ void mailbox::parseImpl(const string& buffer, const string::size_type position,
 			}
 			else
 			{
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 				state = State_None;
 			}
 		}
@@ -299,7 +299,7 @@ void mailbox::parseImpl(const string& buffer, const string::size_type position,
 		}
 		else
 		{
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 			if (p < pend)
 			{
@@ -520,4 +520,10 @@ const std::vector <ref <component> > mailbox::getChildComponents()
 }
 
 
+bool mailbox::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
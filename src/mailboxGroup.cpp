@@ -359,4 +359,10 @@ const std::vector <ref <component> > mailboxGroup::getChildComponents()
 }
 
 
+bool mailboxGroup::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_list, v);
+}
+
+
 } // vmime
@@ -196,6 +196,12 @@ const std::vector <ref <component> > mailboxList::getChildComponents()
 }
 
 
+bool mailboxList::visitChildComponentsImpl(childVisitor& v)
+{
+	return m_list.visitChildComponents(v);
+}
+
+
 void mailboxList::parseImpl(const string& buffer, const string::size_type position,
 	const string::size_type end, string::size_type* newPosition)
 {
@@ -182,4 +182,10 @@ const std::vector <ref <component> > mediaType::getChildComponents()
 }
 
 
+bool mediaType::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
@@ -294,4 +294,10 @@ const std::vector <ref <component> > messageId::getChildComponents()
 }
 
 
+bool messageId::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
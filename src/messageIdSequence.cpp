@@ -84,6 +84,12 @@ const std::vector <ref <component> > messageIdSequence::getChildComponents()
 }
 
 
+bool messageIdSequence::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_list, v);
+}
+
+
 void messageIdSequence::parseImpl(const string& buffer, const string::size_type position,
 	const string::size_type end, string::size_type* newPosition)
 {
@@ -0,0 +1,465 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/messageTemplate.hpp"
+
+#include "vmime/headerField.hpp"
+#include "vmime/stringContentHandler.hpp"
+#include "vmime/exception.hpp"
+#include "vmime/parserHelpers.hpp"
+
+#include "vmime/utility/random.hpp"
+#include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+
+#include <algorithm>
+
+
+namespace vmime
+{
+
+
+/** Header field value which generates the marker of a hole.
+  */
+
+class messageTemplate::fieldMarker : public headerFieldValue
+{
+public:
+
+	fieldMarker(const string& marker)
+		: m_marker(marker)
+	{
+	}
+
+	ref <component> clone() const
+	{
+		return vmime::create <fieldMarker>(m_marker);
+	}
+
+	void copyFrom(const component& other)
+	{
+		m_marker = dynamic_cast <const fieldMarker&>(other).m_marker;
+	}
+
+	const std::vector <ref <component> > getChildComponents()
+	{
+		return std::vector <ref <component> >();
+	}
+
+protected:
+
+	void parseImpl(const string& /* buffer */, const string::size_type /* position */,
+		const string::size_type end, string::size_type* newPosition)
+	{
+		if (newPosition)
+			*newPosition = end;
+	}
+
+	void generateImpl(utility::outputStream& os, const string::size_type /* maxLineLength */,
+		const string::size_type curLinePos, string::size_type* newLinePos) const
+	{
+		os << m_marker;
+
+		if (newLinePos)
+			*newLinePos = curLinePos + m_marker.length();
+	}
+
+private:
+
+	string m_marker;
+};
+
+
+/** Content handler which generates the marker of a hole.
+  */
+
+class messageTemplate::textMarker : public contentHandler
+{
+public:
+
+	textMarker(const string& marker)
+		: m_marker(marker)
+	{
+	}
+
+	ref <contentHandler> clone() const
+	{
+		return vmime::create <textMarker>(m_marker);
+	}
+
+	void generate(utility::outputStream& os, const vmime::encoding& /* enc */,
+		const string::size_type /* maxLineLength */) const
+	{
+		os << m_marker;
+	}
+
+	void extract(utility::outputStream& /* os */, utility::progressListener* /* progress */) const
+	{
+	}
+
+	void extractRaw(utility::outputStream& /* os */, utility::progressListener* /* progress */) const
+	{
+	}
+
+	string::size_type getLength() const
+	{
+		return 0;
+	}
+
+	bool isEncoded() const
+	{
+		return false;
+	}
+
+	const vmime::encoding& getEncoding() const
+	{
+		return NO_ENCODING;
+	}
+
+	bool isEmpty() const
+	{
+		return false;
+	}
+
+	bool isBuffered() const
+	{
+		return true;
+	}
+
+private:
+
+	string m_marker;
+};
+
+
+
+//
+// messageTemplate::values
+//
+
+void messageTemplate::values::setField(const string& name, ref <const headerFieldValue> value)
+{
+	m_fields[utility::stringUtils::toLower(name)] = value;
+}
+
+
+ref <const headerFieldValue> messageTemplate::values::getField(const string& name) const
+{
+	std::map <string, ref <const headerFieldValue> >::const_iterator
+		it = m_fields.find(utility::stringUtils::toLower(name));
+
+	if (it == m_fields.end())
+		return NULL;
+
+	return (*it).second;
+}
+
+
+void messageTemplate::values::setVariable(const string& name, const string& value)
+{
+	m_variables[name] = value;
+}
+
+
+const string messageTemplate::values::getVariable(const string& name) const
+{
+	std::map <string, string>::const_iterator it = m_variables.find(name);
+
+	if (it == m_variables.end())
+		return "";
+
+	return (*it).second;
+}
+
+
+void messageTemplate::values::clear()
+{
+	m_fields.clear();
+	m_variables.clear();
+}
+
+
+
+//
+// messageTemplate
+//
+
+messageTemplate::messageTemplate(ref <const message> msg, const std::vector <string>& fieldNames,
+	const string::size_type maxLineLength)
+	: m_maxLineLength(maxLineLength)
+{
+	// Markers are random strings: in the very unlikely event that one
+	// of them also appears in the message, try again with other markers
+	for (int attempt = 0 ; attempt < 8 ; ++attempt)
+	{
+		if (compile(msg, fieldNames))
+			return;
+	}
+
+	throw exceptions::invalid_argument();
+}
+
+
+messageTemplate::~messageTemplate()
+{
+}
+
+
+bool messageTemplate::compile(ref <const message> msg, const std::vector <string>& fieldNames)
+{
+	const string markerPrefix = "vmime-hole-" + utility::random::getString(24) + "-";
+
+	// message does not override clone(): the copy is a bodyPart
+	ref <bodyPart> copy = msg->clone().dynamicCast <bodyPart>();
+
+	m_holes.clear();
+	m_segments.clear();
+
+	// Replace the values of the header field holes with markers
+	std::vector <string> names;
+
+	for (std::vector <string>::size_type i = 0 ; i < fieldNames.size() ; ++i)
+	{
+		const string name = utility::stringUtils::toLower(fieldNames[i]);
+
+		if (std::find(names.begin(), names.end(), name) != names.end())
+			continue;
+
+		names.push_back(name);
+
+		ref <headerField> field = copy->getHeader()->getField(fieldNames[i]);
+
+		hole h;
+		h.type = hole::TYPE_FIELD;
+		h.fieldName = field->getName();
+
+		utility::outputStreamStringAdapter valueStream(h.defaultValue);
+		field->getValue()->generate(valueStream, m_maxLineLength, h.fieldName.length() + 2);
+
+		field->setValue(vmime::create <fieldMarker>
+			(markerPrefix + utility::stringUtils::toString(m_holes.size()) + "-"));
+
+		m_holes.push_back(h);
+	}
+
+	// Replace the contents of text parts which contain placeholders with markers
+	compileTextParts(copy, markerPrefix);
+
+	// Generate the message and split it at the markers
+	string data;
+	utility::outputStreamStringAdapter dataStream(data);
+
+	copy->generate(dataStream, m_maxLineLength);
+
+	std::vector <hole> holes;
+	std::vector <bool> found(m_holes.size(), false);
+
+	string::size_type pos = 0;
+	string::size_type markerPos;
+
+	while ((markerPos = data.find(markerPrefix, pos)) != string::npos)
+	{
+		string::size_type p = markerPos + markerPrefix.length();
+		std::vector <hole>::size_type index = 0;
+
+		if (p >= data.length() || !parserHelpers::isDigit(data[p]))
+			return false;
+
+		for ( ; p < data.length() && parserHelpers::isDigit(data[p]) ; ++p)
+			index = index * 10 + (data[p] - '0');
+
+		if (p >= data.length() || data[p] != '-' || index >= m_holes.size() || found[index])
+			return false;
+
+		found[index] = true;
+
+		m_segments.push_back(string(data.begin() + pos, data.begin() + markerPos));
+		holes.push_back(m_holes[index]);
+
+		pos = p + 1;
+	}
+
+	if (holes.size() != m_holes.size())
+		return false;
+
+	m_segments.push_back(string(data.begin() + pos, data.end()));
+	m_holes.swap(holes);
+
+	return true;
+}
+
+
+void messageTemplate::compileTextParts(ref <bodyPart> part, const string& markerPrefix)
+{
+	ref <body> bdy = part->getBody();
+
+	if (bdy->getPartCount() != 0)
+	{
+		for (int i = 0 ; i < bdy->getPartCount() ; ++i)
+			compileTextParts(bdy->getPartAt(i), markerPrefix);
+
+		return;
+	}
+
+	if (bdy->getContentType().getType() != mediaTypes::TEXT)
+		return;
+
+	string text;
+	utility::outputStreamStringAdapter textStream(text);
+
+	bdy->getContents()->extract(textStream);
+
+	hole h;
+	h.type = hole::TYPE_TEXT;
+
+	if (!splitText(text, h))
+		return;
+
+	h.enc = bdy->getEncoding();
+
+	bdy->setContents(vmime::create <textMarker>
+		(markerPrefix + utility::stringUtils::toString(m_holes.size()) + "-"));
+
+	m_holes.push_back(h);
+}
+
+
+// static
+bool messageTemplate::splitText(const string& text, hole& h)
+{
+	string::size_type pos = 0;
+	string::size_type literalStart = 0;
+
+	while ((pos = text.find("${", pos)) != string::npos)
+	{
+		string::size_type end = pos + 2;
+
+		while (end < text.length() && (parserHelpers::isAlpha(text[end]) || parserHelpers::isDigit(text[end]) ||
+		       text[end] == '_' || text[end] == '-' || text[end] == '.'))
+		{
+			++end;
+		}
+
+		if (end == pos + 2 || end >= text.length() || text[end] != '}')
+		{
+			// Not a placeholder
+			pos += 2;
+			continue;
+		}
+
+		h.literals.push_back(string(text.begin() + literalStart, text.begin() + pos));
+		h.variables.push_back(string(text.begin() + pos + 2, text.begin() + end));
+
+		pos = literalStart = end + 1;
+	}
+
+	if (h.variables.empty())
+		return false;
+
+	h.literals.push_back(string(text.begin() + literalStart, text.end()));
+
+	return true;
+}
+
+
+void messageTemplate::generate(utility::outputStream& os, const values& vals) const
+{
+	for (std::vector <hole>::size_type i = 0 ; i < m_holes.size() ; ++i)
+	{
+		os.write(m_segments[i].data(), m_segments[i].length());
+		generateHole(os, m_holes[i], vals);
+	}
+
+	os.write(m_segments.back().data(), m_segments.back().length());
+}
+
+
+const string messageTemplate::generate(const values& vals) const
+{
+	string data;
+	data.reserve(getStaticSize());
+
+	utility::outputStreamStringAdapter os(data);
+	generate(os, vals);
+
+	return data;
+}
+
+
+void messageTemplate::generateHole(utility::outputStream& os, const hole& h, const values& vals) const
+{
+	if (h.type == hole::TYPE_FIELD)
+	{
+		ref <const headerFieldValue> value = vals.getField(h.fieldName);
+
+		if (value)
+			value->generate(os, m_maxLineLength, h.fieldName.length() + 2);
+		else
+			os.write(h.defaultValue.data(), h.defaultValue.length());
+	}
+	else // hole::TYPE_TEXT
+	{
+		string text = h.literals[0];
+
+		for (std::vector <string>::size_type i = 0 ; i < h.variables.size() ; ++i)
+		{
+			text += vals.getVariable(h.variables[i]);
+			text += h.literals[i + 1];
+		}
+
+		stringContentHandler(text).generate(os, h.enc, m_maxLineLength);
+	}
+}
+
+
+const std::vector <string> messageTemplate::getVariableNames() const
+{
+	std::vector <string> names;
+
+	for (std::vector <hole>::size_type i = 0 ; i < m_holes.size() ; ++i)
+	{
+		const hole& h = m_holes[i];
+
+		for (std::vector <string>::size_type j = 0 ; j < h.variables.size() ; ++j)
+		{
+			if (std::find(names.begin(), names.end(), h.variables[j]) == names.end())
+				names.push_back(h.variables[j]);
+		}
+	}
+
+	return names;
+}
+
+
+string::size_type messageTemplate::getStaticSize() const
+{
+	string::size_type size = 0;
+
+	for (std::vector <string>::size_type i = 0 ; i < m_segments.size() ; ++i)
+		size += m_segments[i].length();
+
+	return size;
+}
+
+
+} // vmime
@@ -0,0 +1,348 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/mimeEventParser.hpp"
+
+#include "vmime/body.hpp"
+#include "vmime/headerField.hpp"
+#include "vmime/headerFieldFactory.hpp"
+#include "vmime/contentTypeField.hpp"
+#include "vmime/exception.hpp"
+
+#include "vmime/utility/encoder/encoderFactory.hpp"
+#include "vmime/utility/inputStreamStringAdapter.hpp"
+#include "vmime/utility/seekableInputStreamRegionAdapter.hpp"
+#include "vmime/utility/streamUtils.hpp"
+#include "vmime/utility/stringUtils.hpp"
+
+#include <algorithm>
+
+
+namespace vmime
+{
+
+
+/** Forwards decoded contents to the handler.
+  */
+class mimeEventParser::chunkOutputStream : public utility::outputStream
+{
+public:
+
+	chunkOutputStream(handler& h)
+		: m_handler(h)
+	{
+	}
+
+	void write(const value_type* const data, const size_type count)
+	{
+		if (count != 0)
+			m_handler.onBodyChunk(data, count);
+	}
+
+	void flush()
+	{
+		// Nothing to do
+	}
+
+private:
+
+	handler& m_handler;
+};
+
+
+
+mimeEventParser::mimeEventParser()
+{
+}
+
+
+void mimeEventParser::parse(const string& buffer, handler& h)
+{
+	ref <utility::seekableInputStream> is =
+		vmime::create <utility::inputStreamStringAdapter>(buffer);
+
+	parse(is, buffer.length(), h);
+}
+
+
+void mimeEventParser::parse(ref <utility::seekableInputStream> is,
+	const utility::stream::size_type length, handler& h)
+{
+	ref <utility::parserInputStreamAdapter> parser =
+		vmime::create <utility::parserInputStreamAdapter>(is);
+
+	parsePart(parser, 0, length, 0, h);
+}
+
+
+void mimeEventParser::parsePart
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end,
+	 const int depth, handler& h)
+{
+	h.onPartBegin(depth);
+
+	// Parse the header fields in place if the stream is held in
+	// memory, else read the header into a buffer
+	utility::stream::size_type offset = 0, length = 0;
+	const string* buffer = parser->getBuffer(offset, length);
+
+	string::size_type bufferStart, bufferEnd;
+
+	if (buffer != NULL)
+	{
+		bufferEnd = offset + std::min(end, length);
+		bufferStart = std::min(offset + position, bufferEnd);
+	}
+	else
+	{
+		readHeader(parser, position, end);
+
+		buffer = &m_headerBuffer;
+		bufferStart = 0;
+		bufferEnd = m_headerBuffer.length();
+	}
+
+	// Only the first occurrence of Content-Type and Content-Transfer-Encoding
+	// fields is taken into account (see header::findField())
+	bool hasContentType = false;
+	bool hasEncoding = false;
+
+	bool isMultipart = false;
+	string boundary;
+
+	// Defaults to "7bit" (RFC-1521)
+	encoding enc(encodingTypes::SEVEN_BIT);
+
+	const char* data = buffer->data();
+
+	string::size_type pos = bufferStart;
+	string::size_type nameStart, nameEnd, valueStart, valueEnd;
+
+	while (headerField::findNext(*buffer, pos, bufferEnd,
+		&nameStart, &nameEnd, &valueStart, &valueEnd, &pos))
+	{
+		h.onHeaderField(data + nameStart, nameEnd - nameStart,
+			data + valueStart, valueEnd - valueStart);
+
+		if (!hasContentType &&
+		    nameEnd - nameStart == 12 &&
+		    utility::stringUtils::isStringEqualNoCase
+				(buffer->begin() + nameStart, buffer->begin() + nameEnd, "content-type", 12))
+		{
+			hasContentType = true;
+
+			// Parse the media type only (see parameterizedHeaderField::parseImpl()),
+			// and the parameters if this is a multipart
+			string::size_type typeEnd = valueStart;
+
+			while (typeEnd < valueEnd && data[typeEnd] != ';')
+				++typeEnd;
+
+			m_type.parse(*buffer, valueStart, typeEnd);
+
+			if (m_type.getType() == mediaTypes::MULTIPART)
+			{
+				isMultipart = true;
+
+				ref <contentTypeField> ctf = headerFieldFactory::getInstance()->
+					create(fields::CONTENT_TYPE).dynamicCast <contentTypeField>();
+
+				ctf->parse(*buffer, valueStart, valueEnd);
+
+				try
+				{
+					boundary = ctf->getBoundary();
+				}
+				catch (exceptions::no_such_parameter&)
+				{
+					// Will be guessed from the contents
+				}
+			}
+		}
+		else if (!hasEncoding &&
+		         nameEnd - nameStart == 25 &&
+		         utility::stringUtils::isStringEqualNoCase
+					(buffer->begin() + nameStart, buffer->begin() + nameEnd,
+					 "content-transfer-encoding", 25))
+		{
+			hasEncoding = true;
+
+			enc.parse(*buffer, valueStart, valueEnd);
+		}
+	}
+
+	const utility::stream::size_type bodyStart = position + (pos - bufferStart);
+
+	if (isMultipart && boundary.empty() && bodyStart != end)
+		boundary = body::guessBoundary(parser, bodyStart, end);
+
+	if (isMultipart && !boundary.empty())
+		parseMultipart(parser, boundary, bodyStart, end, depth, h);
+	else
+		parseContents(parser, enc, bodyStart, end, h);
+
+	h.onPartEnd();
+}
+
+
+void mimeEventParser::parseMultipart
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const string& boundary,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end,
+	 const int depth, handler& h)
+{
+	// Same as body::parseImpl(), except that prolog and epilog are ignored
+	const string boundarySep("--" + boundary);
+
+	utility::stream::size_type partStart = position;
+	utility::stream::size_type pos = body::findNextBoundary(parser, boundarySep, position, end);
+
+	bool lastPart = false;
+
+	for (int index = 0 ; !lastPart && (pos != utility::stream::npos) && (pos < end) ; ++index)
+	{
+		utility::stream::size_type partEnd = 0;
+		pos = body::skipBoundary(parser, boundarySep, position, pos, end, &partEnd, &lastPart);
+
+		if (index > 0)
+		{
+			// End before start may happen on empty bodyparts (directly
+			// successive boundaries without even a line-break)
+			if (partEnd < partStart)
+				std::swap(partStart, partEnd);
+
+			parsePart(parser, partStart, partEnd, depth + 1, h);
+		}
+
+		partStart = pos;
+
+		pos = body::findNextBoundary(parser, boundarySep, pos, end);
+	}
+
+	// Last part was not found: recover from missing boundary
+	if (!lastPart && pos == utility::stream::npos)
+		parsePart(parser, partStart, end, depth + 1, h);
+}
+
+
+void mimeEventParser::parseContents
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const encoding& enc,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end,
+	 handler& h)
+{
+	if (position >= end)
+		return;
+
+	const utility::encoder::encoderFactory::Encoding encType =
+		utility::encoder::encoderFactory::getEncodingByName(enc.getName());
+
+	const bool isIdentity =
+		(encType == utility::encoder::encoderFactory::ENCODING_7BIT ||
+		 encType == utility::encoder::encoderFactory::ENCODING_8BIT ||
+		 encType == utility::encoder::encoderFactory::ENCODING_BINARY);
+
+	// Contents need not be decoded: give them as is
+	if (isIdentity)
+	{
+		utility::stream::size_type offset = 0, length = 0;
+		const string* buffer = parser->getBuffer(offset, length);
+
+		if (buffer != NULL)
+		{
+			const utility::stream::size_type chunkEnd = std::min(end, length);
+			const utility::stream::size_type chunkStart = std::min(position, chunkEnd);
+
+			h.onBodyChunk(buffer->data() + offset + chunkStart, chunkEnd - chunkStart);
+			return;
+		}
+	}
+
+	utility::seekableInputStreamRegionAdapter in
+		(parser->getUnderlyingStream(), position, end - position);
+
+	in.reset();
+
+	chunkOutputStream out(h);
+
+	try
+	{
+		if (isIdentity)
+			utility::bufferedStreamCopy(in, out);
+		else
+			enc.decode(in, out);
+	}
+	catch (exceptions::no_encoder_available&)
+	{
+		// Unknown encoding: give the contents as is
+		in.reset();
+		utility::bufferedStreamCopy(in, out);
+	}
+}
+
+
+void mimeEventParser::readHeader
+	(ref <utility::parserInputStreamAdapter> parser,
+	 const utility::stream::size_type position,
+	 const utility::stream::size_type end)
+{
+	// Read up to the first empty line: header::parseImpl() may stop
+	// earlier (on a line made of white-spaces), but never later
+	m_headerBuffer.clear();
+
+	parser->seek(position);
+
+	utility::stream::size_type pos = position;
+
+	while (pos < end)
+	{
+		utility::stream::value_type chunk[4096];
+
+		const utility::stream::size_type n =
+			parser->read(chunk, std::min(end - pos, static_cast <utility::stream::size_type>(sizeof(chunk))));
+
+		if (n == 0)
+			break;
+
+		const string::size_type searchStart =
+			(m_headerBuffer.length() >= 2 ? m_headerBuffer.length() - 2 : 0);
+
+		m_headerBuffer.append(chunk, n);
+		pos += n;
+
+		if (m_headerBuffer[0] == '\n' ||
+		    (m_headerBuffer.length() >= 2 && m_headerBuffer[0] == '\r' && m_headerBuffer[1] == '\n') ||
+		    m_headerBuffer.find("\n\n", searchStart) != string::npos ||
+		    m_headerBuffer.find("\n\r\n", searchStart) != string::npos)
+		{
+			break;
+		}
+	}
+}
+
+
+} // vmime
@@ -0,0 +1,514 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/nativeCharsetConverter.hpp"
+
+#include "vmime/utility/stringUtils.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
+
+namespace vmime
+{
+
+
+namespace
+{
+	struct NativeCharsetAlias
+	{
+		const char* name;
+		nativeCharsetConverter::NativeCharset id;
+	};
+
+	const NativeCharsetAlias NATIVE_CHARSET_ALIASES[] =
+	{
+		{ "us-ascii",        nativeCharsetConverter::NATIVE_US_ASCII },
+		{ "ascii",           nativeCharsetConverter::NATIVE_US_ASCII },
+		{ "ansi_x3.4-1968",  nativeCharsetConverter::NATIVE_US_ASCII },
+		{ "iso646-us",       nativeCharsetConverter::NATIVE_US_ASCII },
+		{ "utf-8",           nativeCharsetConverter::NATIVE_UTF_8 },
+		{ "utf8",            nativeCharsetConverter::NATIVE_UTF_8 },
+		{ "iso-8859-1",      nativeCharsetConverter::NATIVE_ISO_8859_1 },
+		{ "iso8859-1",       nativeCharsetConverter::NATIVE_ISO_8859_1 },
+		{ "iso_8859-1",      nativeCharsetConverter::NATIVE_ISO_8859_1 },
+		{ "latin1",          nativeCharsetConverter::NATIVE_ISO_8859_1 },
+		{ "l1",              nativeCharsetConverter::NATIVE_ISO_8859_1 },
+		{ "iso-8859-15",     nativeCharsetConverter::NATIVE_ISO_8859_15 },
+		{ "iso8859-15",      nativeCharsetConverter::NATIVE_ISO_8859_15 },
+		{ "iso_8859-15",     nativeCharsetConverter::NATIVE_ISO_8859_15 },
+		{ "latin-9",         nativeCharsetConverter::NATIVE_ISO_8859_15 },
+		{ "latin9",          nativeCharsetConverter::NATIVE_ISO_8859_15 }
+	};
+
+
+	// Characters of ISO-8859-15 which differ from ISO-8859-1
+	struct Latin9Entry
+	{
+		unsigned char byte;
+		unsigned int codePoint;
+	};
+
+	const Latin9Entry LATIN9_ENTRIES[] =
+	{
+		{ 0xa4, 0x20ac }, { 0xa6, 0x0160 }, { 0xa8, 0x0161 }, { 0xb4, 0x017d },
+		{ 0xb8, 0x017e }, { 0xbc, 0x0152 }, { 0xbd, 0x0153 }, { 0xbe, 0x0178 }
+	};
+
+	const unsigned int LATIN9_ENTRY_COUNT = sizeof(LATIN9_ENTRIES) / sizeof(LATIN9_ENTRIES[0]);
+
+
+	unsigned int latin9ToUnicode(const unsigned char c)
+	{
+		for (unsigned int i = 0 ; i < LATIN9_ENTRY_COUNT ; ++i)
+		{
+			if (LATIN9_ENTRIES[i].byte == c)
+				return LATIN9_ENTRIES[i].codePoint;
+		}
+
+		return c;
+	}
+
+
+	// Return -1 if the code point has no equivalent in ISO-8859-15
+	int unicodeToLatin9(const unsigned int codePoint)
+	{
+		for (unsigned int i = 0 ; i < LATIN9_ENTRY_COUNT ; ++i)
+		{
+			if (LATIN9_ENTRIES[i].codePoint == codePoint)
+				return LATIN9_ENTRIES[i].byte;
+			else if (LATIN9_ENTRIES[i].byte == codePoint)
+				return -1;
+		}
+
+		return (codePoint < 0x100) ? static_cast <int>(codePoint) : -1;
+	}
+
+
+	// Return the number of US-ASCII bytes at the beginning of a buffer
+	string::size_type asciiRunLength(const unsigned char* data, const string::size_type count)
+	{
+		string::size_type i = 0;
+
+#if defined(__SSE2__)
+
+		for ( ; i + 16 <= count ; i += 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast <const __m128i*>(data + i));
+			const int mask = _mm_movemask_epi8(chunk);
+
+			if (mask != 0)
+				return i + __builtin_ctz(static_cast <unsigned int>(mask));
+		}
+
+#else
+
+		for ( ; i + 4 <= count ; i += 4)
+		{
+			vmime_uint32 word;
+			std::memcpy(&word, data + i, 4);
+
+			if ((word & 0x80808080) != 0)
+				break;
+		}
+
+#endif
+
+		while (i < count && data[i] < 0x80)
+			++i;
+
+		return i;
+	}
+
+
+	// Result of decoding a UTF-8 sequence
+	enum UTF8DecodeResult
+	{
+		UTF8_VALID,
+		UTF8_INVALID,
+		UTF8_INCOMPLETE
+	};
+
+
+	UTF8DecodeResult decodeUTF8(const unsigned char* data, const string::size_type count,
+		unsigned int* codePoint, string::size_type* length)
+	{
+		const unsigned char lead = data[0];
+
+		// Allowed range for the second byte (excludes overlong forms,
+		// surrogates and code points above U+10FFFF)
+		unsigned char low = 0x80;
+		unsigned char high = 0xbf;
+
+		string::size_type len = 0;
+		unsigned int cp = 0;
+
+		if (lead < 0x80)
+		{
+			len = 1;
+			cp = lead;
+		}
+		else if (lead < 0xc2)
+		{
+			return UTF8_INVALID;
+		}
+		else if (lead < 0xe0)
+		{
+			len = 2;
+			cp = lead & 0x1f;
+		}
+		else if (lead < 0xf0)
+		{
+			len = 3;
+			cp = lead & 0x0f;
+
+			if (lead == 0xe0)
+				low = 0xa0;
+			else if (lead == 0xed)
+				high = 0x9f;
+		}
+		else if (lead < 0xf5)
+		{
+			len = 4;
+			cp = lead & 0x07;
+
+			if (lead == 0xf0)
+				low = 0x90;
+			else if (lead == 0xf4)
+				high = 0x8f;
+		}
+		else
+		{
+			return UTF8_INVALID;
+		}
+
+		const string::size_type avail = std::min(len, count);
+
+		for (string::size_type i = 1 ; i < avail ; ++i)
+		{
+			const unsigned char c = data[i];
+
+			if (c < low || c > high)
+				return UTF8_INVALID;
+
+			cp = (cp << 6) | (c & 0x3f);
+
+			low = 0x80;
+			high = 0xbf;
+		}
+
+		if (avail < len)
+			return UTF8_INCOMPLETE;
+
+		*codePoint = cp;
+		*length = len;
+
+		return UTF8_VALID;
+	}
+
+
+	// Collects output bytes to avoid writing them one at a time
+	class outputBuffer
+	{
+	public:
+
+		outputBuffer(utility::outputStream& out)
+			: m_out(out), m_length(0)
+		{
+		}
+
+		void put(const unsigned char c)
+		{
+			if (m_length == sizeof(m_buffer))
+				flush();
+
+			m_buffer[m_length++] = static_cast <char>(c);
+		}
+
+		void putInvalid(const string::size_type count)
+		{
+			for (string::size_type i = 0 ; i < count ; ++i)
+				put('?');
+		}
+
+		void putRaw(const unsigned char* data, const string::size_type count)
+		{
+			if (count <= sizeof(m_buffer) - m_length)
+			{
+				std::memcpy(m_buffer + m_length, data, count);
+				m_length += count;
+			}
+			else
+			{
+				flush();
+				m_out.write(reinterpret_cast <const char*>(data), count);
+			}
+		}
+
+		void flush()
+		{
+			if (m_length != 0)
+			{
+				m_out.write(m_buffer, m_length);
+				m_length = 0;
+			}
+		}
+
+	private:
+
+		utility::outputStream& m_out;
+
+		char m_buffer[4096];
+		string::size_type m_length;
+	};
+
+
+	void encodeChar(outputBuffer& buf, const nativeCharsetConverter::NativeCharset dest,
+		const unsigned int cp, const string::size_type sourceLength)
+	{
+		switch (dest)
+		{
+		case nativeCharsetConverter::NATIVE_UTF_8:
+
+			if (cp < 0x80)
+			{
+				buf.put(static_cast <unsigned char>(cp));
+			}
+			else if (cp < 0x800)
+			{
+				buf.put(static_cast <unsigned char>(0xc0 | (cp >> 6)));
+				buf.put(static_cast <unsigned char>(0x80 | (cp & 0x3f)));
+			}
+			else if (cp < 0x10000)
+			{
+				buf.put(static_cast <unsigned char>(0xe0 | (cp >> 12)));
+				buf.put(static_cast <unsigned char>(0x80 | ((cp >> 6) & 0x3f)));
+				buf.put(static_cast <unsigned char>(0x80 | (cp & 0x3f)));
+			}
+			else
+			{
+				buf.put(static_cast <unsigned char>(0xf0 | (cp >> 18)));
+				buf.put(static_cast <unsigned char>(0x80 | ((cp >> 12) & 0x3f)));
+				buf.put(static_cast <unsigned char>(0x80 | ((cp >> 6) & 0x3f)));
+				buf.put(static_cast <unsigned char>(0x80 | (cp & 0x3f)));
+			}
+
+			break;
+
+		case nativeCharsetConverter::NATIVE_US_ASCII:
+
+			if (cp < 0x80)
+				buf.put(static_cast <unsigned char>(cp));
+			else
+				buf.putInvalid(sourceLength);
+
+			break;
+
+		case nativeCharsetConverter::NATIVE_ISO_8859_1:
+
+			if (cp < 0x100)
+				buf.put(static_cast <unsigned char>(cp));
+			else
+				buf.putInvalid(sourceLength);
+
+			break;
+
+		case nativeCharsetConverter::NATIVE_ISO_8859_15:
+		{
+			const int c = unicodeToLatin9(cp);
+
+			if (c >= 0)
+				buf.put(static_cast <unsigned char>(c));
+			else
+				buf.putInvalid(sourceLength);
+
+			break;
+		}
+		case nativeCharsetConverter::NATIVE_NONE:
+
+			break;
+		}
+	}
+
+} // unnamed namespace
+
+
+
+nativeCharsetConverter::nativeCharsetConverter(const charset& source, const charset& dest)
+	: m_source(identify(source)), m_dest(identify(dest)), m_pendingCount(0)
+{
+}
+
+
+// static
+nativeCharsetConverter::NativeCharset nativeCharsetConverter::identify(const charset& ch)
+{
+	const string& name = ch.getName();
+
+	for (unsigned int i = 0 ; i < sizeof(NATIVE_CHARSET_ALIASES) / sizeof(NATIVE_CHARSET_ALIASES[0]) ; ++i)
+	{
+		if (utility::stringUtils::isStringEqualNoCase(name, NATIVE_CHARSET_ALIASES[i].name))
+			return NATIVE_CHARSET_ALIASES[i].id;
+	}
+
+	return NATIVE_NONE;
+}
+
+
+// static
+bool nativeCharsetConverter::isSupported(const charset& source, const charset& dest)
+{
+	return identify(source) != NATIVE_NONE && identify(dest) != NATIVE_NONE;
+}
+
+
+void nativeCharsetConverter::convert(const string::value_type* const data,
+	const string::size_type count, utility::outputStream& out)
+{
+	const unsigned char* bytes = reinterpret_cast <const unsigned char*>(data);
+	string::size_type pos = 0;
+
+	// Complete the sequence left by the previous chunk
+	if (m_pendingCount != 0)
+	{
+		unsigned char buffer[sizeof(m_pending) * 2];
+		std::memcpy(buffer, m_pending, m_pendingCount);
+
+		const string::size_type extra = std::min(count, sizeof(m_pending));
+		std::memcpy(buffer + m_pendingCount, bytes, extra);
+
+		const string::size_type length = m_pendingCount + extra;
+		const string::size_type done = process(buffer, length, m_pendingCount, false, out);
+
+		if (done < m_pendingCount)
+		{
+			// Still incomplete: all the input has been used
+			std::memmove(m_pending, buffer + done, length - done);
+			m_pendingCount = length - done;
+
+			return;
+		}
+
+		pos = done - m_pendingCount;
+		m_pendingCount = 0;
+	}
+
+	const string::size_type done = process(bytes + pos, count - pos, count - pos, false, out);
+
+	// Keep the incomplete sequence at the end, if any
+	m_pendingCount = count - pos - done;
+	std::memcpy(m_pending, bytes + pos + done, m_pendingCount);
+}
+
+
+void nativeCharsetConverter::flush(utility::outputStream& out)
+{
+	if (m_pendingCount != 0)
+	{
+		process(m_pending, m_pendingCount, m_pendingCount, true, out);
+		m_pendingCount = 0;
+	}
+}
+
+
+string::size_type nativeCharsetConverter::process
+	(const unsigned char* data, const string::size_type count,
+	 const string::size_type stopAt, const bool final, utility::outputStream& out)
+{
+	outputBuffer buf(out);
+	string::size_type pos = 0;
+
+	while (pos < stopAt)
+	{
+		// US-ASCII is a subset of all supported charsets
+		const string::size_type run = asciiRunLength(data + pos, stopAt - pos);
+
+		if (run != 0)
+		{
+			buf.putRaw(data + pos, run);
+			pos += run;
+
+			continue;
+		}
+
+		unsigned int cp = 0;
+		string::size_type length = 1;
+
+		if (m_source == NATIVE_UTF_8)
+		{
+			UTF8DecodeResult res = decodeUTF8(data + pos, count - pos, &cp, &length);
+
+			if (res == UTF8_INCOMPLETE)
+			{
+				if (!final)
+					break;  // wait for more data
+
+				res = UTF8_INVALID;
+			}
+
+			if (res == UTF8_INVALID)
+			{
+				buf.putInvalid(1);
+				++pos;
+
+				continue;
+			}
+
+			if (m_dest == NATIVE_UTF_8)
+			{
+				buf.putRaw(data + pos, length);
+				pos += length;
+
+				continue;
+			}
+		}
+		else if (m_source == NATIVE_ISO_8859_15)
+		{
+			cp = latin9ToUnicode(data[pos]);
+		}
+		else if (m_source == NATIVE_ISO_8859_1)
+		{
+			cp = data[pos];
+		}
+		else // NATIVE_US_ASCII
+		{
+			buf.putInvalid(1);
+			++pos;
+
+			continue;
+		}
+
+		encodeChar(buf, m_dest, cp, length);
+		pos += length;
+	}
+
+	buf.flush();
+
+	return pos;
+}
+
+
+} // vmime
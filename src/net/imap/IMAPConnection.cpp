@@ -28,6 +28,7 @@
 
 #include "vmime/exception.hpp"
 #include "vmime/platform.hpp"
+#include "vmime/utility/instrumentation.hpp"
 
 #include "vmime/net/defaultConnectionInfos.hpp"
 
@@ -37,10 +38,10 @@
 
 #if VMIME_HAVE_TLS_SUPPORT
 	#include "vmime/net/tls/TLSSession.hpp"
+	#include "vmime/net/tls/TLSSessionCache.hpp"
 	#include "vmime/net/tls/TLSSecuredConnectionInfos.hpp"
 #endif // VMIME_HAVE_TLS_SUPPORT
 
-#include <sstream>
 
 
 // Helpers for service properties
@@ -107,6 +108,9 @@ void IMAPConnection::connect()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(store->getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(address, port, store->getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -247,7 +251,7 @@ void IMAPConnection::authenticate()
 	send(true, "LOGIN " + IMAPUtils::quoteString(username)
 		+ " " + IMAPUtils::quoteString(password), true);
 
-	utility::auto_ptr <IMAPParser::response> resp(m_parser->readResponse());
+	utility::auto_ptr <IMAPParser::response> resp(readResponse());
 
 	if (resp->isBad())
 	{
@@ -340,7 +344,7 @@ void IMAPConnection::authenticateSASL()
 
 		for (bool cont = true ; cont ; )
 		{
-			utility::auto_ptr <IMAPParser::response> resp(m_parser->readResponse());
+			utility::auto_ptr <IMAPParser::response> resp(readResponse());
 
 			if (resp->response_done() &&
 			    resp->response_done()->response_tagged() &&
@@ -444,7 +448,7 @@ void IMAPConnection::startTLS()
 	{
 		send(true, "STARTTLS", true);
 
-		utility::auto_ptr <IMAPParser::response> resp(m_parser->readResponse());
+		utility::auto_ptr <IMAPParser::response> resp(readResponse());
 
 		if (resp->isBad() || resp->response_done()->response_tagged()->
 			resp_cond_state()->status() != IMAPParser::resp_cond_state::OK)
@@ -456,6 +460,9 @@ void IMAPConnection::startTLS()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(m_store.acquire()->getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(m_cntInfos->getHost(), m_cntInfos->getPort(), m_store.acquire()->getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -488,7 +495,7 @@ const std::vector <string> IMAPConnection::getCapabilities()
 {
 	send(true, "CAPABILITY", true);
 
-	utility::auto_ptr <IMAPParser::response> resp(m_parser->readResponse());
+	utility::auto_ptr <IMAPParser::response> resp(readResponse());
 
 	std::vector <string> res;
 
@@ -582,7 +589,7 @@ void IMAPConnection::initHierarchySeparator()
 {
 	send(true, "LIST \"\" \"\"", true);
 
-	vmime::utility::auto_ptr <IMAPParser::response> resp(m_parser->readResponse());
+	vmime::utility::auto_ptr <IMAPParser::response> resp(readResponse());
 
 	if (resp->isBad() || resp->response_done()->response_tagged()->
 		resp_cond_state()->status() != IMAPParser::resp_cond_state::OK)
@@ -622,39 +629,26 @@ void IMAPConnection::initHierarchySeparator()
 
 void IMAPConnection::send(bool tag, const string& what, bool end)
 {
-#if VMIME_DEBUG
-	std::ostringstream oss;
+	// Build the whole line, so that it is sent in one go
+	string buffer;
+	buffer.reserve(what.length() + 16);
 
 	if (tag)
 	{
-		++(*m_tag);
-
-		oss << string(*m_tag);
-		oss << " ";
-	}
+		VMIME_INSTRUMENT_COUNT(COUNTER_IMAP_COMMANDS);
 
-	oss << what;
-
-	if (end)
-		oss << "\r\n";
-
-	m_socket->send(oss.str());
-#else
-	if (tag)
-	{
 		++(*m_tag);
 
-		m_socket->send(*m_tag);
-		m_socket->send(" ");
+		buffer += string(*m_tag);
+		buffer += ' ';
 	}
 
-	m_socket->send(what);
+	buffer += what;
 
 	if (end)
-	{
-		m_socket->send("\r\n");
-	}
-#endif
+		buffer += "\r\n";
+
+	m_socket->send(buffer);
 }
 
 
@@ -666,6 +660,9 @@ void IMAPConnection::sendRaw(const char* buffer, const int count)
 
 IMAPParser::response* IMAPConnection::readResponse(IMAPParser::literalHandler* lh)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_IMAP_RESPONSES);
+	VMIME_INSTRUMENT_TIME(TIMER_IMAP_RESPONSE);
+
 	return (m_parser->readResponse(lh));
 }
 
@@ -724,6 +721,12 @@ ref <const socket> IMAPConnection::getSocket() const
 }
 
 
+ref <socket> IMAPConnection::getSocket()
+{
+	return m_socket;
+}
+
+
 } // imap
 } // net
 } // vmime
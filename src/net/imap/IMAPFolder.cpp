@@ -30,11 +30,11 @@
 #include "vmime/net/imap/IMAPConnection.hpp"
 
 #include "vmime/message.hpp"
+#include "vmime/componentInputStream.hpp"
 
 #include "vmime/exception.hpp"
 #include "vmime/utility/smartPtr.hpp"
-
-#include "vmime/utility/outputStreamAdapter.hpp"
+#include "vmime/utility/outputStreamSocketAdapter.hpp"
 
 #include <algorithm>
 #include <sstream>
@@ -1312,15 +1312,11 @@ void IMAPFolder::setMessageFlags(const string& set, const int flags, const int m
 void IMAPFolder::addMessage(ref <vmime::message> msg, const int flags,
                             vmime::datetime* date, utility::progressListener* progress)
 {
-	std::ostringstream oss;
-	utility::outputStreamAdapter ossAdapter(oss);
-
-	msg->generate(ossAdapter);
+	// Generate the message while it is being added. The APPEND literal
+	// needs the exact size before the data is sent.
+	componentInputStream cis(msg, options::getInstance()->message.maxLineLength());
 
-	const std::string& str = oss.str();
-	utility::inputStreamStringAdapter strAdapter(str);
-
-	addMessage(strAdapter, str.length(), flags, date, progress);
+	addMessage(cis, static_cast <int>(cis.getSize()), flags, date, progress);
 }
 
 
@@ -1389,8 +1385,12 @@ void IMAPFolder::addMessage(utility::inputStream& is, const int size, const int
 	if (progress)
 		progress->start(total);
 
-      const socket::size_type blockSize = std::min(is.getBlockSize(),
-		static_cast <size_t>(m_connection->getSocket()->getBlockSize()));
+	// Data is sent through a buffered stream, in blocks of the socket's
+	// preferred size, whatever the size of the blocks read from the input
+	utility::outputStreamSocketAdapter sos(*m_connection->getSocket());
+
+	const socket::size_type blockSize = std::min(is.getBlockSize(),
+		static_cast <size_t>(sos.getBlockSize()));
 
 	std::vector <char> vbuffer(blockSize);
 	char* buffer = &vbuffer.front();
@@ -1398,18 +1398,20 @@ void IMAPFolder::addMessage(utility::inputStream& is, const int size, const int
 	while (!is.eof())
 	{
 		// Read some data from the input stream
-		const int read = is.read(buffer, sizeof(buffer));
+		const int read = is.read(buffer, blockSize);
 		current += read;
 
 		// Put read data into socket output stream
-		m_connection->sendRaw(buffer, read);
+		sos.write(buffer, read);
 
 		// Notify progress
 		if (progress)
 			progress->progress(current, total);
 	}
 
-	m_connection->send(false, "", true);
+	// End the command along with the last block of data
+	sos.write("\r\n", 2);
+	sos.flush();
 
 	if (progress)
 		progress->stop(total);
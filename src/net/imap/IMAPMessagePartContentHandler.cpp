@@ -75,16 +75,13 @@ void IMAPMessagePartContentHandler::generate
 			std::ostringstream oss2;
 			utility::outputStreamAdapter tmp2(oss2);
 
-			ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-			theDecoder->decode(in, tmp2);
+			m_encoding.decode(in, tmp2);
 
 			// Reencode to output stream
 			string str = oss2.str();
 			utility::inputStreamStringAdapter tempIn(str);
 
-			ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-			theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-			theEncoder->encode(tempIn, os);
+			enc.encode(tempIn, os, maxLineLength);
 		}
 		// No encoding to perform
 		else
@@ -102,12 +99,9 @@ void IMAPMessagePartContentHandler::generate
 		msg->extractPart(part, tmp, NULL);
 
 		// Encode temporary buffer to output stream
-		ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-		theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-
 		utility::inputStreamStringAdapter is(oss.str());
 
-		theEncoder->encode(is, os);
+		enc.encode(is, os, maxLineLength);
 	}
 }
 
@@ -136,8 +130,7 @@ void IMAPMessagePartContentHandler::extract
 		utility::inputStreamStringAdapter is(oss.str());
 		utility::progressListenerSizeAdapter plsa(progress, getLength());
 
-		ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-		theDecoder->decode(is, os, &plsa);
+		m_encoding.decode(is, os, &plsa);
 	}
 }
 
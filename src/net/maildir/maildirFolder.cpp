@@ -31,12 +31,12 @@
 #include "vmime/utility/smartPtr.hpp"
 
 #include "vmime/message.hpp"
+#include "vmime/componentInputStream.hpp"
 
 #include "vmime/exception.hpp"
 #include "vmime/platform.hpp"
 
-#include "vmime/utility/outputStreamAdapter.hpp"
-#include "vmime/utility/inputStreamStringAdapter.hpp"
+#include <algorithm>
 
 
 namespace vmime {
@@ -823,15 +823,11 @@ void maildirFolder::setMessageFlagsImpl
 void maildirFolder::addMessage(ref <vmime::message> msg, const int flags,
 	vmime::datetime* date, utility::progressListener* progress)
 {
-	std::ostringstream oss;
-	utility::outputStreamAdapter ossAdapter(oss);
+	// Generate the message while it is being added. The size is only
+	// used for progress notification, so it is not computed in advance.
+	componentInputStream cis(msg, options::getInstance()->message.maxLineLength());
 
-	msg->generate(ossAdapter);
-
-	const std::string& str = oss.str();
-	utility::inputStreamStringAdapter strAdapter(str);
-
-	addMessage(strAdapter, str.length(), flags, date, progress);
+	addMessage(cis, 0, flags, date, progress);
 }
 
 
@@ -962,7 +958,7 @@ void maildirFolder::copyMessageImpl(const utility::file::path& tmpDirPath,
 			}
 
 			if (progress)
-				progress->progress(total, size);
+				progress->progress(total, std::max(total, size));
 		}
 
 		os->flush();
@@ -27,15 +27,28 @@
 #include "vmime/net/pop3/POP3Message.hpp"
 
 #include "vmime/net/pop3/POP3Utils.hpp"
+#include "vmime/net/pop3/POP3UIDStore.hpp"
 
 #include "vmime/exception.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <cstdlib>
+
 
 namespace vmime {
 namespace net {
 namespace pop3 {
 
 
+// Fetching attributes with one command per message is preferred over
+// listing the whole mailbox when the mailbox holds more than this many
+// times the number of requested messages (a round trip costs about as
+// much as transferring a hundred lines of listing)
+static const int MULTI_LISTING_RATIO = 100;
+
+
 POP3Folder::POP3Folder(const folder::path& path, ref <POP3Store> store)
 	: m_store(store), m_path(path),
 	  m_name(path.isEmpty() ? folder::path::component("") : path.getLastComponent()),
@@ -356,13 +369,33 @@ void POP3Folder::fetchMessages(std::vector <ref <message> >& msg, const int opti
 			progress->progress(++current, total);
 	}
 
+	// When only a few messages are requested from a large mailbox, one
+	// command per message is cheaper than listing the whole mailbox
+	if ((options & (FETCH_SIZE | FETCH_UID)) &&
+	    static_cast <int>(msg.size()) * MULTI_LISTING_RATIO < m_messageCount)
+	{
+		for (std::vector <ref <message> >::iterator it = msg.begin() ;
+		     it != msg.end() ; ++it)
+		{
+			ref <POP3Message> m = (*it).dynamicCast <POP3Message>();
+
+			if (options & FETCH_SIZE)
+				fetchMessageSize(store, m);
+
+			if (options & FETCH_UID)
+				fetchMessageUID(store, m);
+		}
+
+		if (progress)
+			progress->stop(total);
+
+		return;
+	}
+
 	if (options & FETCH_SIZE)
 	{
 		// Send the "LIST" command
-		std::ostringstream command;
-		command << "LIST";
-
-		store->sendRequest(command.str());
+		store->sendRequest("LIST");
 
 		// Get the response
 		string response;
@@ -388,14 +421,7 @@ void POP3Folder::fetchMessages(std::vector <ref <message> >& msg, const int opti
 				std::map <int, string>::const_iterator x = result.find(m->m_num);
 
 				if (x != result.end())
-				{
-					int size = 0;
-
-					std::istringstream iss((*x).second);
-					iss >> size;
-
-					m->m_size = size;
-				}
+					m->m_size = std::atoi((*x).second.c_str());
 			}
 		}
 
@@ -404,10 +430,7 @@ void POP3Folder::fetchMessages(std::vector <ref <message> >& msg, const int opti
 	if (options & FETCH_UID)
 	{
 		// Send the "UIDL" command
-		std::ostringstream command;
-		command << "UIDL";
-
-		store->sendRequest(command.str());
+		store->sendRequest("UIDL");
 
 		// Get the response
 		string response;
@@ -443,6 +466,66 @@ void POP3Folder::fetchMessages(std::vector <ref <message> >& msg, const int opti
 }
 
 
+void POP3Folder::getUIDChanges(const POP3UIDStore& seen,
+	std::vector <ref <message> >& newMessages, std::vector <message::uid>& removedUIDs)
+{
+	ref <POP3Store> store = m_store.acquire();
+
+	if (!store)
+		throw exceptions::illegal_state("Store disconnected");
+	else if (!isOpen())
+		throw exceptions::illegal_state("Folder not open");
+
+	newMessages.clear();
+	removedUIDs.clear();
+
+	// Send the "UIDL" command
+	store->sendRequest("UIDL");
+
+	// Get the response
+	string response;
+	store->readResponse(response, true, NULL);
+
+	if (!store->isSuccessResponse(response))
+		throw exceptions::command_error("UIDL", response);
+
+	store->stripFirstLine(response, response, NULL);
+
+	std::vector <std::pair <int, string> > result;
+	POP3Utils::parseMultiListOrUidlResponse(response, result);
+
+	response.clear();
+
+	// Messages which have not been seen yet
+	std::vector <message::uid> current;
+	current.reserve(result.size());
+
+	ref <POP3Folder> thisFolder = thisRef().dynamicCast <POP3Folder>();
+
+	for (std::vector <std::pair <int, string> >::const_iterator it = result.begin() ;
+	     it != result.end() ; ++it)
+	{
+		if (!seen.contains((*it).second))
+		{
+			ref <POP3Message> msg = vmime::create <POP3Message>(thisFolder, (*it).first);
+			msg->m_uid = (*it).second;
+
+			newMessages.push_back(msg);
+		}
+
+		current.push_back((*it).second);
+	}
+
+	// Messages which have been removed from the server
+	std::sort(current.begin(), current.end());
+
+	const std::vector <message::uid> seenUIDs = seen.getUIDs();
+
+	std::set_difference(seenUIDs.begin(), seenUIDs.end(),
+		current.begin(), current.end(), std::back_inserter(removedUIDs));
+}
+
+
 void POP3Folder::fetchMessage(ref <message> msg, const int options)
 {
 	ref <POP3Store> store = m_store.acquire();
@@ -456,75 +539,80 @@ void POP3Folder::fetchMessage(ref <message> msg, const int options)
 		(thisRef().dynamicCast <POP3Folder>(), options);
 
 	if (options & FETCH_SIZE)
-	{
-		// Send the "LIST" command
-		std::ostringstream command;
-		command.imbue(std::locale::classic());
+		fetchMessageSize(store, msg.dynamicCast <POP3Message>());
 
-		command << "LIST " << msg->getNumber();
+	if (options & FETCH_UID)
+		fetchMessageUID(store, msg.dynamicCast <POP3Message>());
+}
 
-		store->sendRequest(command.str());
 
-		// Get the response
-		string response;
-		store->readResponse(response, false, NULL);
+void POP3Folder::fetchMessageSize(ref <POP3Store> store, ref <POP3Message> msg)
+{
+	// Send the "LIST" command
+	std::ostringstream command;
+	command.imbue(std::locale::classic());
 
-		if (store->isSuccessResponse(response))
-		{
-			store->stripResponseCode(response, response);
+	command << "LIST " << msg->getNumber();
+
+	store->sendRequest(command.str());
 
-			// C: LIST 2
-			// S: +OK 2 4242
-			string::iterator it = response.begin();
+	// Get the response
+	string response;
+	store->readResponse(response, false, NULL);
 
-			while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
-			while (it != response.end() && !(*it == ' ' || *it == '\t')) ++it;
-			while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
+	if (store->isSuccessResponse(response))
+	{
+		store->stripResponseCode(response, response);
 
-			if (it != response.end())
-			{
-				int size = 0;
+		// C: LIST 2
+		// S: +OK 2 4242
+		string::iterator it = response.begin();
 
-				std::istringstream iss(string(it, response.end()));
-				iss >> size;
+		while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
+		while (it != response.end() && !(*it == ' ' || *it == '\t')) ++it;
+		while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
 
-				msg.dynamicCast <POP3Message>()->m_size = size;
-			}
+		if (it != response.end())
+		{
+			int size = 0;
+
+			std::istringstream iss(string(it, response.end()));
+			iss >> size;
+
+			msg->m_size = size;
 		}
 	}
+}
 
-	if (options & FETCH_UID)
-	{
-		// Send the "UIDL" command
-		std::ostringstream command;
-		command.imbue(std::locale::classic());
 
-		command << "UIDL " << msg->getNumber();
+void POP3Folder::fetchMessageUID(ref <POP3Store> store, ref <POP3Message> msg)
+{
+	// Send the "UIDL" command
+	std::ostringstream command;
+	command.imbue(std::locale::classic());
 
-		store->sendRequest(command.str());
+	command << "UIDL " << msg->getNumber();
 
-		// Get the response
-		string response;
-		store->readResponse(response, false, NULL);
+	store->sendRequest(command.str());
 
-		if (store->isSuccessResponse(response))
-		{
-			store->stripResponseCode(response, response);
+	// Get the response
+	string response;
+	store->readResponse(response, false, NULL);
 
-			// C: UIDL 2
-			// S: +OK 2 QhdPYR:00WBw1Ph7x7
-			string::iterator it = response.begin();
+	if (store->isSuccessResponse(response))
+	{
+		store->stripResponseCode(response, response);
 
-			while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
-			while (it != response.end() && !(*it == ' ' || *it == '\t')) ++it;
-			while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
+		// C: UIDL 2
+		// S: +OK 2 QhdPYR:00WBw1Ph7x7
+		string::iterator it = response.begin();
 
-			if (it != response.end())
-			{
-				msg.dynamicCast <POP3Message>()->m_uid =
-					string(it, response.end());
-			}
-		}
+		while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
+		while (it != response.end() && !(*it == ' ' || *it == '\t')) ++it;
+		while (it != response.end() && (*it == ' ' || *it == '\t')) ++it;
+
+		if (it != response.end())
+			msg->m_uid = string(it, response.end());
 	}
 }
 
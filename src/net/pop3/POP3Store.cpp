@@ -30,7 +30,8 @@
 #include "vmime/security/digest/messageDigestFactory.hpp"
 #include "vmime/utility/filteredStream.hpp"
 #include "vmime/utility/stringUtils.hpp"
-#include "vmime/utility/inputStreamSocketAdapter.hpp"
+#include "vmime/utility/instrumentation.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
 
 #include "vmime/net/defaultConnectionInfos.hpp"
 
@@ -40,6 +41,7 @@
 
 #if VMIME_HAVE_TLS_SUPPORT
 	#include "vmime/net/tls/TLSSession.hpp"
+	#include "vmime/net/tls/TLSSessionCache.hpp"
 	#include "vmime/net/tls/TLSSecuredConnectionInfos.hpp"
 #endif // VMIME_HAVE_TLS_SUPPORT
 
@@ -147,6 +149,9 @@ void POP3Store::connect()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(address, port, getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -546,6 +551,9 @@ void POP3Store::startTLS()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(m_cntInfos->getHost(), m_cntInfos->getPort(), getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -732,6 +740,8 @@ void POP3Store::stripResponseCode(const string& buffer, string& result)
 
 void POP3Store::sendRequest(const string& buffer, const bool end)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_POP3_COMMANDS);
+
 	if (end)
 		m_socket->send(buffer + "\r\n");
 	else
@@ -742,7 +752,11 @@ void POP3Store::sendRequest(const string& buffer, const bool end)
 void POP3Store::readResponse(string& buffer, const bool multiLine,
                              utility::progressListener* progress)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_POP3_RESPONSES);
+	VMIME_INSTRUMENT_TIME(TIMER_POP3_RESPONSE);
+
 	bool foundTerminator = false;
+	bool statusDone = false;
 	int current = 0, total = 0;
 
 	if (progress)
@@ -753,7 +767,12 @@ void POP3Store::readResponse(string& buffer, const bool multiLine,
 
 	buffer.clear();
 
-	string::value_type last1 = '\0', last2 = '\0';
+	// Data following the status line of a multi-line response is
+	// decoded directly into the buffer
+	utility::outputStreamStringAdapter bufferStream(buffer);
+	utility::dotTerminatedFilteredOutputStream decoder(bufferStream);
+
+	string receiveBuffer;
 
 	for ( ; !foundTerminator ; )
 	{
@@ -773,7 +792,6 @@ void POP3Store::readResponse(string& buffer, const bool multiLine,
 		}
 
 		// Receive data from the socket
-		string receiveBuffer;
 		m_socket->receive(receiveBuffer);
 
 		if (receiveBuffer.empty())   // buffer is empty
@@ -786,34 +804,41 @@ void POP3Store::readResponse(string& buffer, const bool multiLine,
 		if (m_timeoutHandler)
 			m_timeoutHandler->resetTimeOut();
 
-		// Check for transparent characters: '\n..' becomes '\n.'
-		const string::value_type first = receiveBuffer[0];
+		current += receiveBuffer.length();
 
-		if (first == '.' && last2 == '\n' && last1 == '.')
+		if (statusDone)
 		{
-			receiveBuffer.erase(receiveBuffer.begin());
+			decoder.write(receiveBuffer.data(), receiveBuffer.length());
+			foundTerminator = decoder.isTerminated();
 		}
-		else if (receiveBuffer.length() >= 2 && first == '.' &&
-		         receiveBuffer[1] == '.' && last1 == '\n')
+		else
 		{
-			receiveBuffer.erase(receiveBuffer.begin());
-		}
+			buffer += receiveBuffer;
 
-		for (string::size_type trans ;
-		     string::npos != (trans = receiveBuffer.find("\n..")) ; )
-		{
-			receiveBuffer.replace(trans, 3, "\n.");
-		}
+			const string::size_type eol = buffer.find('\n');
 
-		last1 = receiveBuffer[receiveBuffer.length() - 1];
-		last2 = static_cast <char>((receiveBuffer.length() >= 2) ? receiveBuffer[receiveBuffer.length() - 2] : 0);
+			// If there is an error (-ERR) when executing a command that
+			// requires a multi-line response, the error response will
+			// include only one line, so we stop waiting for a multi-line
+			// terminator and check for a "normal" one.
+			if (!multiLine || (buffer.length() >= 4 && buffer[0] == '-'))
+			{
+				// Check for terminator string (and strip it if present)
+				foundTerminator = checkTerminator(buffer, false);
+			}
+			else if (eol != string::npos)
+			{
+				// Keep the status line as is, and decode the data
+				// following it
+				const string data(buffer.begin() + eol + 1, buffer.end());
+				buffer.erase(eol + 1);
 
-		// Append the data to the response buffer
-		buffer += receiveBuffer;
-		current += receiveBuffer.length();
+				statusDone = true;
 
-		// Check for terminator string (and strip it if present)
-		foundTerminator = checkTerminator(buffer, multiLine);
+				decoder.write(data.data(), data.length());
+				foundTerminator = decoder.isTerminated();
+			}
+		}
 
 		// Notify progress
 		if (progress)
@@ -821,15 +846,6 @@ void POP3Store::readResponse(string& buffer, const bool multiLine,
 			total = std::max(total, current);
 			progress->progress(current, total);
 		}
-
-		// If there is an error (-ERR) when executing a command that
-		// requires a multi-line response, the error response will
-		// include only one line, so we stop waiting for a multi-line
-		// terminator and check for a "normal" one.
-		if (multiLine && !foundTerminator && buffer.length() >= 4 && buffer[0] == '-')
-		{
-			foundTerminator = checkTerminator(buffer, false);
-		}
 	}
 
 	if (progress)
@@ -840,6 +856,9 @@ void POP3Store::readResponse(string& buffer, const bool multiLine,
 void POP3Store::readResponse(utility::outputStream& os,
 	utility::progressListener* progress, const int predictedSize)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_POP3_RESPONSES);
+	VMIME_INSTRUMENT_TIME(TIMER_POP3_RESPONSE);
+
 	int current = 0, total = predictedSize;
 
 	string temp;
@@ -851,14 +870,11 @@ void POP3Store::readResponse(utility::outputStream& os,
 	if (m_timeoutHandler)
 		m_timeoutHandler->resetTimeOut();
 
-	utility::inputStreamSocketAdapter sis(*m_socket);
-	utility::stopSequenceFilteredInputStream <5> sfis1(sis, "\r\n.\r\n");
-	utility::stopSequenceFilteredInputStream <3> sfis2(sfis1, "\n.\n");
-	utility::dotFilteredInputStream dfis(sfis2);   // "\n.." --> "\n."
-
-	utility::inputStream& is = dfis;
+	// Un-stuff dots and detect the terminating line in a single pass,
+	// writing directly into the output stream
+	utility::dotTerminatedFilteredOutputStream decoder(os);
 
-	while (!is.eof())
+	while (!decoder.isTerminated())
 	{
 #if 0 // not supported
 		// Check for possible cancellation
@@ -875,7 +891,7 @@ void POP3Store::readResponse(utility::outputStream& os,
 
 		// Receive data from the socket
 		utility::stream::value_type buffer[65536];
-		const utility::stream::size_type read = is.read(buffer, sizeof(buffer));
+		const socket::size_type read = m_socket->receiveRaw(buffer, sizeof(buffer));
 
 		if (read == 0)   // buffer is empty
 		{
@@ -901,7 +917,7 @@ void POP3Store::readResponse(utility::outputStream& os,
 
 				codeDone = true;
 
-				os.write(temp.data(), temp.length());
+				decoder.write(temp.data(), temp.length());
 				temp.clear();
 
 				continue;
@@ -910,7 +926,7 @@ void POP3Store::readResponse(utility::outputStream& os,
 		else
 		{
 			// Inject the data into the output stream
-			os.write(buffer, read);
+			decoder.write(buffer, read);
 			current += read;
 
 			// Notify progress
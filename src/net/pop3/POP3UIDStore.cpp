@@ -0,0 +1,182 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/net/pop3/POP3UIDStore.hpp"
+
+#include "vmime/exception.hpp"
+
+#include <sstream>
+#include <algorithm>
+
+
+namespace vmime {
+namespace net {
+namespace pop3 {
+
+
+// File format:
+//
+//    vmime-pop3-uids 1
+//    0 whqtswO00WBw418f9t5JxYwZ
+//    4 swO00WBw418f9t5JxYwa
+//    ...
+//
+// Each line holds the length of the prefix shared with the UID of the
+// previous line, and the remaining characters. UIDs never contain spaces
+// or line breaks (RFC-1939).
+
+static const char* const FILE_SIGNATURE = "vmime-pop3-uids 1";
+
+
+POP3UIDStore::POP3UIDStore()
+{
+}
+
+
+bool POP3UIDStore::contains(const message::uid& uid) const
+{
+	return m_uids.find(uid) != m_uids.end();
+}
+
+
+void POP3UIDStore::add(const message::uid& uid)
+{
+	m_uids.insert(uid);
+}
+
+
+void POP3UIDStore::remove(const message::uid& uid)
+{
+	m_uids.erase(uid);
+}
+
+
+void POP3UIDStore::clear()
+{
+	m_uids.clear();
+}
+
+
+int POP3UIDStore::getUIDCount() const
+{
+	return static_cast <int>(m_uids.size());
+}
+
+
+const std::vector <message::uid> POP3UIDStore::getUIDs() const
+{
+	return std::vector <message::uid>(m_uids.begin(), m_uids.end());
+}
+
+
+void POP3UIDStore::load(utility::inputStream& is)
+{
+	string data;
+
+	while (!is.eof())
+	{
+		utility::stream::value_type buffer[16384];
+		const utility::stream::size_type read = is.read(buffer, sizeof(buffer));
+
+		data.append(buffer, read);
+	}
+
+	std::set <message::uid> uids;
+	message::uid prev;
+
+	const string::size_type length = data.length();
+	string::size_type pos = data.find('\n');
+
+	if (pos == string::npos || data.compare(0, pos, FILE_SIGNATURE) != 0)
+		throw exceptions::invalid_argument();
+
+	for (++pos ; pos < length ; )
+	{
+		string::size_type eol = data.find('\n', pos);
+
+		if (eol == string::npos)
+			eol = length;
+
+		// Length of the prefix shared with the previous UID
+		string::size_type shared = 0;
+
+		for ( ; pos < eol && data[pos] >= '0' && data[pos] <= '9' ; ++pos)
+			shared = shared * 10 + (data[pos] - '0');
+
+		if (pos >= eol || data[pos] != ' ' || shared > prev.length())
+			throw exceptions::invalid_argument();
+
+		++pos;
+
+		message::uid uid(prev, 0, shared);
+		uid.append(data, pos, eol - pos);
+
+		// Sorted input: insert at the end of the set in constant time
+		uids.insert(uids.end(), uid);
+
+		prev = uid;
+		pos = eol + 1;
+	}
+
+	m_uids.swap(uids);
+}
+
+
+void POP3UIDStore::save(utility::outputStream& os) const
+{
+	std::ostringstream oss;
+	oss.imbue(std::locale::classic());
+
+	oss << FILE_SIGNATURE << '\n';
+
+	const message::uid* prev = NULL;
+
+	for (std::set <message::uid>::const_iterator it = m_uids.begin() ;
+	     it != m_uids.end() ; ++it)
+	{
+		const message::uid& uid = *it;
+		string::size_type shared = 0;
+
+		if (prev != NULL)
+		{
+			const string::size_type max = std::min(prev->length(), uid.length());
+
+			while (shared < max && (*prev)[shared] == uid[shared])
+				++shared;
+		}
+
+		oss << shared << ' ';
+		oss.write(uid.data() + shared, uid.length() - shared);
+		oss << '\n';
+
+		prev = &uid;
+	}
+
+	const string data = oss.str();
+	os.write(data.data(), data.length());
+}
+
+
+} // pop3
+} // net
+} // vmime
@@ -23,7 +23,7 @@
 
 #include "vmime/net/pop3/POP3Utils.hpp"
 
-#include <sstream>
+#include <cstring>
 
 
 namespace vmime {
@@ -32,42 +32,79 @@ namespace pop3 {
 
 
 // static
-void POP3Utils::parseMultiListOrUidlResponse(const string& response, std::map <int, string>& result)
+bool POP3Utils::parseListOrUidlLine
+	(const char* begin, const char* end, int& number, string& data)
 {
-	std::istringstream iss(response);
-	std::map <int, string> ids;
+	const char* p = begin;
+
+	while (p != end && (*p == ' ' || *p == '\t')) ++p;
 
-	string line;
+	if (p == end)
+		return false;
 
-	while (std::getline(iss, line))
+	number = 0;
+
+	while (p != end && (*p >= '0' && *p <= '9'))
 	{
-		string::iterator it = line.begin();
+		number = (number * 10) + (*p - '0');
+		++p;
+	}
+
+	while (p != end && !(*p == ' ' || *p == '\t')) ++p;
+	while (p != end && (*p == ' ' || *p == '\t')) ++p;
+
+	// Ignore CR and trailing spaces
+	while (end != p && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) --end;
+
+	if (p == end)
+		return false;
+
+	data.assign(p, end);
+
+	return true;
+}
+
+
+// static
+template <typename CONTAINER>
+void POP3Utils::parseLines(const string& response, CONTAINER& result)
+{
+	const char* p = response.data();
+	const char* const end = p + response.length();
 
-		while (it != line.end() && (*it == ' ' || *it == '\t'))
-			++it;
+	int number = 0;
+	string data;
 
-		if (it != line.end())
-		{
-			int number = 0;
+	while (p != end)
+	{
+		const char* eol = static_cast <const char*>(std::memchr(p, '\n', end - p));
 
-			while (it != line.end() && (*it >= '0' && *it <= '9'))
-			{
-				number = (number * 10) + (*it - '0');
-				++it;
-			}
+		if (eol == NULL)
+			eol = end;
 
-			while (it != line.end() && !(*it == ' ' || *it == '\t')) ++it;
-			while (it != line.end() && (*it == ' ' || *it == '\t')) ++it;
+		if (parseListOrUidlLine(p, eol, number, data))
+			result.insert(result.end(), typename CONTAINER::value_type(number, data));
 
-			if (it != line.end())
-			{
-				result.insert(std::map <int, string>::value_type(number, string(it, line.end())));
-			}
-		}
+		p = (eol == end ? end : eol + 1);
 	}
 }
 
 
+// static
+void POP3Utils::parseMultiListOrUidlResponse(const string& response, std::map <int, string>& result)
+{
+	parseLines(response, result);
+}
+
+
+// static
+void POP3Utils::parseMultiListOrUidlResponse
+	(const string& response, std::vector <std::pair <int, string> >& result)
+{
+	parseLines(response, result);
+}
+
+
 } // pop3
 } // net
 } // vmime
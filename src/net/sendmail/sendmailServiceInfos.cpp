@@ -48,7 +48,12 @@ const sendmailServiceInfos::props& sendmailServiceInfos::getProperties() const
 	static props sendmailProps =
 	{
 		// Path to sendmail (override default)
-		property("binpath", serviceInfos::property::TYPE_STRING, string(VMIME_SENDMAIL_PATH))
+		property("binpath", serviceInfos::property::TYPE_STRING, string(VMIME_SENDMAIL_PATH)),
+
+		// Keep a single sendmail process running in SMTP mode ("-bs")
+		// and send all messages through it, instead of starting a new
+		// process for each message
+		property("options.batch", serviceInfos::property::TYPE_BOOL, "false")
 	};
 
 	return sendmailProps;
@@ -61,6 +66,7 @@ const std::vector <serviceInfos::property> sendmailServiceInfos::getAvailablePro
 	const props& p = getProperties();
 
 	list.push_back(p.PROPERTY_BINPATH);
+	list.push_back(p.PROPERTY_OPTIONS_BATCH);
 
 	return list;
 }
@@ -27,6 +27,7 @@
 #include "vmime/platform.hpp"
 #include "vmime/message.hpp"
 #include "vmime/mailboxList.hpp"
+#include "vmime/parserHelpers.hpp"
 
 #include "vmime/utility/filteredStream.hpp"
 #include "vmime/utility/childProcess.hpp"
@@ -90,6 +91,42 @@ void sendmailTransport::connect()
 	// Use the specified path for 'sendmail' or a default one if no path is specified
 	m_sendmailPath = GET_PROPERTY(string, PROPERTY_BINPATH);
 
+	// In batch mode, start a sendmail process which will be used
+	// to send all messages, and talk to it using SMTP
+	if (GET_PROPERTY(bool, PROPERTY_OPTIONS_BATCH))
+	{
+		const utility::file::path path = vmime::platform::getHandler()->
+			getFileSystemFactory()->stringToPath(m_sendmailPath);
+
+		ref <utility::childProcess> proc =
+			vmime::platform::getHandler()->
+				getChildProcessFactory()->create(path);
+
+		std::vector <string> args;
+		args.push_back("-bs");
+
+		proc->start(args, utility::childProcess::FLAG_REDIRECT_STDIN |
+		                  utility::childProcess::FLAG_REDIRECT_STDOUT);
+
+		m_proc = proc;
+		m_responseBuffer.clear();
+
+		try
+		{
+			string response;
+
+			if (readResponse(response) != 220)
+				throw exceptions::connection_greeting_error(response);
+
+			sendCommand("HELO " + platform::getHandler()->getHostName(), 250);
+		}
+		catch (vmime::exception&)
+		{
+			internalDisconnect();
+			throw;
+		}
+	}
+
 	m_connected = true;
 }
 
@@ -117,19 +154,50 @@ void sendmailTransport::disconnect()
 	if (!isConnected())
 		throw exceptions::not_connected();
 
+	if (m_proc)
+	{
+		try
+		{
+			string response;
+
+			sendRequest("QUIT");
+			readResponse(response);
+		}
+		catch (vmime::exception&)
+		{
+			// Ignore
+		}
+	}
+
 	internalDisconnect();
 }
 
 
 void sendmailTransport::internalDisconnect()
 {
+	if (m_proc)
+	{
+		ref <utility::childProcess> proc = m_proc;
+		m_proc = NULL;
+
+		try
+		{
+			proc->waitForFinish();
+		}
+		catch (vmime::exception&)
+		{
+			// Ignore
+		}
+	}
+
 	m_connected = false;
 }
 
 
 void sendmailTransport::noop()
 {
-	// Do nothing
+	if (m_proc)
+		sendCommand("NOOP", 250);
 }
 
 
@@ -144,6 +212,28 @@ void sendmailTransport::send
 	else if (expeditor.isEmpty())
 		throw exceptions::no_expeditor();
 
+	// Batch mode: send message using the running sendmail process
+	if (m_proc)
+	{
+		try
+		{
+			internalSendBatch(expeditor, recipients, is, size, progress);
+		}
+		catch (exceptions::command_error&)
+		{
+			throw;
+		}
+		catch (vmime::exception& e)
+		{
+			// The process is in an unknown state
+			internalDisconnect();
+
+			throw exceptions::command_error("SEND", "", "sendmail failed", e);
+		}
+
+		return;
+	}
+
 	// Construct the argument list
 	std::vector <string> args;
 
@@ -192,11 +282,127 @@ void sendmailTransport::internalSend
 
 	utility::bufferedStreamCopy(is, fos, size, progress);
 
+	fos.flush();
+
 	// Wait for sendmail to exit
 	proc->waitForFinish();
 }
 
 
+void sendmailTransport::internalSendBatch
+	(const mailbox& expeditor, const mailboxList& recipients,
+	 utility::inputStream& is, const utility::stream::size_type size,
+	 utility::progressListener* progress)
+{
+	sendCommand("MAIL FROM:<" + expeditor.getEmail() + ">", 250);
+
+	for (int i = 0 ; i < recipients.getMailboxCount() ; ++i)
+		sendCommand("RCPT TO:<" + recipients.getMailboxAt(i)->getEmail() + ">", 250);
+
+	sendCommand("DATA", 354);
+
+	// Copy message data from input stream to output pipe
+	utility::outputStream& os = *(m_proc->getStdIn());
+	utility::dotFilteredOutputStream fos(os);
+
+	utility::bufferedStreamCopy(is, fos, size, progress);
+
+	os.write("\r\n.\r\n", 5);
+	os.flush();
+
+	string response;
+
+	if (readResponse(response) / 100 != 2)
+		throw exceptions::command_error("DATA", response);
+}
+
+
+void sendmailTransport::sendRequest(const string& buffer)
+{
+	utility::outputStream& os = *(m_proc->getStdIn());
+
+	os.write(buffer.data(), buffer.length());
+	os.write("\r\n", 2);
+	os.flush();
+}
+
+
+int sendmailTransport::readResponse(string& text)
+{
+	text.clear();
+
+	while (true)
+	{
+		// Read a full line
+		string::size_type eol;
+
+		while ((eol = m_responseBuffer.find('\n')) == string::npos)
+		{
+			utility::stream::value_type buffer[1024];
+			const utility::stream::size_type n =
+				m_proc->getStdOut()->read(buffer, sizeof(buffer));
+
+			if (n == 0)
+				throw exceptions::connection_error("Sendmail process terminated.");
+
+			m_responseBuffer.append(buffer, n);
+		}
+
+		string line(m_responseBuffer, 0, eol);
+		m_responseBuffer.erase(0, eol + 1);
+
+		if (!line.empty() && line[line.length() - 1] == '\r')
+			line.erase(line.length() - 1);
+
+		if (!text.empty())
+			text += '\n';
+
+		text += line;
+
+		// Response lines are "<code>[ -]<text>": the last line of
+		// a multi-line response has a space after the code
+		if (line.length() < 3 ||
+		    !parserHelpers::isDigit(line[0]) ||
+		    !parserHelpers::isDigit(line[1]) ||
+		    !parserHelpers::isDigit(line[2]))
+		{
+			throw exceptions::invalid_response("", text);
+		}
+
+		if (line.length() == 3 || line[3] != '-')
+		{
+			return (line[0] - '0') * 100 + (line[1] - '0') * 10 + (line[2] - '0');
+		}
+	}
+}
+
+
+void sendmailTransport::sendCommand(const string& command, const int expectedCode)
+{
+	sendRequest(command);
+
+	string response;
+
+	if (readResponse(response) / 100 != expectedCode / 100)
+	{
+		// Abort the current transaction, if any
+		try
+		{
+			string rsetResponse;
+
+			sendRequest("RSET");
+			readResponse(rsetResponse);
+		}
+		catch (vmime::exception&)
+		{
+			// Ignore
+		}
+
+		throw exceptions::command_error(command, response);
+	}
+}
+
+
 // Service infos
 
 sendmailServiceInfos sendmailTransport::sm_infos;
@@ -0,0 +1,401 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/net/servicePool.hpp"
+#include "vmime/net/serviceFactory.hpp"
+
+#include "vmime/platform.hpp"
+#include "vmime/exception.hpp"
+
+#include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+
+namespace vmime {
+namespace net {
+
+
+servicePool::servicePool()
+	: m_maxIdleCount(4), m_maxConnectionsPerHost(0),
+	  m_connectCount(0), m_reuseCount(0)
+{
+	m_cond = platform::getHandler()->createCondition();
+}
+
+
+servicePool::~servicePool()
+{
+	clear();
+}
+
+
+// static
+const string servicePool::makeKey(const utility::url& url,
+	ref <security::authenticator> auth, const propertySet& props)
+{
+	std::ostringstream key;
+	key << static_cast <string>(url);
+
+	// Services using different authenticator objects may not
+	// authenticate with the same credentials
+	if (auth)
+		key << '#' << static_cast <const void*>(auth.get());
+
+	// The service is created on a copy of the session, so it gets the
+	// session properties: default credentials, TLS and connection
+	// settings. Services are only shared by sessions which have the
+	// same properties. Lengths are written before names and values so
+	// that different property sets cannot give the same key.
+	const std::vector <ref <const propertySet::property> > propList = props.getPropertyList();
+
+	std::vector <string> propKeys;
+	propKeys.reserve(propList.size());
+
+	for (unsigned int i = 0 ; i < propList.size() ; ++i)
+	{
+		const string name = utility::stringUtils::toLower(propList[i]->getName());
+		const string& value = propList[i]->getValue();
+
+		std::ostringstream propKey;
+		propKey << name.length() << ':' << name << value.length() << ':' << value;
+
+		propKeys.push_back(propKey.str());
+	}
+
+	std::sort(propKeys.begin(), propKeys.end());
+
+	for (unsigned int i = 0 ; i < propKeys.size() ; ++i)
+		key << '#' << propKeys[i];
+
+	return key.str();
+}
+
+
+// static
+const string servicePool::makeHostKey(const utility::url& url)
+{
+	std::ostringstream key;
+	key << utility::stringUtils::toLower(url.getProtocol()) << "://"
+	    << utility::stringUtils::toLower(url.getHost()) << ':' << url.getPort();
+
+	return key.str();
+}
+
+
+// static
+void servicePool::closeService(ref <service> serv)
+{
+	try
+	{
+		if (serv->isConnected())
+			serv->disconnect();
+	}
+	catch (exception&)
+	{
+		// Ignore
+	}
+}
+
+
+ref <service> servicePool::removeIdleForHost(const string& hostKey)
+{
+	for (std::map <string, std::vector <idleService> >::iterator it = m_idle.begin() ;
+	     it != m_idle.end() ; ++it)
+	{
+		std::vector <idleService>& idle = it->second;
+
+		for (std::vector <idleService>::iterator jt = idle.begin() ; jt != idle.end() ; ++jt)
+		{
+			if (jt->hostKey == hostKey)
+			{
+				ref <service> serv = jt->serv;
+				idle.erase(jt);
+
+				return serv;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+ref <service> servicePool::acquire(ref <session> sess, const utility::url& url,
+	ref <security::authenticator> auth, const service::Type type)
+{
+	const string key = makeKey(url, auth, sess->getProperties());
+	const string hostKey = makeHostKey(url);
+
+	while (true)
+	{
+		ref <service> serv;
+		ref <service> evicted;
+
+		{
+			utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+			while (true)
+			{
+				std::map <string, std::vector <idleService> >::iterator it = m_idle.find(key);
+
+				if (it != m_idle.end() && !it->second.empty())
+				{
+					serv = it->second.back().serv;
+					it->second.pop_back();
+
+					break;
+				}
+
+				unsigned int& count = m_hostConnections[hostKey];
+
+				if (m_maxConnectionsPerHost == 0 || count < m_maxConnectionsPerHost)
+				{
+					// Reserve a connection slot
+					++count;
+					break;
+				}
+
+				// Close an idle connection to this server, which is not
+				// usable for this URL (its slot is reused for the new
+				// connection), or wait for one to be released
+				if ((evicted = removeIdleForHost(hostKey)) != NULL)
+					break;
+
+				m_cond->wait();
+			}
+
+			if (serv)
+			{
+				lentService lent;
+				lent.key = key;
+				lent.hostKey = hostKey;
+
+				m_lent[serv.get()] = lent;
+			}
+		}
+
+		if (evicted)
+			closeService(evicted);
+
+		if (serv)
+		{
+			// Make sure the connection is still alive
+			try
+			{
+				if (serv->isConnected())
+				{
+					serv->noop();
+
+					utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+					++m_reuseCount;
+
+					return serv;
+				}
+			}
+			catch (exception&)
+			{
+				// Connection is broken
+			}
+
+			{
+				utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+				m_lent.erase(serv.get());
+				--m_hostConnections[hostKey];
+
+				m_cond->notifyAll();
+			}
+
+			closeService(serv);
+
+			// Try another one
+			continue;
+		}
+
+		// Create and connect a new service, outside of the lock as this
+		// is the expensive part; the service gets its own copy of the
+		// session so that its properties are not changed by other URLs
+		try
+		{
+			ref <session> servSess = vmime::create <session>(*sess);
+
+			serv = serviceFactory::getInstance()->create(servSess, url, auth);
+
+			if (serv->getType() != type)
+				throw exceptions::no_service_available();
+
+			serv->connect();
+		}
+		catch (...)
+		{
+			utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+			--m_hostConnections[hostKey];
+			m_cond->notifyAll();
+
+			throw;
+		}
+
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		lentService lent;
+		lent.key = key;
+		lent.hostKey = hostKey;
+
+		m_lent[serv.get()] = lent;
+
+		++m_connectCount;
+
+		return serv;
+	}
+}
+
+
+void servicePool::release(ref <service> serv)
+{
+	if (!serv)
+		return;
+
+	bool keep = false;
+
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		std::map <const service*, lentService>::iterator it = m_lent.find(serv.get());
+
+		if (it == m_lent.end())
+			return;  // not obtained from this pool
+
+		const lentService lent = it->second;
+		m_lent.erase(it);
+
+		std::vector <idleService>& idle = m_idle[lent.key];
+
+		if (idle.size() < m_maxIdleCount && serv->isConnected())
+		{
+			idleService entry;
+			entry.serv = serv;
+			entry.hostKey = lent.hostKey;
+
+			idle.push_back(entry);
+
+			keep = true;
+		}
+		else
+		{
+			--m_hostConnections[lent.hostKey];
+		}
+
+		m_cond->notifyAll();
+	}
+
+	if (!keep)
+		closeService(serv);
+}
+
+
+void servicePool::clear()
+{
+	std::map <string, std::vector <idleService> > idle;
+
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+		idle.swap(m_idle);
+
+		for (std::map <string, std::vector <idleService> >::const_iterator it = idle.begin() ;
+		     it != idle.end() ; ++it)
+		{
+			for (unsigned int i = 0 ; i < it->second.size() ; ++i)
+				--m_hostConnections[it->second[i].hostKey];
+		}
+
+		m_cond->notifyAll();
+	}
+
+	for (std::map <string, std::vector <idleService> >::iterator it = idle.begin() ;
+	     it != idle.end() ; ++it)
+	{
+		for (unsigned int i = 0 ; i < it->second.size() ; ++i)
+			closeService(it->second[i].serv);
+	}
+}
+
+
+void servicePool::setMaxIdleCount(const unsigned int count)
+{
+	{
+		utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+		m_maxIdleCount = count;
+	}
+
+	clear();
+}
+
+
+unsigned int servicePool::getMaxIdleCount() const
+{
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	return m_maxIdleCount;
+}
+
+
+void servicePool::setMaxConnectionsPerHost(const unsigned int count)
+{
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	m_maxConnectionsPerHost = count;
+	m_cond->notifyAll();
+}
+
+
+unsigned int servicePool::getMaxConnectionsPerHost() const
+{
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	return m_maxConnectionsPerHost;
+}
+
+
+unsigned long servicePool::getConnectCount() const
+{
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	return m_connectCount;
+}
+
+
+unsigned long servicePool::getReuseCount() const
+{
+	utility::sync::autoLock <utility::sync::condition> lock(m_cond);
+
+	return m_reuseCount;
+}
+
+
+} // net
+} // vmime
@@ -23,6 +23,7 @@
 
 #include "vmime/net/session.hpp"
 #include "vmime/net/serviceFactory.hpp"
+#include "vmime/net/servicePool.hpp"
 
 #include "vmime/net/store.hpp"
 #include "vmime/net/transport.hpp"
@@ -118,6 +119,59 @@ ref <store> session::getStore
 }
 
 
+void session::setServicePool(ref <servicePool> pool)
+{
+	m_pool = pool;
+}
+
+
+ref <servicePool> session::getServicePool()
+{
+	return m_pool;
+}
+
+
+ref <transport> session::acquireTransport
+	(const utility::url& url, ref <security::authenticator> auth)
+{
+	if (m_pool)
+	{
+		ref <session> sess = thisRef().dynamicCast <session>();
+		return m_pool->acquire(sess, url, auth, service::TYPE_TRANSPORT).staticCast <transport>();
+	}
+
+	ref <transport> tr = getTransport(url, auth);
+	tr->connect();
+
+	return tr;
+}
+
+
+ref <store> session::acquireStore
+	(const utility::url& url, ref <security::authenticator> auth)
+{
+	if (m_pool)
+	{
+		ref <session> sess = thisRef().dynamicCast <session>();
+		return m_pool->acquire(sess, url, auth, service::TYPE_STORE).staticCast <store>();
+	}
+
+	ref <store> st = getStore(url, auth);
+	st->connect();
+
+	return st;
+}
+
+
+void session::releaseService(ref <service> serv)
+{
+	if (m_pool)
+		m_pool->release(serv);
+	else if (serv->isConnected())
+		serv->disconnect();
+}
+
+
 const propertySet& session::getProperties() const
 {
 	return (m_props);
@@ -30,6 +30,7 @@
 
 #include "vmime/utility/filteredStream.hpp"
 #include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/instrumentation.hpp"
 #include "vmime/utility/outputStreamSocketAdapter.hpp"
 #include "vmime/utility/streamUtils.hpp"
 
@@ -41,6 +42,7 @@
 
 #if VMIME_HAVE_TLS_SUPPORT
 	#include "vmime/net/tls/TLSSession.hpp"
+	#include "vmime/net/tls/TLSSessionCache.hpp"
 	#include "vmime/net/tls/TLSSecuredConnectionInfos.hpp"
 #endif // VMIME_HAVE_TLS_SUPPORT
 
@@ -110,6 +112,9 @@ void SMTPTransport::connect()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(address, port, getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -459,6 +464,9 @@ void SMTPTransport::startTLS()
 		ref <tls::TLSSession> tlsSession =
 			vmime::create <tls::TLSSession>(getCertificateVerifier());
 
+		tlsSession->setCacheKey(tls::TLSSessionCache::makeKey
+			(m_cntInfos->getHost(), m_cntInfos->getPort(), getProtocolName()));
+
 		ref <tls::TLSSocket> tlsSocket =
 			tlsSession->getSocket(m_socket);
 
@@ -605,10 +613,9 @@ void SMTPTransport::send(const mailbox& expeditor, const mailboxList& recipients
 
 	utility::bufferedStreamCopy(is, fos, size, progress);
 
-	fos.flush();
-
-	// Send end-of-data delimiter
-	m_socket->sendRaw("\r\n.\r\n", 5);
+	// Send end-of-data delimiter along with the last block of data
+	sos.write("\r\n.\r\n", 5);
+	sos.flush();
 
 	if ((resp = readResponse())->getCode() != 250)
 	{
@@ -620,6 +627,8 @@ void SMTPTransport::send(const mailbox& expeditor, const mailboxList& recipients
 
 void SMTPTransport::sendRequest(const string& buffer, const bool end)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_SMTP_COMMANDS);
+
 	if (end)
 		m_socket->send(buffer + "\r\n");
 	else
@@ -629,6 +638,9 @@ void SMTPTransport::sendRequest(const string& buffer, const bool end)
 
 ref <SMTPResponse> SMTPTransport::readResponse()
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_SMTP_RESPONSES);
+	VMIME_INSTRUMENT_TIME(TIMER_SMTP_RESPONSE);
+
 	return SMTPResponse::readResponse(m_socket, m_timeoutHandler);
 }
 
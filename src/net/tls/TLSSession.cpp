@@ -271,6 +271,18 @@ ref <security::cert::certificateVerifier> TLSSession::getCertificateVerifier()
 }
 
 
+void TLSSession::setCacheKey(const string& key)
+{
+	m_cacheKey = key;
+}
+
+
+const string TLSSession::getCacheKey() const
+{
+	return m_cacheKey;
+}
+
+
 void TLSSession::throwTLSException(const string& fname, const int code)
 {
 	std::ostringstream msg;
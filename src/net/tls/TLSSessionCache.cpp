@@ -0,0 +1,177 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/net/tls/TLSSessionCache.hpp"
+
+#include "vmime/utility/stringUtils.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+
+
+namespace vmime {
+namespace net {
+namespace tls {
+
+
+TLSSessionCache::TLSSessionCache()
+	: m_maxEntries(256), m_serial(0), m_hitCount(0), m_missCount(0)
+{
+	m_lock = vmime::create <utility::sync::builtinCriticalSection>();
+}
+
+
+TLSSessionCache* TLSSessionCache::getInstance()
+{
+	static TLSSessionCache instance;
+	return (&instance);
+}
+
+
+// static
+const string TLSSessionCache::makeKey
+	(const string& host, const port_t port, const string& service)
+{
+	return utility::stringUtils::toLower(service) + "://"
+		+ utility::stringUtils::toLower(host) + ":"
+		+ utility::stringUtils::toString(port);
+}
+
+
+bool TLSSessionCache::retrieve(const string& key, string& data) const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	std::map <string, entry>::const_iterator it = m_entries.find(key);
+
+	if (it == m_entries.end())
+		return false;
+
+	data = it->second.data;
+
+	return true;
+}
+
+
+void TLSSessionCache::store(const string& key, const string& data)
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	if (m_maxEntries == 0)
+		return;
+
+	std::map <string, entry>::iterator it = m_entries.find(key);
+
+	if (it == m_entries.end())
+	{
+		// Make room for the new entry
+		if (m_entries.size() >= m_maxEntries)
+			removeOldest();
+
+		it = m_entries.insert(std::map <string, entry>::value_type(key, entry())).first;
+	}
+
+	it->second.data = data;
+	it->second.serial = ++m_serial;
+}
+
+
+void TLSSessionCache::remove(const string& key)
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	m_entries.erase(key);
+}
+
+
+void TLSSessionCache::clear()
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	m_entries.clear();
+}
+
+
+void TLSSessionCache::setMaxEntries(const unsigned int count)
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	m_maxEntries = count;
+
+	while (m_entries.size() > m_maxEntries)
+		removeOldest();
+}
+
+
+unsigned int TLSSessionCache::getMaxEntries() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_maxEntries;
+}
+
+
+unsigned long TLSSessionCache::getHitCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_hitCount;
+}
+
+
+unsigned long TLSSessionCache::getMissCount() const
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	return m_missCount;
+}
+
+
+void TLSSessionCache::removeOldest()
+{
+	std::map <string, entry>::iterator oldest = m_entries.begin();
+
+	for (std::map <string, entry>::iterator it = m_entries.begin() ;
+	     it != m_entries.end() ; ++it)
+	{
+		if (it->second.serial < oldest->second.serial)
+			oldest = it;
+	}
+
+	m_entries.erase(oldest);
+}
+
+
+void TLSSessionCache::registerHandshake(const bool resumed)
+{
+	utility::sync::autoLock <utility::sync::criticalSection> lock(m_lock);
+
+	if (resumed)
+		++m_hitCount;
+	else
+		++m_missCount;
+}
+
+
+} // tls
+} // net
+} // vmime
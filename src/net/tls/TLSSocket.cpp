@@ -26,6 +26,7 @@
 
 #include "vmime/net/tls/TLSSocket.hpp"
 #include "vmime/net/tls/TLSSession.hpp"
+#include "vmime/net/tls/TLSSessionCache.hpp"
 
 #include "vmime/platform.hpp"
 
@@ -81,6 +82,10 @@ void TLSSocket::disconnect()
 {
 	if (m_connected)
 	{
+		// With TLS 1.3, the session ticket is sent by the server
+		// after the handshake: store it now that it has been received
+		storeSessionData();
+
 		gnutls_bye(*m_session->m_gnutlsSession, GNUTLS_SHUT_RDWR);
 
 		m_wrapped->disconnect();
@@ -98,7 +103,7 @@ bool TLSSocket::isConnected() const
 
 TLSSocket::size_type TLSSocket::getBlockSize() const
 {
-	return 16384;  // 16 KB
+	return sizeof(m_sendBuffer);  // maximum TLS record payload (16 KB)
 }
 
 
@@ -138,12 +143,79 @@ TLSSocket::size_type TLSSocket::receiveRaw(char* buffer, const size_type count)
 
 void TLSSocket::sendRaw(const char* buffer, const size_type count)
 {
-	gnutls_record_send
-		(*m_session->m_gnutlsSession,
-		 buffer, static_cast <size_t>(count));
+	size_type size = count;
 
-	if (m_ex)
-		internalThrow();
+	while (size > 0)
+	{
+		// Send at most one full TLS record at a time
+		const ssize_t ret = gnutls_record_send
+			(*m_session->m_gnutlsSession,
+			 buffer, static_cast <size_t>(std::min(size, getBlockSize())));
+
+		if (m_ex)
+			internalThrow();
+
+		if (ret < 0)
+		{
+			if (ret == GNUTLS_E_AGAIN || ret == GNUTLS_E_INTERRUPTED)
+			{
+				platform::getHandler()->wait();
+				continue;
+			}
+
+			TLSSession::throwTLSException("gnutls_record_send", static_cast <int>(ret));
+		}
+
+		buffer += ret;
+		size -= static_cast <size_type>(ret);
+	}
+}
+
+
+void TLSSocket::sendRawMultiple(const char* const* buffers, const size_type* counts, const int bufferCount)
+{
+	// Gather data from small buffers, so that it is sent in full TLS records
+	const size_type recordSize = getBlockSize();
+	size_type pending = 0;
+
+	for (int i = 0 ; i < bufferCount ; ++i)
+	{
+		const char* data = buffers[i];
+		size_type count = counts[i];
+
+		while (count > 0)
+		{
+			if (pending == 0 && count >= recordSize)
+			{
+				// Full records can be sent directly
+				const size_type n = count - count % recordSize;
+
+				sendRaw(data, n);
+
+				data += n;
+				count -= n;
+			}
+			else
+			{
+				const size_type n = std::min(count, recordSize - pending);
+
+				std::copy(data, data + n, m_sendBuffer + pending);
+
+				data += n;
+				count -= n;
+				pending += n;
+
+				if (pending == recordSize)
+				{
+					sendRaw(m_sendBuffer, pending);
+					pending = 0;
+				}
+			}
+		}
+	}
+
+	if (pending != 0)
+		sendRaw(m_sendBuffer, pending);
 }
 
 
@@ -152,6 +224,24 @@ void TLSSocket::handshake(ref <timeoutHandler> toHandler)
 	if (toHandler)
 		toHandler->resetTimeOut();
 
+	// Offer the data of a previous session to the server, so that
+	// it can resume it instead of performing a full handshake
+	const string cacheKey = m_session->getCacheKey();
+
+	if (!cacheKey.empty())
+	{
+		string data;
+
+		if (TLSSessionCache::getInstance()->retrieve(cacheKey, data))
+		{
+			if (gnutls_session_set_data(*m_session->m_gnutlsSession,
+				data.data(), data.length()) < 0)
+			{
+				TLSSessionCache::getInstance()->remove(cacheKey);
+			}
+		}
+	}
+
 	// Start handshaking process
 	m_handshaking = true;
 	m_toHandler = toHandler;
@@ -190,6 +280,9 @@ void TLSSocket::handshake(ref <timeoutHandler> toHandler)
 		m_handshaking = false;
 		m_toHandler = NULL;
 
+		if (!cacheKey.empty())
+			TLSSessionCache::getInstance()->remove(cacheKey);
+
 		throw;
 	}
 
@@ -197,14 +290,62 @@ void TLSSocket::handshake(ref <timeoutHandler> toHandler)
 	m_toHandler = NULL;
 
 	// Verify server's certificate(s)
-	ref <security::cert::certificateChain> certs = getPeerCertificates();
+	try
+	{
+		ref <security::cert::certificateChain> certs = getPeerCertificates();
 
-	if (certs == NULL)
-		throw exceptions::tls_exception("No peer certificate.");
+		if (certs == NULL)
+			throw exceptions::tls_exception("No peer certificate.");
+
+		m_session->getCertificateVerifier()->verify(certs);
+	}
+	catch (...)
+	{
+		if (!cacheKey.empty())
+			TLSSessionCache::getInstance()->remove(cacheKey);
 
-	m_session->getCertificateVerifier()->verify(certs);
+		throw;
+	}
 
 	m_connected = true;
+
+	if (!cacheKey.empty())
+	{
+		TLSSessionCache::getInstance()->registerHandshake
+			(gnutls_session_is_resumed(*m_session->m_gnutlsSession) != 0);
+
+		storeSessionData();
+	}
+}
+
+
+void TLSSocket::storeSessionData()
+{
+	const string cacheKey = m_session->getCacheKey();
+
+	if (cacheKey.empty())
+		return;
+
+#if GNUTLS_VERSION_NUMBER >= 0x030603
+	// With TLS 1.3, resumption data is only available once the server
+	// has sent a session ticket (gnutls_session_get_data2() would
+	// otherwise wait for it)
+	if (gnutls_protocol_get_version(*m_session->m_gnutlsSession) == GNUTLS_TLS1_3 &&
+	    !(gnutls_session_get_flags(*m_session->m_gnutlsSession) & GNUTLS_SFLAGS_SESSION_TICKET))
+	{
+		return;
+	}
+#endif // GNUTLS_VERSION_NUMBER >= 0x030603
+
+	gnutls_datum_t data;
+
+	if (gnutls_session_get_data2(*m_session->m_gnutlsSession, &data) < 0)
+		return;
+
+	TLSSessionCache::getInstance()->store
+		(cacheKey, string(reinterpret_cast <const char*>(data.data), data.size));
+
+	gnutls_free(data.data);
 }
 
 
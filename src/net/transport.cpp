@@ -26,9 +26,7 @@
 #include "vmime/utility/stream.hpp"
 #include "vmime/mailboxList.hpp"
 #include "vmime/message.hpp"
-
-#include "vmime/utility/outputStreamAdapter.hpp"
-#include "vmime/utility/inputStreamStringAdapter.hpp"
+#include "vmime/componentInputStream.hpp"
 
 
 namespace vmime {
@@ -111,18 +109,12 @@ void transport::send(ref <vmime::message> msg, utility::progressListener* progre
 	}
 	catch (exceptions::no_such_field&) { }
 
-	// Generate the message, "stream" it and delegate the sending
-	// to the generic send() function.
-	std::ostringstream oss;
-	utility::outputStreamAdapter ossAdapter(oss);
-
-	msg->generate(ossAdapter);
-
-	const string& str(oss.str());
-
-	utility::inputStreamStringAdapter isAdapter(str);
+	// Generate the message while it is being sent, and delegate
+	// the sending to the generic send() function. The size is only
+	// used for progress notification, so it is not computed in advance.
+	componentInputStream cis(msg, options::getInstance()->message.maxLineLength());
 
-	send(expeditor, recipients, isAdapter, str.length(), progress);
+	send(expeditor, recipients, cis, 0, progress);
 }
 
 
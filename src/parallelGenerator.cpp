@@ -0,0 +1,279 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/parallelGenerator.hpp"
+#include "vmime/body.hpp"
+#include "vmime/platform.hpp"
+
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/sync/autoLock.hpp"
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+
+
+namespace vmime
+{
+
+
+#ifndef VMIME_BUILDING_DOC
+
+/** Encodes leaf contents, until there are no more leaves to encode.
+  * The same task is run by all threads.
+  */
+class parallelGenerator::encodingTask : public utility::sync::runnable
+{
+public:
+
+	encodingTask(parallelGenerator* gen)
+		: m_gen(gen)
+	{
+	}
+
+	void run()
+	{
+		while (true)
+		{
+			std::vector <leaf>::size_type index;
+
+			{
+				utility::sync::autoLock <utility::sync::criticalSection> lock(m_gen->m_lock);
+
+				if (m_gen->m_nextLeaf >= m_gen->m_leaves.size())
+					return;
+
+				index = m_gen->m_nextLeaf++;
+			}
+
+			leaf& l = m_gen->m_leaves[index];
+
+			try
+			{
+				utility::outputStreamStringAdapter os(l.data);
+				l.contents->generate(os, l.enc, m_gen->m_maxLineLength);
+
+				l.encoded = true;
+			}
+			catch (...)
+			{
+				// Contents will be generated again when laying out the
+				// data, so that the exception is thrown to the caller
+				string().swap(l.data);
+			}
+		}
+	}
+
+private:
+
+	parallelGenerator* m_gen;
+};
+
+
+/** Collects generated data into segments, between the contents of
+  * leaf parts encoded in advance.
+  */
+class parallelGenerator::layoutOutputStream : public utility::outputStream
+{
+public:
+
+	layoutOutputStream(parallelGenerator* gen)
+		: m_gen(gen)
+	{
+		nextSegment();
+	}
+
+	void write(const value_type* const data, const size_type count)
+	{
+		m_gen->m_segments.back().data.append(data, count);
+	}
+
+	void flush()
+	{
+		// Nothing to do
+	}
+
+	bool insertContents(const body& b)
+	{
+		std::map <const body*, int>::const_iterator it = m_gen->m_leafIndexes.find(&b);
+
+		if (it == m_gen->m_leafIndexes.end() || !m_gen->m_leaves[it->second].encoded)
+			return false;
+
+		m_gen->m_segments.back().leafIndex = it->second;
+		nextSegment();
+
+		return true;
+	}
+
+private:
+
+	void nextSegment()
+	{
+		segment seg;
+		seg.leafIndex = -1;
+
+		m_gen->m_segments.push_back(seg);
+	}
+
+	parallelGenerator* m_gen;
+};
+
+#endif // VMIME_BUILDING_DOC
+
+
+
+parallelGenerator::parallelGenerator(ref <const bodyPart> root, const string::size_type maxLineLength)
+	: m_root(root), m_maxLineLength(maxLineLength), m_prepared(false), m_nextLeaf(0)
+{
+	m_lock = vmime::create <utility::sync::builtinCriticalSection>();
+}
+
+
+parallelGenerator::~parallelGenerator()
+{
+}
+
+
+void parallelGenerator::prepare(const unsigned int threadCount)
+{
+	m_prepared = false;
+
+	m_leaves.clear();
+	m_segments.clear();
+	m_leafIndexes.clear();
+
+	// Find leaf parts and encode their contents
+	std::set <const contentHandler*> handlers;
+	findLeaves(m_root, handlers);
+
+	std::vector <ref <utility::sync::thread> > threads;
+	ref <encodingTask> task = vmime::create <encodingTask>(this);
+
+	m_nextLeaf = 0;
+
+	for (unsigned int i = 1 ; i < threadCount && i < m_leaves.size() ; ++i)
+	{
+		try
+		{
+			threads.push_back(platform::getHandler()->createThread(task));
+		}
+		catch (exceptions::system_error&)
+		{
+			// Continue with the threads already started
+			break;
+		}
+	}
+
+	// The calling thread also takes part in encoding
+	task->run();
+
+	for (std::vector <ref <utility::sync::thread> >::size_type i = 0 ; i < threads.size() ; ++i)
+		threads[i]->join();
+
+	// Lay out generated data: body::generateImpl() will insert the
+	// contents encoded in advance
+	layoutOutputStream os(this);
+	m_root->generate(os, m_maxLineLength);
+
+	m_prepared = true;
+}
+
+
+void parallelGenerator::findLeaves(ref <const bodyPart> part, std::set <const contentHandler*>& handlers)
+{
+	ref <const body> b = part->getBody();
+
+	if (b->getPartCount() != 0)
+	{
+		for (int i = 0 ; i < b->getPartCount() ; ++i)
+			findLeaves(b->getPartAt(i), handlers);
+	}
+	else
+	{
+		// If the same contents are shared by several parts, they cannot be read
+		// concurrently: they will be generated when laying out the data
+		if (handlers.insert(b->getContents().get()).second)
+		{
+			leaf l;
+			l.contents = b->getContents();
+			l.enc = b->getEncoding();
+			l.encoded = false;
+
+			m_leafIndexes[b.get()] = static_cast <int>(m_leaves.size());
+			m_leaves.push_back(l);
+		}
+	}
+}
+
+
+utility::stream::size_type parallelGenerator::getGeneratedSize()
+{
+	if (!m_prepared)
+		prepare(1);
+
+	utility::stream::size_type size = 0;
+
+	for (std::vector <segment>::const_iterator it = m_segments.begin() ; it != m_segments.end() ; ++it)
+	{
+		size += (*it).data.length();
+
+		if ((*it).leafIndex >= 0)
+			size += m_leaves[(*it).leafIndex].data.length();
+	}
+
+	return size;
+}
+
+
+void parallelGenerator::generate(utility::outputStream& os)
+{
+	if (!m_prepared)
+		prepare(1);
+
+	for (std::vector <segment>::const_iterator it = m_segments.begin() ; it != m_segments.end() ; ++it)
+	{
+		if (!(*it).data.empty())
+			os.write((*it).data.data(), (*it).data.length());
+
+		if ((*it).leafIndex >= 0)
+		{
+			const string& data = m_leaves[(*it).leafIndex].data;
+
+			if (!data.empty())
+				os.write(data.data(), data.length());
+		}
+	}
+}
+
+
+// static
+bool parallelGenerator::generateEncodedContents(utility::outputStream& os, const body& b)
+{
+	layoutOutputStream* los = dynamic_cast <layoutOutputStream*>(&os);
+
+	if (los == NULL)
+		return false;
+
+	return los->insertContents(b);
+}
+
+
+} // vmime
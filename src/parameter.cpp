@@ -580,5 +580,11 @@ const std::vector <ref <component> > parameter::getChildComponents()
 }
 
 
+bool parameter::visitChildComponentsImpl(childVisitor& v)
+{
+	return v.visit(*m_value);
+}
+
+
 } // vmime
 
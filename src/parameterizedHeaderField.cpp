@@ -86,13 +86,9 @@ void parameterizedHeaderField::parseImpl(const string& buffer, const string::siz
 	const string::value_type* p = pstart;
 
 	// Skip non-significant whitespaces
-	string::size_type valueStart = position;
+	p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
-	while (p < pend && parserHelpers::isSpace(*p))
-	{
-		++p;
-		++valueStart;
-	}
+	string::size_type valueStart = position + (p - pstart);
 
 	// Advance up to ';', if any
 	string::size_type valueLength = 0;
@@ -123,7 +119,7 @@ void parameterizedHeaderField::parseImpl(const string& buffer, const string::siz
 			// Skip ';'
 			++p;
 
-			while (p < pend && parserHelpers::isSpace(*p)) ++p;
+			p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 			const string::size_type attrStart = position + (p - pstart);
 
@@ -150,7 +146,7 @@ void parameterizedHeaderField::parseImpl(const string& buffer, const string::siz
 				++p;
 
 				// Skip white-spaces between '=' and the value
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 
 				// Extract the value
 				string value;
@@ -304,7 +300,7 @@ void parameterizedHeaderField::parseImpl(const string& buffer, const string::siz
 				}
 
 				// Skip white-spaces after this parameter
-				while (p < pend && parserHelpers::isSpace(*p)) ++p;
+				p = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(p, pend);
 			}
 		}
 
@@ -566,5 +562,12 @@ const std::vector <ref <component> > parameterizedHeaderField::getChildComponent
 }
 
 
+bool parameterizedHeaderField::visitChildComponentsImpl(childVisitor& v)
+{
+	return headerField::visitChildComponentsImpl(v) &&
+	       visitComponents(m_params, v);
+}
+
+
 } // vmime
 
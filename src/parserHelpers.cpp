@@ -0,0 +1,64 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/parserHelpers.hpp"
+
+
+namespace vmime
+{
+
+
+// Classes of a character, as a constant expression
+#define VMIME_CHAR_CLASS(c) static_cast <unsigned char>( \
+	((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n' ? parserHelpers::CHAR_CLASS_SPACE : 0) | \
+	((c) == ' ' || (c) == '\t' ? parserHelpers::CHAR_CLASS_BLANK : 0) | \
+	((c) >= '0' && (c) <= '9' ? parserHelpers::CHAR_CLASS_DIGIT : 0) | \
+	(((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') ? parserHelpers::CHAR_CLASS_ALPHA : 0) | \
+	((c) == '\r' || (c) == '\n' ? parserHelpers::CHAR_CLASS_EOL : 0) | \
+	((c) == ':' ? parserHelpers::CHAR_CLASS_COLON : 0) | \
+	((c) == '=' ? parserHelpers::CHAR_CLASS_EQUAL : 0) | \
+	((c) == '?' ? parserHelpers::CHAR_CLASS_QUESTION : 0))
+
+#define VMIME_CHAR_CLASS_4(c) \
+	VMIME_CHAR_CLASS(c), VMIME_CHAR_CLASS(c + 1), VMIME_CHAR_CLASS(c + 2), VMIME_CHAR_CLASS(c + 3)
+#define VMIME_CHAR_CLASS_16(c) \
+	VMIME_CHAR_CLASS_4(c), VMIME_CHAR_CLASS_4(c + 4), VMIME_CHAR_CLASS_4(c + 8), VMIME_CHAR_CLASS_4(c + 12)
+#define VMIME_CHAR_CLASS_64(c) \
+	VMIME_CHAR_CLASS_16(c), VMIME_CHAR_CLASS_16(c + 16), VMIME_CHAR_CLASS_16(c + 32), VMIME_CHAR_CLASS_16(c + 48)
+
+
+// static
+const unsigned char parserHelpers::charClassTable[256] =
+{
+	VMIME_CHAR_CLASS_64(0), VMIME_CHAR_CLASS_64(64),
+	VMIME_CHAR_CLASS_64(128), VMIME_CHAR_CLASS_64(192)
+};
+
+
+#undef VMIME_CHAR_CLASS_64
+#undef VMIME_CHAR_CLASS_16
+#undef VMIME_CHAR_CLASS_4
+#undef VMIME_CHAR_CLASS
+
+
+} // vmime
@@ -112,6 +112,12 @@ const std::vector <ref <component> > path::getChildComponents()
 }
 
 
+bool path::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 void path::parseImpl(const string& buffer, const string::size_type position,
 	const string::size_type end, string::size_type* newPosition)
 {
@@ -23,6 +23,8 @@
 
 #include "vmime/platform.hpp"
 
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+
 
 namespace vmime
 {
@@ -36,4 +38,32 @@ platform::handler::~handler()
 }
 
 
+ref <utility::sync::criticalSection> platform::handler::createCriticalSection()
+{
+	return vmime::create <utility::sync::builtinCriticalSection>();
+}
+
+
+ref <utility::sync::condition> platform::handler::createCondition()
+{
+	throw exceptions::system_error("Conditions are not supported by the platform handler");
+}
+
+
+ref <utility::sync::thread> platform::handler::createThread(ref <utility::sync::runnable> /* task */)
+{
+	throw exceptions::system_error("Threads are not supported by the platform handler");
+}
+
+
+#if VMIME_HAVE_FILESYSTEM_FEATURES
+
+const utility::file::path platform::handler::getTemporaryDirectory()
+{
+	throw exceptions::system_error("Temporary directory is not known to the platform handler");
+}
+
+#endif
+
+
 } // vmime
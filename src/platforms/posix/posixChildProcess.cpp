@@ -34,6 +34,9 @@
 #include <fcntl.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 
 
 namespace vmime {
@@ -103,34 +106,96 @@ static const string getPosixErrorMessage(const int num)
 }
 
 
-// Output stream adapter for POSIX pipe
+// Output stream adapter for POSIX pipe. Data is buffered, so that
+// small writes do not result in one system call each.
 
 class outputStreamPosixPipeAdapter : public utility::outputStream
 {
 public:
 
 	outputStreamPosixPipeAdapter(const int desc)
-		: m_desc(desc)
+		: m_desc(desc), m_bufferLength(0)
 	{
 	}
 
 	void write(const value_type* const data, const size_type count)
 	{
-		if (::write(m_desc, data, count) == -1)
+		if (m_bufferLength + count <= sizeof(m_buffer))
 		{
-			const string errorMsg = getPosixErrorMessage(errno);
-			throw exceptions::system_error(errorMsg);
+			std::copy(data, data + count, m_buffer + m_bufferLength);
+			m_bufferLength += count;
+		}
+		else
+		{
+			// Write buffered data and new data with a single call
+			struct iovec iov[2];
+
+			iov[0].iov_base = m_buffer;
+			iov[0].iov_len = m_bufferLength;
+			iov[1].iov_base = const_cast <value_type*>(data);
+			iov[1].iov_len = count;
+
+			writeAll(iov, 2);
+
+			m_bufferLength = 0;
 		}
 	}
 
 	void flush()
 	{
-		::fsync(m_desc);
+		if (m_bufferLength != 0)
+		{
+			struct iovec iov;
+
+			iov.iov_base = m_buffer;
+			iov.iov_len = m_bufferLength;
+
+			writeAll(&iov, 1);
+
+			m_bufferLength = 0;
+		}
 	}
 
 private:
 
+	void writeAll(struct iovec* iov, int count)
+	{
+		while (count > 0)
+		{
+			const ssize_t ret = ::writev(m_desc, iov, count);
+
+			if (ret == -1)
+			{
+				if (errno == EINTR)
+					continue;
+
+				const string errorMsg = getPosixErrorMessage(errno);
+				throw exceptions::system_error(errorMsg);
+			}
+
+			// Skip data which has been written
+			size_t written = static_cast <size_t>(ret);
+
+			while (count > 0 && written >= iov->iov_len)
+			{
+				written -= iov->iov_len;
+				++iov;
+				--count;
+			}
+
+			if (count > 0)
+			{
+				iov->iov_base = static_cast <char*>(iov->iov_base) + written;
+				iov->iov_len -= written;
+			}
+		}
+	}
+
+
 	const int m_desc;
+
+	value_type m_buffer[16384];
+	size_type m_bufferLength;
 };
 
 
@@ -141,7 +206,7 @@ class inputStreamPosixPipeAdapter : public utility::inputStream
 public:
 
 	inputStreamPosixPipeAdapter(const int desc)
-		: m_desc(desc)
+		: m_desc(desc), m_eof(false)
 	{
 	}
 
@@ -182,7 +247,10 @@ public:
 	{
 		int bytesRead = 0;
 
-		if ((bytesRead = ::read(m_desc, data, count)) == -1)
+		while ((bytesRead = ::read(m_desc, data, count)) == -1 && errno == EINTR)
+			;
+
+		if (bytesRead == -1)
 		{
 			const string errorMsg = getPosixErrorMessage(errno);
 			throw exceptions::system_error(errorMsg);
@@ -211,8 +279,8 @@ posixChildProcess::posixChildProcess(const utility::file::path& path)
 	: m_processPath(path), m_started(false),
 	  m_stdIn(NULL), m_stdOut(NULL), m_pid(0), m_argArray(NULL)
 {
-	m_pipe[0] = 0;
-	m_pipe[1] = 0;
+	m_stdInPipe[0] = m_stdInPipe[1] = -1;
+	m_stdOutPipe[0] = m_stdOutPipe[1] = -1;
 
 	sigemptyset(&m_oldProcMask);
 }
@@ -220,14 +288,11 @@ posixChildProcess::posixChildProcess(const utility::file::path& path)
 
 posixChildProcess::~posixChildProcess()
 {
-	if (m_started)
-		sigprocmask(SIG_SETMASK, &m_oldProcMask, NULL);
-
-	if (m_pipe[0] != 0)
-		close(m_pipe[0]);
+	if (m_stdInPipe[1] != -1)
+		close(m_stdInPipe[1]);
 
-	if (m_pipe[1] != 0)
-		close(m_pipe[1]);
+	if (m_stdOutPipe[0] != -1)
+		close(m_stdOutPipe[0]);
 
 	delete [] (m_argArray);
 }
@@ -256,19 +321,29 @@ void posixChildProcess::start(const std::vector <string> args, const int flags)
 	for (unsigned int i = 0 ; i < m_argVector.size() ; ++i)
 		argv[i + 1] = m_argVector[i].c_str();
 
-	// Create a pipe to communicate with the child process
-	int fd[2];
+	// Create pipes to communicate with the child process: one
+	// for its standard input and one for its standard output
+	int inFd[2] = { -1, -1 };
+	int outFd[2] = { -1, -1 };
 
-	if (pipe(fd) == -1)
+	if (((flags & FLAG_REDIRECT_STDIN) && pipe(inFd) == -1) ||
+	    ((flags & FLAG_REDIRECT_STDOUT) && pipe(outFd) == -1))
 	{
-		throw exceptions::system_error(getPosixErrorMessage(errno));
-	}
+		const string errorMsg = getPosixErrorMessage(errno);
+
+		if (inFd[0] != -1)
+		{
+			close(inFd[0]);
+			close(inFd[1]);
+		}
 
-	m_pipe[0] = fd[0];
-	m_pipe[1] = fd[1];
+		throw exceptions::system_error(errorMsg);
+	}
 
-	// Block SIGCHLD so the calling application doesn't notice
-	// process exiting before we do
+	// Block SIGCHLD while the process is being spawned. The signal
+	// mask is restored right after fork(), in both processes, so that
+	// it is not changed for the lifetime of a long-running process
+	// (eg. "sendmail -bs" in batch mode), nor inherited by the child.
 	sigset_t mask;
 
 	sigemptyset(&mask);
@@ -284,22 +359,33 @@ void posixChildProcess::start(const std::vector <string> args, const int flags)
 
 		sigprocmask(SIG_SETMASK, &m_oldProcMask, NULL);
 
-		close(fd[0]);
-		close(fd[1]);
+		for (int i = 0 ; i < 2 ; ++i)
+		{
+			if (inFd[i] != -1) close(inFd[i]);
+			if (outFd[i] != -1) close(outFd[i]);
+		}
 
 		throw exceptions::system_error(errorMsg);
 	}
 	else if (pid == 0)  // child process
 	{
+		sigprocmask(SIG_SETMASK, &m_oldProcMask, NULL);
+
 		if (flags & FLAG_REDIRECT_STDIN)
-			dup2(fd[0], STDIN_FILENO);
-		else
-			close(fd[0]);
+		{
+			dup2(inFd[0], STDIN_FILENO);
+
+			close(inFd[0]);
+			close(inFd[1]);
+		}
 
 		if (flags & FLAG_REDIRECT_STDOUT)
-			dup2(fd[1], STDOUT_FILENO);
-		else
-			close(fd[1]);
+		{
+			dup2(outFd[1], STDOUT_FILENO);
+
+			close(outFd[0]);
+			close(outFd[1]);
+		}
 
 		posixFileSystemFactory* pfsf = new posixFileSystemFactory();
 
@@ -311,24 +397,22 @@ void posixChildProcess::start(const std::vector <string> args, const int flags)
 		_exit(255);
 	}
 
+	sigprocmask(SIG_SETMASK, &m_oldProcMask, NULL);
+
 	if (flags & FLAG_REDIRECT_STDIN)
 	{
-		m_stdIn = vmime::create <outputStreamPosixPipeAdapter>(m_pipe[1]);
-	}
-	else
-	{
-		close(m_pipe[1]);
-		m_pipe[1] = 0;
+		close(inFd[0]);
+
+		m_stdInPipe[1] = inFd[1];
+		m_stdIn = vmime::create <outputStreamPosixPipeAdapter>(m_stdInPipe[1]);
 	}
 
 	if (flags & FLAG_REDIRECT_STDOUT)
 	{
-		m_stdOut = vmime::create <inputStreamPosixPipeAdapter>(m_pipe[0]);
-	}
-	else
-	{
-		close(m_pipe[0]);
-		m_pipe[0] = 0;
+		close(outFd[1]);
+
+		m_stdOutPipe[0] = outFd[0];
+		m_stdOut = vmime::create <inputStreamPosixPipeAdapter>(m_stdOutPipe[0]);
 	}
 
 	m_pid = pid;
@@ -350,18 +434,38 @@ ref <utility::inputStream> posixChildProcess::getStdOut()
 
 void posixChildProcess::waitForFinish()
 {
-	// Close stdin pipe
-	if (m_pipe[1] != 0)
+	// Send buffered data and close stdin pipe
+	if (m_stdInPipe[1] != -1)
 	{
-		close(m_pipe[1]);
-		m_pipe[1] = 0;
+		try
+		{
+			m_stdIn->flush();
+		}
+		catch (exceptions::system_error&)
+		{
+			// Process has closed its standard input
+		}
+
+		close(m_stdInPipe[1]);
+		m_stdInPipe[1] = -1;
 	}
 
-	int wstat;
+	int wstat = 0;
+	pid_t ret;
 
-	while (waitpid(m_pid, &wstat, 0) == -1 && errno == EINTR)
+	while ((ret = waitpid(m_pid, &wstat, 0)) == -1 && errno == EINTR)
 		;
 
+	if (ret == -1)
+	{
+		// The process has already been waited for by the application
+		// (eg. in a SIGCHLD handler): its exit status is unknown
+		if (errno == ECHILD)
+			return;
+
+		throw exceptions::system_error(getPosixErrorMessage(errno));
+	}
+
 	if (!WIFEXITED(wstat))
 	{
 		throw exceptions::system_error("Process exited with signal "
@@ -0,0 +1,72 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/platforms/posix/posixCondition.hpp"
+
+
+namespace vmime {
+namespace platforms {
+namespace posix {
+
+
+posixCondition::posixCondition()
+{
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_cond_init(&m_cond, NULL);
+}
+
+
+posixCondition::~posixCondition()
+{
+	pthread_cond_destroy(&m_cond);
+	pthread_mutex_destroy(&m_mutex);
+}
+
+
+void posixCondition::lock()
+{
+	pthread_mutex_lock(&m_mutex);
+}
+
+
+void posixCondition::unlock()
+{
+	pthread_mutex_unlock(&m_mutex);
+}
+
+
+void posixCondition::wait()
+{
+	pthread_cond_wait(&m_cond, &m_mutex);
+}
+
+
+void posixCondition::notifyAll()
+{
+	pthread_cond_broadcast(&m_cond);
+}
+
+
+} // posix
+} // platforms
+} // vmime
@@ -36,6 +36,7 @@
 #include <string.h>
 
 #include "vmime/exception.hpp"
+#include "vmime/dateTime.hpp"
 
 
 #if VMIME_HAVE_FILESYSTEM_FEATURES
@@ -401,6 +402,17 @@ posixFile::length_type posixFile::getLength()
 }
 
 
+const vmime::datetime posixFile::getLastModificationDate()
+{
+	struct stat buf;
+
+	if (::stat(m_nativePath.c_str(), &buf) == -1)
+		posixFileSystemFactory::reportError(m_path, errno);
+
+	return vmime::datetime(buf.st_mtime);
+}
+
+
 const posixFile::path& posixFile::getFullPath() const
 {
 	return (m_path);
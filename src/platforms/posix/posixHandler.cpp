@@ -22,10 +22,14 @@
 //
 
 #include "vmime/platforms/posix/posixHandler.hpp"
+#include "vmime/platforms/posix/posixCriticalSection.hpp"
+#include "vmime/platforms/posix/posixCondition.hpp"
+#include "vmime/platforms/posix/posixThread.hpp"
 
 #include <time.h>
 
 #include <unistd.h>
+#include <stdlib.h>
 #include <locale.h>
 #include <langinfo.h>
 #include <errno.h>
@@ -234,6 +238,17 @@ ref <vmime::utility::childProcessFactory> posixHandler::getChildProcessFactory()
 	return m_childProcFactory;
 }
 
+
+const vmime::utility::file::path posixHandler::getTemporaryDirectory()
+{
+	const char* dir = ::getenv("TMPDIR");
+
+	if (dir == NULL || *dir == '\0')
+		dir = "/tmp";
+
+	return m_fileSysFactory->stringToPath(dir);
+}
+
 #endif
 
 
@@ -255,6 +270,24 @@ void posixHandler::wait() const
 }
 
 
+ref <utility::sync::criticalSection> posixHandler::createCriticalSection()
+{
+	return vmime::create <posixCriticalSection>();
+}
+
+
+ref <utility::sync::condition> posixHandler::createCondition()
+{
+	return vmime::create <posixCondition>();
+}
+
+
+ref <utility::sync::thread> posixHandler::createThread(ref <utility::sync::runnable> task)
+{
+	return vmime::create <posixThread>(task);
+}
+
+
 } // posix
 } // platforms
 } // vmime
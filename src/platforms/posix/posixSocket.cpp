@@ -26,6 +26,7 @@
 
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <netinet/in.h>
@@ -386,6 +387,66 @@ void posixSocket::sendRaw(const char* buffer, const size_type count)
 }
 
 
+void posixSocket::sendRawMultiple(const char* const* buffers, const size_type* counts, const int bufferCount)
+{
+	// Send all buffers with as few system calls as possible
+	std::vector <struct iovec> iov;
+	iov.reserve(bufferCount);
+
+	for (int i = 0 ; i < bufferCount ; ++i)
+	{
+		if (counts[i] > 0)
+		{
+			struct iovec v;
+			v.iov_base = const_cast <char*>(buffers[i]);
+			v.iov_len = static_cast <size_t>(counts[i]);
+
+			iov.push_back(v);
+		}
+	}
+
+	std::vector <struct iovec>::size_type first = 0;
+
+	while (first < iov.size())
+	{
+		struct msghdr msg;
+		::memset(&msg, 0, sizeof(msg));
+
+		msg.msg_iov = &iov[first];
+		msg.msg_iovlen = iov.size() - first;
+
+		const ssize_t ret = ::sendmsg(m_desc, &msg, 0);
+
+		if (ret < 0)
+		{
+			if (errno != EAGAIN)
+				throwSocketError(errno);
+
+			platform::getHandler()->wait();
+			continue;
+		}
+
+		// Skip data which has been sent
+		size_t sent = static_cast <size_t>(ret);
+
+		while (sent != 0)
+		{
+			if (sent >= iov[first].iov_len)
+			{
+				sent -= iov[first].iov_len;
+				++first;
+			}
+			else
+			{
+				iov[first].iov_base = static_cast <char*>(iov[first].iov_base) + sent;
+				iov[first].iov_len -= sent;
+				sent = 0;
+			}
+		}
+	}
+}
+
+
 void posixSocket::throwSocketError(const int err)
 {
 	string msg;
@@ -0,0 +1,78 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/platforms/posix/posixThread.hpp"
+
+#include "vmime/exception.hpp"
+
+
+namespace vmime {
+namespace platforms {
+namespace posix {
+
+
+posixThread::posixThread(ref <utility::sync::runnable> task)
+	: m_task(task), m_joined(false)
+{
+	if (pthread_create(&m_thread, NULL, threadProc, this) != 0)
+		throw exceptions::system_error("pthread_create() failed");
+}
+
+
+posixThread::~posixThread()
+{
+	join();
+}
+
+
+void posixThread::join()
+{
+	if (!m_joined)
+	{
+		pthread_join(m_thread, NULL);
+		m_joined = true;
+	}
+}
+
+
+// static
+void* posixThread::threadProc(void* arg)
+{
+	posixThread* thread = static_cast <posixThread*>(arg);
+
+	try
+	{
+		thread->m_task->run();
+	}
+	catch (...)
+	{
+		// Exceptions cannot cross thread boundaries
+	}
+
+	return NULL;
+}
+
+
+} // posix
+} // platforms
+} // vmime
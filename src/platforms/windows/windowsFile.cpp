@@ -27,6 +27,7 @@
 #include <string.h>
 
 #include "vmime/exception.hpp"
+#include "vmime/dateTime.hpp"
 #include "vmime/utility/stringUtils.hpp"
 
 
@@ -287,6 +288,23 @@ windowsFile::length_type windowsFile::getLength()
 	return dwSize;
 }
 
+const vmime::datetime windowsFile::getLastModificationDate()
+{
+	WIN32_FILE_ATTRIBUTE_DATA attrs;
+
+	if (!GetFileAttributesEx(m_nativePath.c_str(), GetFileExInfoStandard, &attrs))
+		windowsFileSystemFactory::reportError(m_path, GetLastError());
+
+	ULARGE_INTEGER t;
+	t.LowPart = attrs.ftLastWriteTime.dwLowDateTime;
+	t.HighPart = attrs.ftLastWriteTime.dwHighDateTime;
+
+	// FILETIME is the number of 100-nanosecond intervals since January 1, 1601
+	const ULONGLONG epochOffset = static_cast <ULONGLONG>(116444736) * 1000000000;
+
+	return vmime::datetime(static_cast <time_t>((t.QuadPart - epochOffset) / 10000000));
+}
+
 const vmime::utility::path& windowsFile::getFullPath() const
 {
 	return m_path;
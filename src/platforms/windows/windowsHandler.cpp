@@ -22,6 +22,9 @@
 //
 
 #include "vmime/platforms/windows/windowsHandler.hpp"
+#include "vmime/platforms/windows/windowsCriticalSection.hpp"
+#include "vmime/platforms/windows/windowsCondition.hpp"
+#include "vmime/platforms/windows/windowsThread.hpp"
 #include "vmime/config.hpp"
 
 #include <time.h>
@@ -258,6 +261,18 @@ ref <vmime::utility::childProcessFactory> windowsHandler::getChildProcessFactory
 	return (NULL);
 }
 
+
+const vmime::utility::file::path windowsHandler::getTemporaryDirectory()
+{
+	char buffer[MAX_PATH + 1];
+	const DWORD length = ::GetTempPathA(sizeof(buffer), buffer);
+
+	if (length == 0 || length > sizeof(buffer))
+		throw exceptions::system_error("Cannot get the temporary directory");
+
+	return m_fileSysFactory->stringToPath(string(buffer, length));
+}
+
 #endif
 
 
@@ -267,6 +282,24 @@ void windowsHandler::wait() const
 }
 
 
+ref <utility::sync::criticalSection> windowsHandler::createCriticalSection()
+{
+	return vmime::create <windowsCriticalSection>();
+}
+
+
+ref <utility::sync::condition> windowsHandler::createCondition()
+{
+	return vmime::create <windowsCondition>();
+}
+
+
+ref <utility::sync::thread> windowsHandler::createThread(ref <utility::sync::runnable> task)
+{
+	return vmime::create <windowsThread>(task);
+}
+
+
 } // posix
 } // platforms
 } // vmime
@@ -0,0 +1,86 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/platforms/windows/windowsThread.hpp"
+
+#include "vmime/exception.hpp"
+
+#include <process.h>
+
+
+namespace vmime {
+namespace platforms {
+namespace windows {
+
+
+windowsThread::windowsThread(ref <utility::sync::runnable> task)
+	: m_task(task), m_thread(NULL)
+{
+	const uintptr_t handle = _beginthreadex(NULL, 0, threadProc, this, 0, NULL);
+
+	if (handle == 0)
+		throw exceptions::system_error("_beginthreadex() failed");
+
+	m_thread = reinterpret_cast <HANDLE>(handle);
+}
+
+
+windowsThread::~windowsThread()
+{
+	join();
+}
+
+
+void windowsThread::join()
+{
+	if (m_thread != NULL)
+	{
+		WaitForSingleObject(m_thread, INFINITE);
+		CloseHandle(m_thread);
+
+		m_thread = NULL;
+	}
+}
+
+
+// static
+unsigned int __stdcall windowsThread::threadProc(void* arg)
+{
+	windowsThread* thread = static_cast <windowsThread*>(arg);
+
+	try
+	{
+		thread->m_task->run();
+	}
+	catch (...)
+	{
+		// Exceptions cannot cross thread boundaries
+	}
+
+	return 0;
+}
+
+
+} // windows
+} // platforms
+} // vmime
@@ -345,4 +345,10 @@ const std::vector <ref <component> > relay::getChildComponents()
 }
 
 
+bool relay::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
@@ -204,10 +204,11 @@ void sha1MessageDigest::transform
 
 	assert(sizeof(unsigned int) == 4);
 
-	CHAR64LONG16* block;
-	static unsigned char workspace[64];
+	// The work buffer is on the stack, so that several digests
+	// can be computed at the same time
+	CHAR64LONG16 workspace;
+	CHAR64LONG16* block = &workspace;
 
-	block = reinterpret_cast <CHAR64LONG16*>(workspace);
 	memcpy(block, buffer, 64);
 
 	// Copy context->state[] to working vars
@@ -107,10 +107,11 @@ void SASLContext::decodeB64(const string& input, byte_t** output, int* outputLen
 	utility::inputStreamStringAdapter is(input);
 	utility::outputStreamStringAdapter os(res);
 
-	ref <utility::encoder::encoder> dec =
-		utility::encoder::encoderFactory::getInstance()->create("base64");
+	ref <const utility::encoder::encoder> dec =
+		utility::encoder::encoderFactory::getInstance()->getSharedEncoder
+			(utility::encoder::encoderFactory::ENCODING_BASE64);
 
-	dec->decode(is, os);
+	dec->decode(is, os, utility::encoder::encoder::options());
 
 	byte_t* out = new byte_t[res.length()];
 
@@ -128,10 +129,11 @@ const string SASLContext::encodeB64(const byte_t* input, const int inputLen)
 	utility::inputStreamByteBufferAdapter is(input, inputLen);
 	utility::outputStreamStringAdapter os(res);
 
-	ref <utility::encoder::encoder> enc =
-		utility::encoder::encoderFactory::getInstance()->create("base64");
+	ref <const utility::encoder::encoder> enc =
+		utility::encoder::encoderFactory::getInstance()->getSharedEncoder
+			(utility::encoder::encoderFactory::ENCODING_BASE64);
 
-	enc->encode(is, os);
+	enc->encode(is, os, utility::encoder::encoder::options());
 
 	return res;
 }
@@ -99,22 +99,17 @@ void streamContentHandler::generate(utility::outputStream& os, const vmime::enco
 		// buffer, and then re-encode to output stream...
 		if (m_encoding != enc)
 		{
-			ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-			ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-
-			theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-
 			m_stream->reset();  // may not work...
 
 			std::ostringstream oss;
 			utility::outputStreamAdapter tempOut(oss);
 
-			theDecoder->decode(*m_stream, tempOut);
+			m_encoding.decode(*m_stream, tempOut);
 
 			string str = oss.str();
 			utility::inputStreamStringAdapter tempIn(str);
 
-			theEncoder->encode(tempIn, os);
+			enc.encode(tempIn, os, maxLineLength);
 		}
 		// No encoding to perform
 		else
@@ -127,12 +122,9 @@ void streamContentHandler::generate(utility::outputStream& os, const vmime::enco
 	// Need to encode data before
 	else
 	{
-		ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-		theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-
 		m_stream->reset();  // may not work...
 
-		theEncoder->encode(*m_stream, os);
+		enc.encode(*m_stream, os, maxLineLength);
 	}
 }
 
@@ -156,13 +148,11 @@ void streamContentHandler::extract(utility::outputStream& os,
 	// Need to decode data
 	else
 	{
-		ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-
 		m_stream->reset();  // may not work...
 
 		utility::progressListenerSizeAdapter plsa(progress, getLength());
 
-		theDecoder->decode(*m_stream, os, &plsa);
+		m_encoding.decode(*m_stream, os, &plsa);
 	}
 }
 
@@ -0,0 +1,970 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/streamingParser.hpp"
+
+#include "vmime/bodyPart.hpp"
+#include "vmime/headerFieldFactory.hpp"
+#include "vmime/contentTypeField.hpp"
+#include "vmime/emptyContentHandler.hpp"
+#include "vmime/stringContentHandler.hpp"
+#include "vmime/streamContentHandler.hpp"
+#include "vmime/mediaType.hpp"
+#include "vmime/platform.hpp"
+#include "vmime/exception.hpp"
+
+#include "vmime/utility/seekableInputStream.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/random.hpp"
+#include "vmime/utility/stringUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace vmime
+{
+
+
+// Number of bytes read from the stream at once
+static const utility::stream::size_type READ_BUFFER_SIZE = 65536;
+
+// Default memory budget
+static const utility::stream::size_type DEFAULT_MEMORY_BUDGET = 1024 * 1024;
+
+
+
+//
+// streamingParser::spoolFile
+//
+
+/** Temporary file into which the contents which do not fit in the
+  * memory budget are appended. It is deleted when it is destroyed, ie.
+  * when the parser and all the contents read from it are released.
+  */
+class streamingParser::spoolFile : public object
+{
+public:
+
+	spoolFile(const utility::file::path& dir)
+		: m_length(0)
+	{
+		ref <utility::fileSystemFactory> fsf =
+			platform::getHandler()->getFileSystemFactory();
+
+		utility::file::path path = dir;
+		path.appendComponent(utility::file::path::component
+			("vmime-spool-" + utility::random::getString(16)));
+
+		m_file = fsf->create(path);
+		m_file->createFile();
+
+		m_writer = m_file->getFileWriter()->getOutputStream();
+	}
+
+	~spoolFile()
+	{
+		m_writer = NULL;
+		m_reader = NULL;
+
+		try
+		{
+			m_file->remove();
+		}
+		catch (exceptions::filesystem_exception&)
+		{
+			// Ignore
+		}
+	}
+
+	void write(const char* data, const utility::stream::size_type count)
+	{
+		// Contents are written line by line: avoid a system call for each line
+		m_writeBuffer.append(data, count);
+		m_length += count;
+
+		if (m_writeBuffer.length() >= READ_BUFFER_SIZE)
+			flushWriteBuffer();
+	}
+
+	utility::stream::size_type getLength() const
+	{
+		return m_length;
+	}
+
+	utility::stream::size_type read(const utility::stream::size_type pos,
+		char* data, const utility::stream::size_type count)
+	{
+		flushWriteBuffer();
+
+		if (m_reader == NULL)
+			m_reader = m_file->getFileReader()->getInputStream();
+
+		ref <utility::seekableInputStream> seekable =
+			m_reader.dynamicCast <utility::seekableInputStream>();
+
+		if (seekable)
+		{
+			seekable->seek(pos);
+		}
+		else
+		{
+			m_reader->reset();
+			m_reader->skip(pos);
+		}
+
+		utility::stream::size_type total = 0;
+
+		while (total < count)
+		{
+			const utility::stream::size_type n = m_reader->read(data + total, count - total);
+
+			if (n == 0)
+				break;
+
+			total += n;
+		}
+
+		return total;
+	}
+
+private:
+
+	void flushWriteBuffer()
+	{
+		if (!m_writeBuffer.empty())
+		{
+			m_writer->write(m_writeBuffer.data(), m_writeBuffer.length());
+			m_writeBuffer.clear();
+		}
+	}
+
+
+	ref <utility::file> m_file;
+	ref <utility::outputStream> m_writer;
+	ref <utility::inputStream> m_reader;
+	string m_writeBuffer;
+	utility::stream::size_type m_length;
+};
+
+
+
+//
+// streamingParser::spoolInputStream
+//
+
+/** Reads a region of the temporary file. Several streams share the same
+  * file: the position is set again before each read.
+  */
+class streamingParser::spoolInputStream : public utility::seekableInputStream
+{
+public:
+
+	spoolInputStream(ref <spoolFile> spool, const size_type begin, const size_type length)
+		: m_spool(spool), m_begin(begin), m_length(length), m_position(0)
+	{
+	}
+
+	bool eof() const
+	{
+		return m_position >= m_length;
+	}
+
+	void reset()
+	{
+		m_position = 0;
+	}
+
+	size_type read(value_type* const data, const size_type count)
+	{
+		const size_type n = m_spool->read
+			(m_begin + m_position, data, std::min(count, m_length - m_position));
+
+		m_position += n;
+
+		return n;
+	}
+
+	size_type skip(const size_type count)
+	{
+		const size_type n = std::min(count, m_length - m_position);
+		m_position += n;
+
+		return n;
+	}
+
+	size_type getPosition() const
+	{
+		return m_position;
+	}
+
+	void seek(const size_type pos)
+	{
+		m_position = std::min(pos, m_length);
+	}
+
+private:
+
+	ref <spoolFile> m_spool;
+	const size_type m_begin;
+	const size_type m_length;
+	size_type m_position;
+};
+
+
+
+//
+// streamingParser::lookaheadStream
+//
+
+/** Gives access to the next bytes of the input, from the current
+  * position of the parser, without consuming them. Bytes are read from
+  * the input as needed, so that the shared parsing helpers can be used
+  * on a stream which is not seekable.
+  */
+class streamingParser::lookaheadStream : public utility::seekableInputStream
+{
+public:
+
+	lookaheadStream(streamingParser* parser)
+		: m_parser(parser), m_length(0), m_position(0)
+	{
+	}
+
+	void setLength(const size_type length)
+	{
+		m_length = length;
+		m_position = 0;
+	}
+
+	bool eof() const
+	{
+		return m_position >= m_length || m_parser->ensure(m_position + 1) <= m_position;
+	}
+
+	void reset()
+	{
+		m_position = 0;
+	}
+
+	size_type read(value_type* const data, const size_type count)
+	{
+		const size_type n = available(count);
+
+		std::copy(m_parser->m_buffer.data() + m_parser->m_bufferPos + m_position,
+		          m_parser->m_buffer.data() + m_parser->m_bufferPos + m_position + n, data);
+
+		m_position += n;
+
+		return n;
+	}
+
+	size_type skip(const size_type count)
+	{
+		const size_type n = available(count);
+		m_position += n;
+
+		return n;
+	}
+
+	size_type getPosition() const
+	{
+		return m_position;
+	}
+
+	void seek(const size_type pos)
+	{
+		m_position = std::min(pos, m_length);
+	}
+
+private:
+
+	size_type available(const size_type count)
+	{
+		if (m_position >= m_length)
+			return 0;
+
+		const size_type want = std::min(count, m_length - m_position);
+		const size_type avail = m_parser->ensure(m_position + want);
+
+		return (avail > m_position ? std::min(want, avail - m_position) : 0);
+	}
+
+
+	streamingParser* m_parser;
+	size_type m_length;
+	size_type m_position;
+};
+
+
+
+//
+// streamingParser
+//
+
+streamingParser::streamingParser(ref <utility::inputStream> is)
+	: m_stream(is), m_streamEOF(false), m_bufferPos(0),
+	  m_budget(DEFAULT_MEMORY_BUDGET), m_memoryUsed(0), m_tempDirSet(false),
+	  m_state(STATE_START)
+{
+	m_term.level = -1;
+	m_term.close = false;
+}
+
+
+streamingParser::~streamingParser()
+{
+}
+
+
+void streamingParser::setMemoryBudget(const utility::stream::size_type budget)
+{
+	m_budget = budget;
+}
+
+
+utility::stream::size_type streamingParser::getMemoryBudget() const
+{
+	return m_budget;
+}
+
+
+void streamingParser::setTemporaryDirectory(const utility::file::path& dir)
+{
+	m_tempDir = dir;
+	m_tempDirSet = true;
+}
+
+
+int streamingParser::getDepth() const
+{
+	return static_cast <int>(m_parts.size()) - 1;
+}
+
+
+ref <headerField> streamingParser::getHeaderField() const
+{
+	return m_field;
+}
+
+
+ref <contentHandler> streamingParser::getContents() const
+{
+	return m_contents;
+}
+
+
+streamingParser::EventType streamingParser::nextEvent()
+{
+	for (;;)
+	{
+		switch (m_state)
+		{
+		case STATE_START:
+		case STATE_PART_BEGIN:
+		{
+			partInfo part;
+			part.guessBoundary = false;
+			part.closed = false;
+			part.hasContentType = false;
+			part.hasEncoding = false;
+
+			m_parts.push_back(part);
+
+			m_state = STATE_HEADER;
+			return EVENT_PART_BEGIN;
+		}
+		case STATE_HEADER:
+		{
+			string field;
+			terminator term;
+
+			if (readHeaderField(field, term))
+			{
+				// Header fields are kept in memory: count them against
+				// the budget, so that less contents are kept in memory
+				m_memoryUsed += field.length();
+
+				string::size_type nameStart, nameEnd, valueStart, valueEnd, pos;
+
+				if (!headerField::findNext(field, 0, field.length(),
+						&nameStart, &nameEnd, &valueStart, &valueEnd, &pos))
+				{
+					continue;  // not a valid header field: ignore it
+				}
+
+				ref <headerField> f = headerFieldFactory::getInstance()->create
+					(string(field.begin() + nameStart, field.begin() + nameEnd));
+
+				f->parse(field, valueStart, valueEnd, NULL);
+
+				onHeaderField(f);
+				m_field = f;
+
+				return EVENT_HEADER_FIELD;
+			}
+
+			partInfo& part = m_parts.back();
+
+			// Header was interrupted by a boundary or the end of the
+			// stream: the part has no contents
+			if (term.level != -2)
+			{
+				part.boundarySep.clear();
+
+				m_term = term;
+				m_contents = vmime::create <emptyContentHandler>();
+				m_state = STATE_PART_END;
+
+				return EVENT_BODY;
+			}
+
+			if (part.guessBoundary)
+			{
+				// No "boundary" parameter: guess it from the first boundary
+				// line, as body::parseImpl() does, but without reading
+				// more than a buffer ahead
+				const string boundary = body::guessBoundary
+					(lookahead(READ_BUFFER_SIZE), 0, READ_BUFFER_SIZE);
+
+				if (!boundary.empty())
+					part.boundarySep = "--" + boundary;
+			}
+
+			m_state = (part.boundarySep.empty() ? STATE_BODY : STATE_PROLOG);
+			break;
+		}
+		case STATE_BODY:
+		{
+			const partInfo& part = m_parts.back();
+
+			// Defaults to "7bit" (RFC-1521)
+			m_contents = readContents(part.hasEncoding ? part.enc
+				: encoding(encodingTypes::SEVEN_BIT), m_term);
+
+			m_state = STATE_PART_END;
+			return EVENT_BODY;
+		}
+		case STATE_PROLOG:
+		{
+			const int level = getDepth();
+
+			m_contents = readContents(contentHandler::NO_ENCODING, m_term);
+
+			if (m_term.level == level && !m_term.close)
+			{
+				m_state = STATE_PART_BEGIN;
+			}
+			else if (m_term.level == level)
+			{
+				m_parts.back().closed = true;
+				m_state = STATE_EPILOG;
+			}
+			else
+			{
+				// Boundary of an enclosing part, or end of the stream
+				m_state = STATE_PART_END;
+			}
+
+			return EVENT_PROLOG;
+		}
+		case STATE_EPILOG:
+
+			m_contents = readContents(contentHandler::NO_ENCODING, m_term);
+			m_state = STATE_PART_END;
+
+			return EVENT_EPILOG;
+
+		case STATE_PART_END:
+		{
+			m_parts.pop_back();
+
+			const int level = getDepth();
+
+			if (m_parts.empty())
+			{
+				m_state = STATE_END;
+			}
+			else if (m_term.level == level && !m_term.close)
+			{
+				// Next part of the enclosing multipart
+				m_state = STATE_PART_BEGIN;
+			}
+			else if (m_term.level == level)
+			{
+				m_parts.back().closed = true;
+				m_state = STATE_EPILOG;
+			}
+			else
+			{
+				// Boundary of an enclosing part, or end of the stream:
+				// the enclosing multipart ends too
+				m_state = STATE_PART_END;
+			}
+
+			return EVENT_PART_END;
+		}
+		case STATE_END:
+
+			return EVENT_END;
+		}
+	}
+}
+
+
+void streamingParser::onHeaderField(ref <headerField> field)
+{
+	partInfo& part = m_parts.back();
+
+	// Only the first occurrence of a field is taken into account
+	// (see header::findField())
+	if (!part.hasContentType &&
+	    utility::stringUtils::isStringEqualNoCase(field->getName(), fields::CONTENT_TYPE))
+	{
+		part.hasContentType = true;
+
+		ref <contentTypeField> ctf = field.dynamicCast <contentTypeField>();
+
+		if (ctf != NULL &&
+		    ctf->getValue().dynamicCast <const mediaType>()->getType() == mediaTypes::MULTIPART)
+		{
+			try
+			{
+				const string boundary = ctf->getBoundary();
+
+				if (!boundary.empty())
+					part.boundarySep = "--" + boundary;
+			}
+			catch (exceptions::no_such_parameter&)
+			{
+				part.guessBoundary = true;
+			}
+		}
+	}
+	else if (!part.hasEncoding &&
+	         utility::stringUtils::isStringEqualNoCase(field->getName(), fields::CONTENT_TRANSFER_ENCODING))
+	{
+		part.hasEncoding = true;
+		part.enc = *field->getValue().dynamicCast <const encoding>();
+	}
+}
+
+
+bool streamingParser::fill()
+{
+	if (m_streamEOF)
+		return false;
+
+	// Discard data which has already been consumed
+	if (m_bufferPos != 0)
+	{
+		m_buffer.erase(0, m_bufferPos);
+		m_bufferPos = 0;
+	}
+
+	utility::stream::value_type data[READ_BUFFER_SIZE];
+	utility::stream::size_type read = 0;
+
+	while (read == 0)
+	{
+		if (m_stream->eof())
+		{
+			m_streamEOF = true;
+			return false;
+		}
+
+		read = m_stream->read(data, sizeof(data));
+	}
+
+	m_buffer.append(data, read);
+
+	return true;
+}
+
+
+utility::stream::size_type streamingParser::ensure(const utility::stream::size_type count)
+{
+	while (m_buffer.length() - m_bufferPos < count && fill())
+		;
+
+	return m_buffer.length() - m_bufferPos;
+}
+
+
+bool streamingParser::matchBoundary(terminator& term)
+{
+	if (ensure(2) < 2 || m_buffer[m_bufferPos] != '-' || m_buffer[m_bufferPos + 1] != '-')
+		return false;
+
+	for (int level = getDepth() ; level >= 0 ; --level)
+	{
+		const partInfo& part = m_parts[level];
+
+		if (part.boundarySep.empty() || part.closed)
+			continue;
+
+		// Same rules as body::parseImpl(): the line is a boundary if it
+		// starts with the boundary separator, followed by a line break
+		// or "--"
+		const utility::stream::size_type sepLength = part.boundarySep.length();
+
+		if (body::findNextBoundary(lookahead(sepLength + 1),
+				part.boundarySep, 0, sepLength + 1) != 0)
+		{
+			continue;
+		}
+
+		// Skip the boundary line, but not more than a buffer ahead if
+		// it is followed by white-spaces
+		const utility::stream::size_type limit = sepLength + READ_BUFFER_SIZE;
+
+		utility::stream::size_type partEnd = 0;
+		bool lastPart = false;
+
+		const utility::stream::size_type lineEnd = body::skipBoundary
+			(lookahead(limit), part.boundarySep, 0, 0, limit, &partEnd, &lastPart);
+
+		m_bufferPos += lineEnd;
+
+		term.level = level;
+		term.close = lastPart;
+
+		return true;
+	}
+
+	return false;
+}
+
+
+ref <utility::parserInputStreamAdapter> streamingParser::lookahead(const utility::stream::size_type length)
+{
+	if (m_lookahead == NULL)
+	{
+		m_lookahead = vmime::create <lookaheadStream>(this);
+
+		ref <utility::seekableInputStream> is = m_lookahead;
+		m_lookaheadParser = vmime::create <utility::parserInputStreamAdapter>(is);
+	}
+
+	m_lookahead->setLength(length);
+
+	return m_lookaheadParser;
+}
+
+
+bool streamingParser::readHeaderField(string& field, terminator& term)
+{
+	term.level = -2;  // not terminated
+	term.close = false;
+
+	// Check for end of header
+	const utility::stream::size_type avail = ensure(2);
+
+	if (avail == 0)
+	{
+		term.level = -1;
+		return false;
+	}
+
+	const char c = m_buffer[m_bufferPos];
+
+	if (c == '\n')
+	{
+		++m_bufferPos;
+		return false;
+	}
+	else if (c == '\r' && avail >= 2 && m_buffer[m_bufferPos + 1] == '\n')
+	{
+		m_bufferPos += 2;
+		return false;
+	}
+	else if (c == '-' && matchBoundary(term))
+	{
+		return false;
+	}
+
+	// Read the field, including the folded lines
+	for (;;)
+	{
+		const utility::stream::size_type avail = ensure(1);
+
+		if (avail == 0)
+			break;
+
+		const char* p = m_buffer.data() + m_bufferPos;
+		const char* eol = static_cast <const char*>(std::memchr(p, '\n', avail));
+
+		const utility::stream::size_type n = (eol != NULL ? (eol - p) + 1 : avail);
+
+		// Truncate very long fields
+		if (field.length() < m_budget)
+			field.append(p, std::min(n, m_budget - field.length()));
+
+		m_bufferPos += n;
+
+		if (eol != NULL)
+		{
+			// Check for a folded line
+			if (ensure(1) == 0 ||
+			    !(m_buffer[m_bufferPos] == ' ' || m_buffer[m_bufferPos] == '\t'))
+			{
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+void streamingParser::writeContents
+	(contentsSink& sink, const char* data, const utility::stream::size_type count)
+{
+	if (count == 0)
+		return;
+
+	if (!sink.spilled && m_memoryUsed + sink.memory.length() + count <= m_budget)
+	{
+		sink.memory.append(data, count);
+	}
+	else
+	{
+		if (!sink.spilled)
+		{
+			if (m_spool == NULL)
+			{
+				if (!m_tempDirSet)
+				{
+					m_tempDir = platform::getHandler()->getTemporaryDirectory();
+					m_tempDirSet = true;
+				}
+
+				m_spool = vmime::create <spoolFile>(m_tempDir);
+			}
+
+			sink.spilled = true;
+			sink.begin = m_spool->getLength();
+
+			m_spool->write(sink.memory.data(), sink.memory.length());
+
+			string().swap(sink.memory);
+		}
+
+		m_spool->write(data, count);
+	}
+
+	sink.length += count;
+}
+
+
+ref <contentHandler> streamingParser::readContents(const encoding& enc, terminator& term)
+{
+	contentsSink sink;
+	sink.spilled = false;
+	sink.begin = 0;
+	sink.length = 0;
+
+	term.level = -1;
+	term.close = false;
+
+	// The line break before a boundary is part of the boundary: it
+	// is only written when we know the next line is not a boundary
+	char pendingEOL[2];
+	utility::stream::size_type pendingEOLLength = 0;
+
+	bool atLineStart = true;
+
+	for (;;)
+	{
+		const utility::stream::size_type avail = ensure(1);
+
+		if (avail == 0)
+			break;  // end of stream
+
+		if (atLineStart && m_buffer[m_bufferPos] == '-' && matchBoundary(term))
+		{
+			pendingEOLLength = 0;
+			break;
+		}
+
+		const char* p = m_buffer.data() + m_bufferPos;
+		const char* eol = static_cast <const char*>(std::memchr(p, '\n', avail));
+
+		writeContents(sink, pendingEOL, pendingEOLLength);
+		pendingEOLLength = 0;
+
+		if (eol != NULL)
+		{
+			utility::stream::size_type n = eol - p;
+
+			if (n != 0 && p[n - 1] == '\r')
+				--n;
+
+			writeContents(sink, p, n);
+
+			pendingEOLLength = (eol - p) + 1 - n;
+			std::copy(p + n, eol + 1, pendingEOL);
+
+			m_bufferPos += (eol - p) + 1;
+			atLineStart = true;
+		}
+		else
+		{
+			utility::stream::size_type n = avail;
+
+			// Keep a final CR, which may be the start of a line break
+			if (p[n - 1] == '\r')
+				--n;
+
+			writeContents(sink, p, n);
+
+			m_bufferPos += n;
+			atLineStart = false;
+
+			if (n != avail && !fill())
+			{
+				// End of stream: write the CR
+				writeContents(sink, m_buffer.data() + m_bufferPos, 1);
+				++m_bufferPos;
+			}
+		}
+	}
+
+	writeContents(sink, pendingEOL, pendingEOLLength);
+
+	if (sink.length == 0)
+		return vmime::create <emptyContentHandler>();
+
+	if (sink.spilled)
+	{
+		ref <utility::inputStream> is =
+			vmime::create <spoolInputStream>(m_spool, sink.begin, sink.length);
+
+		return vmime::create <streamContentHandler>(is, sink.length, enc);
+	}
+
+	m_memoryUsed += sink.memory.length();
+
+	return vmime::create <stringContentHandler>(sink.memory, enc);
+}
+
+
+void streamingParser::parse(handler& h)
+{
+	for (;;)
+	{
+		switch (nextEvent())
+		{
+		case EVENT_PART_BEGIN: h.onPartBegin(getDepth()); break;
+		case EVENT_HEADER_FIELD: h.onHeaderField(m_field); break;
+		case EVENT_PROLOG: h.onProlog(m_contents); break;
+		case EVENT_BODY: h.onBody(m_contents); break;
+		case EVENT_EPILOG: h.onEpilog(m_contents); break;
+		case EVENT_PART_END: h.onPartEnd(); break;
+		case EVENT_END: return;
+		}
+	}
+}
+
+
+// static
+const string streamingParser::extractContents(ref <const contentHandler> contents)
+{
+	string text;
+	utility::outputStreamStringAdapter os(text);
+
+	contents->extract(os);
+
+	return text;
+}
+
+
+ref <message> streamingParser::parseMessage()
+{
+	ref <message> msg;
+	std::vector <ref <bodyPart> > parts;
+
+	for (;;)
+	{
+		switch (nextEvent())
+		{
+		case EVENT_PART_BEGIN:
+		{
+			if (parts.empty())
+			{
+				msg = vmime::create <message>();
+				parts.push_back(msg);
+			}
+			else
+			{
+				ref <bodyPart> part = vmime::create <bodyPart>();
+
+				parts.back()->getBody()->appendPart(part);
+				parts.push_back(part);
+			}
+
+			break;
+		}
+		case EVENT_HEADER_FIELD:
+
+			parts.back()->getHeader()->appendField(m_field);
+			break;
+
+		case EVENT_PROLOG:
+
+			parts.back()->getBody()->setPrologText(extractContents(m_contents));
+			break;
+
+		case EVENT_EPILOG:
+
+			parts.back()->getBody()->setEpilogText(extractContents(m_contents));
+			break;
+
+		case EVENT_BODY:
+		{
+			ref <bodyPart> part = parts.back();
+
+			// Set the default encoding (see body::parseImpl())
+			if (!m_contents->isEmpty() &&
+			    !part->getHeader()->hasField(fields::CONTENT_TRANSFER_ENCODING))
+			{
+				part->getHeader()->ContentTransferEncoding()->setValue(m_contents->getEncoding());
+			}
+
+			part->getBody()->setContents(m_contents);
+			break;
+		}
+		case EVENT_PART_END:
+
+			parts.pop_back();
+			break;
+
+		case EVENT_END:
+
+			return msg;
+		}
+	}
+}
+
+
+} // vmime
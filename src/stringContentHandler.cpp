@@ -118,22 +118,17 @@ void stringContentHandler::generate(utility::outputStream& os,
 		// buffer, and then re-encode to output stream...
 		if (m_encoding != enc)
 		{
-			ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-			ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-
-			theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-
 			utility::inputStreamStringProxyAdapter in(m_string);
 
 			std::ostringstream oss;
 			utility::outputStreamAdapter tempOut(oss);
 
-			theDecoder->decode(in, tempOut);
+			m_encoding.decode(in, tempOut);
 
 			string str = oss.str();
 			utility::inputStreamStringAdapter tempIn(str);
 
-			theEncoder->encode(tempIn, os);
+			enc.encode(tempIn, os, maxLineLength);
 		}
 		// No encoding to perform
 		else
@@ -144,12 +139,9 @@ void stringContentHandler::generate(utility::outputStream& os,
 	// Need to encode data before
 	else
 	{
-		ref <utility::encoder::encoder> theEncoder = enc.getEncoder();
-		theEncoder->getProperties()["maxlinelength"] = maxLineLength;
-
 		utility::inputStreamStringProxyAdapter in(m_string);
 
-		theEncoder->encode(in, os);
+		enc.encode(in, os, maxLineLength);
 	}
 }
 
@@ -165,12 +157,10 @@ void stringContentHandler::extract(utility::outputStream& os,
 	// Need to decode data
 	else
 	{
-		ref <utility::encoder::encoder> theDecoder = m_encoding.getEncoder();
-
 		utility::inputStreamStringProxyAdapter in(m_string);
 		utility::progressListenerSizeAdapter plsa(progress, getLength());
 
-		theDecoder->decode(in, os, &plsa);
+		m_encoding.decode(in, os, &plsa);
 	}
 }
 
@@ -399,6 +399,12 @@ const std::vector <ref <component> > text::getChildComponents()
 }
 
 
+bool text::visitChildComponentsImpl(childVisitor& v)
+{
+	return visitComponents(m_words, v);
+}
+
+
 const string text::getWholeBuffer() const
 {
 	string res;
@@ -78,12 +78,17 @@ const unsigned char b64Encoder::sm_decodeMap[256] =
 utility::stream::size_type b64Encoder::encode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
 {
-	in.reset();  // may not work...
+	return encode(in, out, options(getProperties()), progress);
+}
+
 
-	const int propMaxLineLength = getProperties().getProperty <int>("maxlinelength", -1);
+utility::stream::size_type b64Encoder::encode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
+{
+	in.reset();  // may not work...
 
-	const bool cutLines = (propMaxLineLength != -1);
-	const int maxLineLength = std::min(propMaxLineLength, 76);
+	const bool cutLines = (opts.maxLineLength != string::npos);
+	const int maxLineLength = static_cast <int>(std::min(opts.maxLineLength, static_cast <string::size_type>(76)));
 
 	// Process data
 	utility::stream::value_type buffer[65536];
@@ -192,6 +197,13 @@ utility::stream::size_type b64Encoder::encode(utility::inputStream& in,
 
 utility::stream::size_type b64Encoder::decode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return decode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type b64Encoder::decode(utility::inputStream& in,
+	utility::outputStream& out, const options& /* opts */, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
@@ -303,6 +315,59 @@ utility::stream::size_type b64Encoder::decode(utility::inputStream& in,
 }
 
 
+// static
+string::size_type b64Encoder::decodeBuffer(const string::value_type* data,
+	const string::size_type length, string& out)
+{
+	const string::size_type initialLength = out.length();
+	string::size_type pos = 0;
+
+	out.reserve(initialLength + (length / 4) * 3 + 3);
+
+	while (pos < length)
+	{
+		unsigned char bytes[4] = { '=', '=', '=', '=' };
+		int count = 0;
+
+		while (count < 4 && pos < length)
+		{
+			const unsigned char c = static_cast <unsigned char>(data[pos++]);
+
+			if (!parserHelpers::isSpace(c))
+				bytes[count++] = c;
+		}
+
+		// Decode the bytes
+		unsigned char c1 = bytes[0];
+		unsigned char c2 = bytes[1];
+
+		if (c1 == '=' || c2 == '=')  // end
+			break;
+
+		out += static_cast <string::value_type>
+			((sm_decodeMap[c1] << 2) | ((sm_decodeMap[c2] & 0x30) >> 4));
+
+		c1 = bytes[2];
+
+		if (c1 == '=')  // end
+			break;
+
+		out += static_cast <string::value_type>
+			(((sm_decodeMap[c2] & 0xf) << 4) | ((sm_decodeMap[c1] & 0x3c) >> 2));
+
+		c2 = bytes[3];
+
+		if (c2 == '=')  // end
+			break;
+
+		out += static_cast <string::value_type>
+			(((sm_decodeMap[c1] & 0x03) << 6) | sm_decodeMap[c2]);
+	}
+
+	return out.length() - initialLength;
+}
+
+
 } // encoder
 } // utility
 } // vmime
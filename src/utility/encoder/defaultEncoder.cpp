@@ -38,6 +38,13 @@ defaultEncoder::defaultEncoder()
 
 utility::stream::size_type defaultEncoder::encode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return encode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type defaultEncoder::encode(utility::inputStream& in,
+	utility::outputStream& out, const options& /* opts */, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
@@ -55,6 +62,13 @@ utility::stream::size_type defaultEncoder::encode(utility::inputStream& in,
 
 utility::stream::size_type defaultEncoder::decode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return decode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type defaultEncoder::decode(utility::inputStream& in,
+	utility::outputStream& out, const options& /* opts */, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
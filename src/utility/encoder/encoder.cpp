@@ -71,6 +71,64 @@ const std::vector <string> encoder::getAvailableProperties() const
 }
 
 
+utility::stream::size_type encoder::encode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
+{
+	encoder* self = const_cast <encoder*>(this);
+
+	opts.toProperties(self->m_props);
+
+	return self->encode(in, out, progress);
+}
+
+
+utility::stream::size_type encoder::decode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
+{
+	encoder* self = const_cast <encoder*>(this);
+
+	opts.toProperties(self->m_props);
+
+	return self->decode(in, out, progress);
+}
+
+
+
+//
+// encoder::options
+//
+
+encoder::options::options()
+	: maxLineLength(string::npos), text(false), rfc2047(false),
+	  filename("no_name"), mode(644)
+{
+}
+
+
+encoder::options::options(const propertySet& props)
+	: maxLineLength(props.getProperty <string::size_type>("maxlinelength", string::npos)),
+	  text(props.getProperty <bool>("text", false)),
+	  rfc2047(props.getProperty <bool>("rfc2047", false)),
+	  filename(props.getProperty <string>("filename", "no_name")),
+	  mode(props.getProperty <int>("mode", 644))
+{
+}
+
+
+void encoder::options::toProperties(propertySet& props) const
+{
+	if (maxLineLength == string::npos)
+		props.removeProperty("maxlinelength");
+	else
+		props["maxlinelength"] = maxLineLength;
+
+	props["text"] = text;
+	props["rfc2047"] = rfc2047;
+	props["filename"] = filename;
+	props["mode"] = mode;
+}
+
+
 } // encoder
 } // utility
 } // vmime
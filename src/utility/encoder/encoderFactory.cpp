@@ -23,6 +23,7 @@
 
 #include "vmime/utility/encoder/encoderFactory.hpp"
 #include "vmime/exception.hpp"
+#include "vmime/utility/instrumentation.hpp"
 
 #include "vmime/utility/encoder/b64Encoder.hpp"
 #include "vmime/utility/encoder/qpEncoder.hpp"
@@ -50,6 +51,14 @@ encoderFactory::encoderFactory()
 	// Also register some non-standard encoding names
 	registerName <sevenBitEncoder>("7-bit");
 	registerName <eightBitEncoder>("8-bit");
+
+	// Shared instances of built-in encoders
+	m_sharedEncoders[ENCODING_7BIT] = vmime::create <sevenBitEncoder>();
+	m_sharedEncoders[ENCODING_8BIT] = vmime::create <eightBitEncoder>();
+	m_sharedEncoders[ENCODING_BINARY] = vmime::create <binaryEncoder>();
+	m_sharedEncoders[ENCODING_QUOTED_PRINTABLE] = vmime::create <qpEncoder>();
+	m_sharedEncoders[ENCODING_BASE64] = vmime::create <b64Encoder>();
+	m_sharedEncoders[ENCODING_UUENCODE] = vmime::create <uuEncoder>();
 }
 
 
@@ -67,10 +76,55 @@ encoderFactory* encoderFactory::getInstance()
 
 ref <encoder> encoderFactory::create(const string& name)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_ENCODERS);
+
 	return (getEncoderByName(name)->create());
 }
 
 
+// static
+encoderFactory::Encoding encoderFactory::getEncodingByName(const string& name)
+{
+	static const struct
+	{
+		const char* name;
+		string::size_type length;
+		Encoding encoding;
+	}
+	names[] =
+	{
+		{ "base64", 6, ENCODING_BASE64 },
+		{ "quoted-printable", 16, ENCODING_QUOTED_PRINTABLE },
+		{ "7bit", 4, ENCODING_7BIT },
+		{ "8bit", 4, ENCODING_8BIT },
+		{ "binary", 6, ENCODING_BINARY },
+		{ "uuencode", 8, ENCODING_UUENCODE },
+		{ "7-bit", 5, ENCODING_7BIT },
+		{ "8-bit", 5, ENCODING_8BIT }
+	};
+
+	for (unsigned int i = 0 ; i < sizeof(names) / sizeof(names[0]) ; ++i)
+	{
+		if (name.length() == names[i].length &&
+		    utility::stringUtils::isStringEqualNoCase(name, names[i].name, names[i].length))
+		{
+			return names[i].encoding;
+		}
+	}
+
+	return ENCODING_UNKNOWN;
+}
+
+
+ref <const encoder> encoderFactory::getSharedEncoder(const Encoding enc) const
+{
+	if (enc == ENCODING_UNKNOWN)
+		return NULL;
+
+	return m_sharedEncoders[enc];
+}
+
+
 const ref <const encoderFactory::registeredEncoder> encoderFactory::getEncoderByName(const string& name) const
 {
 	const string lcName(utility::stringUtils::toLower(name));
@@ -24,6 +24,12 @@
 #include "vmime/utility/encoder/qpEncoder.hpp"
 #include "vmime/parserHelpers.hpp"
 
+#include <cstring>
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
 
 namespace vmime {
 namespace utility {
@@ -159,32 +165,93 @@ int qpEncoder::RFC2047_getEncodedLength(const unsigned char c)
 
 #define QP_WRITE(s, x, l) s.write(reinterpret_cast <utility::stream::value_type*>(x), l)
 
+
+namespace
+{
+
+
+/** Return the number of bytes at the beginning of the specified data
+  * which can be represented literally in a quoted-printable body, that
+  * is octets 32 through 126, except '=' and '?'. Spaces are included:
+  * whether they can stay literal depends on the following byte.
+  */
+string::size_type findSafeRun(const unsigned char* data, const string::size_type count)
+{
+	string::size_type pos = 0;
+
+#if defined(__SSE2__)
+
+	// Octets 0x80-0xFF are negative when compared as signed bytes, so a
+	// single "less than" comparison rejects control chars and 8-bit data
+	const __m128i space = _mm_set1_epi8(32);
+	const __m128i tilde = _mm_set1_epi8(126);
+	const __m128i equal = _mm_set1_epi8('=');
+	const __m128i question = _mm_set1_epi8('?');
+
+	for ( ; pos + 16 <= count ; pos += 16)
+	{
+		const __m128i v = _mm_loadu_si128(reinterpret_cast <const __m128i*>(data + pos));
+
+		const __m128i unsafe = _mm_or_si128
+			(_mm_or_si128(_mm_cmplt_epi8(v, space), _mm_cmpgt_epi8(v, tilde)),
+			 _mm_or_si128(_mm_cmpeq_epi8(v, equal), _mm_cmpeq_epi8(v, question)));
+
+		const int mask = _mm_movemask_epi8(unsafe);
+
+		if (mask != 0)
+			return pos + static_cast <string::size_type>(__builtin_ctz(static_cast <unsigned int>(mask)));
+	}
+
+#endif // __SSE2__
+
+	for ( ; pos < count ; ++pos)
+	{
+		const unsigned char c = data[pos];
+
+		if (c < 32 || c > 126 || c == '=' || c == '?')
+			break;
+	}
+
+	return pos;
+}
+
+
+} // namespace
+
 #endif // VMIME_BUILDING_DOC
 
 
 utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return encode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
-	const string::size_type propMaxLineLength =
-		getProperties().getProperty <string::size_type>("maxlinelength", static_cast <string::size_type>(-1));
+	const bool rfc2047 = opts.rfc2047;
+	const bool text = opts.text;  // binary mode by default
 
-	const bool rfc2047 = getProperties().getProperty <bool>("rfc2047", false);
-	const bool text = getProperties().getProperty <bool>("text", false);  // binary mode by default
+	const bool cutLines = (opts.maxLineLength != string::npos);
+	const string::size_type maxLineLength = std::min(opts.maxLineLength, static_cast <string::size_type>(74));
 
-	const bool cutLines = (propMaxLineLength != static_cast <string::size_type>(-1));
-	const string::size_type maxLineLength = std::min(propMaxLineLength, static_cast <string::size_type>(74));
+	// A soft line break is inserted as soon as the current column reaches this value
+	const string::size_type breakCol = (cutLines ? maxLineLength - 1 : static_cast <string::size_type>(-1));
 
 	// Process the data
-	char buffer[16384];
-	int bufferLength = 0;
-	int bufferPos = 0;
+	unsigned char buffer[16384];
+	string::size_type bufferLength = 0;
+	string::size_type bufferPos = 0;
+	bool eof = false;
 
 	string::size_type curCol = 0;
 
 	unsigned char outBuffer[16384];
-	int outBufferPos = 0;
+	string::size_type outBufferPos = 0;
 
 	utility::stream::size_type total = 0;
 	utility::stream::size_type inTotal = 0;
@@ -192,10 +259,35 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 	if (progress)
 		progress->start(0);
 
-	while (bufferPos < bufferLength || !in.eof())
+	while (true)
 	{
+		// Need to get more data? A pending space (whose encoding depends on
+		// the next byte) is kept at the beginning of the buffer.
+		if (bufferPos >= bufferLength || (bufferPos + 1 == bufferLength && buffer[bufferPos] == ' ' && !eof))
+		{
+			const string::size_type pending = bufferLength - bufferPos;
+
+			if (pending != 0)
+				buffer[0] = buffer[bufferPos];
+
+			const string::size_type count = in.read
+				(reinterpret_cast <utility::stream::value_type*>(buffer + pending), sizeof(buffer) - pending);
+
+			eof = (count == 0 || in.eof());
+
+			bufferLength = pending + count;
+			bufferPos = 0;
+
+			// No more data
+			if (bufferLength == 0)
+				break;
+
+			if (progress)
+				progress->progress(inTotal, inTotal);
+		}
+
 		// Flush current output buffer
-		if (outBufferPos + 6 >= static_cast <int>(sizeof(outBuffer)))
+		if (outBufferPos + 6 >= sizeof(outBuffer))
 		{
 			QP_WRITE(out, outBuffer, outBufferPos);
 
@@ -203,19 +295,66 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 			outBufferPos = 0;
 		}
 
-		// Need to get more data?
-		if (bufferPos >= bufferLength)
+		if (!rfc2047)
 		{
-			bufferLength = in.read(buffer, sizeof(buffer));
-			bufferPos = 0;
+			// Copy characters which do not need encoding in one go
+			const string::size_type runStart = bufferPos;
+			string::size_type run = findSafeRun(buffer + bufferPos, bufferLength - bufferPos);
+
+			// Leave a trailing space to the byte-by-byte encoder, as it has to look
+			// at the next byte (a space cannot appear at the end of a line)
+			if (run != 0 && buffer[bufferPos + run - 1] == ' ')
+				--run;
+
+			// If a '.' appears at the beginning of a line, it has to be encoded
+			// (see below)
+			while (run != 0 && !(curCol == 0 && buffer[bufferPos] == '.'))
+			{
+				string::size_type count = std::min(run, sizeof(outBuffer) - 6 - outBufferPos);
 
-			// No more data
-			if (bufferLength == 0)
-				break;
+				if (breakCol > curCol)
+					count = std::min(count, breakCol - curCol);
+				else
+					count = 1;
+
+				std::copy(buffer + bufferPos, buffer + bufferPos + count, outBuffer + outBufferPos);
+
+				bufferPos += count;
+				outBufferPos += count;
+				inTotal += count;
+				curCol += count;
+				run -= count;
+
+				// Soft line break : "=\r\n"
+				if (curCol >= breakCol)
+				{
+					outBuffer[outBufferPos] = '=';
+					outBuffer[outBufferPos + 1] = '\r';
+					outBuffer[outBufferPos + 2] = '\n';
+
+					outBufferPos += 3;
+					curCol = 0;
+				}
+
+				// Flush current output buffer
+				if (outBufferPos + 6 >= sizeof(outBuffer))
+				{
+					QP_WRITE(out, outBuffer, outBufferPos);
+
+					total += outBufferPos;
+					outBufferPos = 0;
+				}
+			}
+
+			// Refill the buffer if needed before encoding the next char
+			if (bufferPos != runStart)
+				continue;
 		}
 
 		// Get the next char and encode it
-		const unsigned char c = static_cast <unsigned char>(buffer[bufferPos++]);
+		const unsigned char c = buffer[bufferPos++];
+
+		++inTotal;
 
 		if (rfc2047)
 		{
@@ -263,13 +402,6 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 			}
 			case 32:  // space
 			{
-				// Need to get more data?
-				if (bufferPos >= bufferLength)
-				{
-					bufferLength = in.read(buffer, sizeof(buffer));
-					bufferPos = 0;
-				}
-
 				// Spaces cannot appear at the end of a line. So, encode the space.
 				if (bufferPos >= bufferLength ||
 				    (buffer[bufferPos] == '\r' || buffer[bufferPos] == '\n'))
@@ -284,21 +416,18 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 
 				break;
 			}
-			case 9:   // TAB
-			{
-				QP_ENCODE_HEX(c);
-				break;
-			}
 			case 13:  // CR
 			case 10:  // LF
 			{
 				// RFC-2045/6.7(4)
 
-				// Text data
-				if (text && !rfc2047)
+				// Text data: line breaks are kept as is, and start a new line
+				if (text)
 				{
 					outBuffer[outBufferPos++] = c;
-					++curCol;
+
+					if (c == 10)
+						curCol = 0;
 				}
 				// Binary data
 				else
@@ -308,38 +437,25 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 
 				break;
 			}
-			case 61:  // =
-			{
-				QP_ENCODE_HEX('=');
-				break;
-			}
 			/*
 				Rule #2: (Literal representation) Octets with decimal values of 33
 				through 60 inclusive, and 62 through 126, inclusive, MAY be
 				represented as the ASCII characters which correspond to those
 				octets (EXCLAMATION POINT through LESS THAN, and GREATER THAN
 				through TILDE, respectively).
+
+				Other octets (including TAB, '=' and '?') are never part of a
+				safe run, and are always hex-encoded.
 			*/
 			default:
 
-				//if ((c >= 33 && c <= 60) || (c >= 62 && c <= 126))
-				if (c >= 33 && c <= 126 && c != 61 && c != 63)
-				{
-					outBuffer[outBufferPos++] = c;
-					++curCol;
-				}
-				// Other characters: '=' + hexadecimal encoding
-				else
-				{
-					QP_ENCODE_HEX(c);
-				}
-
+				QP_ENCODE_HEX(c);
 				break;
 
 			} // switch (c)
 
 			// Soft line break : "=\r\n"
-			if (cutLines && curCol >= maxLineLength - 1)
+			if (curCol >= breakCol)
 			{
 				outBuffer[outBufferPos] = '=';
 				outBuffer[outBufferPos + 1] = '\r';
@@ -350,11 +466,6 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 			}
 
 		} // !rfc2047
-
-		++inTotal;
-
-		if (progress)
-			progress->progress(inTotal, inTotal);
 	}
 
 	// Flush remaining output buffer
@@ -373,162 +484,159 @@ utility::stream::size_type qpEncoder::encode(utility::inputStream& in,
 
 utility::stream::size_type qpEncoder::decode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return decode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type qpEncoder::decode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
 	// Process the data
-	const bool rfc2047 = getProperties().getProperty <bool>("rfc2047", false);
+	const bool rfc2047 = opts.rfc2047;
 
 	char buffer[16384];
-	int bufferLength = 0;
-	int bufferPos = 0;
+	string::size_type bufferLength = 0;
 
-	unsigned char outBuffer[16384];
-	int outBufferPos = 0;
+	string outBuffer;
+	outBuffer.reserve(sizeof(buffer));
 
 	utility::stream::size_type total = 0;
 	utility::stream::size_type inTotal = 0;
 
-	while (bufferPos < bufferLength || !in.eof())
+	if (progress)
+		progress->start(0);
+
+	while (true)
 	{
-		// Flush current output buffer
-		if (outBufferPos >= static_cast <int>(sizeof(outBuffer)))
-		{
-			QP_WRITE(out, outBuffer, outBufferPos);
+		// Bytes of an incomplete sequence left from the previous chunk
+		// are kept at the beginning of the buffer
+		const string::size_type count = in.read(buffer + bufferLength, sizeof(buffer) - bufferLength);
 
-			total += outBufferPos;
-			outBufferPos = 0;
-		}
+		bufferLength += count;
 
-		// Need to get more data?
-		if (bufferPos >= bufferLength)
-		{
-			bufferLength = in.read(buffer, sizeof(buffer));
-			bufferPos = 0;
+		if (bufferLength == 0)
+			break;
 
-			// No more data
-			if (bufferLength == 0)
-				break;
-		}
+		const bool last = (count == 0 || in.eof());
 
-		// Decode the next sequence (hex-encoded byte or printable character)
-		unsigned char c = static_cast <unsigned char>(buffer[bufferPos++]);
+		outBuffer.clear();
 
-		++inTotal;
+		const string::size_type consumed =
+			decodeChunk(buffer, bufferLength, outBuffer, rfc2047, last);
 
-		switch (c)
+		if (!outBuffer.empty())
 		{
-		case '=':
-		{
-			if (bufferPos >= bufferLength)
-			{
-				bufferLength = in.read(buffer, sizeof(buffer));
-				bufferPos = 0;
-			}
+			out.write(outBuffer.data(), outBuffer.length());
+			total += outBuffer.length();
+		}
 
-			if (bufferPos < bufferLength)
-			{
-				c = static_cast <unsigned char>(buffer[bufferPos++]);
+		inTotal += consumed;
 
-				++inTotal;
+		if (progress)
+			progress->progress(inTotal, inTotal);
 
-				switch (c)
-				{
-				// Ignore soft line break ("=\r\n" or "=\n")
-				case '\r':
+		if (last)
+			break;
 
-					// Read one byte more
-					if (bufferPos >= bufferLength)
-					{
-						bufferLength = in.read(buffer, sizeof(buffer));
-						bufferPos = 0;
-					}
+		std::copy(buffer + consumed, buffer + bufferLength, buffer);
+		bufferLength -= consumed;
+	}
 
-					if (bufferPos < bufferLength)
-					{
-						++bufferPos;
-						++inTotal;
-					}
+	if (progress)
+		progress->stop(inTotal);
 
-					break;
+	return (total);
+}
 
-				case '\n':
 
-					break;
+// static
+string::size_type qpEncoder::decodeBuffer(const string::value_type* data,
+	const string::size_type length, string& out, const bool rfc2047)
+{
+	const string::size_type initialLength = out.length();
 
-				// Hex-encoded char
-				default:
-				{
-					// We need another byte...
-					if (bufferPos >= bufferLength)
-					{
-						bufferLength = in.read(buffer, sizeof(buffer));
-						bufferPos = 0;
-					}
-
-					if (bufferPos < bufferLength)
-					{
-						const unsigned char next = static_cast <unsigned char>(buffer[bufferPos++]);
-
-						++inTotal;
-
-						const unsigned char value = static_cast <unsigned char>
-							(sm_hexDecodeTable[c] * 16 + sm_hexDecodeTable[next]);
-
-						outBuffer[outBufferPos++] = value;
-					}
-					else
-					{
-						// Premature end-of-data
-					}
-
-					break;
-				}
+	decodeChunk(data, length, out, rfc2047, true);
 
-				}
-			}
-			else
-			{
-				// Premature end-of-data
-			}
+	return out.length() - initialLength;
+}
+
+
+// static
+string::size_type qpEncoder::decodeChunk(const string::value_type* data,
+	const string::size_type length, string& out, const bool rfc2047, const bool last)
+{
+	string::size_type pos = 0;
+
+	out.reserve(out.length() + length);
+
+	while (pos < length)
+	{
+		// Copy printable characters in one go
+		const void* equal = std::memchr(data + pos, '=', length - pos);
+		string::size_type runEnd = (equal != NULL
+			? static_cast <string::size_type>(static_cast <const string::value_type*>(equal) - data) : length);
 
+		if (rfc2047)
+		{
+			const void* underscore = std::memchr(data + pos, '_', runEnd - pos);
+
+			if (underscore != NULL)
+				runEnd = static_cast <string::size_type>(static_cast <const string::value_type*>(underscore) - data);
+		}
+
+		out.append(data + pos, runEnd - pos);
+		pos = runEnd;
+
+		if (pos >= length)
 			break;
+
+		if (data[pos] == '_')
+		{
+			// RFC-2047, Page 5, 4.2. The "Q" encoding
+			out += ' ';
+			++pos;
+			continue;
 		}
-		case '_':
+
+		// Incomplete sequence: wait for more data, unless this is the end
+		// of data (in which case it is ignored)
+		const string::size_type avail = length - pos;
+
+		if (avail < 2 || (avail < 3 && data[pos + 1] != '\n'))
 		{
-			if (rfc2047)
-			{
-				// RFC-2047, Page 5, 4.2. The "Q" encoding:
-				// << Note that the "_" always represents hexadecimal 20, even if the SPACE
-				// character occupies a different code position in the character set in use. >>
-				outBuffer[outBufferPos++] = 0x20;
-				break;
-			}
+			if (!last)
+				return pos;
 
-			// no break here...
+			break;
 		}
-		default:
+
+		const unsigned char c = static_cast <unsigned char>(data[pos + 1]);
+
+		// Ignore soft line break ("=\r\n" or "=\n")
+		if (c == '\r')
 		{
-			outBuffer[outBufferPos++] = c;
+			pos += 3;
 		}
-
+		else if (c == '\n')
+		{
+			pos += 2;
 		}
+		// Hex-encoded char
+		else
+		{
+			const unsigned char next = static_cast <unsigned char>(data[pos + 2]);
 
-		if (progress)
-			progress->progress(inTotal, inTotal);
-	}
+			out += static_cast <string::value_type>
+				(sm_hexDecodeTable[c] * 16 + sm_hexDecodeTable[next]);
 
-	// Flush remaining output buffer
-	if (outBufferPos != 0)
-	{
-		QP_WRITE(out, outBuffer, outBufferPos);
-		total += outBufferPos;
+			pos += 3;
+		}
 	}
 
-	if (progress)
-		progress->stop(inTotal);
-
-	return (total);
+	return length;
 }
 
 
@@ -23,6 +23,7 @@
 
 #include "vmime/utility/encoder/uuEncoder.hpp"
 #include "vmime/parserHelpers.hpp"
+#include "vmime/utility/stringUtils.hpp"
 
 
 namespace vmime {
@@ -66,15 +67,21 @@ static inline unsigned char UUDECODE(const unsigned char c)
 
 utility::stream::size_type uuEncoder::encode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return encode(in, out, options(getProperties()), progress);
+}
+
+
+utility::stream::size_type uuEncoder::encode(utility::inputStream& in,
+	utility::outputStream& out, const options& opts, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
-	const string propFilename = getProperties().getProperty <string>("filename", "");
-	const string propMode = getProperties().getProperty <string>("mode", "644");
+	const string& propFilename = opts.filename;
+	const string propMode = (propFilename.empty() ? "" : utility::stringUtils::toString(opts.mode));
 
 	const string::size_type maxLineLength =
-		std::min(getProperties().getProperty <string::size_type>("maxlinelength", 46),
-		         static_cast <string::size_type>(46));
+		std::min(opts.maxLineLength, static_cast <string::size_type>(46));
 
 	utility::stream::size_type total = 0;
 	utility::stream::size_type inTotal = 0;
@@ -145,6 +152,20 @@ utility::stream::size_type uuEncoder::encode(utility::inputStream& in,
 
 utility::stream::size_type uuEncoder::decode(utility::inputStream& in,
 	utility::outputStream& out, utility::progressListener* progress)
+{
+	return decodeImpl(in, out, &getResults(), progress);
+}
+
+
+utility::stream::size_type uuEncoder::decode(utility::inputStream& in,
+	utility::outputStream& out, const options& /* opts */, utility::progressListener* progress) const
+{
+	return decodeImpl(in, out, NULL, progress);
+}
+
+
+utility::stream::size_type uuEncoder::decodeImpl(utility::inputStream& in,
+	utility::outputStream& out, propertySet* results, utility::progressListener* progress) const
 {
 	in.reset();  // may not work...
 
@@ -237,7 +258,8 @@ utility::stream::size_type uuEncoder::decode(utility::inputStream& in,
 
 					while (*p && !parserHelpers::isSpace(*p)) ++p;
 
-					getResults()["mode"] = string(modeStart, p);
+					if (results)
+						(*results)["mode"] = string(modeStart, p);
 
 					while (*p && parserHelpers::isSpace(*p)) ++p;
 
@@ -245,13 +267,14 @@ utility::stream::size_type uuEncoder::decode(utility::inputStream& in,
 
 					while (*p && !(*p == '\r' || *p == '\n')) ++p;
 
-					getResults()["filename"] = string(filenameStart, p);
+					if (results)
+						(*results)["filename"] = string(filenameStart, p);
 				}
 				// No filename or mode specified
-				else
+				else if (results)
 				{
-					getResults()["filename"] = "untitled";
-					getResults()["mode"] = 644;
+					(*results)["filename"] = "untitled";
+					(*results)["mode"] = 644;
 				}
 
 				continue;
@@ -24,6 +24,7 @@
 #include "vmime/utility/filteredStream.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 
 namespace vmime {
@@ -166,10 +167,10 @@ void dotFilteredOutputStream::write
 
 		if (previousChar == '\n')
 		{
-			m_stream.write(start, pos - start);
-			m_stream.write("..", 2);
-
-			start = pos + 1;
+			// Write data up to and including the dot: the dot
+			// will be written again with the next chunk
+			m_stream.write(start, pos - start + 1);
+			start = pos;
 		}
 
 		++pos;
@@ -263,6 +264,201 @@ void CRLFToLFFilteredOutputStream::flush()
 }
 
 
+// dotTerminatedFilteredOutputStream
+
+dotTerminatedFilteredOutputStream::dotTerminatedFilteredOutputStream(outputStream& os)
+	: m_stream(os), m_state(STATE_START), m_pendingLength(0)
+{
+}
+
+
+outputStream& dotTerminatedFilteredOutputStream::getNextOutputStream()
+{
+	return (m_stream);
+}
+
+
+bool dotTerminatedFilteredOutputStream::isTerminated() const
+{
+	return (m_state == STATE_TERMINATED);
+}
+
+
+void dotTerminatedFilteredOutputStream::writePending()
+{
+	if (m_pendingLength != 0)
+	{
+		m_stream.write(m_pending, m_pendingLength);
+		m_pendingLength = 0;
+	}
+}
+
+
+void dotTerminatedFilteredOutputStream::write
+	(const value_type* const data, const size_type count)
+{
+	const value_type* pos = data;
+	const value_type* const end = data + count;
+
+	// Data from 'start' has not been written yet; data from 'hold' may be
+	// part of the terminating sequence (ie. line break, dot and CR). If
+	// the sequence started in a previous buffer, 'hold' is at the beginning
+	// of the buffer and the first part of the sequence is in 'm_pending'.
+	const value_type* start = data;
+	const value_type* hold = data;
+
+	while (pos < end && m_state != STATE_TERMINATED)
+	{
+		switch (m_state)
+		{
+		case STATE_LINE:
+		{
+			// Jump to the end of the line (memchr() is usually vectorized)
+			const value_type* eol = static_cast <const value_type*>
+				(std::memchr(pos, '\n', end - pos));
+
+			if (eol == NULL)
+			{
+				pos = end;
+
+				if (end[-1] == '\r')
+				{
+					hold = end - 1;
+					m_state = STATE_CR;
+				}
+			}
+			else
+			{
+				hold = (eol > data && eol[-1] == '\r') ? eol - 1 : eol;
+				pos = eol + 1;
+
+				m_state = STATE_START;
+			}
+
+			break;
+		}
+		case STATE_CR:
+
+			if (*pos == '\n')
+			{
+				++pos;
+				m_state = STATE_START;
+			}
+			else
+			{
+				writePending();
+				m_state = STATE_LINE;
+			}
+
+			break;
+
+		case STATE_START:
+
+			if (*pos == '.')
+			{
+				++pos;
+				m_state = STATE_DOT;
+			}
+			else
+			{
+				writePending();
+				m_state = STATE_LINE;
+			}
+
+			break;
+
+		case STATE_DOT:
+
+			if (*pos == '\n')
+			{
+				++pos;
+				m_state = STATE_TERMINATED;
+			}
+			else if (*pos == '\r')
+			{
+				++pos;
+				m_state = STATE_DOT_CR;
+			}
+			else if (*pos == '.')
+			{
+				// "\n.." --> "\n.": write up to the first dot, skip the second one
+				writePending();
+
+				if (pos != start)
+					m_stream.write(start, pos - start);
+
+				start = ++pos;
+				m_state = STATE_LINE;
+			}
+			else
+			{
+				writePending();
+				m_state = STATE_LINE;
+			}
+
+			break;
+
+		case STATE_DOT_CR:
+
+			if (*pos == '\n')
+			{
+				++pos;
+				m_state = STATE_TERMINATED;
+			}
+			else
+			{
+				writePending();
+				m_state = STATE_LINE;
+			}
+
+			break;
+
+		case STATE_TERMINATED:
+
+			break;
+		}
+	}
+
+	switch (m_state)
+	{
+	case STATE_LINE:
+
+		if (end != start)
+			m_stream.write(start, end - start);
+
+		break;
+
+	case STATE_TERMINATED:
+
+		// Do not write the line break before the terminating dot
+		m_pendingLength = 0;
+
+		if (hold != start)
+			m_stream.write(start, hold - start);
+
+		break;
+
+	default:
+
+		// Hold back the sequence which may be the beginning
+		// of the terminating line
+		if (hold != start)
+			m_stream.write(start, hold - start);
+
+		for ( ; hold < end ; ++hold)
+			m_pending[m_pendingLength++] = *hold;
+
+		break;
+	}
+}
+
+
+void dotTerminatedFilteredOutputStream::flush()
+{
+	m_stream.flush();
+}
+
+
 // stopSequenceFilteredInputStream <1>
 
 template <>
@@ -60,7 +60,7 @@ stream::size_type inputStreamStringAdapter::read
 	{
 		const size_type remaining = m_end - m_pos;
 
-		std::copy(m_buffer.begin() + m_pos, m_buffer.end(), data);
+		std::copy(m_buffer.begin() + m_pos, m_buffer.begin() + m_end, data);
 		m_pos = m_end;
 		return (remaining);
 	}
@@ -102,6 +102,15 @@ void inputStreamStringAdapter::seek(const size_type pos)
 }
 
 
+const string* inputStreamStringAdapter::getBuffer(size_type& offset, size_type& length) const
+{
+	offset = m_begin;
+	length = m_end - m_begin;
+
+	return &m_buffer;
+}
+
+
 } // utility
 } // vmime
 
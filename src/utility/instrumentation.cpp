@@ -0,0 +1,247 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/utility/instrumentation.hpp"
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <sys/time.h>
+#	if defined(VMIME_HAVE_PTHREAD)
+#		include <pthread.h>
+#	endif
+#endif
+
+
+namespace vmime {
+namespace utility {
+
+
+namespace
+{
+
+// Counters are updated from any thread, possibly on very hot paths
+// (object creation), so use atomic operations where available
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+
+inline void atomicAdd(volatile unsigned long* value, const unsigned long n)
+{
+	__sync_fetch_and_add(value, n);
+}
+
+inline unsigned long atomicGet(volatile unsigned long* value)
+{
+	return __sync_fetch_and_add(value, 0);
+}
+
+#elif defined(_WIN32)
+
+inline void atomicAdd(volatile unsigned long* value, const unsigned long n)
+{
+	InterlockedExchangeAdd(reinterpret_cast <volatile LONG*>(value), static_cast <LONG>(n));
+}
+
+inline unsigned long atomicGet(volatile unsigned long* value)
+{
+	return static_cast <unsigned long>
+		(InterlockedExchangeAdd(reinterpret_cast <volatile LONG*>(value), 0));
+}
+
+#elif defined(VMIME_HAVE_PTHREAD)
+
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+inline void atomicAdd(volatile unsigned long* value, const unsigned long n)
+{
+	pthread_mutex_lock(&g_mutex);
+	*value += n;
+	pthread_mutex_unlock(&g_mutex);
+}
+
+inline unsigned long atomicGet(volatile unsigned long* value)
+{
+	pthread_mutex_lock(&g_mutex);
+	const unsigned long v = *value;
+	pthread_mutex_unlock(&g_mutex);
+
+	return v;
+}
+
+#else // not thread-safe implementation
+
+inline void atomicAdd(volatile unsigned long* value, const unsigned long n)
+{
+	*value += n;
+}
+
+inline unsigned long atomicGet(volatile unsigned long* value)
+{
+	return *value;
+}
+
+#endif
+
+} // namespace
+
+
+instrumentation::instrumentation()
+{
+	for (int i = 0 ; i < COUNTER_COUNT ; ++i)
+		m_counters[i] = 0;
+
+	for (int i = 0 ; i < TIMER_COUNT ; ++i)
+		m_timerCounts[i] = m_timerTotals[i] = 0;
+}
+
+
+instrumentation* instrumentation::getInstance()
+{
+	static instrumentation instance;
+	return (&instance);
+}
+
+
+// static
+bool instrumentation::isEnabled()
+{
+#if VMIME_HAVE_INSTRUMENTATION
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+// static
+const char* instrumentation::getCounterName(const Counter counter)
+{
+	switch (counter)
+	{
+	case COUNTER_OBJECTS: return "objects";
+	case COUNTER_CHARSET_CONVERTERS: return "charset.converters";
+	case COUNTER_ICONV_OPENS: return "charset.iconv-opens";
+	case COUNTER_ENCODERS: return "encoders";
+	case COUNTER_IMAP_COMMANDS: return "imap.commands";
+	case COUNTER_IMAP_RESPONSES: return "imap.responses";
+	case COUNTER_SMTP_COMMANDS: return "smtp.commands";
+	case COUNTER_SMTP_RESPONSES: return "smtp.responses";
+	case COUNTER_POP3_COMMANDS: return "pop3.commands";
+	case COUNTER_POP3_RESPONSES: return "pop3.responses";
+	default: break;
+	}
+
+	return "";
+}
+
+
+// static
+const char* instrumentation::getTimerName(const Timer timer)
+{
+	switch (timer)
+	{
+	case TIMER_IMAP_RESPONSE: return "imap.response";
+	case TIMER_SMTP_RESPONSE: return "smtp.response";
+	case TIMER_POP3_RESPONSE: return "pop3.response";
+	default: break;
+	}
+
+	return "";
+}
+
+
+unsigned long instrumentation::getCounter(const Counter counter) const
+{
+	return atomicGet(const_cast <volatile unsigned long*>(&m_counters[counter]));
+}
+
+
+unsigned long instrumentation::getTimerCount(const Timer timer) const
+{
+	return atomicGet(const_cast <volatile unsigned long*>(&m_timerCounts[timer]));
+}
+
+
+unsigned long instrumentation::getTimerTotal(const Timer timer) const
+{
+	return atomicGet(const_cast <volatile unsigned long*>(&m_timerTotals[timer]));
+}
+
+
+void instrumentation::increment(const Counter counter)
+{
+	atomicAdd(&m_counters[counter], 1);
+}
+
+
+void instrumentation::addTime(const Timer timer, const unsigned long usec)
+{
+	atomicAdd(&m_timerCounts[timer], 1);
+	atomicAdd(&m_timerTotals[timer], usec);
+}
+
+
+// static
+unsigned long instrumentation::getMicroseconds()
+{
+#if defined(_WIN32)
+
+	LARGE_INTEGER freq, count;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+
+	return static_cast <unsigned long>(count.QuadPart * 1000000 / freq.QuadPart);
+
+#else
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return static_cast <unsigned long>(tv.tv_sec) * 1000000UL
+		+ static_cast <unsigned long>(tv.tv_usec);
+
+#endif
+}
+
+
+
+//
+// instrumentation::scopedTimer
+//
+
+instrumentation::scopedTimer::scopedTimer(const Timer timer)
+	: m_timer(timer), m_start(getMicroseconds())
+{
+}
+
+
+instrumentation::scopedTimer::~scopedTimer()
+{
+	// Unsigned arithmetic gives the right result if the clock wraps around
+	instrumentation::getInstance()->addTime(m_timer, getMicroseconds() - m_start);
+}
+
+
+} // utility
+} // vmime
@@ -29,27 +29,77 @@
 
 #include "vmime/net/socket.hpp"
 
+#include <algorithm>
+
 
 namespace vmime {
 namespace utility {
 
 
 outputStreamSocketAdapter::outputStreamSocketAdapter(net::socket& sok)
-	: m_socket(sok)
+	: m_socket(sok), m_bufferLength(0)
+{
+	m_buffer.resize(std::max(static_cast <size_type>(sok.getBlockSize()), static_cast <size_type>(1)));
+}
+
+
+outputStreamSocketAdapter::~outputStreamSocketAdapter()
 {
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		// Don't throw exception in destructor
+	}
 }
 
 
 void outputStreamSocketAdapter::write
 	(const value_type* const data, const size_type count)
 {
-	m_socket.sendRaw(data, count);
+	const size_type capacity = m_buffer.size();
+
+	if (m_bufferLength + count <= capacity)
+	{
+		std::copy(data, data + count, &m_buffer[m_bufferLength]);
+		m_bufferLength += count;
+	}
+	else if (count < capacity)
+	{
+		// Complete the buffer and send it, then keep the remaining data
+		const size_type n = capacity - m_bufferLength;
+
+		std::copy(data, data + n, &m_buffer[m_bufferLength]);
+		m_socket.sendRaw(&m_buffer[0], static_cast <net::socket::size_type>(capacity));
+
+		std::copy(data + n, data + count, &m_buffer[0]);
+		m_bufferLength = count - n;
+	}
+	else
+	{
+		// Send buffered data along with the new data
+		const char* buffers[2] = { &m_buffer[0], data };
+		const net::socket::size_type counts[2] =
+		{
+			static_cast <net::socket::size_type>(m_bufferLength),
+			static_cast <net::socket::size_type>(count)
+		};
+
+		m_socket.sendRawMultiple(buffers, counts, 2);
+		m_bufferLength = 0;
+	}
 }
 
 
 void outputStreamSocketAdapter::flush()
 {
-	// Do nothing
+	if (m_bufferLength != 0)
+	{
+		m_socket.sendRaw(&m_buffer[0], static_cast <net::socket::size_type>(m_bufferLength));
+		m_bufferLength = 0;
+	}
 }
 
 
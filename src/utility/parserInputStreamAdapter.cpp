@@ -23,6 +23,8 @@
 
 #include "vmime/utility/parserInputStreamAdapter.hpp"
 
+#include <algorithm>
+
 
 namespace vmime {
 namespace utility {
@@ -61,22 +63,33 @@ ref <seekableInputStream> parserInputStreamAdapter::getUnderlyingStream()
 
 const string parserInputStreamAdapter::extract(const size_type begin, const size_type end) const
 {
+	if (end <= begin)
+		return string();
+
+	size_type offset = 0, length = 0;
+	const string* buffer = m_stream->getBuffer(offset, length);
+
+	if (buffer != NULL)
+	{
+		// Do not read past the end of the stream
+		return string(buffer->begin() + offset + std::min(begin, length),
+		              buffer->begin() + offset + std::min(end, length));
+	}
+
 	const size_type initialPos = m_stream->getPosition();
 
 	try
 	{
-		value_type *buffer = new value_type[end - begin + 1];
+		// Read directly into the string
+		string str(end - begin, '\0');
 
 		m_stream->seek(begin);
 
-		const size_type readBytes = m_stream->read(buffer, end - begin);
-		buffer[readBytes] = '\0';
+		const size_type readBytes = m_stream->read(&str[0], end - begin);
+		str.resize(readBytes);
 
 		m_stream->seek(initialPos);
 
-		string str(buffer, buffer + readBytes);
-		delete [] buffer;
-
 		return str;
 	}
 	catch (...)
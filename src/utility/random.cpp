@@ -23,6 +23,7 @@
 
 #include "vmime/utility/random.hpp"
 #include "vmime/platform.hpp"
+#include "vmime/utility/smartPtrInt.hpp"
 
 #include <ctime>
 
@@ -31,16 +32,27 @@ namespace vmime {
 namespace utility {
 
 
-unsigned int random::m_next(static_cast<unsigned int>(::std::time(NULL)));
+unsigned int random::m_seed(static_cast<unsigned int>(::std::time(NULL)));
+
+// Number of values returned so far, incremented atomically
+static refCounter g_count(0);
 
 
 unsigned int random::getNext()
 {
-	// Park and Miller's minimal standard generator:
-	// xn+1 = (a * xn + b) mod c
-	// xn+1 = (16807 * xn) mod (2^31 - 1)
-	m_next = static_cast<unsigned int>((16807 * m_next) % 2147483647ul);
-	return (m_next);
+	// Each call gets its own position in the sequence, so that concurrent
+	// calls never return the same value (and no lock is needed). The
+	// position is then scrambled with a bijective 32-bit hash function
+	// (from Chris Wellons' "hash-prospector").
+	unsigned long x = (m_seed + static_cast <unsigned long>(g_count.increment()) * 0x9e3779b9ul) & 0xfffffffful;
+
+	x ^= x >> 16;
+	x = (x * 0x7feb352dul) & 0xfffffffful;
+	x ^= x >> 15;
+	x = (x * 0x846ca68bul) & 0xfffffffful;
+	x ^= x >> 16;
+
+	return static_cast <unsigned int>(x);
 }
 
 
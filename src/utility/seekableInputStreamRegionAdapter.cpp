@@ -23,6 +23,8 @@
 
 #include "vmime/utility/seekableInputStreamRegionAdapter.hpp"
 
+#include <algorithm>
+
 
 namespace vmime {
 namespace utility {
@@ -90,6 +92,24 @@ void seekableInputStreamRegionAdapter::seek(const size_type pos)
 }
 
 
+const string* seekableInputStreamRegionAdapter::getBuffer(size_type& offset, size_type& length) const
+{
+	size_type streamLength = 0;
+	const string* buffer = m_stream->getBuffer(offset, streamLength);
+
+	if (buffer != NULL)
+	{
+		// The region may not extend past the end of the source stream
+		const size_type begin = std::min(m_begin, streamLength);
+
+		offset += begin;
+		length = std::min(m_length, streamLength - begin);
+	}
+
+	return buffer;
+}
+
+
 } // utility
 } // vmime
 
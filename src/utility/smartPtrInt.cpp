@@ -23,6 +23,7 @@
 
 #include "vmime/utility/smartPtrInt.hpp"
 #include "vmime/object.hpp"
+#include "vmime/utility/instrumentation.hpp"
 
 #if defined(_WIN32)
 #	include <windows.h>
@@ -38,6 +39,8 @@ namespace utility {
 // static
 refManager* refManager::create(object* obj)
 {
+	VMIME_INSTRUMENT_COUNT(COUNTER_OBJECTS);
+
 	return new refManagerImpl(obj);
 }
 
@@ -0,0 +1,99 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "vmime/utility/sync/builtinCriticalSection.hpp"
+
+#if defined(_WIN32)
+#	include <windows.h>
+#elif defined(VMIME_HAVE_PTHREAD)
+#	include <pthread.h>
+#endif
+
+
+namespace vmime {
+namespace utility {
+namespace sync {
+
+
+#ifndef VMIME_BUILDING_DOC
+
+struct builtinCriticalSection::impl
+{
+#if defined(_WIN32)
+	CRITICAL_SECTION cs;
+#elif defined(VMIME_HAVE_PTHREAD)
+	pthread_mutex_t mutex;
+#else
+	int unused;
+#endif
+};
+
+#endif // VMIME_BUILDING_DOC
+
+
+builtinCriticalSection::builtinCriticalSection()
+	: m_impl(new impl)
+{
+#if defined(_WIN32)
+	InitializeCriticalSection(&m_impl->cs);
+#elif defined(VMIME_HAVE_PTHREAD)
+	pthread_mutex_init(&m_impl->mutex, NULL);
+#endif
+}
+
+
+builtinCriticalSection::~builtinCriticalSection()
+{
+#if defined(_WIN32)
+	DeleteCriticalSection(&m_impl->cs);
+#elif defined(VMIME_HAVE_PTHREAD)
+	pthread_mutex_destroy(&m_impl->mutex);
+#endif
+
+	delete m_impl;
+}
+
+
+void builtinCriticalSection::lock()
+{
+#if defined(_WIN32)
+	EnterCriticalSection(&m_impl->cs);
+#elif defined(VMIME_HAVE_PTHREAD)
+	pthread_mutex_lock(&m_impl->mutex);
+#endif
+}
+
+
+void builtinCriticalSection::unlock()
+{
+#if defined(_WIN32)
+	LeaveCriticalSection(&m_impl->cs);
+#elif defined(VMIME_HAVE_PTHREAD)
+	pthread_mutex_unlock(&m_impl->mutex);
+#endif
+}
+
+
+} // sync
+} // utility
+} // vmime
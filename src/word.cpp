@@ -28,9 +28,6 @@
 #include "vmime/utility/smartPtr.hpp"
 #include "vmime/parserHelpers.hpp"
 
-#include "vmime/utility/outputStreamStringAdapter.hpp"
-#include "vmime/utility/inputStreamStringAdapter.hpp"
-
 #include "vmime/utility/encoder/encoder.hpp"
 #include "vmime/utility/encoder/b64Encoder.hpp"
 #include "vmime/utility/encoder/qpEncoder.hpp"
@@ -76,19 +73,22 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 	//   - before the first word
 	//   - between two encoded words
 	//   - after the last word
-	string whiteSpaces;
+	pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(buffer, pos, end);
 
-	while (pos < end && parserHelpers::isSpace(buffer[pos]))
-	{
-		whiteSpaces += buffer[pos];
-		++pos;
-	}
+	const string::size_type whiteSpacesLength = pos - position;
 
 	string::size_type startPos = pos;
 	string unencoded;
 
 	while (pos < end)
 	{
+		// Skip to the next line break or '=' character
+		pos = parserHelpers::findFirstOf
+			<parserHelpers::CHAR_CLASS_EOL | parserHelpers::CHAR_CLASS_EQUAL>(buffer, pos, end);
+
+		if (pos == end)
+			break;
+
 		// End of line: does not occur in the middle of an encoded word. This is
 		// used to remove folding white-spaces from unencoded text.
 		if (buffer[pos] == '\n')
@@ -101,10 +101,9 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 				--endPos;
 			}
 
-			while (pos != end && parserHelpers::isSpace(buffer[pos]))
-				++pos;
+			pos = parserHelpers::skipWhile <parserHelpers::CHAR_CLASS_SPACE>(buffer, pos, end);
 
-			unencoded += buffer.substr(startPos, endPos - startPos);
+			unencoded.append(buffer, startPos, endPos - startPos);
 
 			if (pos != end)  // ignore white-spaces at end
 				unencoded += ' ';
@@ -117,12 +116,12 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 		         buffer[pos] == '=' && buffer[pos + 1] == '?')
 		{
 			// Check whether there is some unencoded text before
-			unencoded += buffer.substr(startPos, pos - startPos);
+			unencoded.append(buffer, startPos, pos - startPos);
 
 			if (!unencoded.empty())
 			{
 				if (prevIsEncoded)
-					unencoded = whiteSpaces + unencoded;
+					unencoded.insert(0, buffer, position, whiteSpacesLength);
 
 				ref <word> w = vmime::create <word>(unencoded, charset(charsets::US_ASCII));
 				w->setParsedBounds(position, pos);
@@ -141,15 +140,13 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 
 			pos += 2;
 
-			while (pos < end && buffer[pos] != '?')
-				++pos;
+			pos = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_QUESTION>(buffer, pos, end);
 
 			if (pos < end)
 			{
 				++pos; // skip '?' between charset and encoding
 
-				while (pos < end && buffer[pos] != '?')
-					++pos;
+				pos = parserHelpers::findFirstOf <parserHelpers::CHAR_CLASS_QUESTION>(buffer, pos, end);
 
 				if (pos < end)
 				{
@@ -157,7 +154,8 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 				}
 			}
 
-			while (pos < end)
+			while ((pos = parserHelpers::findFirstOf
+				<parserHelpers::CHAR_CLASS_EOL | parserHelpers::CHAR_CLASS_QUESTION>(buffer, pos, end)) < end)
 			{
 				if (buffer[pos] == '\n')
 				{
@@ -197,10 +195,10 @@ ref <word> word::parseNext(const string& buffer, const string::size_type positio
 	}
 
 	if (startPos != end && !isFirst && prevIsEncoded)
-		unencoded += whiteSpaces;
+		unencoded.append(buffer, position, whiteSpacesLength);
 
 	if (startPos != end)
-		unencoded += buffer.substr(startPos, end - startPos);
+		unencoded.append(buffer, startPos, end - startPos);
 
 	// Treat unencoded text at the end of the buffer
 	if (!unencoded.empty())
@@ -273,32 +271,33 @@ void word::parseImpl(const string& buffer, const string::size_type position,
 					const string::const_iterator dataEnd = p;
 					p += 2; // skip '?='
 
-					utility::encoder::encoder* theEncoder = NULL;
+					const string::size_type dataOffset = dataPos - buffer.begin();
+					const string::size_type dataLength = dataEnd - dataPos;
+
+					// Decode text directly from the input buffer
+					bool decoded = true;
+
+					m_buffer.clear();
 
 					// Base-64 encoding
 					if (*encPos == 'B' || *encPos == 'b')
 					{
-						theEncoder = new utility::encoder::b64Encoder();
+						utility::encoder::b64Encoder::decodeBuffer
+							(buffer.data() + dataOffset, dataLength, m_buffer);
 					}
 					// Quoted-Printable encoding
 					else if (*encPos == 'Q' || *encPos == 'q')
 					{
-						theEncoder = new utility::encoder::qpEncoder();
-						theEncoder->getProperties()["rfc2047"] = true;
+						utility::encoder::qpEncoder::decodeBuffer
+							(buffer.data() + dataOffset, dataLength, m_buffer, true);
 					}
-
-					if (theEncoder)
+					else
 					{
-						// Decode text
-						string decodedBuffer;
-
-						utility::inputStreamStringAdapter ein(string(dataPos, dataEnd));
-						utility::outputStreamStringAdapter eout(decodedBuffer);
-
-						theEncoder->decode(ein, eout);
-						delete (theEncoder);
+						decoded = false;
+					}
 
-						m_buffer = decodedBuffer;
+					if (decoded)
+					{
 						m_charset = charset(string(charsetPos, charsetEnd));
 
 						setParsedBounds(position, p - buffer.begin());
@@ -749,4 +748,10 @@ const std::vector <ref <component> > word::getChildComponents()
 }
 
 
+bool word::visitChildComponentsImpl(childVisitor& /* v */)
+{
+	return true;
+}
+
+
 } // vmime
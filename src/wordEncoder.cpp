@@ -30,6 +30,7 @@
 
 #include "vmime/utility/encoder/b64Encoder.hpp"
 #include "vmime/utility/encoder/qpEncoder.hpp"
+#include "vmime/utility/encoder/encoderFactory.hpp"
 
 #include "vmime/utility/stringUtils.hpp"
 
@@ -66,14 +67,17 @@ wordEncoder::wordEncoder(const string& buffer, const charset& charset, const Enc
 	if (m_encoding == ENCODING_AUTO)
 		m_encoding = guessBestEncoding(buffer, charset);
 
+	utility::encoder::encoderFactory* factory =
+		utility::encoder::encoderFactory::getInstance();
+
 	if (m_encoding == ENCODING_B64)
 	{
-		m_encoder = vmime::create <utility::encoder::b64Encoder>();
+		m_encoder = factory->getSharedEncoder(utility::encoder::encoderFactory::ENCODING_BASE64);
 	}
 	else // ENCODING_QP
 	{
-		m_encoder = vmime::create <utility::encoder::qpEncoder>();
-		m_encoder->getProperties()["rfc2047"] = true;
+		m_encoder = factory->getSharedEncoder(utility::encoder::encoderFactory::ENCODING_QUOTED_PRINTABLE);
+		m_encoderOptions.rfc2047 = true;
 	}
 }
 
@@ -139,7 +143,7 @@ const string wordEncoder::getNextChunk(const string::size_type maxLength)
 			// Encode chunk
 			utility::inputStreamStringAdapter in(m_buffer, m_pos, m_pos + inputCount);
 
-			m_encoder->encode(in, chunkStream);
+			m_encoder->encode(in, chunkStream, m_encoderOptions);
 			m_pos += inputCount;
 		}
 		else // ENCODING_QP
@@ -161,7 +165,7 @@ const string wordEncoder::getNextChunk(const string::size_type maxLength)
 			// Encode chunk
 			utility::inputStreamStringAdapter in(m_buffer, m_pos, m_pos + inputCount);
 
-			m_encoder->encode(in, chunkStream);
+			m_encoder->encode(in, chunkStream, m_encoderOptions);
 			m_pos += inputCount;
 		}
 	}
@@ -210,7 +214,7 @@ const string wordEncoder::getNextChunk(const string::size_type maxLength)
 		// Encode chunk
 		utility::inputStreamStringAdapter in(encodeBuffer);
 
-		m_encoder->encode(in, chunkStream);
+		m_encoder->encode(in, chunkStream, m_encoderOptions);
 		m_pos += inputCount;
 	}
 
@@ -0,0 +1,277 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/net/imap/IMAPTag.hpp"
+#include "vmime/net/imap/IMAPParser.hpp"
+
+
+#define VMIME_TEST_SUITE         IMAPParserTest
+#define VMIME_TEST_SUITE_MODULE  "Net/IMAP"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testGreeting)
+		VMIME_TEST(testTaggedResponse)
+		VMIME_TEST(testFetchResponse)
+		VMIME_TEST(testDateTime)
+		VMIME_TEST(testSpecialAtomCase)
+		VMIME_TEST(testLiteral)
+		VMIME_TEST(testInvalidResponse)
+		VMIME_TEST(testResponseOutlivesParser)
+	VMIME_TEST_LIST_END
+
+
+	typedef vmime::net::imap::IMAPParser IMAPParser;
+
+
+	class parserContext
+	{
+	public:
+
+		parserContext()
+			: socket(vmime::create <testSocket>()),
+			  toh(vmime::create <testTimeoutHandler>()),
+			  tag(vmime::create <vmime::net::imap::IMAPTag>())
+		{
+			++(*tag);  // "a001"
+			parser = vmime::create <IMAPParser>
+				(tag, vmime::ref <vmime::net::socket>(socket), toh);
+		}
+
+		vmime::ref <testSocket> socket;
+		vmime::ref <vmime::net::timeoutHandler> toh;
+		vmime::ref <vmime::net::imap::IMAPTag> tag;
+		vmime::ref <IMAPParser> parser;
+	};
+
+
+	void testGreeting()
+	{
+		parserContext ctx;
+		ctx.socket->localSend("* OK IMAP4rev1 server ready\r\n");
+
+		vmime::utility::auto_ptr <IMAPParser::greeting> greet(ctx.parser->readGreeting());
+
+		VASSERT("Auth", greet->resp_cond_auth() != NULL);
+		VASSERT_EQ("Condition", IMAPParser::resp_cond_auth::OK, greet->resp_cond_auth()->condition());
+		VASSERT_EQ("Text", "IMAP4rev1 server ready", greet->resp_cond_auth()->resp_text()->text());
+	}
+
+	void testTaggedResponse()
+	{
+		parserContext ctx;
+		ctx.socket->localSend
+		(
+			"* 3 EXISTS\r\n"
+			"* 1 RECENT\r\n"
+			"a001 NO [TRYCREATE] No such mailbox\r\n"
+		);
+
+		vmime::utility::auto_ptr <IMAPParser::response> resp(ctx.parser->readResponse());
+
+		VASSERT_EQ("Count", 2, resp->continue_req_or_response_data().size());
+
+		const IMAPParser::mailbox_data* data1 =
+			resp->continue_req_or_response_data()[0]->response_data()->mailbox_data();
+
+		VASSERT_EQ("Type 1", IMAPParser::mailbox_data::EXISTS, data1->type());
+		VASSERT_EQ("Number 1", 3, data1->number()->value());
+
+		const IMAPParser::mailbox_data* data2 =
+			resp->continue_req_or_response_data()[1]->response_data()->mailbox_data();
+
+		VASSERT_EQ("Type 2", IMAPParser::mailbox_data::RECENT, data2->type());
+		VASSERT_EQ("Number 2", 1, data2->number()->value());
+
+		const IMAPParser::resp_cond_state* state =
+			resp->response_done()->response_tagged()->resp_cond_state();
+
+		VASSERT_EQ("Status", IMAPParser::resp_cond_state::NO, state->status());
+		VASSERT_EQ("Code", IMAPParser::resp_text_code::TRYCREATE, state->resp_text()->resp_text_code()->type());
+		VASSERT("Not bad", !resp->isBad());
+	}
+
+	void testFetchResponse()
+	{
+		parserContext ctx;
+		ctx.socket->localSend
+		(
+			"* 12 FETCH (UID 1042 RFC822.SIZE 2345 FLAGS (\\Seen \\Answered) "
+			"BODYSTRUCTURE (\"text\" \"plain\" (\"charset\" \"us-ascii\") NIL NIL \"7bit\" 1152 23))\r\n"
+			"a001 OK FETCH completed\r\n"
+		);
+
+		vmime::utility::auto_ptr <IMAPParser::response> resp(ctx.parser->readResponse());
+
+		VASSERT_EQ("Count", 1, resp->continue_req_or_response_data().size());
+
+		const IMAPParser::message_data* msg =
+			resp->continue_req_or_response_data()[0]->response_data()->message_data();
+
+		VASSERT_EQ("Number", 12, msg->number());
+		VASSERT_EQ("Type", IMAPParser::message_data::FETCH, msg->type());
+
+		const std::vector <IMAPParser::msg_att_item*>& items = msg->msg_att()->items();
+
+		VASSERT_EQ("Items", 4, items.size());
+		VASSERT_EQ("UID type", IMAPParser::msg_att_item::UID, items[0]->type());
+		VASSERT_EQ("UID", 1042, items[0]->unique_id()->value());
+		VASSERT_EQ("Size type", IMAPParser::msg_att_item::RFC822_SIZE, items[1]->type());
+		VASSERT_EQ("Size", 2345, items[1]->number()->value());
+		VASSERT_EQ("Flags type", IMAPParser::msg_att_item::FLAGS, items[2]->type());
+		VASSERT_EQ("Flags", 2, items[2]->flag_list()->flags().size());
+		VASSERT_EQ("Structure type", IMAPParser::msg_att_item::BODY_STRUCTURE, items[3]->type());
+		VASSERT("Structure", items[3]->body()->body_type_1part() != NULL);
+	}
+
+	void testDateTime()
+	{
+		parserContext ctx;
+		ctx.socket->localSend
+		(
+			"* 1 FETCH (INTERNALDATE \"17-Jul-1996 02:44:25 -0700\")\r\n"
+			"* 2 FETCH (INTERNALDATE \" 3-Dec-2012 21:05:00 +0130\")\r\n"
+			"a001 OK FETCH completed\r\n"
+		);
+
+		vmime::utility::auto_ptr <IMAPParser::response> resp(ctx.parser->readResponse());
+
+		VASSERT_EQ("Count", 2, resp->continue_req_or_response_data().size());
+
+		const vmime::datetime& d1 = resp->continue_req_or_response_data()[0]->
+			response_data()->message_data()->msg_att()->items()[0]->date_time()->value();
+
+		VASSERT_EQ("1.Year", 1996, d1.getYear());
+		VASSERT_EQ("1.Month", vmime::datetime::JULY, d1.getMonth());
+		VASSERT_EQ("1.Day", 17, d1.getDay());
+		VASSERT_EQ("1.Hour", 2, d1.getHour());
+		VASSERT_EQ("1.Minute", 44, d1.getMinute());
+		VASSERT_EQ("1.Second", 25, d1.getSecond());
+		VASSERT_EQ("1.Zone", -420, d1.getZone());
+
+		const vmime::datetime& d2 = resp->continue_req_or_response_data()[1]->
+			response_data()->message_data()->msg_att()->items()[0]->date_time()->value();
+
+		VASSERT_EQ("2.Year", 2012, d2.getYear());
+		VASSERT_EQ("2.Month", vmime::datetime::DECEMBER, d2.getMonth());
+		VASSERT_EQ("2.Day", 3, d2.getDay());
+		VASSERT_EQ("2.Zone", 90, d2.getZone());
+	}
+
+	void testSpecialAtomCase()
+	{
+		parserContext ctx;
+		ctx.socket->localSend
+		(
+			"* 4 fetch (uid 7 Flags ())\r\n"
+			"* 5 EXPUNGE\r\n"
+			"a001 ok Done\r\n"
+		);
+
+		vmime::utility::auto_ptr <IMAPParser::response> resp(ctx.parser->readResponse());
+
+		VASSERT_EQ("Count", 2, resp->continue_req_or_response_data().size());
+
+		const IMAPParser::message_data* msg1 =
+			resp->continue_req_or_response_data()[0]->response_data()->message_data();
+
+		VASSERT_EQ("Type 1", IMAPParser::message_data::FETCH, msg1->type());
+		VASSERT_EQ("UID", 7, msg1->msg_att()->items()[0]->unique_id()->value());
+
+		const IMAPParser::message_data* msg2 =
+			resp->continue_req_or_response_data()[1]->response_data()->message_data();
+
+		VASSERT_EQ("Type 2", IMAPParser::message_data::EXPUNGE, msg2->type());
+		VASSERT_EQ("Status", IMAPParser::resp_cond_state::OK,
+			resp->response_done()->response_tagged()->resp_cond_state()->status());
+	}
+
+	void testLiteral()
+	{
+		parserContext ctx;
+		ctx.socket->localSend
+		(
+			"* 1 FETCH (RFC822.HEADER {18}\r\n"
+			"Subject: Hello\r\n\r\n"
+			" UID 9)\r\n"
+			"a001 OK FETCH completed\r\n"
+		);
+
+		vmime::utility::auto_ptr <IMAPParser::response> resp(ctx.parser->readResponse());
+
+		const std::vector <IMAPParser::msg_att_item*>& items =
+			resp->continue_req_or_response_data()[0]->response_data()->message_data()->msg_att()->items();
+
+		VASSERT_EQ("Items", 2, items.size());
+		VASSERT_EQ("Header", "Subject: Hello\r\n\r\n", items[0]->nstring()->value());
+		VASSERT_EQ("UID", 9, items[1]->unique_id()->value());
+	}
+
+	void testInvalidResponse()
+	{
+		parserContext ctx;
+		ctx.socket->localSend("* 1 FETCH (UID x)\r\n");
+
+		try
+		{
+			delete ctx.parser->readResponse();
+			VASSERT("Exception expected", false);
+		}
+		catch (vmime::exceptions::invalid_response& e)
+		{
+			// The error is reported at the furthest position reached
+			VASSERT_EQ("Position", "* 1 FETCH (UID [^]x)\r\n [number]", e.response());
+		}
+	}
+
+	void testResponseOutlivesParser()
+	{
+		IMAPParser::response* resp = NULL;
+
+		{
+			parserContext ctx;
+			ctx.socket->localSend
+			(
+				"* LIST (\\HasNoChildren) \"/\" \"INBOX/Sent\"\r\n"
+				"* LIST (\\HasNoChildren) \"/\" \"INBOX/Drafts\"\r\n"
+				"a001 OK LIST completed\r\n"
+			);
+
+			resp = ctx.parser->readResponse();
+		}
+
+		vmime::utility::auto_ptr <IMAPParser::response> respPtr(resp);
+
+		VASSERT_EQ("Count", 2, resp->continue_req_or_response_data().size());
+		VASSERT_EQ("Name 1", "INBOX/Sent", resp->continue_req_or_response_data()[0]->
+			response_data()->mailbox_data()->mailbox_list()->mailbox()->name());
+		VASSERT_EQ("Name 2", "INBOX/Drafts", resp->continue_req_or_response_data()[1]->
+			response_data()->mailbox_data()->mailbox_list()->mailbox()->name());
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -0,0 +1,219 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/net/pop3/POP3Folder.hpp"
+#include "vmime/net/pop3/POP3UIDStore.hpp"
+
+
+#define VMIME_TEST_SUITE         POP3FolderTest
+#define VMIME_TEST_SUITE_MODULE  "Net/POP3"
+
+
+class UIDLPOP3TestSocket;
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testFetchUIDs)
+		VMIME_TEST(testFetchUIDsSubset)
+		VMIME_TEST(testGetUIDChanges)
+	VMIME_TEST_LIST_END
+
+
+	vmime::ref <vmime::net::folder> openFolder(vmime::ref <vmime::net::store>& st)
+	{
+		vmime::ref <vmime::net::session> session =
+			vmime::create <vmime::net::session>();
+
+		session->getProperties()["store.pop3.options.sasl"] = false;
+		session->getProperties()["store.pop3.options.apop"] = false;
+		session->getProperties()["store.pop3.auth.username"] = "user";
+		session->getProperties()["store.pop3.auth.password"] = "password";
+
+		st = session->getStore(vmime::utility::url("pop3://localhost"));
+
+		st->setSocketFactory(vmime::create <testSocketFactory <UIDLPOP3TestSocket> >());
+		st->setTimeoutHandlerFactory(vmime::create <testTimeoutHandlerFactory>());
+
+		st->connect();
+
+		vmime::ref <vmime::net::folder> f = st->getDefaultFolder();
+		f->open(vmime::net::folder::MODE_READ_ONLY);
+
+		return f;
+	}
+
+	void testFetchUIDs()
+	{
+		vmime::ref <vmime::net::store> st;
+		vmime::ref <vmime::net::folder> f = openFolder(st);
+
+		std::vector <vmime::ref <vmime::net::message> > msgs = f->getMessages();
+		f->fetchMessages(msgs, vmime::net::folder::FETCH_UID | vmime::net::folder::FETCH_SIZE);
+
+		VASSERT_EQ("Count", 500, static_cast <int>(msgs.size()));
+		VASSERT_EQ("UID 1", "uid-1", msgs[0]->getUniqueId());
+		VASSERT_EQ("UID 500", "uid-500", msgs[499]->getUniqueId());
+		VASSERT_EQ("Size 500", 1500, msgs[499]->getSize());
+	}
+
+	void testFetchUIDsSubset()
+	{
+		vmime::ref <vmime::net::store> st;
+		vmime::ref <vmime::net::folder> f = openFolder(st);
+
+		// Only a few messages: the server rejects full listings
+		// here, so this ensures "UIDL n" and "LIST n" are used
+		std::vector <vmime::ref <vmime::net::message> > msgs = f->getMessages(42, 43);
+		f->fetchMessages(msgs, vmime::net::folder::FETCH_UID | vmime::net::folder::FETCH_SIZE);
+
+		VASSERT_EQ("UID 42", "uid-42", msgs[0]->getUniqueId());
+		VASSERT_EQ("UID 43", "uid-43", msgs[1]->getUniqueId());
+		VASSERT_EQ("Size 43", 129, msgs[1]->getSize());
+	}
+
+	void testGetUIDChanges()
+	{
+		vmime::ref <vmime::net::store> st;
+		vmime::ref <vmime::net::folder> f = openFolder(st);
+
+		vmime::net::pop3::POP3UIDStore seen;
+
+		for (int i = 1 ; i <= 500 ; ++i)
+		{
+			if (i != 7 && i != 300)
+			{
+				std::ostringstream oss;
+				oss << "uid-" << i;
+
+				seen.add(oss.str());
+			}
+		}
+
+		seen.add("uid-0");
+		seen.add("uid-999");
+
+		std::vector <vmime::ref <vmime::net::message> > newMessages;
+		std::vector <vmime::net::message::uid> removedUIDs;
+
+		f.dynamicCast <vmime::net::pop3::POP3Folder>()->getUIDChanges(seen, newMessages, removedUIDs);
+
+		VASSERT_EQ("New count", 2, static_cast <int>(newMessages.size()));
+		VASSERT_EQ("New 1 number", 7, newMessages[0]->getNumber());
+		VASSERT_EQ("New 1 UID", "uid-7", newMessages[0]->getUniqueId());
+		VASSERT_EQ("New 2 number", 300, newMessages[1]->getNumber());
+		VASSERT_EQ("New 2 UID", "uid-300", newMessages[1]->getUniqueId());
+
+		VASSERT_EQ("Removed count", 2, static_cast <int>(removedUIDs.size()));
+		VASSERT_EQ("Removed 1", "uid-0", removedUIDs[0]);
+		VASSERT_EQ("Removed 2", "uid-999", removedUIDs[1]);
+	}
+
+VMIME_TEST_SUITE_END
+
+
+/** POP3 test server.
+  *
+  * Mailbox with 500 messages: message 'n' has UID "uid-n" and its size
+  * is 3 * n bytes. Full LIST and UIDL listings are rejected when
+  * the client only asked for messages 42 and 43 before.
+  */
+class UIDLPOP3TestSocket : public lineBasedTestSocket
+{
+public:
+
+	UIDLPOP3TestSocket()
+		: m_singleCommands(false)
+	{
+	}
+
+	void onConnected()
+	{
+		localSend("+OK test.vmime.org POP3 server ready\r\n");
+	}
+
+	void processCommand()
+	{
+		if (!haveMoreLines())
+			return;
+
+		vmime::string line = getNextLine();
+		std::istringstream iss(line);
+
+		std::string cmd;
+		iss >> cmd;
+
+		int num = 0;
+		const bool hasNum = !!(iss >> num);
+
+		std::ostringstream resp;
+
+		if (cmd == "USER" || cmd == "PASS" || cmd == "QUIT")
+		{
+			resp << "+OK\r\n";
+		}
+		else if (cmd == "STAT")
+		{
+			resp << "+OK 500 375750\r\n";
+		}
+		else if ((cmd == "UIDL" || cmd == "LIST") && hasNum)
+		{
+			m_singleCommands = m_singleCommands || num == 42;
+
+			resp << "+OK " << num << " ";
+
+			if (cmd == "UIDL")
+				resp << "uid-" << num << "\r\n";
+			else
+				resp << (3 * num) << "\r\n";
+		}
+		else if ((cmd == "UIDL" || cmd == "LIST") && !m_singleCommands)
+		{
+			resp << "+OK\r\n";
+
+			for (int i = 1 ; i <= 500 ; ++i)
+			{
+				if (cmd == "UIDL")
+					resp << i << " uid-" << i << "\r\n";
+				else
+					resp << i << " " << (3 * i) << "\r\n";
+			}
+
+			resp << ".\r\n";
+		}
+		else
+		{
+			resp << "-ERR\r\n";
+		}
+
+		localSend(resp.str());
+		processCommand();
+	}
+
+private:
+
+	bool m_singleCommands;
+};
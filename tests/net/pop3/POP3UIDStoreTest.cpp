@@ -0,0 +1,137 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/net/pop3/POP3UIDStore.hpp"
+
+
+#define VMIME_TEST_SUITE         POP3UIDStoreTest
+#define VMIME_TEST_SUITE_MODULE  "Net/POP3"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testAddRemove)
+		VMIME_TEST(testSave)
+		VMIME_TEST(testLoad)
+		VMIME_TEST(testLoadInvalid)
+	VMIME_TEST_LIST_END
+
+
+	typedef vmime::net::pop3::POP3UIDStore POP3UIDStore;
+
+
+	void testAddRemove()
+	{
+		POP3UIDStore store;
+
+		store.add("whqtswO00WBw418f9t5JxYwZ");
+		store.add("QhdPYR:00WBw1Ph7x7");
+		store.add("whqtswO00WBw418f9t5JxYwZ");
+
+		VASSERT_EQ("1", 2, store.getUIDCount());
+		VASSERT("2", store.contains("QhdPYR:00WBw1Ph7x7"));
+		VASSERT("3", !store.contains("QhdPYR"));
+
+		store.remove("QhdPYR:00WBw1Ph7x7");
+
+		VASSERT_EQ("4", 1, store.getUIDCount());
+		VASSERT("5", !store.contains("QhdPYR:00WBw1Ph7x7"));
+	}
+
+	void testSave()
+	{
+		POP3UIDStore store;
+
+		store.add("msg-000123");
+		store.add("msg-000120");
+		store.add("abc");
+		store.add("msg-000");
+
+		std::ostringstream oss;
+		vmime::utility::outputStreamAdapter os(oss);
+
+		store.save(os);
+
+		VASSERT_EQ("Save",
+			"vmime-pop3-uids 1\n"
+			"0 abc\n"
+			"0 msg-000\n"
+			"7 120\n"
+			"9 3\n", oss.str());
+	}
+
+	void testLoad()
+	{
+		POP3UIDStore store;
+		store.add("to be replaced");
+
+		vmime::string data =
+			"vmime-pop3-uids 1\n"
+			"0 abc\n"
+			"0 msg-000\n"
+			"7 120\n"
+			"9 3\n";
+
+		vmime::utility::inputStreamStringAdapter is(data);
+
+		store.load(is);
+
+		VASSERT_EQ("Count", 4, store.getUIDCount());
+		VASSERT("1", store.contains("abc"));
+		VASSERT("2", store.contains("msg-000"));
+		VASSERT("3", store.contains("msg-000120"));
+		VASSERT("4", store.contains("msg-000123"));
+
+		// Round trip
+		std::ostringstream oss;
+		vmime::utility::outputStreamAdapter os(oss);
+
+		store.save(os);
+
+		VASSERT_EQ("Save", data, oss.str());
+	}
+
+	void testLoadInvalid()
+	{
+		POP3UIDStore store;
+		store.add("abc");
+
+		vmime::string data1 = "something else\n0 abc\n";
+		vmime::utility::inputStreamStringAdapter is1(data1);
+
+		VASSERT_THROW("Signature", store.load(is1), vmime::exceptions::invalid_argument);
+
+		vmime::string data2 = "vmime-pop3-uids 1\n0 abc\n5 def\n";
+		vmime::utility::inputStreamStringAdapter is2(data2);
+
+		VASSERT_THROW("Prefix", store.load(is2), vmime::exceptions::invalid_argument);
+
+		// Store is left unchanged
+		VASSERT_EQ("Count", 1, store.getUIDCount());
+		VASSERT("Contains", store.contains("abc"));
+	}
+
+VMIME_TEST_SUITE_END
@@ -0,0 +1,234 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2009 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/platform.hpp"
+
+#include "vmime/net/servicePool.hpp"
+#include "vmime/net/store.hpp"
+
+
+#define VMIME_TEST_SUITE         servicePoolTest
+#define VMIME_TEST_SUITE_MODULE  "Net"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testReuse)
+		VMIME_TEST(testKeyedByURL)
+		VMIME_TEST(testKeyedBySessionProperties)
+		VMIME_TEST(testDisconnectedNotReused)
+		VMIME_TEST(testMaxIdleCount)
+		VMIME_TEST(testMaxConnectionsPerHost)
+		VMIME_TEST(testNoPool)
+	VMIME_TEST_LIST_END
+
+
+public:
+
+	servicePoolTest()
+	{
+		m_tempPath = "/tmp/vmime" + vmime::utility::stringUtils::toString(std::time(NULL))
+			+ vmime::utility::stringUtils::toString(std::rand());
+	}
+
+	void tearDown()
+	{
+		vmime::ref <vmime::utility::fileSystemFactory> fsf =
+			vmime::platform::getHandler()->getFileSystemFactory();
+
+		const char* suffixes[] = { "a", "b" };
+
+		for (unsigned int i = 0 ; i < sizeof(suffixes) / sizeof(suffixes[0]) ; ++i)
+		{
+			vmime::ref <vmime::utility::file> dir =
+				fsf->create(fsf->stringToPath(m_tempPath + suffixes[i]));
+
+			if (dir->exists())
+				dir->remove();
+		}
+	}
+
+	void testReuse()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		sess->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("connected", st1->isConnected());
+
+		sess->releaseService(st1);
+
+		vmime::ref <vmime::net::store> st2 = sess->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("reused", st1 == st2);
+		VASSERT_EQ("connect count", 1, pool->getConnectCount());
+		VASSERT_EQ("reuse count", 1, pool->getReuseCount());
+
+		sess->releaseService(st2);
+	}
+
+	void testKeyedByURL()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		sess->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess->acquireStore(getURL("a"));
+		sess->releaseService(st1);
+
+		vmime::ref <vmime::net::store> st2 = sess->acquireStore(getURL("b"));
+
+		VASSERT_TRUE("not reused", st1 != st2);
+		VASSERT_EQ("connect count", 2, pool->getConnectCount());
+
+		sess->releaseService(st2);
+	}
+
+	void testKeyedBySessionProperties()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+
+		vmime::ref <vmime::net::session> sess1 = vmime::create <vmime::net::session>();
+		sess1->getProperties()["store.maildir.auth.username"] = "user1";
+		sess1->setServicePool(pool);
+
+		vmime::ref <vmime::net::session> sess2 = vmime::create <vmime::net::session>();
+		sess2->getProperties()["store.maildir.auth.username"] = "user2";
+		sess2->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess1->acquireStore(getURL("a"));
+		sess1->releaseService(st1);
+
+		// Same URL, but the session uses other credentials
+		vmime::ref <vmime::net::store> st2 = sess2->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("not reused", st1 != st2);
+		VASSERT_EQ("connect count", 2, pool->getConnectCount());
+
+		sess2->releaseService(st2);
+
+		// A session with the same properties reuses the service
+		vmime::ref <vmime::net::session> sess3 = vmime::create <vmime::net::session>();
+		sess3->getProperties()["store.maildir.auth.username"] = "user1";
+		sess3->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st3 = sess3->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("reused", st1 == st3);
+		VASSERT_EQ("reuse count", 1, pool->getReuseCount());
+
+		sess3->releaseService(st3);
+	}
+
+	void testDisconnectedNotReused()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		sess->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess->acquireStore(getURL("a"));
+		st1->disconnect();
+		sess->releaseService(st1);
+
+		vmime::ref <vmime::net::store> st2 = sess->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("not reused", st1 != st2);
+		VASSERT_EQ("reuse count", 0, pool->getReuseCount());
+
+		sess->releaseService(st2);
+	}
+
+	void testMaxIdleCount()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		pool->setMaxIdleCount(1);
+		sess->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess->acquireStore(getURL("a"));
+		vmime::ref <vmime::net::store> st2 = sess->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("different", st1 != st2);
+
+		sess->releaseService(st1);
+		sess->releaseService(st2);
+
+		VASSERT_TRUE("kept", st1->isConnected());
+		VASSERT_TRUE("discarded", !st2->isConnected());
+	}
+
+	void testMaxConnectionsPerHost()
+	{
+		vmime::ref <vmime::net::servicePool> pool = vmime::create <vmime::net::servicePool>();
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		pool->setMaxConnectionsPerHost(1);
+		sess->setServicePool(pool);
+
+		vmime::ref <vmime::net::store> st1 = sess->acquireStore(getURL("a"));
+		sess->releaseService(st1);
+
+		// The idle connection for the other URL on the same
+		// server must be closed to make room for the new one
+		vmime::ref <vmime::net::store> st2 = sess->acquireStore(getURL("b"));
+
+		VASSERT_TRUE("different", st1 != st2);
+		VASSERT_TRUE("evicted", !st1->isConnected());
+
+		sess->releaseService(st2);
+	}
+
+	void testNoPool()
+	{
+		vmime::ref <vmime::net::session> sess = vmime::create <vmime::net::session>();
+
+		vmime::ref <vmime::net::store> st = sess->acquireStore(getURL("a"));
+
+		VASSERT_TRUE("connected", st->isConnected());
+
+		sess->releaseService(st);
+
+		VASSERT_TRUE("disconnected", !st->isConnected());
+	}
+
+private:
+
+	vmime::string m_tempPath;
+
+
+	const vmime::utility::url getURL(const vmime::string& suffix)
+	{
+		return vmime::utility::url("maildir://localhost" + m_tempPath + suffix);
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -0,0 +1,179 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#if VMIME_HAVE_TLS_SUPPORT
+
+#include "vmime/net/tls/TLSSessionCache.hpp"
+
+
+#define VMIME_TEST_SUITE         TLSSessionCacheTest
+#define VMIME_TEST_SUITE_MODULE  "Net/TLS"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testMakeKey)
+		VMIME_TEST(testStoreRetrieve)
+		VMIME_TEST(testRemove)
+		VMIME_TEST(testEviction)
+		VMIME_TEST(testDisabled)
+		VMIME_TEST(testCounters)
+	VMIME_TEST_LIST_END
+
+
+public:
+
+	void setUp()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		m_maxEntries = cache->getMaxEntries();
+		cache->clear();
+	}
+
+	void tearDown()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		cache->clear();
+		cache->setMaxEntries(m_maxEntries);
+	}
+
+
+	void testMakeKey()
+	{
+		typedef vmime::net::tls::TLSSessionCache cache;
+
+		VASSERT_EQ("1", "imaps://mail.example.com:993", cache::makeKey("Mail.Example.COM", 993, "IMAPS"));
+		VASSERT("2", cache::makeKey("example.com", 993, "imaps") != cache::makeKey("example.com", 995, "imaps"));
+		VASSERT("3", cache::makeKey("example.com", 993, "imaps") != cache::makeKey("example.com", 993, "pop3s"));
+	}
+
+	void testStoreRetrieve()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		vmime::string data;
+		VASSERT("1", !cache->retrieve("imaps://a:993", data));
+
+		cache->store("imaps://a:993", "data-a");
+		cache->store("imaps://b:993", "data-b");
+
+		VASSERT_TRUE("2", cache->retrieve("imaps://a:993", data));
+		VASSERT_EQ("3", "data-a", data);
+		VASSERT_TRUE("4", cache->retrieve("imaps://b:993", data));
+		VASSERT_EQ("5", "data-b", data);
+
+		// Storing again replaces the data
+		cache->store("imaps://a:993", "data-a2");
+
+		VASSERT_TRUE("6", cache->retrieve("imaps://a:993", data));
+		VASSERT_EQ("7", "data-a2", data);
+	}
+
+	void testRemove()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		cache->store("imaps://a:993", "data-a");
+		cache->store("imaps://b:993", "data-b");
+
+		cache->remove("imaps://a:993");
+
+		vmime::string data;
+		VASSERT("1", !cache->retrieve("imaps://a:993", data));
+		VASSERT_TRUE("2", cache->retrieve("imaps://b:993", data));
+
+		cache->clear();
+
+		VASSERT("3", !cache->retrieve("imaps://b:993", data));
+	}
+
+	void testEviction()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		cache->setMaxEntries(2);
+
+		cache->store("imaps://a:993", "data-a");
+		cache->store("imaps://b:993", "data-b");
+
+		// Storing again makes 'a' the most recently stored entry
+		cache->store("imaps://a:993", "data-a2");
+
+		// 'b' is the least recently stored entry, and is discarded
+		cache->store("imaps://c:993", "data-c");
+
+		vmime::string data;
+		VASSERT_TRUE("1", cache->retrieve("imaps://a:993", data));
+		VASSERT("2", !cache->retrieve("imaps://b:993", data));
+		VASSERT_TRUE("3", cache->retrieve("imaps://c:993", data));
+
+		// Reducing the size discards the oldest entries
+		cache->setMaxEntries(1);
+
+		VASSERT("4", !cache->retrieve("imaps://a:993", data));
+		VASSERT_TRUE("5", cache->retrieve("imaps://c:993", data));
+	}
+
+	void testDisabled()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		cache->store("imaps://a:993", "data-a");
+		cache->setMaxEntries(0);
+
+		vmime::string data;
+		VASSERT("1", !cache->retrieve("imaps://a:993", data));
+
+		cache->store("imaps://a:993", "data-a");
+
+		VASSERT("2", !cache->retrieve("imaps://a:993", data));
+	}
+
+	void testCounters()
+	{
+		vmime::net::tls::TLSSessionCache* cache = vmime::net::tls::TLSSessionCache::getInstance();
+
+		const unsigned long hits = cache->getHitCount();
+		const unsigned long misses = cache->getMissCount();
+
+		cache->registerHandshake(true);
+		cache->registerHandshake(true);
+		cache->registerHandshake(false);
+
+		VASSERT_EQ("1", hits + 2, cache->getHitCount());
+		VASSERT_EQ("2", misses + 1, cache->getMissCount());
+	}
+
+private:
+
+	unsigned int m_maxEntries;
+
+VMIME_TEST_SUITE_END
+
+#endif // VMIME_HAVE_TLS_SUPPORT
+
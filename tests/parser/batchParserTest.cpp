@@ -0,0 +1,332 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/batchParser.hpp"
+#include "vmime/utility/random.hpp"
+
+#include <fstream>
+
+
+#define VMIME_TEST_SUITE         batchParserTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testMessages)
+		VMIME_TEST(testEvents)
+		VMIME_TEST(testErrors)
+		VMIME_TEST(testHandlerException)
+		VMIME_TEST(testFileSource)
+		VMIME_TEST(testSingleThread)
+	VMIME_TEST_LIST_END
+
+
+	static const vmime::string makeMessage(const int n)
+	{
+		std::ostringstream oss;
+		oss << "Subject: message " << n << "\r\n"
+		    << "Content-Type: multipart/mixed; boundary=\"b" << n << "\"\r\n"
+		    << "\r\n"
+		    << "--b" << n << "\r\n"
+		    << "Content-Type: text/plain\r\n"
+		    << "\r\n"
+		    << vmime::string(n * 100, 'x') << "\r\n"
+		    << "--b" << n << "\r\n"
+		    << "Content-Transfer-Encoding: base64\r\n"
+		    << "\r\n"
+		    << "Ym9keQ==\r\n"
+		    << "--b" << n << "--\r\n";
+
+		return oss.str();
+	}
+
+	static const std::vector <vmime::ref <vmime::batchParser::source> > makeSources(const int count)
+	{
+		std::vector <vmime::ref <vmime::batchParser::source> > sources;
+
+		for (int i = 0 ; i < count ; ++i)
+			sources.push_back(vmime::create <vmime::batchParser::stringSource>(makeMessage(i)));
+
+		return sources;
+	}
+
+
+	/** Records the subjects of the messages, and the errors. */
+	class subjectHandler : public vmime::batchParser::messageHandler
+	{
+	public:
+
+		subjectHandler() : m_throwAt(-1) { }
+
+		void onMessage(const vmime::batchParser::size_type index, vmime::ref <vmime::message> msg)
+		{
+			if (static_cast <int>(index) == m_throwAt)
+				throw vmime::exceptions::invalid_argument();
+
+			std::ostringstream oss;
+			oss << index << ":" << msg->getHeader()->Subject()->getValue()
+				.dynamicCast <vmime::text>()->getWholeBuffer() << ":" << msg->getBody()->getPartCount();
+
+			m_trace.push_back(oss.str());
+		}
+
+		void onError(const vmime::batchParser::size_type index, const vmime::exception& e)
+		{
+			std::ostringstream oss;
+			oss << index << ":error:" << e.what();
+
+			m_trace.push_back(oss.str());
+		}
+
+		std::vector <vmime::string> m_trace;
+		int m_throwAt;
+	};
+
+
+	/** Records the events as text, one string per message. */
+	class traceHandler : public vmime::batchParser::eventHandler
+	{
+	public:
+
+		void onMessageBegin(const vmime::batchParser::size_type index)
+		{
+			m_current.str("");
+			m_current << index << ":";
+		}
+
+		void onPartBegin(const int depth)
+		{
+			m_current << "[" << depth;
+		}
+
+		void onHeaderField(const char* name, const vmime::string::size_type nameLength,
+			const char* value, const vmime::string::size_type valueLength)
+		{
+			m_current << "|" << vmime::string(name, nameLength) << "=" << vmime::string(value, valueLength);
+		}
+
+		void onBodyChunk(const vmime::utility::stream::value_type* data,
+			const vmime::utility::stream::size_type count)
+		{
+			m_current << "|" << vmime::string(data, count);
+		}
+
+		void onPartEnd()
+		{
+			m_current << "]";
+		}
+
+		void onMessageEnd(const vmime::batchParser::size_type /* index */)
+		{
+			m_trace.push_back(m_current.str());
+		}
+
+		void onError(const vmime::batchParser::size_type index, const vmime::exception& /* e */)
+		{
+			std::ostringstream oss;
+			oss << index << ":error";
+
+			m_trace.push_back(oss.str());
+		}
+
+		std::ostringstream m_current;
+		std::vector <vmime::string> m_trace;
+	};
+
+
+	/** A source which cannot be read. */
+	class failingSource : public vmime::batchParser::source
+	{
+	public:
+
+		void read(vmime::string& /* data */)
+		{
+			throw vmime::exceptions::system_error("cannot read");
+		}
+	};
+
+
+	void testMessages()
+	{
+		const std::vector <vmime::ref <vmime::batchParser::source> > sources = makeSources(50);
+
+		vmime::batchParser parser(4);
+		parser.setMaxPendingMessages(3);
+
+		subjectHandler h;
+		parser.parse(sources, h);
+
+		VASSERT_EQ("Count", 50, h.m_trace.size());
+
+		for (int i = 0 ; i < 50 ; ++i)
+		{
+			std::ostringstream expected;
+			expected << i << ":message " << i << ":2";
+
+			VASSERT_EQ("Message", expected.str(), h.m_trace[i]);
+		}
+	}
+
+	void testEvents()
+	{
+		const std::vector <vmime::ref <vmime::batchParser::source> > sources = makeSources(20);
+
+		vmime::batchParser parser(3);
+
+		traceHandler h;
+		parser.parse(sources, h);
+
+		VASSERT_EQ("Count", 20, h.m_trace.size());
+
+		// Same events as with a single event parser
+		for (int i = 0 ; i < 20 ; ++i)
+		{
+			traceHandler expected;
+			expected.onMessageBegin(i);
+
+			vmime::mimeEventParser().parse(makeMessage(i), expected);
+
+			expected.onMessageEnd(i);
+
+			VASSERT_EQ("Events", expected.m_trace[0], h.m_trace[i]);
+		}
+
+		VASSERT("Header", h.m_trace[3].find("|Content-Transfer-Encoding=base64|") != vmime::string::npos);
+	}
+
+	void testErrors()
+	{
+		std::vector <vmime::ref <vmime::batchParser::source> > sources = makeSources(10);
+		sources[4] = vmime::create <failingSource>();
+
+		vmime::batchParser parser(4);
+
+		subjectHandler h1;
+		parser.parse(sources, h1);
+
+		VASSERT_EQ("1.1", 10, h1.m_trace.size());
+		VASSERT_EQ("1.2", "3:message 3:2", h1.m_trace[3]);
+		VASSERT_EQ("1.3", "4:error:cannot read", h1.m_trace[4]);
+		VASSERT_EQ("1.4", "5:message 5:2", h1.m_trace[5]);
+
+		traceHandler h2;
+		parser.parse(sources, h2);
+
+		VASSERT_EQ("2.1", 10, h2.m_trace.size());
+		VASSERT_EQ("2.2", "4:error", h2.m_trace[4]);
+	}
+
+	void testHandlerException()
+	{
+		const std::vector <vmime::ref <vmime::batchParser::source> > sources = makeSources(100);
+
+		vmime::batchParser parser(4);
+
+		subjectHandler h;
+		h.m_throwAt = 10;
+
+		VASSERT_THROW("Exception", parser.parse(sources, h), vmime::exceptions::invalid_argument);
+		VASSERT_EQ("Count", 10, h.m_trace.size());
+
+		// The parser can be used again
+		h.m_throwAt = -1;
+		h.m_trace.clear();
+
+		parser.parse(sources, h);
+
+		VASSERT_EQ("Count after", 100, h.m_trace.size());
+	}
+
+	void testFileSource()
+	{
+		vmime::ref <vmime::utility::fileSystemFactory> fsf =
+			vmime::platform::getHandler()->getFileSystemFactory();
+
+		vmime::utility::file::path dirPath = fsf->stringToPath("/tmp");
+		dirPath.appendComponent(vmime::utility::file::path::component
+			("vmime-test-" + vmime::utility::random::getString(16)));
+
+		vmime::ref <vmime::utility::file> dir = fsf->create(dirPath);
+		dir->createDirectory();
+
+		std::vector <vmime::ref <vmime::batchParser::source> > sources;
+
+		for (int i = 0 ; i < 5 ; ++i)
+		{
+			vmime::utility::file::path path = dirPath;
+			path.appendComponent(vmime::utility::file::path::component
+				("msg" + vmime::utility::stringUtils::toString(i)));
+
+			{
+				std::ofstream ofs(fsf->pathToString(path).c_str(), std::ios::out | std::ios::binary);
+				ofs << makeMessage(i);
+			}
+
+			sources.push_back(vmime::create <vmime::batchParser::fileSource>(fsf->create(path)));
+		}
+
+		vmime::batchParser parser(2);
+
+		subjectHandler h;
+		parser.parse(sources, h);
+
+		for (int i = 0 ; i < 5 ; ++i)
+		{
+			vmime::utility::file::path path = dirPath;
+			path.appendComponent(vmime::utility::file::path::component
+				("msg" + vmime::utility::stringUtils::toString(i)));
+
+			fsf->create(path)->remove();
+		}
+
+		dir->remove();
+
+		VASSERT_EQ("Count", 5, h.m_trace.size());
+		VASSERT_EQ("Message", "2:message 2:2", h.m_trace[2]);
+	}
+
+	void testSingleThread()
+	{
+		const std::vector <vmime::ref <vmime::batchParser::source> > sources = makeSources(5);
+
+		vmime::batchParser parser(1);
+
+		subjectHandler h;
+		parser.parse(sources, h);
+
+		VASSERT_EQ("Count", 5, h.m_trace.size());
+		VASSERT_EQ("Message", "4:message 4:2", h.m_trace[4]);
+
+		// No source
+		subjectHandler h2;
+		parser.parse(std::vector <vmime::ref <vmime::batchParser::source> >(), h2);
+
+		VASSERT_EQ("Empty", 0, h2.m_trace.size());
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -23,6 +23,8 @@
 
 #include "tests/testUtils.hpp"
 
+#include "vmime/utility/seekableInputStreamRegionAdapter.hpp"
+
 
 #define VMIME_TEST_SUITE         bodyPartTest
 #define VMIME_TEST_SUITE_MODULE  "Parser"
@@ -41,9 +43,55 @@ VMIME_TEST_SUITE_BEGIN
 		VMIME_TEST(testGenerate7bit)
 		VMIME_TEST(testTextUsageForQPEncoding)
 		VMIME_TEST(testParseVeryBigMessage)
+		VMIME_TEST(testVisitChildComponents)
+		VMIME_TEST(testParseFromStream)
+		VMIME_TEST(testParseStreamRegion)
 	VMIME_TEST_LIST_END
 
 
+	// Seekable stream whose contents are not held in memory
+	class opaqueStream : public vmime::utility::seekableInputStream
+	{
+	public:
+
+		opaqueStream(const vmime::string& buffer)
+			: m_stream(buffer)
+		{
+		}
+
+		bool eof() const { return m_stream.eof(); }
+		void reset() { m_stream.reset(); }
+		size_type read(value_type* const data, const size_type count) { return m_stream.read(data, count); }
+		size_type skip(const size_type count) { return m_stream.skip(count); }
+		size_type getPosition() const { return m_stream.getPosition(); }
+		void seek(const size_type pos) { m_stream.seek(pos); }
+
+	private:
+
+		vmime::utility::inputStreamStringAdapter m_stream;
+	};
+
+
+	class childCollector : public vmime::component::childVisitor
+	{
+	public:
+
+		childCollector(const unsigned int max)
+			: m_max(max)
+		{
+		}
+
+		bool visit(vmime::component& child)
+		{
+			m_children.push_back(&child);
+			return m_children.size() < m_max;
+		}
+
+		std::vector <vmime::component*> m_children;
+		const unsigned int m_max;
+	};
+
+
 	static const vmime::string extractComponentString
 		(const vmime::string& buffer, const vmime::component& c)
 	{
@@ -327,5 +375,110 @@ VMIME_TEST_SUITE_BEGIN
 		VASSERT("2.2", body2Cts.dynamicCast <const vmime::streamContentHandler>() != NULL);
 	}
 
+	void testVisitChildComponents()
+	{
+		vmime::bodyPart p;
+		p.parse("Subject: test\r\nTo: a@b.c, d@e.f\r\nContent-Type: multipart/mixed; boundary=\"X\"\r\n\r\n"
+		        "--X\r\n\r\nfoo\r\n--X\r\n\r\nbar\r\n--X--\r\n");
+
+		vmime::component& hdr = *p.getHeader();
+		vmime::component& bdy = *p.getBody();
+
+		// Same children, in the same order, as getChildComponents()
+		vmime::component* comps[] = { &p, &hdr, &bdy };
+
+		for (unsigned int i = 0 ; i < sizeof(comps) / sizeof(comps[0]) ; ++i)
+		{
+			const std::vector <vmime::ref <vmime::component> > expected =
+				comps[i]->getChildComponents();
+
+			childCollector all(~0u);
+
+			VASSERT_TRUE("visit", comps[i]->visitChildComponents(all));
+			VASSERT_EQ("count", expected.size(), all.m_children.size());
+
+			for (unsigned int j = 0 ; j < expected.size() ; ++j)
+				VASSERT_EQ("child", expected[j].get(), static_cast <const vmime::component*>(all.m_children[j]));
+		}
+
+		// Walk stops when the visitor returns false
+		childCollector first(1);
+
+		VASSERT("stop", !hdr.visitChildComponents(first));
+		VASSERT_EQ("stop count", 1, first.m_children.size());
+	}
+
+	void testParseFromStream()
+	{
+		const vmime::string str =
+			"Subject: test\r\nContent-Type: multipart/mixed; boundary=\"X\"\r\n\r\n"
+			"--X\r\nFrom: a@b.c\r\n\r\nfoo\r\n--X--\r\n";
+		const vmime::string prefix = "garbage";
+
+		vmime::ref <vmime::utility::seekableInputStream> streams[] =
+		{
+			// Parsed in place
+			vmime::create <vmime::utility::inputStreamStringAdapter>(str),
+			vmime::create <vmime::utility::inputStreamStringAdapter>
+				(prefix + str + prefix, prefix.length(), prefix.length() + str.length()),
+			// Parsed from a copy
+			vmime::create <opaqueStream>(str)
+		};
+
+		for (unsigned int i = 0 ; i < sizeof(streams) / sizeof(streams[0]) ; ++i)
+		{
+			std::ostringstream oss;
+			oss << "Stream " << i;
+
+			vmime::bodyPart p;
+			p.parse(streams[i], str.length());
+
+			vmime::ref <vmime::bodyPart> part = p.getBody()->getPartAt(0);
+			vmime::ref <vmime::headerField> from = part->getHeader()->findField("From");
+
+			VASSERT_EQ(oss.str() + " subject", "test",
+				p.getHeader()->Subject()->getValue().dynamicCast <vmime::text>()->getWholeBuffer());
+			VASSERT_EQ(oss.str() + " from", "From: a@b.c\r\n", extractComponentString(str, *from));
+			VASSERT_EQ(oss.str() + " part header", "From: a@b.c\r\n\r\n", extractComponentString(str, *part->getHeader()));
+			VASSERT_EQ(oss.str() + " part body", "foo", extractContents(part->getBody()->getContents()));
+		}
+	}
+
+	void testParseStreamRegion()
+	{
+		const vmime::string str = "Hello world";
+		const vmime::string data = "garbage" + str + "MORE";
+		const vmime::string::size_type begin = 7;
+
+		vmime::ref <vmime::utility::seekableInputStream> memoryStream =
+			vmime::create <vmime::utility::inputStreamStringAdapter>(data);
+		vmime::ref <vmime::utility::seekableInputStream> copiedStream =
+			vmime::create <opaqueStream>(data);
+
+		vmime::ref <vmime::utility::seekableInputStream> streams[] =
+		{
+			// Parsed in place
+			vmime::create <vmime::utility::inputStreamStringAdapter>(data, begin, begin + str.length()),
+			vmime::create <vmime::utility::seekableInputStreamRegionAdapter>(memoryStream, begin, str.length()),
+			// Parsed from a copy
+			vmime::create <vmime::utility::seekableInputStreamRegionAdapter>(copiedStream, begin, str.length())
+		};
+
+		for (unsigned int i = 0 ; i < sizeof(streams) / sizeof(streams[0]) ; ++i)
+		{
+			std::ostringstream oss;
+			oss << "Stream " << i;
+
+			// Data past the end of the stream must not be parsed,
+			// even if a greater length is given
+			vmime::text t;
+			t.parse(streams[i], str.length() + 100);
+
+			VASSERT_EQ(oss.str() + " text", str, t.getWholeBuffer());
+			VASSERT_EQ(oss.str() + " offset", 0, t.getParsedOffset());
+			VASSERT_EQ(oss.str() + " length", str.length(), t.getParsedLength());
+		}
+	}
+
 VMIME_TEST_SUITE_END
 
@@ -101,9 +101,13 @@ VMIME_TEST_SUITE_BEGIN
 		VMIME_TEST(testFilterValid2)
 		VMIME_TEST(testFilterValid3)
 		VMIME_TEST(testEncodingHebrew1255)
+		VMIME_TEST(testConverterPoolReuse)
+		VMIME_TEST(testConvertNative)
+		VMIME_TEST(testFilterNativeSplitSequence)
 
 		// Test invalid input
 		VMIME_TEST(testFilterInvalid1)
+		VMIME_TEST(testConvertNativeInvalid)
 
 		// TODO: more tests
 	VMIME_TEST_LIST_END
@@ -238,6 +242,80 @@ VMIME_TEST_SUITE_BEGIN
 		VASSERT_EQ("1", "=?windows-1255?B?6fn3+On5+Pfp6fk=?=", encoded);
 	}
 
+	void testConverterPoolReuse()
+	{
+		vmime::charsetConverterPool* pool = vmime::charsetConverterPool::getInstance();
+
+		vmime::string in(inputBytes, sizeof(inputBytes) - 1);
+		vmime::string expectedOut(outputBytes, sizeof(outputBytes) - 1);
+		vmime::string actualOut;
+
+		// Warm-up
+		vmime::charset::convert(in, actualOut, inputCharset, outputCharset);
+
+		const unsigned long openCount = pool->getOpenCount();
+		const unsigned long reuseCount = pool->getReuseCount();
+
+		for (int i = 0 ; i < 10 ; ++i)
+		{
+			vmime::charset::convert(in, actualOut, inputCharset, outputCharset);
+			VASSERT_EQ("1", toHex(expectedOut), toHex(actualOut));
+		}
+
+		// Charset names are not case-sensitive
+		vmime::charset::convert(in, actualOut, vmime::charset("GB2312"), vmime::charset("UTF-8"));
+		VASSERT_EQ("2", toHex(expectedOut), toHex(actualOut));
+
+		VASSERT_EQ("3", openCount, pool->getOpenCount());
+		VASSERT_EQ("4", reuseCount + 11, pool->getReuseCount());
+	}
+
+	static const vmime::string convert(const vmime::string& in,
+		const vmime::charset& source, const vmime::charset& dest)
+	{
+		vmime::string out;
+		vmime::charset::convert(in, out, source, dest);
+
+		return out;
+	}
+
+	void testConvertNative()
+	{
+		VASSERT_EQ("1", "caf\xc3\xa9", convert("caf\xe9", "iso-8859-1", "utf-8"));
+		VASSERT_EQ("2", "caf\xe9", convert("caf\xc3\xa9", "utf-8", "ISO-8859-1"));
+		VASSERT_EQ("3", "\xe2\x82\xac", convert("\xa4", "iso-8859-15", "utf-8"));
+		VASSERT_EQ("4", "\xa4", convert("\xe2\x82\xac", "utf-8", "iso-8859-15"));
+		VASSERT_EQ("5", "\xf0\x9f\x98\x80 ok", convert("\xf0\x9f\x98\x80 ok", "utf-8", "utf8"));
+		VASSERT_EQ("6", "plain text", convert("plain text", "us-ascii", "iso-8859-15"));
+	}
+
+	void testConvertNativeInvalid()
+	{
+		// One replacement character for each byte of the sequence
+		VASSERT_EQ("1", "1 ??? 2", convert("1 \xe2\x82\xac 2", "utf-8", "iso-8859-1"));
+		VASSERT_EQ("2", "a?b", convert("a\xe9" "b", "us-ascii", "utf-8"));
+		VASSERT_EQ("3", "a??b", convert("a\xc0\x80" "b", "utf-8", "utf-8"));  // overlong
+		VASSERT_EQ("4", "a???b", convert("a\xed\xa0\x80" "b", "utf-8", "utf-8"));  // surrogate
+		VASSERT_EQ("5", "a??", convert("a\xe2\x82", "utf-8", "iso-8859-1"));  // truncated
+	}
+
+	void testFilterNativeSplitSequence()
+	{
+		vmime::string actualOut;
+		vmime::utility::outputStreamStringAdapter osa(actualOut);
+		vmime::utility::charsetFilteredOutputStream os
+			(vmime::charset("utf-8"), vmime::charset("iso-8859-15"), osa);
+
+		const vmime::string in("\xe2\x82\xac x \xc3\xa9\xe2");
+
+		for (unsigned int i = 0 ; i < in.length() ; ++i)
+			os.write(in.data() + i, 1);
+
+		os.flush();
+
+		VASSERT_EQ("1", "\xa4 x \xe9?", actualOut);
+	}
+
 	// Conversion to hexadecimal for easier debugging
 	static const vmime::string toHex(const vmime::string str)
 	{
@@ -0,0 +1,199 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2009 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/componentInputStream.hpp"
+#include "vmime/contentTypeField.hpp"
+
+
+#define VMIME_TEST_SUITE         componentInputStreamTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testRead)
+		VMIME_TEST(testSize)
+		VMIME_TEST(testResetAndSkip)
+		VMIME_TEST(testStopReading)
+		VMIME_TEST(testGenerationError)
+	VMIME_TEST_LIST_END
+
+
+	/** An input stream which fails after some data has been read. */
+	class failingInputStream : public vmime::utility::inputStream
+	{
+	public:
+
+		failingInputStream() : m_count(0) { }
+
+		bool eof() const { return false; }
+		void reset() { m_count = 0; }
+
+		size_type read(value_type* const data, const size_type count)
+		{
+			if (m_count >= 10000)
+				throw vmime::exceptions::invalid_argument();
+
+			std::fill(data, data + count, 'x');
+			m_count += count;
+
+			return count;
+		}
+
+		size_type skip(const size_type count)
+		{
+			m_count += count;
+			return count;
+		}
+
+	private:
+
+		size_type m_count;
+	};
+
+
+	static vmime::ref <vmime::message> createMessage()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+
+		msg->getHeader()->Subject()->setValue(vmime::text("Streaming generation"));
+		msg->getHeader()->ContentType()->setValue(vmime::mediaType("multipart/mixed"));
+
+		for (int i = 0 ; i < 3 ; ++i)
+		{
+			vmime::ref <vmime::bodyPart> part = vmime::create <vmime::bodyPart>();
+
+			part->getBody()->setContents(vmime::create <vmime::stringContentHandler>
+				(vmime::string(100000, static_cast <char>('a' + i))));
+			part->getBody()->setEncoding(vmime::encoding("base64"));
+
+			msg->getBody()->appendPart(part);
+		}
+
+		return msg;
+	}
+
+	static const vmime::string readAll(vmime::utility::inputStream& is, const vmime::string::size_type blockSize)
+	{
+		std::vector <vmime::utility::stream::value_type> buffer(blockSize);
+		vmime::string data;
+
+		while (!is.eof())
+		{
+			const vmime::utility::stream::size_type n = is.read(&buffer[0], blockSize);
+			data.append(&buffer[0], n);
+		}
+
+		return data;
+	}
+
+
+	void testRead()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+		msg->getHeader()->ContentType().dynamicCast <vmime::contentTypeField>()->setBoundary("=_boundary");
+
+		const vmime::string expected = msg->generate(76);
+
+		vmime::componentInputStream is1(msg, 76);
+		VASSERT_EQ("1", expected, readAll(is1, 16384));
+
+		vmime::componentInputStream is2(msg, 76);
+		VASSERT_EQ("2", expected, readAll(is2, 7));
+	}
+
+	void testSize()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+
+		vmime::componentInputStream is(msg, 76);
+
+		const vmime::utility::stream::size_type size = is.getSize();
+
+		VASSERT_EQ("1", msg->generate(76).length(), size);
+		VASSERT_EQ("2", size, readAll(is, 4096).length());
+	}
+
+	void testResetAndSkip()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+		msg->getHeader()->ContentType().dynamicCast <vmime::contentTypeField>()->setBoundary("=_boundary");
+
+		const vmime::string expected = msg->generate(76);
+
+		vmime::componentInputStream is(msg, 76);
+
+		vmime::utility::stream::value_type buffer[100];
+		VASSERT_EQ("1", 100, is.read(buffer, sizeof(buffer)));
+
+		is.reset();
+
+		VASSERT_EQ("2", 150000, is.skip(150000));
+		VASSERT_EQ("3", expected.substr(150000), readAll(is, 1000));
+
+		VASSERT_EQ("4", 0, is.skip(10));
+		VASSERT_TRUE("5", is.eof());
+	}
+
+	void testStopReading()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+
+		// Destroying the stream before the end must stop generation
+		vmime::ref <vmime::componentInputStream> is =
+			vmime::create <vmime::componentInputStream>(msg, 76);
+
+		vmime::utility::stream::value_type buffer[100];
+		VASSERT_EQ("1", 100, is->read(buffer, sizeof(buffer)));
+
+		is = NULL;
+	}
+
+	void testGenerationError()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+
+		vmime::ref <vmime::utility::inputStream> contents = vmime::create <failingInputStream>();
+
+		msg->getBody()->setContents(vmime::create <vmime::streamContentHandler>
+			(contents, static_cast <vmime::utility::stream::size_type>(100000)));
+
+		vmime::componentInputStream is(msg, 76);
+
+		// The exception thrown during generation must keep its type
+		try
+		{
+			readAll(is, 4096);
+			VASSERT("Expected exception", false);
+		}
+		catch (vmime::exceptions::invalid_argument&)
+		{
+			// OK
+		}
+	}
+
+VMIME_TEST_SUITE_END
+
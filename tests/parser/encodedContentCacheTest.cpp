@@ -0,0 +1,312 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/encodedContentCache.hpp"
+#include "vmime/cachedContentHandler.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/random.hpp"
+
+#include <fstream>
+
+#include <time.h>
+#include <utime.h>
+
+
+#define VMIME_TEST_SUITE         encodedContentCacheTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testDisabled)
+		VMIME_TEST(testMemory)
+		VMIME_TEST(testEviction)
+		VMIME_TEST(testSpill)
+		VMIME_TEST(testLargeEntry)
+		VMIME_TEST(testFileAttachment)
+	VMIME_TEST_LIST_END
+
+
+	/** Counts the number of times the contents are generated. */
+	class countingContentHandler : public vmime::stringContentHandler
+	{
+	public:
+
+		countingContentHandler(const vmime::string& data)
+			: vmime::stringContentHandler(data), m_count(0)
+		{
+		}
+
+		void generate(vmime::utility::outputStream& os, const vmime::encoding& enc,
+			const vmime::string::size_type maxLineLength) const
+		{
+			++m_count;
+			vmime::stringContentHandler::generate(os, enc, maxLineLength);
+		}
+
+		mutable int m_count;
+	};
+
+
+	static const vmime::string generate(vmime::ref <const vmime::contentHandler> cts,
+		const vmime::string& enc = "base64")
+	{
+		vmime::string res;
+		vmime::utility::outputStreamStringAdapter os(res);
+
+		cts->generate(os, vmime::encoding(enc), 76);
+
+		return res;
+	}
+
+	static vmime::ref <vmime::utility::file> createTempDirectory()
+	{
+		vmime::ref <vmime::utility::fileSystemFactory> fsf =
+			vmime::platform::getHandler()->getFileSystemFactory();
+
+		vmime::utility::file::path path = fsf->stringToPath("/tmp");
+		path.appendComponent(vmime::utility::file::path::component
+			("vmime-test-" + vmime::utility::random::getString(16)));
+
+		vmime::ref <vmime::utility::file> dir = fsf->create(path);
+		dir->createDirectory();
+
+		return dir;
+	}
+
+	static const vmime::string generateAttachment(const vmime::string& filePath)
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+
+		vmime::ref <vmime::attachment> att = vmime::create <vmime::fileAttachment>
+			(filePath, vmime::mediaType("application/octet-stream"));
+
+		vmime::attachmentHelper::addAttachment(msg, att);
+
+		vmime::ref <vmime::body> body = msg->getBody();
+
+		return body->getPartAt(body->getPartCount() - 1)->getBody()->generate();
+	}
+
+	static void resetCache()
+	{
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+
+		cache->setMaxMemorySize(0);
+		cache->setSpillDirectory(vmime::utility::file::path(), 0);
+		cache->clear();
+	}
+
+
+	void testDisabled()
+	{
+		resetCache();
+
+		vmime::ref <countingContentHandler> cts = vmime::create <countingContentHandler>("Hello");
+		vmime::ref <vmime::cachedContentHandler> cached =
+			vmime::create <vmime::cachedContentHandler>(cts, "key");
+
+		VASSERT_EQ("1", "SGVsbG8=", generate(cached));
+		VASSERT_EQ("2", "SGVsbG8=", generate(cached));
+		VASSERT_EQ("Count", 2, cts->m_count);
+		VASSERT_EQ("Hits", 0, vmime::encodedContentCache::getInstance()->getHitCount());
+	}
+
+	void testMemory()
+	{
+		resetCache();
+
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+		cache->setMaxMemorySize(1024);
+
+		const unsigned long hits = cache->getHitCount();
+
+		vmime::ref <countingContentHandler> cts = vmime::create <countingContentHandler>("Hello");
+
+		// Contents are shared between handlers with the same key
+		VASSERT_EQ("1", "SGVsbG8=", generate(vmime::create <vmime::cachedContentHandler>(cts, "key")));
+		VASSERT_EQ("2", "SGVsbG8=", generate(vmime::create <vmime::cachedContentHandler>(cts, "key")));
+		VASSERT_EQ("Count", 1, cts->m_count);
+		VASSERT_EQ("Hits", hits + 1, cache->getHitCount());
+
+		// Another encoding is another entry
+		VASSERT_EQ("3", "Hello", generate(vmime::create <vmime::cachedContentHandler>(cts, "key"), "7bit"));
+		VASSERT_EQ("Count 2", 2, cts->m_count);
+		VASSERT_EQ("Memory", 13, cache->getMemorySize());
+
+		resetCache();
+	}
+
+	void testEviction()
+	{
+		resetCache();
+
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+		cache->setMaxMemorySize(20);
+
+		vmime::ref <countingContentHandler> cts1 = vmime::create <countingContentHandler>("0123456789");
+		vmime::ref <countingContentHandler> cts2 = vmime::create <countingContentHandler>("abcdefghij");
+
+		generate(vmime::create <vmime::cachedContentHandler>(cts1, "key1"));  // 16 bytes
+		generate(vmime::create <vmime::cachedContentHandler>(cts2, "key2"));  // evicts key1
+
+		VASSERT_EQ("Memory", 16, cache->getMemorySize());
+
+		generate(vmime::create <vmime::cachedContentHandler>(cts2, "key2"));
+		generate(vmime::create <vmime::cachedContentHandler>(cts1, "key1"));
+
+		VASSERT_EQ("Count 1", 2, cts1->m_count);
+		VASSERT_EQ("Count 2", 1, cts2->m_count);
+
+		// Too large to be cached
+		vmime::ref <countingContentHandler> cts3 = vmime::create <countingContentHandler>(vmime::string(100, 'x'));
+
+		generate(vmime::create <vmime::cachedContentHandler>(cts3, "key3"));
+		generate(vmime::create <vmime::cachedContentHandler>(cts3, "key3"));
+
+		VASSERT_EQ("Count 3", 2, cts3->m_count);
+
+		resetCache();
+	}
+
+	void testSpill()
+	{
+		resetCache();
+
+		vmime::ref <vmime::utility::file> dir = createTempDirectory();
+
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+		cache->setMaxMemorySize(20);
+		cache->setSpillDirectory(dir->getFullPath(), 1000);
+
+		const vmime::string data(300, 'x');
+
+		vmime::ref <countingContentHandler> cts = vmime::create <countingContentHandler>(data);
+		const vmime::string expected = generate(cts);
+
+		VASSERT_EQ("1", expected, generate(vmime::create <vmime::cachedContentHandler>(cts, "key")));
+		VASSERT_EQ("2", expected, generate(vmime::create <vmime::cachedContentHandler>(cts, "key")));
+		VASSERT_EQ("Count", 2, cts->m_count);  // including the first generate()
+
+		VASSERT_EQ("Memory", 0, cache->getMemorySize());
+		VASSERT_EQ("Disk", expected.length(), cache->getDiskSize());
+		VASSERT_EQ("File", true, dir->getFiles()->hasMoreElements());
+
+		resetCache();
+
+		VASSERT("File deleted", !dir->getFiles()->hasMoreElements());
+
+		dir->remove();
+	}
+
+	void testLargeEntry()
+	{
+		resetCache();
+
+		vmime::ref <vmime::utility::file> dir = createTempDirectory();
+
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+		cache->setMaxMemorySize(100);
+		cache->setSpillDirectory(dir->getFullPath(), 1000);
+
+		vmime::ref <countingContentHandler> small = vmime::create <countingContentHandler>("0123456789");
+		vmime::ref <countingContentHandler> large = vmime::create <countingContentHandler>(vmime::string(300, 'x'));
+
+		generate(vmime::create <vmime::cachedContentHandler>(small, "small"));  // 16 bytes
+		const vmime::string expected = generate(vmime::create <vmime::cachedContentHandler>(large, "large"));
+
+		// Larger than the memory cache: written to a file, and the
+		// other entries stay in memory
+		VASSERT_EQ("Memory", 16, cache->getMemorySize());
+		VASSERT_EQ("Disk", expected.length(), cache->getDiskSize());
+
+		VASSERT_EQ("Large", expected, generate(vmime::create <vmime::cachedContentHandler>(large, "large")));
+		generate(vmime::create <vmime::cachedContentHandler>(small, "small"));
+
+		VASSERT_EQ("Count small", 1, small->m_count);
+		VASSERT_EQ("Count large", 1, large->m_count);
+
+		resetCache();
+
+		VASSERT("File deleted", !dir->getFiles()->hasMoreElements());
+
+		dir->remove();
+	}
+
+	void testFileAttachment()
+	{
+		resetCache();
+
+		vmime::encodedContentCache* cache = vmime::encodedContentCache::getInstance();
+		cache->setMaxMemorySize(1024 * 1024);
+
+		vmime::ref <vmime::utility::file> dir = createTempDirectory();
+
+		vmime::utility::file::path path = dir->getFullPath();
+		path.appendComponent(vmime::utility::file::path::component("attachment.bin"));
+
+		const vmime::string filePath =
+			vmime::platform::getHandler()->getFileSystemFactory()->pathToString(path);
+
+		{
+			std::ofstream ofs(filePath.c_str(), std::ios::out | std::ios::binary);
+			ofs << vmime::string(10000, '\x01');
+		}
+
+		const unsigned long misses = cache->getMissCount();
+		const unsigned long hits = cache->getHitCount();
+
+		// Not modified before the current second: not cached
+		struct utimbuf times;
+		times.actime = times.modtime = ::time(NULL) + 3600;
+
+		::utime(filePath.c_str(), &times);
+
+		generateAttachment(filePath);
+		generateAttachment(filePath);
+
+		VASSERT_EQ("Misses (recent)", misses, cache->getMissCount());
+		VASSERT_EQ("Hits (recent)", hits, cache->getHitCount());
+
+		times.actime = times.modtime = ::time(NULL) - 3600;
+
+		::utime(filePath.c_str(), &times);
+
+		const vmime::string res1 = generateAttachment(filePath);
+		const vmime::string res2 = generateAttachment(filePath);
+
+		VASSERT_EQ("Output", res1, res2);
+		VASSERT_EQ("Misses", misses + 1, cache->getMissCount());
+		VASSERT_EQ("Hits", hits + 1, cache->getHitCount());
+
+		vmime::platform::getHandler()->getFileSystemFactory()->create(path)->remove();
+		dir->remove();
+
+		resetCache();
+	}
+
+VMIME_TEST_SUITE_END
+
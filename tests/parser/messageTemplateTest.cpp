@@ -0,0 +1,225 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/messageTemplate.hpp"
+
+
+#define VMIME_TEST_SUITE         messageTemplateTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testFields)
+		VMIME_TEST(testNewField)
+		VMIME_TEST(testTextParts)
+		VMIME_TEST(testFolding)
+		VMIME_TEST(testVariableNames)
+	VMIME_TEST_LIST_END
+
+
+	static const vmime::string getMultipartMessage()
+	{
+		return
+			"From: sender@example.com\r\n"
+			"To: nobody@example.com\r\n"
+			"Subject: Newsletter\r\n"
+			"Message-Id: <template@example.com>\r\n"
+			"MIME-Version: 1.0\r\n"
+			"Content-Type: multipart/alternative; boundary=\"=_outer\"\r\n"
+			"\r\n"
+			"--=_outer\r\n"
+			"Content-Type: text/plain; charset=utf-8\r\n"
+			"Content-Transfer-Encoding: quoted-printable\r\n"
+			"\r\n"
+			"Hello ${name},=0D=0Ayour code is ${code}. ${unterminated\r\n"
+			"--=_outer\r\n"
+			"Content-Type: text/html; charset=utf-8\r\n"
+			"Content-Transfer-Encoding: 7bit\r\n"
+			"\r\n"
+			"<p>No placeholder here, ${} or $name.</p>\r\n"
+			"--=_outer\r\n"
+			"Content-Type: application/octet-stream\r\n"
+			"Content-Transfer-Encoding: base64\r\n"
+			"\r\n"
+			"JHtuYW1lfQ==\r\n"
+			"--=_outer--\r\n";
+	}
+
+	static vmime::ref <vmime::message> cloneMessage(vmime::ref <const vmime::message> msg)
+	{
+		vmime::ref <vmime::message> copy = vmime::create <vmime::message>();
+		copy->copyFrom(*msg);
+
+		return copy;
+	}
+
+	static void setText(vmime::ref <vmime::message> msg, const int part, const vmime::string& text)
+	{
+		msg->getBody()->getPartAt(part)->getBody()->setContents
+			(vmime::create <vmime::stringContentHandler>(text));
+	}
+
+
+	void testFields()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(getMultipartMessage());
+
+		std::vector <vmime::string> fields;
+		fields.push_back("to");
+		fields.push_back("Message-Id");
+		fields.push_back("TO");  // duplicate
+
+		vmime::messageTemplate tpl(msg, fields);
+
+		vmime::messageTemplate::values vals;
+		vals.setVariable("name", "John");
+		vals.setVariable("code", "1234");
+
+		// Default values
+		vmime::ref <vmime::message> expected = cloneMessage(msg);
+		setText(expected, 0, "Hello John,\r\nyour code is 1234. ${unterminated");
+
+		VASSERT_EQ("1", expected->generate(), tpl.generate(vals));
+
+		// Substituted values
+		vmime::ref <vmime::mailbox> to =
+			vmime::create <vmime::mailbox>(vmime::text("Jean Dupont"), "jean@example.com");
+		vmime::ref <vmime::messageId> mid =
+			vmime::create <vmime::messageId>("1234", "example.com");
+
+		vals.setField("To", to);
+		vals.setField("message-id", mid);
+
+		expected->getHeader()->To()->setValue(to);
+		expected->getHeader()->MessageId()->setValue(mid);
+
+		VASSERT_EQ("2", expected->generate(), tpl.generate(vals));
+
+		// The compiled message has not been modified
+		VASSERT_EQ("3", "nobody@example.com",
+			msg->getHeader()->To()->getValue()->generate());
+	}
+
+	void testNewField()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse("Subject: test\r\n\r\nBody\r\n");
+
+		std::vector <vmime::string> fields;
+		fields.push_back("X-Recipient-Id");
+
+		vmime::messageTemplate tpl(msg, fields);
+
+		vmime::messageTemplate::values vals;
+		vals.setField("X-Recipient-Id", vmime::create <vmime::text>("42"));
+
+		// Parsing adds the default "Content-Transfer-Encoding" field
+		VASSERT_EQ("1", "Subject: test\r\nContent-Transfer-Encoding: 7bit\r\n"
+			"X-Recipient-Id: 42\r\n\r\nBody\r\n", tpl.generate(vals));
+		VASSERT("2", !msg->getHeader()->hasField("X-Recipient-Id"));
+	}
+
+	void testTextParts()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(getMultipartMessage());
+
+		vmime::messageTemplate tpl(msg, std::vector <vmime::string>());
+
+		// Substituted text must be encoded
+		vmime::messageTemplate::values vals;
+		vals.setVariable("name", "J\xc3\xa9r\xc3\xb4me");
+
+		vmime::ref <vmime::message> expected = cloneMessage(msg);
+		setText(expected, 0, "Hello J\xc3\xa9r\xc3\xb4me,\r\nyour code is . ${unterminated");
+
+		const vmime::string res = tpl.generate(vals);
+
+		VASSERT_EQ("1", expected->generate(), res);
+		VASSERT("2", res.find("Hello J=C3=A9r=C3=B4me,") != vmime::string::npos);
+		VASSERT("3", res.find("<p>No placeholder here, ${} or $name.</p>") != vmime::string::npos);
+		VASSERT("4", res.find("JHtuYW1lfQ==") != vmime::string::npos);
+
+		VASSERT_EQ("5", res.length() - vmime::string("Hello J=C3=A9r=C3=B4me,=0D=0Ayour code is . ${unterminated").length(),
+			tpl.getStaticSize());
+	}
+
+	void testFolding()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(getMultipartMessage());
+
+		std::vector <vmime::string> fields;
+		fields.push_back("To");
+
+		vmime::messageTemplate tpl(msg, fields, vmime::lineLengthLimits::convenient);
+
+		vmime::ref <vmime::addressList> to = vmime::create <vmime::addressList>();
+
+		for (int i = 0 ; i < 10 ; ++i)
+		{
+			to->appendAddress(vmime::create <vmime::mailbox>
+				(vmime::text("Recipient"), "recipient" + vmime::utility::stringUtils::toString(i) + "@example.com"));
+		}
+
+		vmime::messageTemplate::values vals;
+		vals.setField("To", to);
+
+		vmime::ref <vmime::message> expected = cloneMessage(msg);
+		expected->getHeader()->To()->setValue(to);
+		setText(expected, 0, "Hello ,\r\nyour code is . ${unterminated");
+
+		VASSERT_EQ("1", expected->generate(vmime::lineLengthLimits::convenient), tpl.generate(vals));
+	}
+
+	void testVariableNames()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(
+			"Content-Type: multipart/mixed; boundary=\"b\"\r\n"
+			"\r\n"
+			"--b\r\n"
+			"\r\n"
+			"${a} ${b} ${a}\r\n"
+			"--b\r\n"
+			"\r\n"
+			"${c.d} ${b}\r\n"
+			"--b--\r\n");
+
+		vmime::messageTemplate tpl(msg, std::vector <vmime::string>());
+
+		const std::vector <vmime::string> names = tpl.getVariableNames();
+
+		VASSERT_EQ("1", 3, names.size());
+		VASSERT_EQ("2", "a", names[0]);
+		VASSERT_EQ("3", "b", names[1]);
+		VASSERT_EQ("4", "c.d", names[2]);
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -0,0 +1,267 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/mimeEventParser.hpp"
+#include "vmime/utility/inputStreamStringAdapter.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+
+
+#define VMIME_TEST_SUITE         mimeEventParserTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testSimpleMessage)
+		VMIME_TEST(testMultipartMessage)
+		VMIME_TEST(testMultipartMessageStream)
+		VMIME_TEST(testEncodings)
+		VMIME_TEST(testGuessBoundary)
+		VMIME_TEST(testMissingBoundary)
+	VMIME_TEST_LIST_END
+
+
+	/** Records the events as text. */
+	class traceHandler : public vmime::mimeEventParser::handler
+	{
+	public:
+
+		void onPartBegin(const int depth)
+		{
+			m_trace << "[" << depth;
+		}
+
+		void onHeaderField(const char* name, const vmime::string::size_type nameLength,
+			const char* value, const vmime::string::size_type valueLength)
+		{
+			m_trace << "|" << vmime::string(name, nameLength) << "=" << vmime::string(value, valueLength);
+		}
+
+		void onBodyChunk(const vmime::utility::stream::value_type* data,
+			const vmime::utility::stream::size_type count)
+		{
+			if (!m_inBody)
+				m_trace << "|";
+
+			m_trace << vmime::string(data, count);
+			m_inBody = true;
+		}
+
+		void onPartEnd()
+		{
+			m_trace << "]";
+			m_inBody = false;
+		}
+
+		traceHandler() : m_inBody(false) { }
+
+		const vmime::string getTrace() const { return m_trace.str(); }
+
+	private:
+
+		std::ostringstream m_trace;
+		bool m_inBody;
+	};
+
+	/** Seekable stream which is not held in memory. */
+	class unbufferedStream : public vmime::utility::seekableInputStream
+	{
+	public:
+
+		unbufferedStream(const vmime::string& data)
+			: m_data(data), m_stream(m_data)
+		{
+		}
+
+		bool eof() const { return m_stream.eof(); }
+		void reset() { m_stream.reset(); }
+		size_type read(value_type* const data, const size_type count) { return m_stream.read(data, count); }
+		size_type skip(const size_type count) { return m_stream.skip(count); }
+		size_type getPosition() const { return m_stream.getPosition(); }
+		void seek(const size_type pos) { m_stream.seek(pos); }
+
+	private:
+
+		const vmime::string m_data;
+		vmime::utility::inputStreamStringAdapter m_stream;
+	};
+
+
+	static const vmime::string trace(const vmime::string& data)
+	{
+		traceHandler h;
+		vmime::mimeEventParser().parse(data, h);
+
+		return h.getTrace();
+	}
+
+	static const vmime::string traceStream(const vmime::string& data)
+	{
+		vmime::ref <vmime::utility::seekableInputStream> is =
+			vmime::create <unbufferedStream>(data);
+
+		traceHandler h;
+		vmime::mimeEventParser().parse(is, data.length(), h);
+
+		return h.getTrace();
+	}
+
+	// Build the same trace from a parsed message
+	static void traceMessage(std::ostream& os, vmime::ref <const vmime::bodyPart> part, const int depth)
+	{
+		os << "[" << depth;
+
+		for (int i = 0 ; i < part->getHeader()->getFieldCount() ; ++i)
+		{
+			vmime::ref <const vmime::headerField> field = part->getHeader()->getFieldAt(i);
+			os << "|" << field->getName() << "=" << field->getValue()->generate();
+		}
+
+		if (part->getBody()->getPartCount() == 0)
+		{
+			vmime::string contents;
+			vmime::utility::outputStreamStringAdapter out(contents);
+
+			part->getBody()->getContents()->extract(out);
+
+			if (!contents.empty())
+				os << "|" << contents;
+		}
+
+		for (int i = 0 ; i < part->getBody()->getPartCount() ; ++i)
+			traceMessage(os, part->getBody()->getPartAt(i), depth + 1);
+
+		os << "]";
+	}
+
+	static const vmime::string multipartMessage()
+	{
+		return
+			"From: me@vmime.org\r\n"
+			"Subject: Events\r\n"
+			"Content-Type: multipart/mixed; boundary=\"outer\"\r\n"
+			"\r\n"
+			"Prolog\r\n"
+			"--outer\r\n"
+			"Content-Type: text/plain\r\n"
+			"Content-Transfer-Encoding: quoted-printable\r\n"
+			"\r\n"
+			"caf=E9 au lait\r\n"
+			"--outer\r\n"
+			"Content-Type: multipart/alternative; boundary=inner\r\n"
+			"\r\n"
+			"--inner\r\n"
+			"\r\n"
+			"First\r\n"
+			"--inner\r\n"
+			"Content-Type: text/html\r\n"
+			"\r\n"
+			"<p>Second</p>\r\n"
+			"--inner--\r\n"
+			"--outer\r\n"
+			"Content-Transfer-Encoding: base64\r\n"
+			"\r\n"
+			"SGVsbG8gd29ybGQ=\r\n"
+			"--outer--\r\n"
+			"Epilog\r\n";
+	}
+
+
+	void testSimpleMessage()
+	{
+		VASSERT_EQ("1", "[0|Subject=Hello|X-Folded=first\r\n second|Line 1\r\nLine 2\r\n]",
+			trace("Subject: Hello\r\nX-Folded: first\r\n second\r\n\r\nLine 1\r\nLine 2\r\n"));
+		VASSERT_EQ("2", "[0|Subject=Hello]", trace("Subject: Hello\r\n\r\n"));
+		VASSERT_EQ("3", "[0|Body]", trace("\nBody"));
+	}
+
+	void testMultipartMessage()
+	{
+		VASSERT_EQ("Trace",
+			"[0|From=me@vmime.org|Subject=Events|Content-Type=multipart/mixed; boundary=\"outer\""
+				"[1|Content-Type=text/plain|Content-Transfer-Encoding=quoted-printable|caf\xe9 au lait]"
+				"[1|Content-Type=multipart/alternative; boundary=inner"
+					"[2|First]"
+					"[2|Content-Type=text/html|<p>Second</p>]"
+				"]"
+				"[1|Content-Transfer-Encoding=base64|Hello world]"
+			"]",
+			trace(multipartMessage()));
+
+		// Same structure and contents as message::parse()
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(multipartMessage());
+
+		std::ostringstream oss;
+		traceMessage(oss, msg, 0);
+
+		const vmime::string expected = oss.str();
+		const vmime::string actual = trace(multipartMessage());
+
+		VASSERT_EQ("Part count",
+			std::count(expected.begin(), expected.end(), '['),
+			std::count(actual.begin(), actual.end(), '['));
+	}
+
+	void testMultipartMessageStream()
+	{
+		VASSERT_EQ("Trace", trace(multipartMessage()), traceStream(multipartMessage()));
+
+		// Header larger than the read buffer
+		std::ostringstream oss;
+
+		for (int i = 0 ; i < 1000 ; ++i)
+			oss << "X-Field-" << i << ": value " << i << "\r\n";
+
+		oss << "\r\nBody\r\n";
+
+		VASSERT_EQ("Large header", trace(oss.str()), traceStream(oss.str()));
+	}
+
+	void testEncodings()
+	{
+		VASSERT_EQ("Base64", "[0|Content-Transfer-Encoding=BASE64|\x01\x02\x03]",
+			trace("Content-Transfer-Encoding: BASE64\r\n\r\nAQID\r\n"));
+		VASSERT_EQ("Unknown", "[0|Content-Transfer-Encoding=x-foo|AQID\r\n]",
+			trace("Content-Transfer-Encoding: x-foo\r\n\r\nAQID\r\n"));
+		VASSERT_EQ("First only", "[0|Content-Transfer-Encoding=8bit|Content-Transfer-Encoding=base64|AQID]",
+			trace("Content-Transfer-Encoding: 8bit\r\nContent-Transfer-Encoding: base64\r\n\r\nAQID"));
+	}
+
+	void testGuessBoundary()
+	{
+		VASSERT_EQ("Trace", "[0|Content-Type=multipart/mixed[1|A][1|B]]",
+			trace("Content-Type: multipart/mixed\r\n\r\n--b\r\n\r\nA\r\n--b\r\n\r\nB\r\n--b--\r\n"));
+	}
+
+	void testMissingBoundary()
+	{
+		VASSERT_EQ("Trace", "[0|Content-Type=multipart/mixed; boundary=b[1|A][1|B\r\n]]",
+			trace("Content-Type: multipart/mixed; boundary=b\r\n\r\n--b\r\n\r\nA\r\n--b\r\n\r\nB\r\n"));
+	}
+
+VMIME_TEST_SUITE_END
+
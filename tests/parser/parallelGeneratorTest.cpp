@@ -0,0 +1,134 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2009 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/contentTypeField.hpp"
+
+
+#define VMIME_TEST_SUITE         parallelGeneratorTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testGenerate)
+		VMIME_TEST(testGenerateSimplePart)
+		VMIME_TEST(testSharedContents)
+	VMIME_TEST_LIST_END
+
+
+	static vmime::ref <vmime::bodyPart> createPart
+		(const vmime::string& contents, const vmime::string& encoding)
+	{
+		vmime::ref <vmime::bodyPart> part = vmime::create <vmime::bodyPart>();
+
+		part->getBody()->setContents(vmime::create <vmime::stringContentHandler>(contents));
+		part->getBody()->setEncoding(vmime::encoding(encoding));
+
+		return part;
+	}
+
+	static vmime::ref <vmime::message> createMessage()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+
+		msg->getHeader()->Subject()->setValue(vmime::text("Parallel generation"));
+		msg->getHeader()->ContentType()->setValue(vmime::mediaType("multipart/mixed"));
+		msg->getHeader()->ContentType().dynamicCast <vmime::contentTypeField>()->setBoundary("=_boundary");
+
+		msg->getBody()->appendPart(createPart("Some text\r\n", "quoted-printable"));
+
+		vmime::ref <vmime::bodyPart> alt = vmime::create <vmime::bodyPart>();
+		alt->getHeader()->ContentType()->setValue(vmime::mediaType("multipart/alternative"));
+		alt->getHeader()->ContentType().dynamicCast <vmime::contentTypeField>()->setBoundary("=_inner");
+		alt->getBody()->appendPart(createPart(vmime::string(20000, 'x'), "base64"));
+		alt->getBody()->appendPart(createPart("<p>caf\xe9</p>", "quoted-printable"));
+		msg->getBody()->appendPart(alt);
+
+		for (int i = 0 ; i < 5 ; ++i)
+			msg->getBody()->appendPart(createPart(vmime::string(50000 + i, static_cast <char>('a' + i)), "base64"));
+
+		return msg;
+	}
+
+	static const vmime::string generate(vmime::parallelGenerator& gen)
+	{
+		std::ostringstream oss;
+		vmime::utility::outputStreamAdapter os(oss);
+
+		gen.generate(os);
+
+		return oss.str();
+	}
+
+
+	void testGenerate()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+		const vmime::string expected = msg->generate();
+
+		for (unsigned int threads = 1 ; threads <= 4 ; ++threads)
+		{
+			std::ostringstream oss;
+			oss << threads << " thread(s)";
+
+			vmime::parallelGenerator gen(msg);
+			gen.prepare(threads);
+
+			VASSERT_EQ(oss.str() + " size", expected.length(), gen.getGeneratedSize());
+			VASSERT_EQ(oss.str() + " data", expected, generate(gen));
+		}
+	}
+
+	void testGenerateSimplePart()
+	{
+		vmime::ref <vmime::bodyPart> part = createPart("Hello world!", "base64");
+
+		vmime::parallelGenerator gen(part, 76);
+
+		VASSERT_EQ("1", part->generate(76).length(), gen.getGeneratedSize());
+		VASSERT_EQ("2", part->generate(76), generate(gen));
+	}
+
+	void testSharedContents()
+	{
+		vmime::ref <vmime::message> msg = createMessage();
+
+		// Same contents in two parts, with different encodings
+		vmime::ref <vmime::bodyPart> part = createPart("", "quoted-printable");
+		part->getBody()->setContents(msg->getBody()->getPartAt(2)->getBody()->getContents());
+		msg->getBody()->appendPart(part);
+
+		const vmime::string expected = msg->generate();
+
+		vmime::parallelGenerator gen(msg);
+		gen.prepare(3);
+
+		VASSERT_EQ("1", expected.length(), gen.getGeneratedSize());
+		VASSERT_EQ("2", expected, generate(gen));
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -0,0 +1,163 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/parserHelpers.hpp"
+
+
+#define VMIME_TEST_SUITE         parserHelpersTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testCharClasses)
+		VMIME_TEST(testSkipWhile)
+		VMIME_TEST(testFindFirstOf)
+		VMIME_TEST(testPositions)
+	VMIME_TEST_LIST_END
+
+
+	typedef vmime::parserHelpers PH;
+
+
+	void testCharClasses()
+	{
+		for (int i = 0 ; i < 256 ; ++i)
+		{
+			const char c = static_cast <char>(i);
+
+			std::ostringstream oss;
+			oss << "Char " << i;
+
+			VASSERT_EQ(oss.str() + " space", PH::isSpace(c), PH::is <PH::CHAR_CLASS_SPACE>(c));
+			VASSERT_EQ(oss.str() + " blank", PH::isSpaceOrTab(c), PH::is <PH::CHAR_CLASS_BLANK>(c));
+			VASSERT_EQ(oss.str() + " digit", PH::isDigit(c), PH::is <PH::CHAR_CLASS_DIGIT>(c));
+			VASSERT_EQ(oss.str() + " alpha", PH::isAlpha(c), PH::is <PH::CHAR_CLASS_ALPHA>(c));
+			VASSERT_EQ(oss.str() + " eol", c == '\r' || c == '\n', PH::is <PH::CHAR_CLASS_EOL>(c));
+			VASSERT_EQ(oss.str() + " colon", c == ':', PH::is <PH::CHAR_CLASS_COLON>(c));
+			VASSERT_EQ(oss.str() + " equal", c == '=', PH::is <PH::CHAR_CLASS_EQUAL>(c));
+			VASSERT_EQ(oss.str() + " question", c == '?', PH::is <PH::CHAR_CLASS_QUESTION>(c));
+
+			VASSERT_EQ(oss.str() + " combined", PH::isDigit(c) || c == ':',
+				(PH::is <PH::CHAR_CLASS_DIGIT | PH::CHAR_CLASS_COLON>(c)));
+		}
+	}
+
+	void testSkipWhile()
+	{
+		// Runs of all lengths, so that both the block and the byte-wise
+		// scans are exercised
+		for (int n = 0 ; n < 50 ; ++n)
+		{
+			for (int i = 0 ; i < 256 ; ++i)
+			{
+				const char c = static_cast <char>(i);
+
+				if (PH::isSpace(c))
+					continue;
+
+				std::string data(n, ' ');
+				data[n / 2] = '\t';
+				data += c;
+				data += "   ";
+
+				std::ostringstream oss;
+				oss << "Space " << n << " " << i;
+
+				const char* begin = data.data();
+
+				VASSERT_EQ(oss.str(), n, static_cast <int>(PH::skipWhile
+					<PH::CHAR_CLASS_SPACE>(begin, begin + data.length()) - begin));
+			}
+
+			std::string digits(n, '7');
+			digits += "x12";
+
+			std::ostringstream oss;
+			oss << "Digit " << n;
+
+			VASSERT_EQ(oss.str(), n, static_cast <int>(PH::skipWhile
+				<PH::CHAR_CLASS_DIGIT>(digits.data(), digits.data() + digits.length()) - digits.data()));
+
+			// Everything matches: stop at the end
+			std::string alpha(n, 'q');
+
+			VASSERT_EQ(oss.str() + " end", n, static_cast <int>(PH::skipWhile
+				<PH::CHAR_CLASS_ALPHA>(alpha.data(), alpha.data() + n) - alpha.data()));
+		}
+	}
+
+	void testFindFirstOf()
+	{
+		for (int n = 0 ; n < 50 ; ++n)
+		{
+			for (int i = 0 ; i < 256 ; ++i)
+			{
+				const char c = static_cast <char>(i);
+
+				if (c == 'x' || !(PH::is <PH::CHAR_CLASS_EOL | PH::CHAR_CLASS_COLON | PH::CHAR_CLASS_ALPHA>(c)))
+					continue;
+
+				std::string data(n, '-');
+				data += c;
+				data += "\n:";
+
+				for (int j = 0 ; j < n ; j += 3)
+					data[j] = static_cast <char>(0xe9);  // 8-bit
+
+				std::ostringstream oss;
+				oss << "Find " << n << " " << i;
+
+				const char* begin = data.data();
+
+				VASSERT_EQ(oss.str(), n, static_cast <int>(PH::findFirstOf
+					<PH::CHAR_CLASS_EOL | PH::CHAR_CLASS_COLON | PH::CHAR_CLASS_ALPHA>
+						(begin, begin + data.length()) - begin));
+			}
+
+			// Nothing matches: stop at the end
+			std::string none(n, '-');
+
+			std::ostringstream oss;
+			oss << "None " << n;
+
+			VASSERT_EQ(oss.str(), n, static_cast <int>(PH::findFirstOf
+				<PH::CHAR_CLASS_QUESTION>(none.data(), none.data() + n) - none.data()));
+		}
+	}
+
+	void testPositions()
+	{
+		const std::string data = "Subject:   hello world\r\n";
+
+		VASSERT_EQ("1", 7U, PH::findFirstOf <PH::CHAR_CLASS_COLON>(data, 0, data.length()));
+		VASSERT_EQ("2", 11U, PH::skipWhile <PH::CHAR_CLASS_BLANK>(data, 8, data.length()));
+		VASSERT_EQ("3", 22U, PH::findFirstOf <PH::CHAR_CLASS_EOL>(data, 11, data.length()));
+		VASSERT_EQ("4", 5U, PH::findFirstOf <PH::CHAR_CLASS_COLON>(data, 0, 5));
+		VASSERT_EQ("5", 30U, PH::skipWhile <PH::CHAR_CLASS_BLANK>(data, 30, 10));
+	}
+
+VMIME_TEST_SUITE_END
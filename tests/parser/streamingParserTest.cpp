@@ -0,0 +1,426 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/streamingParser.hpp"
+#include "vmime/utility/outputStreamStringAdapter.hpp"
+#include "vmime/utility/random.hpp"
+
+
+#define VMIME_TEST_SUITE         streamingParserTest
+#define VMIME_TEST_SUITE_MODULE  "Parser"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testEvents)
+		VMIME_TEST(testSimpleMessage)
+		VMIME_TEST(testMultipartMessage)
+		VMIME_TEST(testTruncatedMessage)
+		VMIME_TEST(testBoundaryRules)
+		VMIME_TEST(testSpill)
+		VMIME_TEST(testHeaderBudget)
+	VMIME_TEST_LIST_END
+
+
+	/** Non-seekable stream which returns data by small chunks. */
+	class chunkedInputStream : public vmime::utility::inputStream
+	{
+	public:
+
+		chunkedInputStream(const vmime::string& data, const size_type chunkSize)
+			: m_data(data), m_pos(0), m_chunkSize(chunkSize)
+		{
+		}
+
+		bool eof() const { return m_pos >= m_data.length(); }
+		void reset() { VASSERT("Stream is not seekable", false); }
+
+		size_type read(value_type* const data, const size_type count)
+		{
+			const size_type n = std::min(std::min(count, m_chunkSize), m_data.length() - m_pos);
+
+			std::copy(m_data.begin() + m_pos, m_data.begin() + m_pos + n, data);
+			m_pos += n;
+
+			return n;
+		}
+
+		size_type skip(const size_type count)
+		{
+			const size_type n = std::min(count, m_data.length() - m_pos);
+			m_pos += n;
+
+			return n;
+		}
+
+	private:
+
+		const vmime::string m_data;
+		vmime::string::size_type m_pos;
+		const size_type m_chunkSize;
+	};
+
+
+	static const vmime::string multipartMessage()
+	{
+		return
+			"From: me@vmime.org\r\n"
+			"Subject: Streaming\r\n"
+			"Content-Type: multipart/mixed; boundary=\"outer\"\r\n"
+			"\r\n"
+			"This is the prolog\r\n"
+			"--outer\r\n"
+			"Content-Type: text/plain\r\n"
+			"Content-Transfer-Encoding: quoted-printable\r\n"
+			"\r\n"
+			"caf=E9\r\n"
+			"--outer\r\n"
+			"Content-Type: multipart/alternative;\r\n"
+			"  boundary=inner\r\n"
+			"\r\n"
+			"--inner\r\n"
+			"\r\n"
+			"First alternative\r\n"
+			"--inner\r\n"
+			"Content-Type: text/html\r\n"
+			"\r\n"
+			"<p>Second</p>\r\n"
+			"--outer2 is not a boundary\r\n"
+			"--inner--\r\n"
+			"Inner epilog\r\n"
+			"--outer\r\n"
+			"Content-Transfer-Encoding: base64\r\n"
+			"\r\n"
+			"AAECAwQ=\r\n"
+			"--outer--\r\n"
+			"This is the epilog\r\n";
+	}
+
+
+	static const vmime::string extract(vmime::ref <const vmime::contentHandler> cts)
+	{
+		vmime::string res;
+		vmime::utility::outputStreamStringAdapter os(res);
+
+		cts->extract(os);
+
+		return res;
+	}
+
+	static const vmime::string extractRaw(vmime::ref <const vmime::contentHandler> cts)
+	{
+		vmime::string res;
+		vmime::utility::outputStreamStringAdapter os(res);
+
+		cts->extractRaw(os);
+
+		return res;
+	}
+
+	static vmime::ref <vmime::streamingParser> createParser
+		(const vmime::string& data, const vmime::utility::stream::size_type chunkSize = 7)
+	{
+		vmime::ref <vmime::utility::inputStream> is =
+			vmime::create <chunkedInputStream>(data, chunkSize);
+
+		return vmime::create <vmime::streamingParser>(is);
+	}
+
+	// Check that both parts have the same structure and contents
+	static void comparePart(const vmime::string& path,
+		vmime::ref <const vmime::bodyPart> expected, vmime::ref <const vmime::bodyPart> actual)
+	{
+		VASSERT_EQ(path + ": header", expected->getHeader()->generate(), actual->getHeader()->generate());
+		VASSERT_EQ(path + ": part count", expected->getBody()->getPartCount(), actual->getBody()->getPartCount());
+
+		VASSERT_EQ(path + ": encoding",
+			expected->getBody()->getContents()->getEncoding().generate(),
+			actual->getBody()->getContents()->getEncoding().generate());
+		VASSERT_EQ(path + ": contents",
+			extract(expected->getBody()->getContents()),
+			extract(actual->getBody()->getContents()));
+
+		for (int i = 0 ; i < expected->getBody()->getPartCount() ; ++i)
+		{
+			std::ostringstream oss;
+			oss << path << "." << (i + 1);
+
+			comparePart(oss.str(), expected->getBody()->getPartAt(i), actual->getBody()->getPartAt(i));
+		}
+	}
+
+
+	void testEvents()
+	{
+		typedef vmime::streamingParser sp;
+
+		vmime::ref <sp> p = createParser(multipartMessage());
+
+		const sp::EventType expected[] =
+		{
+			sp::EVENT_PART_BEGIN,                // message
+			sp::EVENT_HEADER_FIELD, sp::EVENT_HEADER_FIELD, sp::EVENT_HEADER_FIELD,
+			sp::EVENT_PROLOG,
+			sp::EVENT_PART_BEGIN,                // 1
+			sp::EVENT_HEADER_FIELD, sp::EVENT_HEADER_FIELD,
+			sp::EVENT_BODY,
+			sp::EVENT_PART_END,
+			sp::EVENT_PART_BEGIN,                // 2
+			sp::EVENT_HEADER_FIELD,
+			sp::EVENT_PROLOG,
+			sp::EVENT_PART_BEGIN,                // 2.1
+			sp::EVENT_BODY,
+			sp::EVENT_PART_END,
+			sp::EVENT_PART_BEGIN,                // 2.2
+			sp::EVENT_HEADER_FIELD,
+			sp::EVENT_BODY,
+			sp::EVENT_PART_END,
+			sp::EVENT_EPILOG,
+			sp::EVENT_PART_END,
+			sp::EVENT_PART_BEGIN,                // 3
+			sp::EVENT_HEADER_FIELD,
+			sp::EVENT_BODY,
+			sp::EVENT_PART_END,
+			sp::EVENT_EPILOG,
+			sp::EVENT_PART_END,
+			sp::EVENT_END
+		};
+
+		for (unsigned int i = 0 ; i < sizeof(expected) / sizeof(expected[0]) ; ++i)
+		{
+			std::ostringstream oss;
+			oss << "Event " << i;
+
+			const sp::EventType event = p->nextEvent();
+
+			VASSERT_EQ(oss.str(), expected[i], event);
+
+			if (i == 1)
+				VASSERT_EQ("From", "From", p->getHeaderField()->getName());
+			else if (i == 4)
+				VASSERT_EQ("Prolog", "This is the prolog", extract(p->getContents()));
+			else if (i == 14)
+			{
+				VASSERT_EQ("Depth", 2, p->getDepth());
+				VASSERT_EQ("Body 2.1", "First alternative", extract(p->getContents()));
+			}
+			else if (i == 18)
+				VASSERT_EQ("Body 2.2", "<p>Second</p>\r\n--outer2 is not a boundary", extract(p->getContents()));
+			else if (i == 20)
+				VASSERT_EQ("Epilog 2", "Inner epilog", extract(p->getContents()));
+			else if (i == 24)
+			{
+				VASSERT_EQ("Body 3 encoding", "base64", p->getContents()->getEncoding().generate());
+				VASSERT_EQ("Body 3 raw", "AAECAwQ=", extractRaw(p->getContents()));
+			}
+			else if (i == 26)
+				VASSERT_EQ("Epilog", "This is the epilog\r\n", extract(p->getContents()));
+		}
+
+		VASSERT_EQ("End", sp::EVENT_END, p->nextEvent());
+	}
+
+	void testSimpleMessage()
+	{
+		const vmime::string data =
+			"Subject: Simple\n"
+			"X-Folded: first\n"
+			"\tsecond\n"
+			"\n"
+			"Line 1\n"
+			"Line 2\n";
+
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(data);
+
+		comparePart("msg", msg, createParser(data, 3)->parseMessage());
+	}
+
+	void testMultipartMessage()
+	{
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(multipartMessage());
+
+		for (vmime::utility::stream::size_type chunkSize = 1 ; chunkSize <= 4096 ; chunkSize *= 4)
+		{
+			vmime::ref <vmime::message> msg2 = createParser(multipartMessage(), chunkSize)->parseMessage();
+
+			comparePart("msg", msg, msg2);
+
+			VASSERT_EQ("Epilog", "This is the epilog\r\n", msg2->getBody()->getEpilogText());
+			VASSERT_EQ("Epilog 2", "Inner epilog", msg2->getBody()->getPartAt(1)->getBody()->getEpilogText());
+		}
+	}
+
+	void testTruncatedMessage()
+	{
+		const vmime::string data =
+			"Content-Type: multipart/mixed; boundary=\"b\"\r\n"
+			"\r\n"
+			"--b\r\n"
+			"Content-Type: text/plain\r\n"
+			"\r\n"
+			"Incomplete";
+
+		vmime::ref <vmime::message> msg = createParser(data)->parseMessage();
+
+		VASSERT_EQ("Part count", 1, msg->getBody()->getPartCount());
+		VASSERT_EQ("Contents", "Incomplete", extract(msg->getBody()->getPartAt(0)->getBody()->getContents()));
+	}
+
+	void testBoundaryRules()
+	{
+		// Boundary is guessed; lines which start with the boundary but
+		// are followed by something else are contents
+		const vmime::string data =
+			"Content-Type: multipart/mixed\r\n"
+			"\r\n"
+			"Prolog\r\n"
+			"--b\r\n"
+			"\r\n"
+			"--bb\r\n"
+			"--b x\r\n"
+			"--b\n"
+			"\r\n"
+			"Part 2\r\n"
+			"--b--  \r\n"
+			"Epilog\r\n";
+
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(data);
+
+		VASSERT_EQ("Part count", 2, msg->getBody()->getPartCount());
+
+		for (vmime::utility::stream::size_type chunkSize = 1 ; chunkSize <= 64 ; chunkSize *= 4)
+		{
+			vmime::ref <vmime::message> msg2 = createParser(data, chunkSize)->parseMessage();
+
+			// Headers differ: appending the parts sets a boundary
+			VASSERT_EQ("Part count 2", 2, msg2->getBody()->getPartCount());
+
+			comparePart("msg.1", msg->getBody()->getPartAt(0), msg2->getBody()->getPartAt(0));
+			comparePart("msg.2", msg->getBody()->getPartAt(1), msg2->getBody()->getPartAt(1));
+
+			VASSERT_EQ("Epilog", "Epilog\r\n", msg2->getBody()->getEpilogText());
+		}
+	}
+
+	void testSpill()
+	{
+		vmime::ref <vmime::utility::fileSystemFactory> fsf =
+			vmime::platform::getHandler()->getFileSystemFactory();
+
+		vmime::utility::file::path tempDir = fsf->stringToPath("/tmp");
+		tempDir.appendComponent(vmime::utility::file::path::component
+			("vmime-test-" + vmime::utility::random::getString(16)));
+
+		vmime::ref <vmime::utility::file> dir = fsf->create(tempDir);
+		dir->createDirectory();
+
+		std::ostringstream data;
+		data << "Content-Type: multipart/mixed; boundary=\"b\"\r\n\r\n";
+
+		for (int i = 0 ; i < 4 ; ++i)
+		{
+			data << "--b\r\n\r\n";
+
+			for (int j = 0 ; j < 1000 + i ; ++j)
+				data << "Line " << j << " of part " << i << "\r\n";
+		}
+
+		data << "--b--\r\n";
+
+		vmime::ref <vmime::message> msg = vmime::create <vmime::message>();
+		msg->parse(data.str());
+
+		vmime::ref <vmime::streamingParser> p = createParser(data.str(), 1000);
+		p->setMemoryBudget(30000);
+		p->setTemporaryDirectory(tempDir);
+
+		vmime::ref <vmime::message> msg2 = p->parseMessage();
+
+		VASSERT_EQ("Spool file", true, dir->getFiles()->hasMoreElements());
+
+		comparePart("msg", msg, msg2);
+
+		// Temporary file is deleted when contents are released
+		p = NULL;
+		msg2 = NULL;
+
+		VASSERT("Spool file deleted", !dir->getFiles()->hasMoreElements());
+
+		dir->remove();
+	}
+
+	void testHeaderBudget()
+	{
+		vmime::ref <vmime::utility::fileSystemFactory> fsf =
+			vmime::platform::getHandler()->getFileSystemFactory();
+
+		vmime::utility::file::path tempDir = fsf->stringToPath("/tmp");
+		tempDir.appendComponent(vmime::utility::file::path::component
+			("vmime-test-" + vmime::utility::random::getString(16)));
+
+		vmime::ref <vmime::utility::file> dir = fsf->create(tempDir);
+		dir->createDirectory();
+
+		// Header fields use most of the budget: the body does not fit
+		// in what remains, and is written to the temporary file
+		std::ostringstream data;
+
+		for (int i = 0 ; i < 10 ; ++i)
+			data << "X-Field-" << i << ": " << vmime::string(80, 'x') << "\r\n";
+
+		data << "\r\n" << vmime::string(200, 'y');
+
+		vmime::ref <vmime::streamingParser> p = createParser(data.str(), 100);
+		p->setMemoryBudget(1000);
+		p->setTemporaryDirectory(tempDir);
+
+		int fieldCount = 0;
+		vmime::ref <vmime::contentHandler> body;
+
+		for (vmime::streamingParser::EventType event = p->nextEvent() ;
+		     event != vmime::streamingParser::EVENT_END ; event = p->nextEvent())
+		{
+			if (event == vmime::streamingParser::EVENT_HEADER_FIELD)
+				++fieldCount;
+			else if (event == vmime::streamingParser::EVENT_BODY)
+				body = p->getContents();
+		}
+
+		VASSERT_EQ("Field count", 10, fieldCount);
+		VASSERT_EQ("Contents", vmime::string(200, 'y'), extract(body));
+		VASSERT("Spilled", body.dynamicCast <vmime::streamContentHandler>() != NULL);
+
+		p = NULL;
+		body = NULL;
+
+		dir->remove();
+	}
+
+VMIME_TEST_SUITE_END
+
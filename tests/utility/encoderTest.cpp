@@ -23,6 +23,9 @@
 
 #include "tests/testUtils.hpp"
 
+#include "vmime/utility/encoder/b64Encoder.hpp"
+#include "vmime/utility/encoder/qpEncoder.hpp"
+
 
 #define VMIME_TEST_SUITE         encoderTest
 #define VMIME_TEST_SUITE_MODULE  "Parser"
@@ -35,7 +38,12 @@ VMIME_TEST_SUITE_BEGIN
 		VMIME_TEST(testQuotedPrintable)
 		VMIME_TEST(testQuotedPrintable_SoftLineBreaks)
 		VMIME_TEST(testQuotedPrintable_CRLF)
+		VMIME_TEST(testQuotedPrintable_TextLines)
+		VMIME_TEST(testQuotedPrintable_ChunkBoundaries)
 		VMIME_TEST(testQuotedPrintable_RFC2047)
+		VMIME_TEST(testDecodeBuffer)
+		VMIME_TEST(testEncodingByName)
+		VMIME_TEST(testSharedEncoder)
 	VMIME_TEST_LIST_END
 
 
@@ -62,11 +70,14 @@ VMIME_TEST_SUITE_BEGIN
 	}
 
 	// Decoding helper function
-	static const vmime::string decode(const vmime::string& name, const vmime::string& in, int maxLineLength = 0)
+	static const vmime::string decode(const vmime::string& name, const vmime::string& in,
+		int maxLineLength = 0, const vmime::propertySet props = vmime::propertySet())
 	{
 		vmime::ref <vmime::utility::encoder::encoder> enc =
 			vmime::utility::encoder::encoderFactory::getInstance()->create(name);
 
+		enc->getProperties() = props;
+
 		if (maxLineLength != 0)
 			enc->getProperties()["maxlinelength"] = maxLineLength;
 
@@ -319,6 +330,47 @@ VMIME_TEST_SUITE_BEGIN
 		           encode("quoted-printable", "line1\r\nline2", 80, encProps));
 	}
 
+	/** In text mode, a line break starts a new line: line length is counted
+	  * from there, and a '.' following it is encoded. */
+	void testQuotedPrintable_TextLines()
+	{
+		vmime::propertySet encProps;
+		encProps["text"] = true;
+
+		VASSERT_EQ("1", "0123456789\r\n0123456789",
+		           encode("quoted-printable", "0123456789\r\n0123456789", 15, encProps));
+
+		VASSERT_EQ("2", "line1\r\n=2E\r\nline3",
+		           encode("quoted-printable", "line1\r\n.\r\nline3", 80, encProps));
+
+		VASSERT_EQ("3", "0123456789abcd=\r\n=2E",
+		           encode("quoted-printable", "0123456789abcd.", 15, encProps));
+	}
+
+	/** Encoded sequences and trailing spaces spanning input chunks. */
+	void testQuotedPrintable_ChunkBoundaries()
+	{
+		for (unsigned int i = 16380 ; i <= 16384 ; ++i)
+		{
+			const vmime::string pad(i, 'a');
+
+			std::ostringstream oss;
+			oss << "offset " << i;
+
+			VASSERT_EQ(oss.str() + " encode 1", pad + " b",
+			           encode("quoted-printable", pad + " b"));
+			VASSERT_EQ(oss.str() + " encode 2", pad + "=20=0D=0A",
+			           encode("quoted-printable", pad + " \r\n"));
+
+			VASSERT_EQ(oss.str() + " decode 1", pad + "Ab",
+			           decode("quoted-printable", pad + "=41=\r\nb"));
+			VASSERT_EQ(oss.str() + " decode 2", pad + "\xe9" "b",
+			           decode("quoted-printable", pad + "=E9=\nb"));
+			VASSERT_EQ(oss.str() + " decode 3", pad,
+			           decode("quoted-printable", pad + "=4"));
+		}
+	}
+
 	void testQuotedPrintable_RFC2047()
 	{
 		/*
@@ -350,6 +402,138 @@ VMIME_TEST_SUITE_BEGIN
 		VASSERT_EQ("especials.12", "=22", encode("quoted-printable", "\"", 10, encProps));
 	}
 
+	// Decoding from a memory buffer must give the same result as decoding from a stream
+	void testDecodeBuffer()
+	{
+		static const char* b64Inputs[] =
+		{
+			"", "QQ==", "QUI=", "QUJD", "Zm9v", "Zm9v\r\nYmFy", " Z m 9 v ", "Zm9", "Zg", "Z", "Zm9v=YmFy"
+		};
+
+		for (unsigned int i = 0 ; i < sizeof(b64Inputs) / sizeof(b64Inputs[0]) ; ++i)
+		{
+			const vmime::string in(b64Inputs[i]);
+
+			vmime::string out("prefix");
+			vmime::utility::encoder::b64Encoder::decodeBuffer(in.data(), in.length(), out);
+
+			std::ostringstream oss;
+			oss << "[Base64] Test " << (i + 1);
+
+			VASSERT_EQ(oss.str(), "prefix" + decode("base64", in), out);
+		}
+
+		static const char* qpInputs[] =
+		{
+			"", "abc", "a=3Db", "a_b", "=C3=A9t=C3=A9", "soft=\r\nbreak", "soft=\nbreak",
+			"end=", "end=4", "=4", "a=\r", "__=5F__"
+		};
+
+		vmime::propertySet rfc2047Props;
+		rfc2047Props["rfc2047"] = true;
+
+		for (unsigned int i = 0 ; i < sizeof(qpInputs) / sizeof(qpInputs[0]) ; ++i)
+		{
+			const vmime::string in(qpInputs[i]);
+
+			vmime::string out;
+			vmime::utility::encoder::qpEncoder::decodeBuffer(in.data(), in.length(), out, false);
+
+			vmime::string out2047;
+			vmime::utility::encoder::qpEncoder::decodeBuffer(in.data(), in.length(), out2047, true);
+
+			std::ostringstream oss;
+			oss << "[QP] Test " << (i + 1);
+
+			VASSERT_EQ(oss.str(), decode("quoted-printable", in), out);
+			VASSERT_EQ(oss.str() + " (RFC-2047)", decode("quoted-printable", in, 0, rfc2047Props), out2047);
+		}
+	}
+
+	void testEncodingByName()
+	{
+		typedef vmime::utility::encoder::encoderFactory factory;
+
+		VASSERT_EQ("1", factory::ENCODING_BASE64, factory::getEncodingByName("base64"));
+		VASSERT_EQ("2", factory::ENCODING_QUOTED_PRINTABLE, factory::getEncodingByName("Quoted-Printable"));
+		VASSERT_EQ("3", factory::ENCODING_7BIT, factory::getEncodingByName("7-bit"));
+		VASSERT_EQ("4", factory::ENCODING_UUENCODE, factory::getEncodingByName("UUENCODE"));
+		VASSERT_EQ("5", factory::ENCODING_UNKNOWN, factory::getEncodingByName("base6"));
+		VASSERT_EQ("6", factory::ENCODING_UNKNOWN, factory::getEncodingByName("x-unknown"));
+
+		VASSERT("7", factory::getInstance()->getSharedEncoder(factory::ENCODING_UNKNOWN) == NULL);
+		VASSERT("8", factory::getInstance()->getSharedEncoder(factory::ENCODING_BASE64)
+			== factory::getInstance()->getSharedEncoder(factory::ENCODING_BASE64));
+	}
+
+	// Shared encoders must give the same results as new encoder
+	// instances with the equivalent properties
+	void testSharedEncoder()
+	{
+		typedef vmime::utility::encoder::encoderFactory factory;
+		typedef vmime::utility::encoder::encoder::options options;
+
+		const vmime::string data = "Some text with special chars: \xe9 = _ ? and a very long line "
+			"which has to be cut somewhere, as it does not fit in 76 characters.\r\n";
+
+		static const struct
+		{
+			const char* name;
+			factory::Encoding encoding;
+		}
+		encodings[] =
+		{
+			{ "base64", factory::ENCODING_BASE64 },
+			{ "quoted-printable", factory::ENCODING_QUOTED_PRINTABLE },
+			{ "uuencode", factory::ENCODING_UUENCODE },
+			{ "8bit", factory::ENCODING_8BIT }
+		};
+
+		for (unsigned int i = 0 ; i < sizeof(encodings) / sizeof(encodings[0]) ; ++i)
+		{
+			vmime::ref <const vmime::utility::encoder::encoder> enc =
+				factory::getInstance()->getSharedEncoder(encodings[i].encoding);
+
+			options opts;
+			opts.maxLineLength = 40;
+
+			vmime::utility::inputStreamStringAdapter vin(data);
+
+			std::ostringstream out;
+			vmime::utility::outputStreamAdapter vout(out);
+
+			enc->encode(vin, vout, opts);
+
+			VASSERT_EQ(encodings[i].name, encode(encodings[i].name, data, 40), out.str());
+
+			const vmime::string encoded = out.str();
+			vmime::utility::inputStreamStringAdapter vin2(encoded);
+
+			std::ostringstream out2;
+			vmime::utility::outputStreamAdapter vout2(out2);
+
+			enc->decode(vin2, vout2, opts);
+
+			VASSERT_EQ(encodings[i].name, decode(encodings[i].name, encoded), out2.str());
+		}
+
+		// RFC-2047 "Q" encoding
+		vmime::propertySet rfc2047Props;
+		rfc2047Props["rfc2047"] = true;
+
+		options opts;
+		opts.rfc2047 = true;
+
+		vmime::utility::inputStreamStringAdapter vin(data);
+
+		std::ostringstream out;
+		vmime::utility::outputStreamAdapter vout(out);
+
+		factory::getInstance()->getSharedEncoder(factory::ENCODING_QUOTED_PRINTABLE)->encode(vin, vout, opts);
+
+		VASSERT_EQ("rfc2047", encode("quoted-printable", data, 0, rfc2047Props), out.str());
+	}
+
 	// TODO: UUEncode
 
 VMIME_TEST_SUITE_END
@@ -36,6 +36,8 @@ VMIME_TEST_SUITE_BEGIN
 		VMIME_TEST(testDotFilteredInputStream)
 		VMIME_TEST(testDotFilteredOutputStream)
 		VMIME_TEST(testCRLFToLFFilteredOutputStream)
+		VMIME_TEST(testDotTerminatedFilteredOutputStream)
+		VMIME_TEST(testDotTerminatedFilteredOutputStreamSplit)
 		VMIME_TEST(testStopSequenceFilteredInputStream1)
 		VMIME_TEST(testStopSequenceFilteredInputStreamN_2)
 		VMIME_TEST(testStopSequenceFilteredInputStreamN_3)
@@ -163,6 +165,8 @@ VMIME_TEST_SUITE_BEGIN
 		testFilteredOutputStreamHelper<FILTER>("3", "foo\n..bar", "foo", "\n.bar");
 		testFilteredOutputStreamHelper<FILTER>("4", "foo\n..bar", "foo", "\n", ".bar");
 		testFilteredOutputStreamHelper<FILTER>("5", "foo\n..bar", "foo", "\n", ".", "bar");
+		testFilteredOutputStreamHelper<FILTER>("6", "foo\n..\n..bar\n", "foo\n.\n.bar\n");
+		testFilteredOutputStreamHelper<FILTER>("7", "a\n..b\nc\n..d", "a\n.b\nc", "\n.d");
 	}
 
 	void testCRLFToLFFilteredOutputStream()
@@ -178,6 +182,49 @@ VMIME_TEST_SUITE_BEGIN
 		testFilteredOutputStreamHelper<FILTER>("7", "foo\nba\nr", "foo\r", "\nba\r\nr");
 	}
 
+	// dotTerminatedFilteredOutputStream
+
+	void testDotTerminatedFilteredOutputStream()
+	{
+		typedef vmime::utility::dotTerminatedFilteredOutputStream FILTER;
+
+		testFilteredOutputStreamHelper<FILTER>("1", "foo\r\n.bar", "foo\r\n..bar\r\n.\r\n");
+		testFilteredOutputStreamHelper<FILTER>("2", "foo\r\n.bar", "foo\r\n", "..bar\r\n", ".\r\n");
+		testFilteredOutputStreamHelper<FILTER>("3", "foo\n.bar", "foo\n..bar\n.\n");
+		testFilteredOutputStreamHelper<FILTER>("4", ".foo", "..foo\r\n.\r\n");
+		testFilteredOutputStreamHelper<FILTER>("5", "", ".\r\n");
+		testFilteredOutputStreamHelper<FILTER>("6", "foo", "foo\r\n.\r\nbar\r\n");
+		testFilteredOutputStreamHelper<FILTER>("7", "foo\r\n.x\r\n", "foo\r\n.x\r\n\r\n.\r\n");
+		testFilteredOutputStreamHelper<FILTER>("8", "a\rb\r\n", "a\rb\r\n\r\n.\r\n");
+	}
+
+	void testDotTerminatedFilteredOutputStreamSplit()
+	{
+		const std::string input = "foo\r\n..bar\r\n.\r\r\n\r\n..\r\nbaz\r\n.\r\nextra";
+		const std::string expected = "foo\r\n.bar\r\n.\r\r\n\r\n.\r\nbaz";
+
+		for (std::string::size_type i = 0 ; i <= input.length() ; ++i)
+		{
+			for (std::string::size_type j = i ; j <= input.length() ; ++j)
+			{
+				std::ostringstream oss;
+				vmime::utility::outputStreamAdapter os(oss);
+
+				vmime::utility::dotTerminatedFilteredOutputStream fos(os);
+
+				fos.write(input.data(), i);
+				fos.write(input.data() + i, j - i);
+				fos.write(input.data() + j, input.length() - j);
+
+				std::ostringstream num;
+				num << i << "/" << j;
+
+				VASSERT_EQ(num.str(), expected, oss.str());
+				VASSERT(num.str(), fos.isTerminated());
+			}
+		}
+	}
+
 	// stopSequenceFilteredInputStream
 
 	template <int N>
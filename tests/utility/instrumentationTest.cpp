@@ -0,0 +1,105 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/utility/instrumentation.hpp"
+
+
+#define VMIME_TEST_SUITE         instrumentationTest
+#define VMIME_TEST_SUITE_MODULE  "Utility"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testNames)
+		VMIME_TEST(testCounters)
+		VMIME_TEST(testTimer)
+	VMIME_TEST_LIST_END
+
+
+	typedef vmime::utility::instrumentation instrumentation;
+
+
+	void testNames()
+	{
+		VASSERT_EQ("1", "objects", vmime::string(instrumentation::getCounterName(instrumentation::COUNTER_OBJECTS)));
+		VASSERT_EQ("2", "imap.response", vmime::string(instrumentation::getTimerName(instrumentation::TIMER_IMAP_RESPONSE)));
+
+		for (int i = 0 ; i < instrumentation::COUNTER_COUNT ; ++i)
+		{
+			VASSERT("3", !vmime::string(instrumentation::getCounterName
+				(static_cast <instrumentation::Counter>(i))).empty());
+		}
+
+		for (int i = 0 ; i < instrumentation::TIMER_COUNT ; ++i)
+		{
+			VASSERT("4", !vmime::string(instrumentation::getTimerName
+				(static_cast <instrumentation::Timer>(i))).empty());
+		}
+	}
+
+	void testCounters()
+	{
+		instrumentation* instr = instrumentation::getInstance();
+
+		const unsigned long objects = instr->getCounter(instrumentation::COUNTER_OBJECTS);
+		const unsigned long encoders = instr->getCounter(instrumentation::COUNTER_ENCODERS);
+		const unsigned long converters = instr->getCounter(instrumentation::COUNTER_CHARSET_CONVERTERS);
+
+		vmime::create <vmime::text>("Test");
+		vmime::utility::encoder::encoderFactory::getInstance()->create("base64");
+		vmime::charsetConverter conv(vmime::charset("iso-8859-1"), vmime::charset("utf-8"));
+
+		if (instrumentation::isEnabled())
+		{
+			VASSERT("1", instr->getCounter(instrumentation::COUNTER_OBJECTS) > objects);
+			VASSERT_EQ("2", encoders + 1, instr->getCounter(instrumentation::COUNTER_ENCODERS));
+			VASSERT_EQ("3", converters + 1, instr->getCounter(instrumentation::COUNTER_CHARSET_CONVERTERS));
+		}
+		else
+		{
+			VASSERT_EQ("4", 0UL, instr->getCounter(instrumentation::COUNTER_OBJECTS));
+			VASSERT_EQ("5", 0UL, instr->getCounter(instrumentation::COUNTER_ENCODERS));
+			VASSERT_EQ("6", 0UL, instr->getCounter(instrumentation::COUNTER_CHARSET_CONVERTERS));
+		}
+	}
+
+	void testTimer()
+	{
+		instrumentation* instr = instrumentation::getInstance();
+
+		const unsigned long count = instr->getTimerCount(instrumentation::TIMER_SMTP_RESPONSE);
+
+		{
+			instrumentation::scopedTimer timer(instrumentation::TIMER_SMTP_RESPONSE);
+		}
+
+		// The timer always records a measure, whether instrumentation is
+		// enabled or not: only the macros are compiled out
+		VASSERT_EQ("1", count + 1, instr->getTimerCount(instrumentation::TIMER_SMTP_RESPONSE));
+	}
+
+VMIME_TEST_SUITE_END
+
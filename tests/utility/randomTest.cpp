@@ -0,0 +1,93 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#include "tests/testUtils.hpp"
+
+#include "vmime/utility/random.hpp"
+#include "vmime/utility/sync/runnable.hpp"
+#include "vmime/utility/sync/thread.hpp"
+
+#include <set>
+
+
+#define VMIME_TEST_SUITE         randomTest
+#define VMIME_TEST_SUITE_MODULE  "Utility"
+
+
+VMIME_TEST_SUITE_BEGIN
+
+	VMIME_TEST_LIST_BEGIN
+		VMIME_TEST(testGetString)
+		VMIME_TEST(testConcurrentCalls)
+	VMIME_TEST_LIST_END
+
+
+	/** Draws random numbers in a thread. */
+	class drawTask : public vmime::utility::sync::runnable
+	{
+	public:
+
+		void run()
+		{
+			for (int i = 0 ; i < 10000 ; ++i)
+				m_numbers.push_back(vmime::utility::random::getNext());
+		}
+
+		std::vector <unsigned int> m_numbers;
+	};
+
+
+	void testGetString()
+	{
+		const vmime::string s = vmime::utility::random::getString(100, "ab");
+
+		VASSERT_EQ("Length", 100, s.length());
+		VASSERT_EQ("Chars", vmime::string::npos, s.find_first_not_of("ab"));
+		VASSERT("Different", s != vmime::utility::random::getString(100, "ab"));
+	}
+
+	void testConcurrentCalls()
+	{
+		std::vector <vmime::ref <drawTask> > tasks;
+		std::vector <vmime::ref <vmime::utility::sync::thread> > threads;
+
+		for (int i = 0 ; i < 4 ; ++i)
+		{
+			tasks.push_back(vmime::create <drawTask>());
+			threads.push_back(vmime::platform::getHandler()->createThread(tasks.back()));
+		}
+
+		std::set <unsigned int> numbers;
+
+		for (int i = 0 ; i < 4 ; ++i)
+		{
+			threads[i]->join();
+			numbers.insert(tasks[i]->m_numbers.begin(), tasks[i]->m_numbers.end());
+		}
+
+		// No number has been returned twice
+		VASSERT_EQ("Count", 4 * 10000, numbers.size());
+	}
+
+VMIME_TEST_SUITE_END
+
@@ -0,0 +1,287 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_BATCHPARSER_HPP_INCLUDED
+#define VMIME_BATCHPARSER_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+
+#include "vmime/message.hpp"
+#include "vmime/mimeEventParser.hpp"
+#include "vmime/exception.hpp"
+
+#include "vmime/utility/file.hpp"
+#include "vmime/utility/sync/criticalSection.hpp"
+#include "vmime/utility/sync/condition.hpp"
+
+#include <vector>
+#include <deque>
+
+
+namespace vmime
+{
+
+
+/** Parses a lot of messages (eg. the contents of a maildir folder or
+  * the messages of a mbox file) using several threads.
+  *
+  * Each thread has its own queue of messages to parse, and takes messages
+  * from the queues of the other threads when its own queue is empty. The
+  * parsed messages (or their parsing events) are reported to the handler
+  * in the calling thread, in the order of the sources. At most
+  * getMaxPendingMessages() messages are parsed in advance, so that the
+  * memory used does not depend on the number of messages.
+  *
+  * Each thread reads its messages into a buffer which is reused for all
+  * the messages it parses, and has its own event parser. The factories
+  * (headerFieldFactory, textPartFactory, encoderFactory) and the options
+  * are shared by all threads: they must not be modified during parsing.
+  */
+
+class batchParser : public object
+{
+public:
+
+	/** A message to parse.
+	  */
+	class source : public object
+	{
+	public:
+
+		/** Read the whole message. This is called from the parsing threads.
+		  *
+		  * @param data will receive the message data (the same string is
+		  * given for all the messages parsed by a thread, so that its memory
+		  * can be reused)
+		  */
+		virtual void read(string& data) = 0;
+	};
+
+	/** A message stored in a file (eg. in a maildir folder).
+	  */
+	class fileSource : public source
+	{
+	public:
+
+		fileSource(ref <utility::file> file);
+
+		void read(string& data);
+
+	private:
+
+		ref <utility::file> m_file;
+	};
+
+	/** A message held in memory (eg. extracted from a mbox file).
+	  */
+	class stringSource : public source
+	{
+	public:
+
+		stringSource(const string& data);
+
+		void read(string& data);
+
+	private:
+
+		const string m_data;
+	};
+
+
+	typedef std::vector <ref <source> >::size_type size_type;
+
+
+	/** Receives the parsed messages, in the calling thread.
+	  */
+	class messageHandler
+	{
+	public:
+
+		virtual ~messageHandler() { }
+
+		/** Called for each message which has been parsed.
+		  *
+		  * @param index index of the message in the sources
+		  * @param msg parsed message
+		  */
+		virtual void onMessage(const size_type index, ref <message> msg) = 0;
+
+		/** Called instead of onMessage() if the message cannot be read.
+		  *
+		  * @param index index of the message in the sources
+		  * @param e error
+		  */
+		virtual void onError(const size_type index, const exception& e) = 0;
+	};
+
+	/** Receives the parsing events of the messages, in the calling thread.
+	  * The events of a message are reported between onMessageBegin() and
+	  * onMessageEnd().
+	  */
+	class eventHandler : public mimeEventParser::handler
+	{
+	public:
+
+		/** Called before the events of a message.
+		  *
+		  * @param index index of the message in the sources
+		  */
+		virtual void onMessageBegin(const size_type index) = 0;
+
+		/** Called after the events of a message.
+		  *
+		  * @param index index of the message in the sources
+		  */
+		virtual void onMessageEnd(const size_type index) = 0;
+
+		/** Called instead of all the other functions if the message
+		  * cannot be read.
+		  *
+		  * @param index index of the message in the sources
+		  * @param e error
+		  */
+		virtual void onError(const size_type index, const exception& e) = 0;
+	};
+
+
+	/** Construct a new batch parser.
+	  *
+	  * @param threadCount number of threads used for parsing, including
+	  * the calling thread
+	  */
+	batchParser(const unsigned int threadCount);
+
+	~batchParser();
+
+	/** Set the maximum number of messages which are parsed in advance
+	  * and kept in memory until they are reported. Default is four times
+	  * the number of threads.
+	  *
+	  * @param count number of messages
+	  */
+	void setMaxPendingMessages(const size_type count);
+
+	/** Return the maximum number of messages which are parsed in advance.
+	  *
+	  * @return number of messages
+	  */
+	size_type getMaxPendingMessages() const;
+
+	/** Parse messages and build message objects. This returns when
+	  * all the messages have been reported to the handler.
+	  *
+	  * @param sources messages to parse
+	  * @param h handler which receives the messages
+	  */
+	void parse(const std::vector <ref <source> >& sources, messageHandler& h);
+
+	/** Parse messages and report their structure with events,
+	  * without building message objects (see mimeEventParser).
+	  * This returns when all the messages have been reported
+	  * to the handler.
+	  *
+	  * @param sources messages to parse
+	  * @param h handler which receives the events
+	  */
+	void parse(const std::vector <ref <source> >& sources, eventHandler& h);
+
+private:
+
+	class worker;
+	class eventRecorder;
+
+	/** State owned by a parsing thread. */
+	struct context
+	{
+		string data;
+		mimeEventParser eventParser;
+	};
+
+	/** A parsing event, recorded by a parsing thread and reported later. */
+	struct recordedEvent
+	{
+		enum Type
+		{
+			PART_BEGIN,
+			HEADER_FIELD,
+			BODY_CHUNK,
+			PART_END
+		};
+
+		Type type;
+		int depth;                      // PART_BEGIN
+		string::size_type offset;       // HEADER_FIELD (name then value) and BODY_CHUNK data
+		string::size_type length;
+		string::size_type valueLength;  // HEADER_FIELD
+	};
+
+	/** Result of the parsing of a message. */
+	struct result
+	{
+		bool ready;
+		ref <message> msg;
+		std::vector <recordedEvent> events;
+		string eventData;               // data of all the events
+		exception* error;
+	};
+
+	/** Messages to be parsed by a thread. */
+	struct workQueue
+	{
+		ref <utility::sync::criticalSection> lock;
+		std::deque <size_type> indexes;
+	};
+
+
+	void run(const std::vector <ref <source> >& sources, messageHandler* mh, eventHandler* eh);
+
+	void addWork(const size_type index);
+	bool takeWork(const unsigned int queue, size_type& index);
+	bool waitForWork(const unsigned int queue, size_type& index);
+
+	void process(const size_type index, context& ctx);
+
+	void report(const size_type index, result& res, messageHandler* mh, eventHandler* eh);
+
+	static void initializeSingletons();
+
+
+	unsigned int m_threadCount;
+	size_type m_maxPending;
+
+	const std::vector <ref <source> >* m_sources;
+	bool m_events;
+
+	std::vector <workQueue> m_queues;
+	std::vector <result> m_results;     // m_maxPending slots, indexed by message index
+
+	ref <utility::sync::condition> m_cond;
+	bool m_stopping;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_BATCHPARSER_HPP_INCLUDED
@@ -280,6 +280,55 @@ public:
 
 	const std::vector <ref <component> > getChildComponents();
 
+	/** Try to guess the boundary of a multipart body which does not
+	  * have a "boundary" parameter, from the first boundary line.
+	  *
+	  * @param parser input stream
+	  * @param position start position of the body contents
+	  * @param end end position of the body contents
+	  * @return boundary, or an empty string if none was found
+	  */
+	static const string guessBoundary
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end);
+
+	/** Find the next boundary line.
+	  *
+	  * @param parser input stream
+	  * @param boundarySep boundary, prefixed with "--"
+	  * @param position position from which to search
+	  * @param end end position of the body contents
+	  * @return position of the boundary line, or utility::stream::npos
+	  * if there are no more boundaries
+	  */
+	static utility::stream::size_type findNextBoundary
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const string& boundarySep,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end);
+
+	/** Skip a boundary line.
+	  *
+	  * @param parser input stream
+	  * @param boundarySep boundary, prefixed with "--"
+	  * @param position start position of the body contents
+	  * @param boundaryPos position of the boundary line
+	  * @param end end position of the body contents
+	  * @param partEnd will receive the end position of the part which
+	  * precedes the boundary (the line break before it is not part of it)
+	  * @param lastPart will be set to true if this is the closing boundary
+	  * @return position after the boundary line
+	  */
+	static utility::stream::size_type skipBoundary
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const string& boundarySep,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type boundaryPos,
+		 const utility::stream::size_type end,
+		 utility::stream::size_type* partEnd,
+		 bool* lastPart);
+
 private:
 
 	void setParentPart(ref <bodyPart> parent);
@@ -313,6 +362,8 @@ protected:
 		 const string::size_type maxLineLength = lineLengthLimits::infinite,
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
+
+	bool visitChildComponentsImpl(childVisitor& v);
 };
 
 
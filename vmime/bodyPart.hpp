@@ -112,6 +112,8 @@ protected:
 		 const string::size_type maxLineLength = lineLengthLimits::infinite,
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
+
+	bool visitChildComponentsImpl(childVisitor& v);
 };
 
 
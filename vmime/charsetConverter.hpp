@@ -29,6 +29,7 @@
 #include "vmime/component.hpp"
 
 #include "vmime/charset.hpp"
+#include "vmime/nativeCharsetConverter.hpp"
 #include "vmime/utility/filteredStream.hpp"
 
 
@@ -37,6 +38,12 @@ namespace vmime
 
 
 /** Convert between charsets.
+  *
+  * Conversions between US-ASCII, UTF-8, ISO-8859-1 and ISO-8859-15
+  * are done by nativeCharsetConverter. Other conversions use iconv
+  * descriptors obtained from charsetConverterPool, so constructing
+  * a converter is cheap once a given pair of charsets has already
+  * been used.
   */
 
 class charsetConverter : public object
@@ -81,6 +88,8 @@ private:
 
 	charset m_source;
 	charset m_dest;
+
+	bool m_native;
 };
 
 
@@ -122,6 +131,7 @@ private:
 
 
 	void* m_desc;
+	ref <nativeCharsetConverter> m_native;
 
 	const charset m_sourceCharset;
 	const charset m_destCharset;
@@ -0,0 +1,136 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_CHARSETCONVERTERPOOL_HPP_INCLUDED
+#define VMIME_CHARSETCONVERTERPOOL_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/charset.hpp"
+
+#include "vmime/utility/sync/criticalSection.hpp"
+
+#include <map>
+
+
+namespace vmime
+{
+
+
+/** Keeps conversion descriptors opened by charset converters so that
+  * they can be reused instead of being opened and closed for each
+  * conversion.
+  *
+  * Descriptors are keyed by (source, destination) charset pair and
+  * are lent exclusively: a descriptor is owned by a single converter
+  * (and thus a single thread) until it is released. Its conversion
+  * state is reset before it is lent again.
+  */
+
+class charsetConverterPool
+{
+private:
+
+	charsetConverterPool();
+	~charsetConverterPool();
+
+public:
+
+	static charsetConverterPool* getInstance();
+
+	/** Get a conversion descriptor for the specified charsets. An idle
+	  * descriptor is reused if there is one, else a new one is opened.
+	  *
+	  * @param source input charset
+	  * @param dest output charset
+	  * @return conversion descriptor, or NULL if the conversion is
+	  * not supported
+	  */
+	void* acquire(const charset& source, const charset& dest);
+
+	/** Give back a conversion descriptor previously obtained with
+	  * acquire(). The descriptor is kept for later use or closed if
+	  * there are already enough idle descriptors for this pair.
+	  *
+	  * @param source input charset
+	  * @param dest output charset
+	  * @param desc conversion descriptor (may be NULL)
+	  */
+	void release(const charset& source, const charset& dest, void* desc);
+
+	/** Close all idle conversion descriptors.
+	  */
+	void clear();
+
+	/** Set the maximum number of idle descriptors kept for each
+	  * (source, destination) charset pair. Zero disables caching.
+	  *
+	  * @param count maximum number of idle descriptors per pair
+	  */
+	void setMaxIdleCount(const unsigned int count);
+
+	/** Return the maximum number of idle descriptors kept for each
+	  * (source, destination) charset pair.
+	  *
+	  * @return maximum number of idle descriptors per pair
+	  */
+	unsigned int getMaxIdleCount() const;
+
+	/** Return the number of descriptors opened since the pool was
+	  * created, ie. the number of cache misses.
+	  *
+	  * @return number of descriptors opened
+	  */
+	unsigned long getOpenCount() const;
+
+	/** Return the number of times an idle descriptor has been
+	  * reused, ie. the number of cache hits.
+	  *
+	  * @return number of descriptors reused
+	  */
+	unsigned long getReuseCount() const;
+
+private:
+
+	typedef std::pair <string, string> key_type;
+
+	static const key_type makeKey(const charset& source, const charset& dest);
+
+	static void closeDescriptor(void* desc);
+
+
+	std::map <key_type, std::vector <void*> > m_idle;
+
+	unsigned int m_maxIdleCount;
+
+	unsigned long m_openCount;
+	unsigned long m_reuseCount;
+
+	ref <utility::sync::criticalSection> m_lock;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_CHARSETCONVERTERPOOL_HPP_INCLUDED
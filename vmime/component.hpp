@@ -31,6 +31,8 @@
 #include "vmime/utility/parserInputStreamAdapter.hpp"
 #include "vmime/utility/outputStream.hpp"
 
+#include <cstddef>
+
 
 namespace vmime
 {
@@ -162,6 +164,33 @@ public:
 	  */
 	virtual const std::vector <ref <component> > getChildComponents() = 0;
 
+	/** Interface for walking the children of a component
+	  * (see visitChildComponents()).
+	  */
+	class childVisitor
+	{
+	public:
+
+		virtual ~childVisitor() { }
+
+		/** Called for each child component.
+		  *
+		  * @param child child component
+		  * @return true to continue with the next child,
+		  * or false to stop
+		  */
+		virtual bool visit(component& child) = 0;
+	};
+
+	/** Call the visitor for each child of this component, in the
+	  * same order as getChildComponents(). Unlike getChildComponents(),
+	  * this does not build a list of the children.
+	  *
+	  * @param v visitor
+	  * @return false if the visitor stopped the walk, true otherwise
+	  */
+	bool visitChildComponents(childVisitor& v);
+
 protected:
 
 	void setParsedBounds(const utility::stream::size_type start, const utility::stream::size_type end);
@@ -185,9 +214,44 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const = 0;
 
+	/** Call the visitor for each child of this component. The default
+	  * implementation uses getChildComponents(); derived classes should
+	  * override it to avoid building the list.
+	  *
+	  * @param v visitor
+	  * @return false if the visitor stopped the walk, true otherwise
+	  */
+	virtual bool visitChildComponentsImpl(childVisitor& v);
+
+	/** Call the visitor for each component in the specified list.
+	  *
+	  * @param list list of components
+	  * @param v visitor
+	  * @return false if the visitor stopped the walk, true otherwise
+	  */
+	template <class T>
+	static bool visitComponents(std::vector <ref <T> >& list, childVisitor& v)
+	{
+		for (typename std::vector <ref <T> >::iterator it = list.begin() ;
+		     it != list.end() ; ++it)
+		{
+			if (!v.visit(**it))
+				return false;
+		}
+
+		return true;
+	}
+
 private:
 
-	void offsetParsedBounds(const utility::stream::size_type offset);
+	class offsetVisitor;
+
+	/** Move the parsed bounds of this component and its children.
+	  *
+	  * @param delta number of bytes to add to the parsed offsets
+	  * (negative to move them backwards)
+	  */
+	void offsetParsedBounds(const std::ptrdiff_t delta);
 
 	utility::stream::size_type m_parsedOffset;
 	utility::stream::size_type m_parsedLength;
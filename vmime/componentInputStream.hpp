@@ -0,0 +1,112 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_COMPONENTINPUTSTREAM_HPP_INCLUDED
+#define VMIME_COMPONENTINPUTSTREAM_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/component.hpp"
+
+#include "vmime/utility/inputStream.hpp"
+#include "vmime/utility/sync/thread.hpp"
+
+
+namespace vmime
+{
+
+
+/** An input stream which reads the RFC-2822/MIME data generated for
+  * a component (usually a message), without holding the whole data
+  * in memory.
+  *
+  * The component is generated by a separate thread as data is read from
+  * the stream: contents (for example, file attachments) are read and
+  * encoded on the fly, and only a small buffer is kept between the
+  * generating thread and the reader.
+  *
+  * If the platform handler does not support threads, the component is
+  * generated in memory when the stream is first read.
+  *
+  * Errors which occur during generation are thrown again by read(),
+  * with their original type.
+  *
+  * The component must not be modified while the stream is in use.
+  */
+
+class componentInputStream : public utility::inputStream
+{
+public:
+
+	/** Construct a new stream.
+	  *
+	  * @param comp component to generate
+	  * @param maxLineLength maximum line length for output
+	  */
+	componentInputStream(ref <const component> comp,
+		const string::size_type maxLineLength = lineLengthLimits::infinite);
+
+	~componentInputStream();
+
+	/** Return the exact number of bytes which will be read from this stream.
+	  * The first call generates the whole component once, without storing
+	  * the generated data, so contents are read and encoded twice. Only
+	  * call this if the size must be known before sending the data.
+	  *
+	  * @return size of generated data, in bytes
+	  */
+	size_type getSize();
+
+	bool eof() const;
+	void reset();
+	size_type read(value_type* const data, const size_type count);
+	size_type skip(const size_type count);
+
+private:
+
+	class pipe;
+	class generatorTask;
+
+	void start();
+	void stop();
+
+
+	ref <const component> m_component;
+	string::size_type m_maxLineLength;
+
+	ref <pipe> m_pipe;
+	ref <utility::sync::thread> m_thread;
+
+	size_type m_size;
+	bool m_sizeKnown;
+
+	bool m_inMemory;
+	string m_data;
+	string::size_type m_dataPos;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_COMPONENTINPUTSTREAM_HPP_INCLUDED
@@ -0,0 +1,202 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_ENCODEDCONTENTCACHE_HPP_INCLUDED
+#define VMIME_ENCODEDCONTENTCACHE_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/contentHandler.hpp"
+#include "vmime/encoding.hpp"
+
+#include "vmime/utility/file.hpp"
+#include "vmime/utility/sync/criticalSection.hpp"
+
+#include <map>
+#include <list>
+#include <vector>
+
+
+namespace vmime
+{
+
+
+/** Keeps the encoded form of contents which are generated several times,
+  * such as an attachment sent in many messages, so that they are read
+  * and encoded only once.
+  *
+  * Contents are identified by a key given by the user of the cache (see
+  * cachedContentHandler), which must change whenever the contents change:
+  * for example, the path, size and modification date of a file. Encoded
+  * data is kept for each (key, encoding, maximum line length) triple.
+  *
+  * The cache is disabled by default. Entries are kept in memory up to
+  * a maximum size, and the least recently used ones are then evicted,
+  * or moved to files if a spill directory has been set. Entries larger
+  * than the memory cache are written directly to files.
+  */
+
+class encodedContentCache
+{
+private:
+
+	encodedContentCache();
+	~encodedContentCache();
+
+public:
+
+	static encodedContentCache* getInstance();
+
+	/** Generate encoded contents into a stream. If the encoded contents
+	  * for this key are in the cache, they are copied to the stream;
+	  * otherwise, they are generated by the content handler, and kept
+	  * in the cache if it is enabled.
+	  *
+	  * @param contentKey identity of the contents
+	  * @param cts content handler which generates the contents
+	  * @param os output stream
+	  * @param enc encoding for output
+	  * @param maxLineLength maximum line length for output
+	  */
+	void generate(const string& contentKey, const contentHandler& cts,
+		utility::outputStream& os, const encoding& enc,
+		const string::size_type maxLineLength);
+
+	/** Test whether the cache is enabled, ie. if its maximum memory or
+	  * disk size is not zero.
+	  *
+	  * @return true if the cache is enabled, false otherwise
+	  */
+	bool isEnabled() const;
+
+	/** Set the maximum number of bytes of encoded data kept in memory.
+	  * Zero (the default) disables the memory cache.
+	  *
+	  * @param size maximum size, in bytes
+	  */
+	void setMaxMemorySize(const utility::stream::size_type size);
+
+	/** Return the maximum number of bytes of encoded data kept in memory.
+	  *
+	  * @return maximum size, in bytes
+	  */
+	utility::stream::size_type getMaxMemorySize() const;
+
+	/** Set the directory in which entries evicted from memory are
+	  * written, and the maximum number of bytes written to it. Files
+	  * are deleted when the entries are evicted from the disk cache,
+	  * or when the cache is cleared.
+	  *
+	  * @param dir path of an existing directory
+	  * @param maxSize maximum size of the files, in bytes; zero (the
+	  * default) disables the disk cache
+	  */
+	void setSpillDirectory(const utility::file::path& dir, const utility::stream::size_type maxSize);
+
+	/** Return the maximum number of bytes written to the spill directory.
+	  *
+	  * @return maximum size, in bytes
+	  */
+	utility::stream::size_type getMaxDiskSize() const;
+
+	/** Remove all the entries from the cache.
+	  */
+	void clear();
+
+	/** Return the number of bytes of encoded data currently kept in memory.
+	  *
+	  * @return size, in bytes
+	  */
+	utility::stream::size_type getMemorySize() const;
+
+	/** Return the number of bytes of encoded data currently kept on disk.
+	  *
+	  * @return size, in bytes
+	  */
+	utility::stream::size_type getDiskSize() const;
+
+	/** Return the number of times encoded contents have been found
+	  * in the cache.
+	  *
+	  * @return number of cache hits
+	  */
+	unsigned long getHitCount() const;
+
+	/** Return the number of times encoded contents have not been found
+	  * in the cache, and have been generated.
+	  *
+	  * @return number of cache misses
+	  */
+	unsigned long getMissCount() const;
+
+private:
+
+	class entry;
+
+	typedef string key_type;
+
+	struct slot
+	{
+		ref <entry> data;
+		std::list <key_type>::iterator lruPos;
+	};
+
+	/** An entry removed from memory, to be written to a file. */
+	struct pendingEntry
+	{
+		key_type key;
+		ref <entry> data;
+	};
+
+	static const key_type makeKey(const string& contentKey,
+		const encoding& enc, const string::size_type maxLineLength);
+
+	void store(const key_type& key, const string& data);
+	void insert(const key_type& key, ref <entry> e, const bool mostRecent);
+	void evict(std::vector <pendingEntry>& toSpill, std::vector <ref <entry> >& dropped);
+	void spill(std::vector <pendingEntry>& toSpill, const utility::file::path& dir);
+
+	static ref <entry> writeToFile(const utility::file::path& dir, const string& data);
+
+
+	std::map <key_type, slot> m_entries;
+	std::list <key_type> m_lru;   // most recently used first
+
+	utility::stream::size_type m_maxMemorySize;
+	utility::stream::size_type m_memorySize;
+
+	utility::file::path m_spillDir;
+	utility::stream::size_type m_maxDiskSize;
+	utility::stream::size_type m_diskSize;
+
+	unsigned long m_hitCount;
+	unsigned long m_missCount;
+
+	ref <utility::sync::criticalSection> m_lock;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_ENCODEDCONTENTCACHE_HPP_INCLUDED
@@ -125,8 +125,51 @@ public:
 	  */
 	ref <utility::encoder::encoder> getEncoder() const;
 
+	/** Encode data with the current encoding type. Built-in
+	  * encodings use a shared encoder, so no encoder object is
+	  * created (see encoderFactory::getSharedEncoder()).
+	  *
+	  * @param in input data (decoded)
+	  * @param out output stream for encoded data
+	  * @param maxLineLength maximum line length for output, or
+	  * string::npos to use the default of the encoder
+	  * @param progress progress listener, or NULL if you do not
+	  * want to receive progress notifications
+	  * @throw exceptions::no_encoder_available if no encoder
+	  * is registered for the encoding
+	  * @return number of bytes written into output stream
+	  */
+	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const string::size_type maxLineLength = string::npos,
+		utility::progressListener* progress = NULL) const;
+
+	/** Decode data with the current encoding type. Built-in
+	  * encodings use a shared encoder, so no encoder object is
+	  * created (see encoderFactory::getSharedEncoder()).
+	  *
+	  * @param in input data (encoded)
+	  * @param out output stream for decoded data
+	  * @param progress progress listener, or NULL if you do not
+	  * want to receive progress notifications
+	  * @throw exceptions::no_encoder_available if no encoder
+	  * is registered for the encoding
+	  * @return number of bytes written into output stream
+	  */
+	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		utility::progressListener* progress = NULL) const;
+
 private:
 
+	/** Return the shared encoder for the current encoding type, or
+	  * a new encoder object if it is not a built-in encoding.
+	  */
+	ref <const utility::encoder::encoder> getSharedEncoder() const;
+
+	/** Return the options to use for encoding data.
+	  */
+	const utility::encoder::encoder::options getEncoderOptions() const;
+
+
 	string m_name;
 	EncodingUsage m_usage;
 
@@ -155,6 +198,8 @@ protected:
 		 const string::size_type maxLineLength = lineLengthLimits::infinite,
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
+
+	bool visitChildComponentsImpl(childVisitor& v);
 };
 
 
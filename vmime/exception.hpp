@@ -85,6 +85,12 @@ public:
 	  */
 	virtual exception* clone() const;
 
+	/** Throw a copy of this object, keeping its dynamic type.
+	  * This allows rethrowing an exception which has been cloned,
+	  * for example in another thread.
+	  */
+	virtual void throwException() const;
+
 protected:
 
 	static const exception NO_EXCEPTION;
@@ -106,6 +112,7 @@ public:
 	~bad_field_type() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -118,6 +125,7 @@ public:
 	~charset_conv_error() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -133,6 +141,7 @@ public:
 	~no_encoder_available() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -148,6 +157,7 @@ public:
 	~no_digest_algorithm_available() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -160,6 +170,7 @@ public:
 	~no_such_parameter() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -172,6 +183,7 @@ public:
 	~no_such_field() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -184,6 +196,7 @@ public:
 	~no_such_part() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -196,6 +209,7 @@ public:
 	~no_such_mailbox() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -208,6 +222,7 @@ public:
 	~no_such_message_id() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -220,6 +235,7 @@ public:
 	~no_such_address() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -232,6 +248,7 @@ public:
 	~open_file_error() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -244,6 +261,7 @@ public:
 	~no_factory_available() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -256,6 +274,7 @@ public:
 	~no_platform_handler() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -271,6 +290,7 @@ public:
 	~no_expeditor() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -286,6 +306,7 @@ public:
 	~no_recipient() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -298,6 +319,7 @@ public:
 	~no_object_found() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -313,6 +335,7 @@ public:
 	~no_such_property() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -328,6 +351,7 @@ public:
 	~invalid_property_type() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -343,6 +367,7 @@ public:
 	~invalid_argument() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -358,6 +383,7 @@ public:
 	~system_error() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -377,6 +403,7 @@ public:
 	~net_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -398,6 +425,7 @@ public:
 	~socket_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 };
@@ -415,6 +443,7 @@ public:
 	~connection_error() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -432,6 +461,7 @@ public:
 	const string& response() const;
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 private:
@@ -454,6 +484,7 @@ public:
 	const string& response() const;
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 private:
@@ -473,6 +504,7 @@ public:
 	~unsupported_option() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -488,6 +520,7 @@ public:
 	~no_service_available() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -504,6 +537,7 @@ public:
 	~illegal_state() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -519,6 +553,7 @@ public:
 	~folder_not_found() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -534,6 +569,7 @@ public:
 	~message_not_found() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -549,6 +585,7 @@ public:
 	~operation_not_supported() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -564,6 +601,7 @@ public:
 	~operation_timed_out() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -579,6 +617,7 @@ public:
 	~operation_cancelled() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -595,6 +634,7 @@ public:
 	~unfetched_object() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -610,6 +650,7 @@ public:
 	~not_connected() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -625,6 +666,7 @@ public:
 	~already_connected() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -640,6 +682,7 @@ public:
 	~illegal_operation() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -669,6 +712,7 @@ public:
 	const string& response() const;
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 private:
@@ -703,6 +747,7 @@ public:
 	const string& response() const;
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 private:
@@ -723,6 +768,7 @@ public:
 	~partial_fetch_not_supported() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -738,6 +784,7 @@ public:
 	~malformed_url() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -753,6 +800,7 @@ public:
 	~invalid_folder_name() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -780,6 +828,7 @@ public:
 	const utility::path& path() const;
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 
 private:
@@ -799,6 +848,7 @@ public:
 	~not_a_directory() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -814,6 +864,7 @@ public:
 	~file_not_found() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -832,6 +883,7 @@ public:
 	~authentication_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -847,6 +899,7 @@ public:
 	~no_auth_information() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -865,6 +918,7 @@ public:
 	~sasl_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -880,6 +934,7 @@ public:
 	~no_such_mechanism() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -901,6 +956,7 @@ public:
 	~tls_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -913,6 +969,7 @@ public:
 	~certificate_exception() throw();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw();
 };
 
@@ -925,6 +982,7 @@ public:
 	~certificate_verification_exception() throw ();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw ();
 };
 
@@ -937,6 +995,7 @@ public:
 	~unsupported_certificate_type() throw ();
 
 	exception* clone() const;
+	void throwException() const;
 	const char* name() const throw ();
 };
 
@@ -117,6 +117,30 @@ public:
 	  */
 	void setValue(const string& value);
 
+	/** Locate the next header field in a buffer, without creating it.
+	  *
+	  * @param buffer input buffer
+	  * @param position start position in the buffer
+	  * @param end end position in the buffer
+	  * @param nameStart will receive the start position of the field name
+	  * @param nameEnd will receive the end position of the field name
+	  * @param valueStart will receive the start position of the (raw) field value
+	  * @param valueEnd will receive the end position of the field value
+	  * @param newPosition will receive the position after the field, or
+	  * after the end of the header if there are no more fields
+	  * @return true if a field has been found, or false if the end of
+	  * the header has been reached
+	  */
+	static bool findNext
+		(const string& buffer,
+		 const string::size_type position,
+		 const string::size_type end,
+		 string::size_type* nameStart,
+		 string::size_type* nameEnd,
+		 string::size_type* valueStart,
+		 string::size_type* valueEnd,
+		 string::size_type* newPosition);
+
 
 protected:
 
@@ -132,6 +156,8 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
 
+	bool visitChildComponentsImpl(childVisitor& v);
+
 
 	static ref <headerField> parseNext
 		(const string& buffer,
@@ -34,6 +34,9 @@ namespace vmime
 
 
 /** Creates header field and header field value objects.
+  *
+  * Objects can be created from several threads at the same time, but
+  * types must be registered before other threads use the factory.
   */
 
 class headerFieldFactory
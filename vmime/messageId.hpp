@@ -119,6 +119,8 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
 
+	bool visitChildComponentsImpl(childVisitor& v);
+
 	/** Parse a message-id from an input buffer.
 	  *
 	  * @param buffer input buffer
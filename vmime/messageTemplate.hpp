@@ -0,0 +1,199 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_MESSAGETEMPLATE_HPP_INCLUDED
+#define VMIME_MESSAGETEMPLATE_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+
+#include "vmime/message.hpp"
+#include "vmime/headerFieldValue.hpp"
+#include "vmime/encoding.hpp"
+
+#include "vmime/utility/outputStream.hpp"
+
+#include <vector>
+#include <map>
+
+
+namespace vmime
+{
+
+
+/** A message which is serialized once, and from which a lot of variants
+  * can be generated quickly (eg. the same message sent to a lot of
+  * recipients).
+  *
+  * When the template is compiled, the message is generated once and split
+  * into static segments and holes. A hole is either:
+  *   - the value of a header field of the message, whose name has been
+  *     given to the constructor (eg. "To" or "Message-Id");
+  *   - the contents of a text part which contains placeholders in the
+  *     form "${name}".
+  *
+  * Generating a variant writes the static segments as-is, and only
+  * generates (and encodes) the values of the holes. The part encodings
+  * and boundaries are chosen when the template is compiled: the
+  * substituted text is encoded with the encoding of its part.
+  */
+
+class messageTemplate : public object
+{
+public:
+
+	/** Values of the holes for one variant.
+	  */
+	class values
+	{
+	public:
+
+		/** Set the value of a header field hole.
+		  *
+		  * @param name name of the field (case-insensitive)
+		  * @param value value of the field
+		  */
+		void setField(const string& name, ref <const headerFieldValue> value);
+
+		/** Return the value of a header field hole.
+		  *
+		  * @param name name of the field (case-insensitive)
+		  * @return value of the field, or NULL if it has not been set
+		  */
+		ref <const headerFieldValue> getField(const string& name) const;
+
+		/** Set the value of a placeholder in text parts.
+		  *
+		  * @param name name of the placeholder (without "${" and "}")
+		  * @param value decoded text to put in place of the placeholder
+		  */
+		void setVariable(const string& name, const string& value);
+
+		/** Return the value of a placeholder in text parts.
+		  *
+		  * @param name name of the placeholder
+		  * @return value of the placeholder, or an empty string
+		  * if it has not been set
+		  */
+		const string getVariable(const string& name) const;
+
+		/** Remove all field and placeholder values.
+		  */
+		void clear();
+
+	private:
+
+		std::map <string, ref <const headerFieldValue> > m_fields;
+		std::map <string, string> m_variables;
+	};
+
+
+	/** Compile a template from a message. The message is not modified.
+	  *
+	  * @param msg message to compile
+	  * @param fieldNames names of the header fields of the message whose
+	  * value changes with each variant; a field which does not exist in
+	  * the message is created with an empty value
+	  * @param maxLineLength maximum line length for output
+	  */
+	messageTemplate(ref <const message> msg, const std::vector <string>& fieldNames,
+		const string::size_type maxLineLength = options::getInstance()->message.maxLineLength());
+
+	~messageTemplate();
+
+	/** Generate a variant of the message. Header field holes whose
+	  * value is not set keep the value they had in the compiled
+	  * message, and placeholders whose value is not set are removed.
+	  *
+	  * @param os output stream
+	  * @param vals values of the holes
+	  */
+	void generate(utility::outputStream& os, const values& vals) const;
+
+	/** Generate a variant of the message.
+	  *
+	  * @param vals values of the holes
+	  * @return generated data
+	  */
+	const string generate(const values& vals) const;
+
+	/** Return the names of the placeholders found in the text parts
+	  * of the message, in order of appearance (without duplicates).
+	  *
+	  * @return names of the placeholders
+	  */
+	const std::vector <string> getVariableNames() const;
+
+	/** Return the number of bytes of the static segments, ie. the size
+	  * of a variant not counting the holes.
+	  *
+	  * @return number of bytes
+	  */
+	string::size_type getStaticSize() const;
+
+private:
+
+	class fieldMarker;
+	class textMarker;
+
+	/** A part of the message which changes with each variant. */
+	struct hole
+	{
+		enum Type
+		{
+			TYPE_FIELD,
+			TYPE_TEXT
+		};
+
+		Type type;
+
+		// TYPE_FIELD
+		string fieldName;
+		string defaultValue;      // generated value from the compiled message
+
+		// TYPE_TEXT: literals[0] variables[0] literals[1] ... literals[n]
+		std::vector <string> literals;
+		std::vector <string> variables;
+		encoding enc;
+	};
+
+
+	bool compile(ref <const message> msg, const std::vector <string>& fieldNames);
+	void compileTextParts(ref <bodyPart> part, const string& markerPrefix);
+
+	void generateHole(utility::outputStream& os, const hole& h, const values& vals) const;
+
+	static bool splitText(const string& text, hole& h);
+
+
+	string::size_type m_maxLineLength;
+
+	std::vector <string> m_segments;   // one more than m_holes
+	std::vector <hole> m_holes;        // in order of appearance
+};
+
+
+} // vmime
+
+
+#endif // VMIME_MESSAGETEMPLATE_HPP_INCLUDED
@@ -0,0 +1,158 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_MIMEEVENTPARSER_HPP_INCLUDED
+#define VMIME_MIMEEVENTPARSER_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+
+#include "vmime/mediaType.hpp"
+#include "vmime/encoding.hpp"
+
+#include "vmime/utility/seekableInputStream.hpp"
+#include "vmime/utility/parserInputStreamAdapter.hpp"
+
+
+namespace vmime
+{
+
+
+/** Parses a message and reports its structure to a handler, without
+  * building the message, header and body objects.
+  *
+  * The same rules as message::parse() are used to split the header
+  * fields and the parts. Header fields are reported as raw names and
+  * values pointing into the parsed data (no header field object is
+  * created), and the contents of the parts are decoded according to
+  * their Content-Transfer-Encoding.
+  */
+
+class mimeEventParser : public object
+{
+public:
+
+	/** Receives the parsing events.
+	  */
+	class handler
+	{
+	public:
+
+		virtual ~handler() { }
+
+		/** Called at the start of a part, before its header fields.
+		  *
+		  * @param depth depth of the part (0 for the message itself)
+		  */
+		virtual void onPartBegin(const int depth) = 0;
+
+		/** Called for each header field of the current part. The data
+		  * is only valid during the call.
+		  *
+		  * @param name field name
+		  * @param nameLength length of the field name
+		  * @param value raw field value, as found in the message (folded
+		  * lines and encoded words are left as is)
+		  * @param valueLength length of the field value
+		  */
+		virtual void onHeaderField
+			(const char* name, const string::size_type nameLength,
+			 const char* value, const string::size_type valueLength) = 0;
+
+		/** Called for each chunk of decoded contents of the current
+		  * part, if it is not a multipart. The data is only valid
+		  * during the call.
+		  *
+		  * @param data decoded data
+		  * @param count number of bytes
+		  */
+		virtual void onBodyChunk
+			(const utility::stream::value_type* data, const utility::stream::size_type count) = 0;
+
+		/** Called at the end of the current part.
+		  */
+		virtual void onPartEnd() = 0;
+	};
+
+
+	mimeEventParser();
+
+	/** Parse a message held in memory. Header fields are reported
+	  * without copying them.
+	  *
+	  * @param buffer message data
+	  * @param h handler which receives the events
+	  */
+	void parse(const string& buffer, handler& h);
+
+	/** Parse a message from a stream. If the stream is held in memory
+	  * (see seekableInputStream::getBuffer()), header fields are reported
+	  * without copying them; otherwise, each header is read into a buffer
+	  * which is reused for all the parts.
+	  *
+	  * @param is input stream
+	  * @param length number of bytes to parse, from the beginning of the stream
+	  * @param h handler which receives the events
+	  */
+	void parse(ref <utility::seekableInputStream> is,
+		const utility::stream::size_type length, handler& h);
+
+private:
+
+	class chunkOutputStream;
+
+	void parsePart
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end,
+		 const int depth, handler& h);
+
+	void parseMultipart
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const string& boundary,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end,
+		 const int depth, handler& h);
+
+	void parseContents
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const encoding& enc,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end,
+		 handler& h);
+
+	void readHeader
+		(ref <utility::parserInputStreamAdapter> parser,
+		 const utility::stream::size_type position,
+		 const utility::stream::size_type end);
+
+
+	string m_headerBuffer;
+	mediaType m_type;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_MIMEEVENTPARSER_HPP_INCLUDED
@@ -0,0 +1,122 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_NATIVECHARSETCONVERTER_HPP_INCLUDED
+#define VMIME_NATIVECHARSETCONVERTER_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/charset.hpp"
+
+#include "vmime/utility/outputStream.hpp"
+
+
+namespace vmime
+{
+
+
+/** Built-in conversion between the most common charsets (US-ASCII,
+  * UTF-8, ISO-8859-1 and ISO-8859-15), which does not rely on iconv.
+  *
+  * This is used by charsetConverter and charsetFilteredOutputStream
+  * when both the source and the destination charsets are supported.
+  * Invalid input sequences and characters which cannot be represented
+  * in the destination charset are replaced exactly as they would be
+  * with iconv: one '?' for each byte of the offending sequence.
+  */
+
+class nativeCharsetConverter : public object
+{
+public:
+
+	/** Construct a new converter. The conversion must be
+	  * supported (see isSupported()).
+	  *
+	  * @param source input charset
+	  * @param dest output charset
+	  */
+	nativeCharsetConverter(const charset& source, const charset& dest);
+
+	/** Test whether a conversion can be done by this converter.
+	  *
+	  * @param source input charset
+	  * @param dest output charset
+	  * @return true if the conversion is supported natively,
+	  * false if iconv should be used instead
+	  */
+	static bool isSupported(const charset& source, const charset& dest);
+
+	/** Convert a chunk of data. An incomplete multi-byte sequence at
+	  * the end of the chunk is kept until more data is available.
+	  *
+	  * @param data input bytes
+	  * @param count number of input bytes
+	  * @param out output stream into which converted bytes are written
+	  */
+	void convert(const string::value_type* const data,
+		const string::size_type count, utility::outputStream& out);
+
+	/** Terminate the conversion: replace any pending incomplete
+	  * sequence and reset the converter state.
+	  *
+	  * @param out output stream into which converted bytes are written
+	  */
+	void flush(utility::outputStream& out);
+
+	/** Charsets supported by the built-in converter. */
+	enum NativeCharset
+	{
+		NATIVE_NONE,           /**< Not supported, use iconv. */
+		NATIVE_US_ASCII,
+		NATIVE_UTF_8,
+		NATIVE_ISO_8859_1,
+		NATIVE_ISO_8859_15
+	};
+
+	/** Find out whether a charset is supported natively.
+	  *
+	  * @param ch charset
+	  * @return built-in charset identifier, or NATIVE_NONE if
+	  * the charset is not supported
+	  */
+	static NativeCharset identify(const charset& ch);
+
+private:
+
+	string::size_type process(const unsigned char* data, const string::size_type count,
+		const string::size_type stopAt, const bool final, utility::outputStream& out);
+
+
+	NativeCharset m_source;
+	NativeCharset m_dest;
+
+	// Bytes of an incomplete UTF-8 sequence, waiting for more data
+	unsigned char m_pending[4];
+	string::size_type m_pendingCount;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_NATIVECHARSETCONVERTER_HPP_INCLUDED
@@ -97,6 +97,7 @@ public:
 	ref <connectionInfos> getConnectionInfos() const;
 
 	ref <const socket> getSocket() const;
+	ref <socket> getSocket();
 
 private:
 
@@ -49,6 +49,8 @@
 
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <new>
 
 
 //#define DEBUG_RESPONSE 1
@@ -105,8 +107,7 @@ namespace imap {
 			for (int i = 0 ; i < IMAPParserDebugResponse_level ; ++i)
 				std::cout << "  ";
 
-			std::cout << "LEAVE(" << m_name << "), result=";
-			std::cout << (std::uncaught_exception() ? "FALSE" : "TRUE") << ", pos=" << m_pos;
+			std::cout << "LEAVE(" << m_name << "), pos=" << m_pos;
 			std::cout << std::endl;
 
 			--IMAPParserDebugResponse_level;
@@ -138,7 +139,8 @@ public:
 
 	IMAPParser(weak_ref <IMAPTag> tag, weak_ref <socket> sok, weak_ref <timeoutHandler> _timeoutHandler)
 		: m_tag(tag), m_socket(sok), m_progress(NULL), m_strict(false),
-		  m_literalHandler(NULL), m_timeoutHandler(_timeoutHandler)
+		  m_literalHandler(NULL), m_timeoutHandler(_timeoutHandler),
+		  m_errorComponent(NULL), m_errorPos(0), m_arena(NULL)
 	{
 	}
 
@@ -295,6 +297,193 @@ public:
 	};
 
 
+	//
+	// arena : memory from which the components of a response are allocated
+	//
+	// A response is made of a lot of small components which are all
+	// destroyed at the same time. They are carved out of big chunks
+	// of memory instead of being allocated one by one, and the chunks
+	// are freed in one step when the last component has been deleted
+	// (usually, when the caller deletes the response).
+	//
+
+	class arena
+	{
+	private:
+
+		struct chunk
+		{
+			chunk* next;
+			size_t size;
+			size_t used;
+		};
+
+		// Header of each allocated block: it points to the arena which
+		// owns the block (or is NULL if it has been allocated from the
+		// heap), and keeps the blocks correctly aligned
+		union blockHeader
+		{
+			arena* owner;
+
+			double align1;
+			long align2;
+			void* align3;
+		};
+
+		enum
+		{
+			CHUNK_SIZE = 16384
+		};
+
+		arena()
+			: m_chunks(NULL), m_refs(1)
+		{
+		}
+
+		~arena()
+		{
+			while (m_chunks)
+			{
+				chunk* next = m_chunks->next;
+				::operator delete(m_chunks);
+				m_chunks = next;
+			}
+		}
+
+		static size_t alignedSize(const size_t size)
+		{
+			return (size + sizeof(blockHeader) - 1) / sizeof(blockHeader) * sizeof(blockHeader);
+		}
+
+		static size_t chunkHeaderSize()
+		{
+			return alignedSize(sizeof(chunk));
+		}
+
+		unsigned char* chunkData(chunk* c) const
+		{
+			return reinterpret_cast <unsigned char*>(c) + chunkHeaderSize();
+		}
+
+		void* allocateBlock(const size_t size)
+		{
+			const size_t blockSize = sizeof(blockHeader) + alignedSize(size);
+
+			if (!m_chunks || m_chunks->size - m_chunks->used < blockSize)
+			{
+				const size_t dataSize = std::max(blockSize, static_cast <size_t>(CHUNK_SIZE) - chunkHeaderSize());
+
+				chunk* c = static_cast <chunk*>(::operator new(chunkHeaderSize() + dataSize));
+				c->size = dataSize;
+				c->used = 0;
+
+				// Keep a partially used chunk at the head if the new
+				// one is full (ie. a big block has been allocated)
+				if (m_chunks && blockSize >= dataSize)
+				{
+					c->next = m_chunks->next;
+					m_chunks->next = c;
+				}
+				else
+				{
+					c->next = m_chunks;
+					m_chunks = c;
+				}
+
+				blockHeader* hdr = reinterpret_cast <blockHeader*>(chunkData(c));
+				c->used = blockSize;
+
+				hdr->owner = this;
+				++m_refs;
+
+				return (hdr + 1);
+			}
+
+			blockHeader* hdr = reinterpret_cast <blockHeader*>(chunkData(m_chunks) + m_chunks->used);
+			m_chunks->used += blockSize;
+
+			hdr->owner = this;
+			++m_refs;
+
+			return (hdr + 1);
+		}
+
+		void releaseBlock(blockHeader* hdr, const size_t size)
+		{
+			// Components of a failed alternative are often the last ones
+			// which have been allocated: reclaim their memory immediately
+			const size_t blockSize = sizeof(blockHeader) + alignedSize(size);
+			unsigned char* block = reinterpret_cast <unsigned char*>(hdr);
+
+			if (m_chunks && block + blockSize == chunkData(m_chunks) + m_chunks->used)
+				m_chunks->used -= blockSize;
+
+			release();
+		}
+
+	public:
+
+		/** Create a new arena. The caller holds a reference on it, which
+		  * must be given back with release().
+		  */
+		static arena* create()
+		{
+			return new arena;
+		}
+
+		/** Release a reference on the arena. It is destroyed when no more
+		  * reference is held, ie. when all the blocks allocated from it have
+		  * been freed and its creator has released it.
+		  */
+		void release()
+		{
+			if (--m_refs == 0)
+				delete this;
+		}
+
+		/** Allocate a block of memory from an arena, or from the heap if
+		  * no arena is specified.
+		  *
+		  * @param a arena (may be NULL)
+		  * @param size size of the block
+		  * @return pointer to allocated memory
+		  */
+		static void* allocate(arena* a, const size_t size)
+		{
+			if (a)
+				return a->allocateBlock(size);
+
+			blockHeader* hdr = static_cast <blockHeader*>(::operator new(sizeof(blockHeader) + size));
+			hdr->owner = NULL;
+
+			return (hdr + 1);
+		}
+
+		/** Free a block of memory allocated with allocate().
+		  *
+		  * @param ptr pointer to the block
+		  * @param size size of the block, as given to allocate()
+		  */
+		static void free(void* ptr, const size_t size)
+		{
+			if (!ptr)
+				return;
+
+			blockHeader* hdr = static_cast <blockHeader*>(ptr) - 1;
+
+			if (hdr->owner)
+				hdr->owner->releaseBlock(hdr, size);
+			else
+				::operator delete(hdr);
+		}
+
+	private:
+
+		chunk* m_chunks;
+		unsigned long m_refs;
+	};
+
+
 	//
 	// Base class for a terminal or a non-terminal
 	//
@@ -306,11 +495,45 @@ public:
 		component() { }
 		virtual ~component() { }
 
-		virtual void go(IMAPParser& parser, string& line, string::size_type* currentPos) = 0;
+
+		// Components are allocated from the arena of the response
+		// being parsed (see IMAPParser::get())
+		static void* operator new(size_t size)
+		{
+			return arena::allocate(NULL, size);
+		}
+
+		static void* operator new(size_t size, arena* a)
+		{
+			return arena::allocate(a, size);
+		}
+
+		static void operator delete(void* ptr, size_t size)
+		{
+			arena::free(ptr, size);
+		}
+
+		static void operator delete(void* ptr, arena* /* a */)
+		{
+			// Only called if a constructor throws: the size is unknown,
+			// so the memory will be reclaimed with the arena
+			arena::free(ptr, 0);
+		}
+
+		/** Parse the component.
+		  *
+		  * @param parser parser
+		  * @param line line being parsed
+		  * @param currentPos current position in the line; it is only
+		  * updated if the component has been successfully parsed
+		  * @return true if the component has been successfully parsed,
+		  * false otherwise (the parser then records where it failed)
+		  */
+		virtual bool go(IMAPParser& parser, string& line, string::size_type* currentPos) = 0;
 
 
-		const string makeResponseLine(const string& comp, const string& line,
-		                              const string::size_type pos)
+		static const string makeResponseLine(const string& comp, const string& line,
+		                                     const string::size_type pos)
 		{
 #if DEBUG_RESPONSE
 			if (pos > line.length())
@@ -330,14 +553,42 @@ public:
 #define COMPONENT_ALIAS(parent, name) \
 	class name : public parent \
 	{ \
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos) \
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos) \
 		{ \
 			DEBUG_ENTER_COMPONENT(#name); \
-			parent::go(parser, line, currentPos); \
+			return parent::go(parser, line, currentPos); \
 		} \
 	}
 
 
+	//
+	// Helpers for parsing a sequence of components: the enclosing
+	// component fails (ie. go() returns false) as soon as one of them
+	// cannot be parsed. They expect 'parser', 'line' and 'pos' to be
+	// in scope.
+	//
+
+#define VIMAP_PARSER_FAIL_UNLESS(cond) \
+	do { if (!(cond)) return false; } while (false)
+
+#define VIMAP_PARSER_CHECK(type) \
+	VIMAP_PARSER_FAIL_UNLESS(parser.check <type>(line, &pos))
+
+#define VIMAP_PARSER_CHECK_WITHARG(type, arg) \
+	VIMAP_PARSER_FAIL_UNLESS(parser.checkWithArg <type>(line, &pos, arg))
+
+#define VIMAP_PARSER_GET(type, variable) \
+	VIMAP_PARSER_FAIL_UNLESS((variable = parser.get <type>(line, &pos)) != NULL)
+
+#define VIMAP_PARSER_GET_PUSHBACK(type, list) \
+	do \
+	{ \
+		type* item = parser.get <type>(line, &pos); \
+		VIMAP_PARSER_FAIL_UNLESS(item != NULL); \
+		list.push_back(item); \
+	} while (false)
+
+
 	//
 	// Parse one character
 	//
@@ -347,16 +598,23 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT(string("one_char <") + C + ">: current='" + ((*currentPos < line.length() ? line[*currentPos] : '?')) + "'");
 
 			const string::size_type pos = *currentPos;
 
 			if (pos < line.length() && line[pos] == C)
+			{
 				*currentPos = pos + 1;
+			}
 			else
-				throw exceptions::invalid_response("", makeResponseLine("", line, pos));
+			{
+				parser.setErrorPosition("", pos);
+				return false;
+			}
+
+			return true;
 		}
 	};
 
@@ -369,7 +627,7 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("SPACE");
 
@@ -379,9 +637,16 @@ public:
 				++pos;
 
 			if (pos > *currentPos)
+			{
 				*currentPos = pos;
+			}
 			else
-				throw exceptions::invalid_response("", makeResponseLine("SPACE", line, pos));
+			{
+				parser.setErrorPosition("SPACE", pos);
+				return false;
+			}
+
+			return true;
 		}
 	};
 
@@ -396,13 +661,13 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("CRLF");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <SPACE>(line, &pos, true);
+			parser.check <SPACE>(line, &pos);
 
 			if (pos + 1 < line.length() &&
 			    line[pos] == 0x0d && line[pos + 1] == 0x0a)
@@ -411,8 +676,11 @@ public:
 			}
 			else
 			{
-				throw exceptions::invalid_response("", makeResponseLine("CRLF", line, pos));
+				parser.setErrorPosition("CRLF", pos);
+				return false;
 			}
+
+			return true;
 		}
 	};
 
@@ -433,7 +701,7 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("tag");
 
@@ -484,8 +752,11 @@ public:
 			else
 			{
 				// Invalid tag
-				throw exceptions::invalid_response("", makeResponseLine("tag", line, pos));
+				parser.setErrorPosition("tag", pos);
+				return false;
 			}
+
+			return true;
 		}
 	};
 
@@ -508,7 +779,7 @@ public:
 		{
 		}
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("number");
 
@@ -540,8 +811,11 @@ public:
 			}
 			else
 			{
-				throw exceptions::invalid_response("", makeResponseLine("number", line, pos));
+				parser.setErrorPosition("number", pos);
+				return false;
 			}
+
+			return true;
 		}
 
 	private:
@@ -586,7 +860,7 @@ public:
 		{
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("text");
 
@@ -641,8 +915,11 @@ public:
 			}
 			else
 			{
-				throw exceptions::invalid_response("", makeResponseLine("text", line, pos));
+				parser.setErrorPosition("text", pos);
+				return false;
 			}
+
+			return true;
 		}
 
 	private:
@@ -700,7 +977,7 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("quoted_char");
 
@@ -723,8 +1000,11 @@ public:
 			}
 			else
 			{
-				throw exceptions::invalid_response("", makeResponseLine("QUOTED_CHAR", line, pos));
+				parser.setErrorPosition("QUOTED_CHAR", pos);
+				return false;
 			}
+
+			return true;
 		}
 
 	private:
@@ -749,7 +1029,7 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("quoted_text");
 
@@ -814,8 +1094,11 @@ public:
 			}
 			else
 			{
-				throw exceptions::invalid_response("", makeResponseLine("quoted_text", line, pos));
+				parser.setErrorPosition("quoted_text", pos);
+				return false;
 			}
+
+			return true;
 		}
 
 	private:
@@ -836,15 +1119,17 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("NIL");
 
 			string::size_type pos = *currentPos;
 
-			parser.checkWithArg <special_atom>(line, &pos, "nil");
+			VIMAP_PARSER_CHECK_WITHARG(special_atom, "nil");
 
 			*currentPos = pos;
+
+			return true;
 		}
 	};
 
@@ -872,14 +1157,14 @@ public:
 		{
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("string");
 
 			string::size_type pos = *currentPos;
 
 			if (m_canBeNIL &&
-			    parser.checkWithArg <special_atom>(line, &pos, "nil", true))
+			    parser.checkWithArg <special_atom>(line, &pos, "nil"))
 			{
 				// NIL
 			}
@@ -888,10 +1173,12 @@ public:
 				pos = *currentPos;
 
 				// quoted ::= <"> *QUOTED_CHAR <">
-				if (parser.check <one_char <'"'> >(line, &pos, true))
+				if (parser.check <one_char <'"'> >(line, &pos))
 				{
 					utility::auto_ptr <quoted_text> text(parser.get <quoted_text>(line, &pos));
-					parser.check <one_char <'"'> >(line, &pos);
+					VIMAP_PARSER_FAIL_UNLESS(text);
+
+					VIMAP_PARSER_CHECK(one_char <'"'>);
 
 					if (parser.m_literalHandler != NULL)
 					{
@@ -935,16 +1222,17 @@ public:
 				// literal ::= "{" number "}" CRLF *CHAR8
 				else
 				{
-					parser.check <one_char <'{'> >(line, &pos);
+					VIMAP_PARSER_CHECK(one_char <'{'>);
 
-					number* num = parser.get <number>(line, &pos);
+					number* num = NULL;
+					VIMAP_PARSER_GET(number, num);
 
 					const string::size_type length = num->value();
 					delete (num);
 
-					parser.check <one_char <'}'> >(line, &pos);
+					VIMAP_PARSER_CHECK(one_char <'}'>);
 
-					parser.check <CRLF>(line, &pos);
+					VIMAP_PARSER_CHECK(CRLF);
 
 
 					if (parser.m_literalHandler != NULL)
@@ -981,6 +1269,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1020,7 +1310,7 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("astring");
 
@@ -1028,19 +1318,22 @@ public:
 
 			xstring* str = NULL;
 
-			if ((str = parser.get <xstring>(line, &pos, true)))
+			if ((str = parser.get <xstring>(line, &pos)))
 			{
 				m_value = str->value();
 				delete (str);
 			}
 			else
 			{
-				atom* at = parser.get <atom>(line, &pos);
+				atom* at = NULL;
+				VIMAP_PARSER_GET(atom, at);
 				m_value = at->value();
 				delete (at);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1069,56 +1362,56 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& /* parser */, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("atom");
 
 			string::size_type pos = *currentPos;
-			string::size_type len = 0;
 
-			for (bool end = false ; !end && pos < line.length() ; )
+			while (pos < line.length() && isAtomChar(line[pos]))
+				++pos;
+
+			if (pos != *currentPos)
 			{
-				const unsigned char c = line[pos];
+				m_value.assign(line, *currentPos, pos - *currentPos);
 
-				switch (c)
-				{
-				case '(':
-				case ')':
-				case '{':
-				case 0x20:  // SPACE
-				case '%':   // list_wildcards
-				case '*':   // list_wildcards
-				case '"':   // quoted_specials
-				case '\\':  // quoted_specials
+				*currentPos = pos;
+			}
+			else
+			{
+				parser.setErrorPosition("atom", pos);
+				return false;
+			}
 
-				case '[':
-				case ']':   // for "special_atom"
+			return true;
+		}
 
-					end = true;
-					break;
+		/** Test whether a character can be part of an atom.
+		  *
+		  * @param c character to test
+		  * @return true if the character is an ATOM_CHAR, false otherwise
+		  */
+		static bool isAtomChar(const unsigned char c)
+		{
+			switch (c)
+			{
+			case '(':
+			case ')':
+			case '{':
+			case 0x20:  // SPACE
+			case '%':   // list_wildcards
+			case '*':   // list_wildcards
+			case '"':   // quoted_specials
+			case '\\':  // quoted_specials
 
-				default:
+			case '[':
+			case ']':   // for "special_atom"
 
-					if (c <= 0x1f || c >= 0x7f)
-						end = true;
-					else
-					{
-						++pos;
-						++len;
-					}
-				}
-			}
+				return false;
 
-			if (len != 0)
-			{
-				m_value.resize(len);
-				std::copy(line.begin() + *currentPos, line.begin() + pos, m_value.begin());
+			default:
 
-				*currentPos = pos;
-			}
-			else
-			{
-				throw exceptions::invalid_response("", makeResponseLine("atom", line, pos));
+				return (c > 0x1f && c < 0x7f);
 			}
 		}
 
@@ -1150,35 +1443,37 @@ public:
 		{
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT(string("special_atom(") + m_string + ")");
 
 			string::size_type pos = *currentPos;
 
-			atom::go(parser, line, &pos);
-
-			const char* cmp = value().c_str();
-			const char* with = m_string;
-
-			bool ok = true;
-
-			while (ok && *cmp && *with)
+			// Compare the atom in place, without extracting it
+			for (const char* with = m_string ; *with ; ++with, ++pos)
 			{
-				ok = (std::tolower(*cmp, std::locale()) == *with);
+				unsigned char c = (pos < line.length() ? line[pos] : 0);
 
-				++cmp;
-				++with;
-			}
+				if (c >= 'A' && c <= 'Z')
+					c = static_cast <unsigned char>(c - 'A' + 'a');
 
-			if (!ok || *cmp || *with)
-			{
-				throw exceptions::invalid_response("", makeResponseLine(string("special_atom <") + m_string + ">", line, pos));
+				if (c != static_cast <unsigned char>(*with))
+				{
+					parser.setErrorPosition("special_atom", pos);
+					return false;
+				}
 			}
-			else
+
+			// The atom must end here
+			if (pos < line.length() && isAtomChar(line[pos]))
 			{
-				*currentPos = pos;
+				parser.setErrorPosition("special_atom", pos);
+				return false;
 			}
+
+			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1196,44 +1491,32 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("text_mime2");
 
 			string::size_type pos = *currentPos;
 
-			atom* theCharset = NULL, *theEncoding = NULL;
-			text* theText = NULL;
-
-			try
-			{
-				parser.check <one_char <'='> >(line, &pos);
-				parser.check <one_char <'?'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'='>);
+			VIMAP_PARSER_CHECK(one_char <'?'>);
 
-				theCharset = parser.get <atom>(line, &pos);
+			utility::auto_ptr <atom> theCharset(parser.get <atom>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(theCharset);
 
-				parser.check <one_char <'?'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'?'>);
 
-				theEncoding = parser.get <atom>(line, &pos);
+			utility::auto_ptr <atom> theEncoding(parser.get <atom>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(theEncoding);
 
-				parser.check <one_char <'?'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'?'>);
 
-				theText = parser.get <text8_except <'?'> >(line, &pos);
+			utility::auto_ptr <text> theText(parser.get <text8_except <'?'> >(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(theText);
 
-				parser.check <one_char <'?'> >(line, &pos);
-				parser.check <one_char <'='> >(line, &pos);
-			}
-			catch (std::exception& e)
-			{
-				delete (theCharset);
-				delete (theEncoding);
-				delete (theText);
-
-				throw;
-			}
+			VIMAP_PARSER_CHECK(one_char <'?'>);
+			VIMAP_PARSER_CHECK(one_char <'='>);
 
 			m_charset = theCharset->value();
-			delete (theCharset);
 
 			// Decode text
 			utility::encoder::encoder* theEncoder = NULL;
@@ -1264,10 +1547,9 @@ public:
 				m_value = theText->value();
 			}
 
-			delete (theEncoding);
-			delete (theText);
-
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1311,21 +1593,22 @@ public:
 			delete (m_flag_keyword);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("flag_keyword");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'\\'> >(line, &pos, true))
+			if (parser.check <one_char <'\\'> >(line, &pos))
 			{
-				if (parser.check <one_char <'*'> >(line, &pos, true))
+				if (parser.check <one_char <'*'> >(line, &pos))
 				{
 					m_type = STAR;
 				}
 				else
 				{
-					atom* at = parser.get <atom>(line, &pos);
+					atom* at = NULL;
+					VIMAP_PARSER_GET(atom, at);
 					const string name = utility::stringUtils::toLower(at->value());
 					delete (at);
 
@@ -1349,10 +1632,12 @@ public:
 			else
 			{
 				m_type = KEYWORD_OR_EXTENSION;
-				m_flag_keyword = parser.get <atom>(line, &pos);
+				VIMAP_PARSER_GET(atom, m_flag_keyword);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -1401,21 +1686,23 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("flag_list");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			while (!parser.check <one_char <')'> >(line, &pos, true))
+			while (!parser.check <one_char <')'> >(line, &pos))
 			{
-				m_flags.push_back(parser.get <flag>(line, &pos));
-				parser.check <SPACE>(line, &pos, true);
+				VIMAP_PARSER_GET_PUSHBACK(flag, m_flags);
+				parser.check <SPACE>(line, &pos);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1440,13 +1727,13 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("mailbox");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.checkWithArg <special_atom>(line, &pos, "inbox", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "inbox"))
 			{
 				m_type = INBOX;
 				m_name = "INBOX";
@@ -1455,12 +1742,15 @@ public:
 			{
 				m_type = OTHER;
 
-				astring* astr = parser.get <astring>(line, &pos);
+				astring* astr = NULL;
+				VIMAP_PARSER_GET(astring, astr);
 				m_name = astr->value();
 				delete (astr);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -1491,15 +1781,16 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("mailbox_flag");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'\\'> >(line, &pos, true))
+			if (parser.check <one_char <'\\'> >(line, &pos))
 			{
-				atom* at = parser.get <atom>(line, &pos);
+				atom* at = NULL;
+				VIMAP_PARSER_GET(atom, at);
 				const string name = utility::stringUtils::toLower(at->value());
 				delete (at);
 
@@ -1519,7 +1810,8 @@ public:
 			}
 			else
 			{
-				atom* at = parser.get <atom>(line, &pos);
+				atom* at = NULL;
+				VIMAP_PARSER_GET(atom, at);
 				const string name = utility::stringUtils::toLower(at->value());
 				delete (at);
 
@@ -1528,6 +1820,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -1569,21 +1863,23 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("mailbox_flag_list");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			while (!parser.check <one_char <')'> >(line, &pos, true))
+			while (!parser.check <one_char <')'> >(line, &pos))
 			{
-				m_flags.push_back(parser.get <mailbox_flag>(line, &pos));
-				parser.check <SPACE>(line, &pos, true);
+				VIMAP_PARSER_GET_PUSHBACK(mailbox_flag, m_flags);
+				parser.check <SPACE>(line, &pos);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1617,32 +1913,35 @@ public:
 			delete (m_mailbox);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("mailbox_list");
 
 			string::size_type pos = *currentPos;
 
-			m_mailbox_flag_list = parser.get <IMAPParser::mailbox_flag_list>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::mailbox_flag_list, m_mailbox_flag_list);
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			if (!parser.check <NIL>(line, &pos, true))
+			if (!parser.check <NIL>(line, &pos))
 			{
-				parser.check <one_char <'"'> >(line, &pos);
+				VIMAP_PARSER_CHECK(one_char <'"'>);
 
-				QUOTED_CHAR* qc = parser.get <QUOTED_CHAR>(line, &pos);
+				QUOTED_CHAR* qc = NULL;
+				VIMAP_PARSER_GET(QUOTED_CHAR, qc);
 				m_quoted_char = qc->value();
 				delete (qc);
 
-				parser.check <one_char <'"'> >(line, &pos);
+				VIMAP_PARSER_CHECK(one_char <'"'>);
 			}
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_mailbox = parser.get <IMAPParser::mailbox>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::mailbox, m_mailbox);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1684,74 +1983,76 @@ public:
 			delete (m_text);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("resp_text_code");
 
 			string::size_type pos = *currentPos;
 
 			// "ALERT"
-			if (parser.checkWithArg <special_atom>(line, &pos, "alert", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "alert"))
 			{
 				m_type = ALERT;
 			}
 			// "PARSE"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "parse", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "parse"))
 			{
 				m_type = PARSE;
 			}
 			// "PERMANENTFLAGS" SPACE flag_list
-			else if (parser.checkWithArg <special_atom>(line, &pos, "permanentflags", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "permanentflags"))
 			{
 				m_type = PERMANENTFLAGS;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_flag_list = parser.get <IMAPParser::flag_list>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::flag_list, m_flag_list);
 			}
 			// "READ-ONLY"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "read-only", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "read-only"))
 			{
 				m_type = READ_ONLY;
 			}
 			// "READ-WRITE"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "read-write", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "read-write"))
 			{
 				m_type = READ_WRITE;
 			}
 			// "TRYCREATE"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "trycreate", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "trycreate"))
 			{
 				m_type = TRYCREATE;
 			}
 			// "UIDVALIDITY" SPACE nz_number
-			else if (parser.checkWithArg <special_atom>(line, &pos, "uidvalidity", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "uidvalidity"))
 			{
 				m_type = UIDVALIDITY;
 
-				parser.check <SPACE>(line, &pos);
-				m_nz_number = parser.get <IMAPParser::nz_number>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::nz_number, m_nz_number);
 			}
 			// "UNSEEN" SPACE nz_number
-			else if (parser.checkWithArg <special_atom>(line, &pos, "unseen", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "unseen"))
 			{
 				m_type = UNSEEN;
 
-				parser.check <SPACE>(line, &pos);
-				m_nz_number = parser.get <IMAPParser::nz_number>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::nz_number, m_nz_number);
 			}
 			// atom [SPACE 1*<any TEXT_CHAR except "]">]
 			else
 			{
 				m_type = OTHER;
 
-				m_atom = parser.get <IMAPParser::atom>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::atom, m_atom);
 
-				if (parser.check <SPACE>(line, &pos, true))
-					m_text = parser.get <text_except <']'> >(line, &pos);
+				if (parser.check <SPACE>(line, &pos))
+					VIMAP_PARSER_GET(text_except <']'>, m_text);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -1806,21 +2107,21 @@ public:
 			delete (m_resp_text_code);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("resp_text");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'['> >(line, &pos, true))
+			if (parser.check <one_char <'['> >(line, &pos))
 			{
-				m_resp_text_code = parser.get <IMAPParser::resp_text_code>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::resp_text_code, m_resp_text_code);
 
-				parser.check <one_char <']'> >(line, &pos);
-				parser.check <SPACE>(line, &pos, true);
+				VIMAP_PARSER_CHECK(one_char <']'>);
+				parser.check <SPACE>(line, &pos);
 			}
 
-			text_mime2* text1 = parser.get <text_mime2>(line, &pos, true);
+			text_mime2* text1 = parser.get <text_mime2>(line, &pos);
 
 			if (text1 != NULL)
 			{
@@ -1830,7 +2131,7 @@ public:
 			else
 			{
 				IMAPParser::text* text2 =
-					parser.get <IMAPParser::text>(line, &pos, true);
+					parser.get <IMAPParser::text>(line, &pos);
 
 				if (text2 != NULL)
 				{
@@ -1844,6 +2145,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1876,20 +2179,22 @@ public:
 			delete (m_resp_text);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("continue_req");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'+'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'+'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_resp_text = parser.get <IMAPParser::resp_text>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::resp_text, m_resp_text);
 
-			parser.check <CRLF>(line, &pos);
+			VIMAP_PARSER_CHECK(CRLF);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -1911,11 +2216,14 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("auth_type");
 
-			atom* at = parser.get <atom>(line, currentPos);
+			string::size_type pos = *currentPos;
+
+			atom* at = NULL;
+			VIMAP_PARSER_GET(atom, at);
 			m_name = utility::stringUtils::toLower(at->value());
 			delete (at);
 
@@ -1927,6 +2235,10 @@ public:
 				m_type = SKEY;
 			else
 				m_type = UNKNOWN;
+
+			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -1961,35 +2273,37 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("status_att");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.checkWithArg <special_atom>(line, &pos, "messages", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "messages"))
 			{
 				m_type = MESSAGES;
 			}
-			else if (parser.checkWithArg <special_atom>(line, &pos, "recent", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "recent"))
 			{
 				m_type = RECENT;
 			}
-			else if (parser.checkWithArg <special_atom>(line, &pos, "uidnext", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "uidnext"))
 			{
 				m_type = UIDNEXT;
 			}
-			else if (parser.checkWithArg <special_atom>(line, &pos, "uidvalidity", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "uidvalidity"))
 			{
 				m_type = UIDVALIDITY;
 			}
 			else
 			{
-				parser.checkWithArg <special_atom>(line, &pos, "unseen");
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "unseen");
 				m_type = UNSEEN;
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -2033,13 +2347,14 @@ public:
 			delete (m_atom);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("capability");
 
 			string::size_type pos = *currentPos;
 
-			class atom* at = parser.get <IMAPParser::atom>(line, &pos);
+			class atom* at = NULL;
+			VIMAP_PARSER_GET(IMAPParser::atom, at);
 
 			string value = at->value();
 			const char* str = value.c_str();
@@ -2050,9 +2365,11 @@ public:
 			    (str[3] == 'h' || str[3] == 'H') &&
 			    (str[4] == '='))
 			{
-				string::size_type pos = 5;
-				m_auth_type = parser.get <IMAPParser::auth_type>(value, &pos);
+				string::size_type authPos = 5;
+				m_auth_type = parser.get <IMAPParser::auth_type>(value, &authPos);
 				delete (at);
+
+				VIMAP_PARSER_FAIL_UNLESS(m_auth_type);
 			}
 			else
 			{
@@ -2060,6 +2377,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2095,15 +2414,15 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("capability_data");
 
 			string::size_type pos = *currentPos;
 
-			parser.checkWithArg <special_atom>(line, &pos, "capability");
+			VIMAP_PARSER_CHECK_WITHARG(special_atom, "capability");
 
-			while (parser.check <SPACE>(line, &pos, true))
+			while (parser.check <SPACE>(line, &pos))
 			{
 				capability* cap = parser.get <capability>(line, &pos);
 				if (cap == NULL) break;
@@ -2112,6 +2431,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2152,50 +2473,72 @@ public:
 	{
 	public:
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("date_time");
 
 			string::size_type pos = *currentPos;
 
 			// <"> date_day_fixed "-" date_month "-" date_year
-			parser.check <one_char <'"'> >(line, &pos);
-			parser.check <SPACE>(line, &pos, true);
+			VIMAP_PARSER_CHECK(one_char <'"'>);
+			parser.check <SPACE>(line, &pos);
 
 			utility::auto_ptr <number> nd(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(nd);
+
+			VIMAP_PARSER_CHECK(one_char <'-'>);
+
+			// date_month is made of exactly three letters (an atom would
+			// also include the following "-" date_year)
+			if (pos + 3 > line.length())
+			{
+				parser.setErrorPosition("date_month", pos);
+				return false;
+			}
 
-			parser.check <one_char <'-'> >(line, &pos);
+			char month[3];
 
-			utility::auto_ptr <atom> amo(parser.get <atom>(line, &pos));
+			for (int i = 0 ; i < 3 ; ++i, ++pos)
+			{
+				const char c = line[pos];
+				month[i] = (c >= 'A' && c <= 'Z') ? static_cast <char>(c - 'A' + 'a') : c;
+			}
 
-			parser.check <one_char <'-'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'-'>);
 
 			utility::auto_ptr <number> ny(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(ny);
 
-			parser.check <SPACE>(line, &pos, true);
+			parser.check <SPACE>(line, &pos);
 
 			// 2digit ":" 2digit ":" 2digit
 			utility::auto_ptr <number> nh(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(nh);
 
-			parser.check <one_char <':'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <':'>);
 
 			utility::auto_ptr <number> nmi(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(nmi);
 
-			parser.check <one_char <':'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <':'>);
 
 			utility::auto_ptr <number> ns(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(ns);
 
-			parser.check <SPACE>(line, &pos, true);
+			parser.check <SPACE>(line, &pos);
 
 			// ("+" / "-") 4digit
 			int sign = 1;
 
-			if (!(parser.check <one_char <'+'> >(line, &pos, true)))
-				parser.check <one_char <'-'> >(line, &pos);
+			if (parser.check <one_char <'-'> >(line, &pos))
+				sign = -1;
+			else
+				VIMAP_PARSER_CHECK(one_char <'+'>);
 
 			utility::auto_ptr <number> nz(parser.get <number>(line, &pos));
+			VIMAP_PARSER_FAIL_UNLESS(nz);
 
-			parser.check <one_char <'"'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'"'>);
 
 
 			m_datetime.setHour(std::min(std::max(nh->value(), 0u), 23u));
@@ -2211,69 +2554,71 @@ public:
 			m_datetime.setDay(std::min(std::max(nd->value(), 1u), 31u));
 			m_datetime.setYear(ny->value());
 
-			const string month(utility::stringUtils::toLower(amo->value()));
 			int mon = vmime::datetime::JANUARY;
 
-			if (month.length() >= 3)
+			switch (month[0])
+			{
+			case 'j':
 			{
-				switch (month[0])
+				switch (month[1])
 				{
-				case 'j':
+				case 'a': mon = vmime::datetime::JANUARY; break;
+				case 'u':
 				{
-					switch (month[1])
-					{
-					case 'a': mon = vmime::datetime::JANUARY; break;
-					case 'u':
+					switch (month[2])
 					{
-						switch (month[2])
-						{
-						case 'n': mon = vmime::datetime::JUNE; break;
-						default:  mon = vmime::datetime::JULY; break;
-						}
-
-						break;
-					}
-
+					case 'n': mon = vmime::datetime::JUNE; break;
+					default:  mon = vmime::datetime::JULY; break;
 					}
 
 					break;
 				}
-				case 'f': mon = vmime::datetime::FEBRUARY; break;
-				case 'm':
-				{
-					switch (month[2])
-					{
-					case 'r': mon = vmime::datetime::MARCH; break;
-					default:  mon = vmime::datetime::MAY; break;
-					}
 
-					break;
 				}
-				case 'a':
-				{
-					switch (month[1])
-					{
-					case 'p': mon = vmime::datetime::APRIL; break;
-					default:  mon = vmime::datetime::AUGUST; break;
-					}
 
-					break;
+				break;
+			}
+			case 'f': mon = vmime::datetime::FEBRUARY; break;
+			case 'm':
+			{
+				switch (month[2])
+				{
+				case 'r': mon = vmime::datetime::MARCH; break;
+				default:  mon = vmime::datetime::MAY; break;
 				}
-				case 's': mon = vmime::datetime::SEPTEMBER; break;
-				case 'o': mon = vmime::datetime::OCTOBER; break;
-				case 'n': mon = vmime::datetime::NOVEMBER; break;
-				case 'd': mon = vmime::datetime::DECEMBER; break;
+
+				break;
+			}
+			case 'a':
+			{
+				switch (month[1])
+				{
+				case 'p': mon = vmime::datetime::APRIL; break;
+				default:  mon = vmime::datetime::AUGUST; break;
 				}
+
+				break;
+			}
+			case 's': mon = vmime::datetime::SEPTEMBER; break;
+			case 'o': mon = vmime::datetime::OCTOBER; break;
+			case 'n': mon = vmime::datetime::NOVEMBER; break;
+			case 'd': mon = vmime::datetime::DECEMBER; break;
 			}
 
 			m_datetime.setMonth(mon);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
 
 		vmime::datetime m_datetime;
+
+	public:
+
+		const vmime::datetime& value() const { return (m_datetime); }
 	};
 
 
@@ -2301,21 +2646,23 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("header_list");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			while (!parser.check <one_char <')'> >(line, &pos, true))
+			while (!parser.check <one_char <')'> >(line, &pos))
 			{
-				m_fld_names.push_back(parser.get <header_fld_name>(line, &pos));
-				parser.check <SPACE>(line, &pos, true);
+				VIMAP_PARSER_GET_PUSHBACK(header_fld_name, m_fld_names);
+				parser.check <SPACE>(line, &pos);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2359,28 +2706,29 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'('> >(line, &pos, true))
+			if (parser.check <one_char <'('> >(line, &pos))
 			{
-				m_body_extensions.push_back
-					(parser.get <body_extension>(line, &pos));
+				VIMAP_PARSER_GET_PUSHBACK(body_extension, m_body_extensions);
 
-				while (!parser.check <one_char <')'> >(line, &pos, true))
+				while (!parser.check <one_char <')'> >(line, &pos))
 				{
-					m_body_extensions.push_back(parser.get <body_extension>(line, &pos));
-					parser.check <SPACE>(line, &pos, true);
+					VIMAP_PARSER_GET_PUSHBACK(body_extension, m_body_extensions);
+					parser.check <SPACE>(line, &pos);
 				}
 			}
 			else
 			{
-				if (!(m_nstring = parser.get <IMAPParser::nstring>(line, &pos, true)))
-					m_number = parser.get <IMAPParser::number>(line, &pos);
+				if (!(m_nstring = parser.get <IMAPParser::nstring>(line, &pos)))
+					VIMAP_PARSER_GET(IMAPParser::number, m_number);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2418,30 +2766,30 @@ public:
 			delete (m_header_list);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("section_text");
 
 			string::size_type pos = *currentPos;
 
 			// "HEADER.FIELDS" [".NOT"] SPACE header_list
-			const bool b1 = parser.checkWithArg <special_atom>(line, &pos, "header.fields.not", true);
-			const bool b2 = (b1 ? false : parser.checkWithArg <special_atom>(line, &pos, "header.fields", true));
+			const bool b1 = parser.checkWithArg <special_atom>(line, &pos, "header.fields.not");
+			const bool b2 = (b1 ? false : parser.checkWithArg <special_atom>(line, &pos, "header.fields"));
 
 			if (b1 || b2)
 			{
 				m_type = b1 ? HEADER_FIELDS_NOT : HEADER_FIELDS;
 
-				parser.check <SPACE>(line, &pos);
-				m_header_list = parser.get <IMAPParser::header_list>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::header_list, m_header_list);
 			}
 			// "HEADER"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "header", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "header"))
 			{
 				m_type = HEADER;
 			}
 			// "MIME"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "mime", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "mime"))
 			{
 				m_type = MIME;
 			}
@@ -2450,10 +2798,12 @@ public:
 			{
 				m_type = TEXT;
 
-				parser.checkWithArg <special_atom>(line, &pos, "text");
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "text");
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -2498,41 +2848,44 @@ public:
 			delete (m_section_text2);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("section");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'['> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'['>);
 
-			if (!parser.check <one_char <']'> >(line, &pos, true))
+			if (!parser.check <one_char <']'> >(line, &pos))
 			{
-				if (!(m_section_text1 = parser.get <section_text>(line, &pos, true)))
+				if (!(m_section_text1 = parser.get <section_text>(line, &pos)))
 				{
-					nz_number* num = parser.get <nz_number>(line, &pos);
+					nz_number* num = NULL;
+					VIMAP_PARSER_GET(nz_number, num);
 					m_nz_numbers.push_back(num->value());
 					delete (num);
 
-					while (parser.check <one_char <'.'> >(line, &pos, true))
+					while (parser.check <one_char <'.'> >(line, &pos))
 					{
-						if ((num = parser.get <nz_number>(line, &pos, true)))
+						if ((num = parser.get <nz_number>(line, &pos)))
 						{
 							m_nz_numbers.push_back(num->value());
 							delete (num);
 						}
 						else
 						{
-							m_section_text2 = parser.get <section_text>(line, &pos);
+							VIMAP_PARSER_GET(section_text, m_section_text2);
 							break;
 						}
 					}
 				}
 
-				parser.check <one_char <']'> >(line, &pos);
+				VIMAP_PARSER_CHECK(one_char <']'>);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2590,23 +2943,25 @@ public:
 			delete (m_addr_host);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("address");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
-			m_addr_name = parser.get <nstring>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_addr_adl = parser.get <nstring>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_addr_mailbox = parser.get <nstring>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_addr_host = parser.get <nstring>(line, &pos);
-			parser.check <one_char <')'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
+			VIMAP_PARSER_GET(nstring, m_addr_name);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(nstring, m_addr_adl);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(nstring, m_addr_mailbox);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(nstring, m_addr_host);
+			VIMAP_PARSER_CHECK(one_char <')'>);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2642,24 +2997,26 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("address_list");
 
 			string::size_type pos = *currentPos;
 
-			if (!parser.check <NIL>(line, &pos, true))
+			if (!parser.check <NIL>(line, &pos))
 			{
-				parser.check <one_char <'('> >(line, &pos);
+				VIMAP_PARSER_CHECK(one_char <'('>);
 
-				while (!parser.check <one_char <')'> >(line, &pos, true))
+				while (!parser.check <one_char <')'> >(line, &pos))
 				{
-					m_addresses.push_back(parser.get <address>(line, &pos));
-					parser.check <SPACE>(line, &pos, true);
+					VIMAP_PARSER_GET_PUSHBACK(address, m_addresses);
+					parser.check <SPACE>(line, &pos);
 				}
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2775,46 +3132,48 @@ public:
 			delete (m_env_message_id);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("envelope");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			m_env_date = parser.get <IMAPParser::env_date>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_date, m_env_date);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_subject = parser.get <IMAPParser::env_subject>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_subject, m_env_subject);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_from = parser.get <IMAPParser::env_from>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_from, m_env_from);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_sender = parser.get <IMAPParser::env_sender>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_sender, m_env_sender);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_reply_to = parser.get <IMAPParser::env_reply_to>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_reply_to, m_env_reply_to);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_to = parser.get <IMAPParser::env_to>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_to, m_env_to);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_cc = parser.get <IMAPParser::env_cc>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_cc, m_env_cc);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_bcc = parser.get <IMAPParser::env_bcc>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_bcc, m_env_bcc);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_in_reply_to = parser.get <IMAPParser::env_in_reply_to>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_in_reply_to, m_env_in_reply_to);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_env_message_id = parser.get <IMAPParser::env_message_id>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::env_message_id, m_env_message_id);
 
-			parser.check <one_char <')'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <')'>);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2907,19 +3266,21 @@ public:
 			delete (m_string2);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_fld_param_item");
 
 			string::size_type pos = *currentPos;
 
-			m_string1 = parser.get <xstring>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_string2 = parser.get <xstring>(line, &pos);
+			VIMAP_PARSER_GET(xstring, m_string1);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(xstring, m_string2);
 
 			DEBUG_FOUND("body_fld_param_item", "<" << m_string1->value() << ", " << m_string2->value() << ">");
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -2951,28 +3312,30 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_fld_param");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'('> >(line, &pos, true))
+			if (parser.check <one_char <'('> >(line, &pos))
 			{
-				m_items.push_back(parser.get <body_fld_param_item>(line, &pos));
+				VIMAP_PARSER_GET_PUSHBACK(body_fld_param_item, m_items);
 
-				while (!parser.check <one_char <')'> >(line, &pos, true))
+				while (!parser.check <one_char <')'> >(line, &pos))
 				{
-					parser.check <SPACE>(line, &pos);
-					m_items.push_back(parser.get <body_fld_param_item>(line, &pos));
+					VIMAP_PARSER_CHECK(SPACE);
+					VIMAP_PARSER_GET_PUSHBACK(body_fld_param_item, m_items);
 				}
 			}
 			else
 			{
-				parser.check <NIL>(line, &pos);
+				VIMAP_PARSER_CHECK(NIL);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3004,25 +3367,27 @@ public:
 			delete (m_body_fld_param);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_fld_dsp");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'('> >(line, &pos, true))
+			if (parser.check <one_char <'('> >(line, &pos))
 			{
-				m_string = parser.get <xstring>(line, &pos);
-				parser.check <SPACE>(line, &pos);
-				m_body_fld_param = parser.get <class body_fld_param>(line, &pos);
-				parser.check <one_char <')'> >(line, &pos);
+				VIMAP_PARSER_GET(xstring, m_string);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(class body_fld_param, m_body_fld_param);
+				VIMAP_PARSER_CHECK(one_char <')'>);
 			}
 			else
 			{
-				parser.check <NIL>(line, &pos);
+				VIMAP_PARSER_CHECK(NIL);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3054,28 +3419,30 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_fld_lang");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.check <one_char <'('> >(line, &pos, true))
+			if (parser.check <one_char <'('> >(line, &pos))
 			{
-				m_strings.push_back(parser.get <class xstring>(line, &pos));
+				VIMAP_PARSER_GET_PUSHBACK(class xstring, m_strings);
 
-				while (!parser.check <one_char <')'> >(line, &pos, true))
+				while (!parser.check <one_char <')'> >(line, &pos))
 				{
-					parser.check <SPACE>(line, &pos);
-					m_strings.push_back(parser.get <class xstring>(line, &pos));
+					VIMAP_PARSER_CHECK(SPACE);
+					VIMAP_PARSER_GET_PUSHBACK(class xstring, m_strings);
 				}
 			}
 			else
 			{
-				m_strings.push_back(parser.get <class nstring>(line, &pos));
+				VIMAP_PARSER_GET_PUSHBACK(class nstring, m_strings);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3113,23 +3480,25 @@ public:
 			delete (m_body_fld_octets);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_fields");
 
 			string::size_type pos = *currentPos;
 
-			m_body_fld_param = parser.get <IMAPParser::body_fld_param>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fld_id = parser.get <IMAPParser::body_fld_id>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fld_desc = parser.get <IMAPParser::body_fld_desc>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fld_enc = parser.get <IMAPParser::body_fld_enc>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fld_octets = parser.get <IMAPParser::body_fld_octets>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_param, m_body_fld_param);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_id, m_body_fld_id);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_desc, m_body_fld_desc);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_enc, m_body_fld_enc);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_octets, m_body_fld_octets);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3177,20 +3546,22 @@ public:
 			delete (m_media_subtype);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("media_text");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'"'> >(line, &pos);
-			parser.checkWithArg <special_atom>(line, &pos, "text");
-			parser.check <one_char <'"'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'"'>);
+			VIMAP_PARSER_CHECK_WITHARG(special_atom, "text");
+			VIMAP_PARSER_CHECK(one_char <'"'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_media_subtype = parser.get <IMAPParser::media_subtype>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_subtype, m_media_subtype);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3222,24 +3593,26 @@ public:
 			delete m_media_subtype;
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("media_message");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'"'> >(line, &pos);
-			parser.checkWithArg <special_atom>(line, &pos, "message");
-			parser.check <one_char <'"'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'"'>);
+			VIMAP_PARSER_CHECK_WITHARG(special_atom, "message");
+			VIMAP_PARSER_CHECK(one_char <'"'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
 			//parser.check <one_char <'"'> >(line, &pos);
 			//parser.checkWithArg <special_atom>(line, &pos, "rfc822");
 			//parser.check <one_char <'"'> >(line, &pos);
 
-			m_media_subtype = parser.get <IMAPParser::media_subtype>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_subtype, m_media_subtype);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3273,19 +3646,21 @@ public:
 			delete (m_media_subtype);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("media_basic");
 
 			string::size_type pos = *currentPos;
 
-			m_media_type = parser.get <xstring>(line, &pos);
+			VIMAP_PARSER_GET(xstring, m_media_type);
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_media_subtype = parser.get <IMAPParser::media_subtype>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_subtype, m_media_subtype);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3330,44 +3705,45 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_ext_1part");
 
 			string::size_type pos = *currentPos;
 
-			m_body_fld_md5 = parser.get <IMAPParser::body_fld_md5>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_md5, m_body_fld_md5);
 
 			// [SPACE body_fld_dsp
-			if (parser.check <SPACE>(line, &pos, true))
+			if (parser.check <SPACE>(line, &pos))
 			{
-				m_body_fld_dsp = parser.get <IMAPParser::body_fld_dsp>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::body_fld_dsp, m_body_fld_dsp);
 
 				// [SPACE body_fld_lang
-				if (parser.check <SPACE>(line, &pos, true))
+				if (parser.check <SPACE>(line, &pos))
 				{
-					m_body_fld_lang = parser.get <IMAPParser::body_fld_lang>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::body_fld_lang, m_body_fld_lang);
 
 					// [SPACE 1#body_extension]
-					if (parser.check <SPACE>(line, &pos, true))
+					if (parser.check <SPACE>(line, &pos))
 					{
-						m_body_extensions.push_back
-							(parser.get <body_extension>(line, &pos));
+						VIMAP_PARSER_GET_PUSHBACK(body_extension, m_body_extensions);
 
-						parser.check <SPACE>(line, &pos, true);
+						parser.check <SPACE>(line, &pos);
 
 						body_extension* ext = NULL;
 
-						while ((ext = parser.get <body_extension>(line, &pos, true)) != NULL)
+						while ((ext = parser.get <body_extension>(line, &pos)) != NULL)
 						{
 							m_body_extensions.push_back(ext);
-							parser.check <SPACE>(line, &pos, true);
+							parser.check <SPACE>(line, &pos);
 						}
 					}
 				}
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3417,40 +3793,41 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_ext_mpart");
 
 			string::size_type pos = *currentPos;
 
-			m_body_fld_param = parser.get <IMAPParser::body_fld_param>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_param, m_body_fld_param);
 
 			// [SPACE body_fld_dsp SPACE body_fld_lang [SPACE 1#body_extension]]
-			if (parser.check <SPACE>(line, &pos, true))
+			if (parser.check <SPACE>(line, &pos))
 			{
-				m_body_fld_dsp = parser.get <IMAPParser::body_fld_dsp>(line, &pos);
-				parser.check <SPACE>(line, &pos);
-				m_body_fld_lang = parser.get <IMAPParser::body_fld_lang>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::body_fld_dsp, m_body_fld_dsp);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::body_fld_lang, m_body_fld_lang);
 
 				// [SPACE 1#body_extension]
-				if (parser.check <SPACE>(line, &pos, true))
+				if (parser.check <SPACE>(line, &pos))
 				{
-					m_body_extensions.push_back
-						(parser.get <body_extension>(line, &pos));
+					VIMAP_PARSER_GET_PUSHBACK(body_extension, m_body_extensions);
 
-					parser.check <SPACE>(line, &pos, true);
+					parser.check <SPACE>(line, &pos);
 
 					body_extension* ext = NULL;
 
-					while ((ext = parser.get <body_extension>(line, &pos, true)) != NULL)
+					while ((ext = parser.get <body_extension>(line, &pos)) != NULL)
 					{
 						m_body_extensions.push_back(ext);
-						parser.check <SPACE>(line, &pos, true);
+						parser.check <SPACE>(line, &pos);
 					}
 				}
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3491,17 +3868,19 @@ public:
 			delete (m_body_fields);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_type_basic");
 
 			string::size_type pos = *currentPos;
 
-			m_media_basic = parser.get <IMAPParser::media_basic>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fields = parser.get <IMAPParser::body_fields>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_basic, m_media_basic);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fields, m_body_fields);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3543,26 +3922,28 @@ public:
 			delete (m_body_fld_lines);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_type_msg");
 
 			string::size_type pos = *currentPos;
 
-			m_media_message = parser.get <IMAPParser::media_message>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fields = parser.get <IMAPParser::body_fields>(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_message, m_media_message);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fields, m_body_fields);
+			VIMAP_PARSER_CHECK(SPACE);
 
 			// BUGFIX: made SPACE optional. This is not standard, but some servers
 			// seem to return responses like that...
-			m_envelope = parser.get <IMAPParser::envelope>(line, &pos);
-			parser.check <SPACE>(line, &pos, true);
-			m_body = parser.get <IMAPParser::xbody>(line, &pos);
-			parser.check <SPACE>(line, &pos, true);
-			m_body_fld_lines = parser.get <IMAPParser::body_fld_lines>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::envelope, m_envelope);
+			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::xbody, m_body);
+			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_lines, m_body_fld_lines);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3604,19 +3985,21 @@ public:
 			delete (m_body_fld_lines);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_type_text");
 
 			string::size_type pos = *currentPos;
 
-			m_media_text = parser.get <IMAPParser::media_text>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fields = parser.get <IMAPParser::body_fields>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_body_fld_lines = parser.get <IMAPParser::body_fld_lines>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_text, m_media_text);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fields, m_body_fields);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::body_fld_lines, m_body_fld_lines);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3657,25 +4040,27 @@ public:
 			delete (m_body_ext_1part);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_type_1part");
 
 			string::size_type pos = *currentPos;
 
-			if (!(m_body_type_text = parser.get <IMAPParser::body_type_text>(line, &pos, true)))
-				if (!(m_body_type_msg = parser.get <IMAPParser::body_type_msg>(line, &pos, true)))
-					m_body_type_basic = parser.get <IMAPParser::body_type_basic>(line, &pos);
+			if (!(m_body_type_text = parser.get <IMAPParser::body_type_text>(line, &pos)))
+				if (!(m_body_type_msg = parser.get <IMAPParser::body_type_msg>(line, &pos)))
+					VIMAP_PARSER_GET(IMAPParser::body_type_basic, m_body_type_basic);
 
-			if (parser.check <SPACE>(line, &pos, true))
+			if (parser.check <SPACE>(line, &pos))
 			{
-				m_body_ext_1part = parser.get <IMAPParser::body_ext_1part>(line, &pos, true);
+				m_body_ext_1part = parser.get <IMAPParser::body_ext_1part>(line, &pos);
 
 				if (!m_body_ext_1part)
 					--pos;
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3722,25 +4107,27 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body_type_mpart");
 
 			string::size_type pos = *currentPos;
 
-			m_list.push_back(parser.get <xbody>(line, &pos));
+			VIMAP_PARSER_GET_PUSHBACK(xbody, m_list);
 
-			for (xbody* b ; (b = parser.get <xbody>(line, &pos, true)) ; )
+			for (xbody* b ; (b = parser.get <xbody>(line, &pos)) ; )
 				m_list.push_back(b);
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_media_subtype = parser.get <IMAPParser::media_subtype>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::media_subtype, m_media_subtype);
 
-			if (parser.check <SPACE>(line, &pos, true))
-				m_body_ext_mpart = parser.get <IMAPParser::body_ext_mpart>(line, &pos);
+			if (parser.check <SPACE>(line, &pos))
+				VIMAP_PARSER_GET(IMAPParser::body_ext_mpart, m_body_ext_mpart);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3778,20 +4165,22 @@ public:
 			delete (m_body_type_mpart);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("body");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			if (!(m_body_type_mpart = parser.get <IMAPParser::body_type_mpart>(line, &pos, true)))
-				m_body_type_1part = parser.get <IMAPParser::body_type_1part>(line, &pos);
+			if (!(m_body_type_mpart = parser.get <IMAPParser::body_type_mpart>(line, &pos)))
+				VIMAP_PARSER_GET(IMAPParser::body_type_1part, m_body_type_1part);
 
-			parser.check <one_char <')'> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <')'>);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -3844,112 +4233,112 @@ public:
  			delete (m_section);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("msg_att_item");
 
 			string::size_type pos = *currentPos;
 
 			// "ENVELOPE" SPACE envelope
-			if (parser.checkWithArg <special_atom>(line, &pos, "envelope", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "envelope"))
 			{
 				m_type = ENVELOPE;
 
-				parser.check <SPACE>(line, &pos);
-				m_envelope = parser.get <IMAPParser::envelope>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::envelope, m_envelope);
 			}
 			// "FLAGS" SPACE "(" #(flag / "\Recent") ")"
-			else if (parser.checkWithArg <special_atom>(line, &pos, "flags", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "flags"))
 			{
 				m_type = FLAGS;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_flag_list = parser.get <IMAPParser::flag_list>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::flag_list, m_flag_list);
 			}
 			// "INTERNALDATE" SPACE date_time
-			else if (parser.checkWithArg <special_atom>(line, &pos, "internaldate", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "internaldate"))
 			{
 				m_type = INTERNALDATE;
 
-				parser.check <SPACE>(line, &pos);
-				m_date_time = parser.get <IMAPParser::date_time>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::date_time, m_date_time);
 			}
 			// "RFC822" ".HEADER" SPACE nstring
-			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.header", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.header"))
 			{
 				m_type = RFC822_HEADER;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_nstring = parser.get <IMAPParser::nstring>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::nstring, m_nstring);
 			}
 			// "RFC822" ".TEXT" SPACE nstring
-			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.text", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.text"))
 			{
 				m_type = RFC822_TEXT;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_nstring = parser.getWithArgs <IMAPParser::nstring>
-					(line, &pos, this, RFC822_TEXT);
+				VIMAP_PARSER_FAIL_UNLESS(m_nstring = parser.getWithArgs <IMAPParser::nstring>
+					(line, &pos, this, RFC822_TEXT));
 			}
 			// "RFC822.SIZE" SPACE number
-			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.size", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822.size"))
 			{
 				m_type = RFC822_SIZE;
 
-				parser.check <SPACE>(line, &pos);
-				m_number = parser.get <IMAPParser::number>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET(IMAPParser::number, m_number);
 			}
 			// "RFC822" SPACE nstring
-			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "rfc822"))
 			{
 				m_type = RFC822;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_nstring = parser.get <IMAPParser::nstring>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::nstring, m_nstring);
 			}
 			// "BODY" "STRUCTURE" SPACE body
-			else if (parser.checkWithArg <special_atom>(line, &pos, "bodystructure", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "bodystructure"))
 			{
 				m_type = BODY_STRUCTURE;
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_body = parser.get <IMAPParser::body>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::body, m_body);
 			}
 			// "BODY" section ["<" number ">"] SPACE nstring
 			// "BODY" SPACE body
-			else if (parser.checkWithArg <special_atom>(line, &pos, "body", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "body"))
 			{
-				m_section = parser.get <IMAPParser::section>(line, &pos, true);
+				m_section = parser.get <IMAPParser::section>(line, &pos);
 
 				// "BODY" section ["<" number ">"] SPACE nstring
 				if (m_section != NULL)
 				{
 					m_type = BODY_SECTION;
 
-					if (parser.check <one_char <'<'> >(line, &pos, true))
+					if (parser.check <one_char <'<'> >(line, &pos))
 					{
-						m_number = parser.get <IMAPParser::number>(line, &pos);
-						parser.check <one_char <'>'> >(line, &pos);
+						VIMAP_PARSER_GET(IMAPParser::number, m_number);
+						VIMAP_PARSER_CHECK(one_char <'>'>);
 					}
 
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_nstring = parser.getWithArgs <IMAPParser::nstring>
-						(line, &pos, this, BODY_SECTION);
+					VIMAP_PARSER_FAIL_UNLESS(m_nstring = parser.getWithArgs <IMAPParser::nstring>
+						(line, &pos, this, BODY_SECTION));
 				}
 				// "BODY" SPACE body
 				else
 				{
 					m_type = BODY;
 
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_body = parser.get <IMAPParser::body>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::body, m_body);
 				}
 			}
 			// "UID" SPACE uniqueid
@@ -3957,13 +4346,15 @@ public:
 			{
 				m_type = UID;
 
-				parser.checkWithArg <special_atom>(line, &pos, "uid");
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "uid");
+				VIMAP_PARSER_CHECK(SPACE);
 
-				m_uniqueid = parser.get <nz_number>(line, &pos);
+				VIMAP_PARSER_GET(nz_number, m_uniqueid);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4027,23 +4418,25 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("msg_att");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'('> >(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'('>);
 
-			m_items.push_back(parser.get <msg_att_item>(line, &pos));
+			VIMAP_PARSER_GET_PUSHBACK(msg_att_item, m_items);
 
-			while (!parser.check <one_char <')'> >(line, &pos, true))
+			while (!parser.check <one_char <')'> >(line, &pos))
 			{
-				parser.check <SPACE>(line, &pos);
-				m_items.push_back(parser.get <msg_att_item>(line, &pos));
+				VIMAP_PARSER_CHECK(SPACE);
+				VIMAP_PARSER_GET_PUSHBACK(msg_att_item, m_items);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4075,33 +4468,36 @@ public:
 			delete (m_msg_att);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("message_data");
 
 			string::size_type pos = *currentPos;
 
-			nz_number* num = parser.get <nz_number>(line, &pos);
+			nz_number* num = NULL;
+			VIMAP_PARSER_GET(nz_number, num);
 			m_number = num->value();
 			delete (num);
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			if (parser.checkWithArg <special_atom>(line, &pos, "expunge", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "expunge"))
 			{
 				m_type = EXPUNGE;
 			}
 			else
 			{
-				parser.checkWithArg <special_atom>(line, &pos, "fetch");
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "fetch");
 
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
 				m_type = FETCH;
-				m_msg_att = parser.get <IMAPParser::msg_att>(line, &pos);
+				VIMAP_PARSER_GET(IMAPParser::msg_att, m_msg_att);
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4144,31 +4540,33 @@ public:
 			delete (m_resp_text);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("resp_cond_state");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.checkWithArg <special_atom>(line, &pos, "ok", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "ok"))
 			{
 				m_status = OK;
 			}
-			else if (parser.checkWithArg <special_atom>(line, &pos, "no", true))
+			else if (parser.checkWithArg <special_atom>(line, &pos, "no"))
 			{
 				m_status = NO;
 			}
 			else
 			{
-				parser.checkWithArg <special_atom>(line, &pos, "bad");
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "bad");
 				m_status = BAD;
 			}
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_resp_text = parser.get <IMAPParser::resp_text>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::resp_text, m_resp_text);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4209,19 +4607,21 @@ public:
 			delete (m_resp_text);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("resp_cond_bye");
 
 			string::size_type pos = *currentPos;
 
-			parser.checkWithArg <special_atom>(line, &pos, "bye");
+			VIMAP_PARSER_CHECK_WITHARG(special_atom, "bye");
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_resp_text = parser.get <IMAPParser::resp_text>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::resp_text, m_resp_text);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4253,28 +4653,30 @@ public:
 			delete (m_resp_text);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("resp_cond_auth");
 
 			string::size_type pos = *currentPos;
 
-			if (parser.checkWithArg <special_atom>(line, &pos, "ok", true))
+			if (parser.checkWithArg <special_atom>(line, &pos, "ok"))
 			{
 				m_cond = OK;
 			}
 			else
 			{
-				parser.checkWithArg <special_atom>(line, &pos, "preauth");
+				VIMAP_PARSER_CHECK_WITHARG(special_atom, "preauth");
 
 				m_cond = PREAUTH;
 			}
 
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_resp_text = parser.get <IMAPParser::resp_text>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::resp_text, m_resp_text);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4315,17 +4717,19 @@ public:
 			delete (m_number);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("status_info");
 
 			string::size_type pos = *currentPos;
 
-			m_status_att = parser.get <IMAPParser::status_att>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_number = parser.get <IMAPParser::number>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::status_att, m_status_att);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::number, m_number);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4383,25 +4787,25 @@ public:
 			}
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("mailbox_data");
 
 			string::size_type pos = *currentPos;
 
-			m_number = parser.get <IMAPParser::number>(line, &pos, true);
+			m_number = parser.get <IMAPParser::number>(line, &pos);
 
 			if (m_number)
 			{
-				parser.check <SPACE>(line, &pos);
+				VIMAP_PARSER_CHECK(SPACE);
 
-				if (parser.checkWithArg <special_atom>(line, &pos, "exists", true))
+				if (parser.checkWithArg <special_atom>(line, &pos, "exists"))
 				{
 					m_type = EXISTS;
 				}
 				else
 				{
-					parser.checkWithArg <special_atom>(line, &pos, "recent");
+					VIMAP_PARSER_CHECK_WITHARG(special_atom, "recent");
 
 					m_type = RECENT;
 				}
@@ -4409,53 +4813,51 @@ public:
 			else
 			{
 				// "FLAGS" SPACE mailbox_flag_list
-				if (parser.checkWithArg <special_atom>(line, &pos, "flags", true))
+				if (parser.checkWithArg <special_atom>(line, &pos, "flags"))
 				{
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_mailbox_flag_list = parser.get <IMAPParser::mailbox_flag_list>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::mailbox_flag_list, m_mailbox_flag_list);
 
 					m_type = FLAGS;
 				}
 				// "LIST" SPACE mailbox_list
-				else if (parser.checkWithArg <special_atom>(line, &pos, "list", true))
+				else if (parser.checkWithArg <special_atom>(line, &pos, "list"))
 				{
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_mailbox_list = parser.get <IMAPParser::mailbox_list>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::mailbox_list, m_mailbox_list);
 
 					m_type = LIST;
 				}
 				// "LSUB" SPACE mailbox_list
-				else if (parser.checkWithArg <special_atom>(line, &pos, "lsub", true))
+				else if (parser.checkWithArg <special_atom>(line, &pos, "lsub"))
 				{
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_mailbox_list = parser.get <IMAPParser::mailbox_list>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::mailbox_list, m_mailbox_list);
 
 					m_type = LSUB;
 				}
 				// "MAILBOX" SPACE text
-				else if (parser.checkWithArg <special_atom>(line, &pos, "mailbox", true))
+				else if (parser.checkWithArg <special_atom>(line, &pos, "mailbox"))
 				{
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_text = parser.get <IMAPParser::text>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::text, m_text);
 
 					m_type = MAILBOX;
 				}
 				// "SEARCH" [SPACE 1#nz_number]
-				else if (parser.checkWithArg <special_atom>(line, &pos, "search", true))
+				else if (parser.checkWithArg <special_atom>(line, &pos, "search"))
 				{
-					if (parser.check <SPACE>(line, &pos, true))
+					if (parser.check <SPACE>(line, &pos))
 					{
-						m_search_nz_number_list.push_back
-							(parser.get <nz_number>(line, &pos));
+						VIMAP_PARSER_GET_PUSHBACK(nz_number, m_search_nz_number_list);
 
-						while (parser.check <SPACE>(line, &pos, true))
+						while (parser.check <SPACE>(line, &pos))
 						{
-							m_search_nz_number_list.push_back
-								(parser.get <nz_number>(line, &pos));
+							VIMAP_PARSER_GET_PUSHBACK(nz_number, m_search_nz_number_list);
 						}
 					}
 
@@ -4467,20 +4869,20 @@ public:
 				// "(" [status_att SPACE number *(SPACE status_att SPACE number)] ")"
 				else
 				{
-					parser.checkWithArg <special_atom>(line, &pos, "status");
-					parser.check <SPACE>(line, &pos);
+					VIMAP_PARSER_CHECK_WITHARG(special_atom, "status");
+					VIMAP_PARSER_CHECK(SPACE);
 
-					m_mailbox = parser.get <IMAPParser::mailbox>(line, &pos);
+					VIMAP_PARSER_GET(IMAPParser::mailbox, m_mailbox);
 
-					parser.check <SPACE>(line, &pos);
-					parser.check <one_char <'('> >(line, &pos);
+					VIMAP_PARSER_CHECK(SPACE);
+					VIMAP_PARSER_CHECK(one_char <'('>);
 
-					m_status_info_list.push_back(parser.get <status_info>(line, &pos));
+					VIMAP_PARSER_GET_PUSHBACK(status_info, m_status_info_list);
 
-					while (!parser.check <one_char <')'> >(line, &pos, true))
+					while (!parser.check <one_char <')'> >(line, &pos))
 					{
-						parser.check <SPACE>(line, &pos);
-						m_status_info_list.push_back(parser.get <status_info>(line, &pos));
+						VIMAP_PARSER_CHECK(SPACE);
+						VIMAP_PARSER_GET_PUSHBACK(status_info, m_status_info_list);
 					}
 
 					m_type = STATUS;
@@ -4488,6 +4890,8 @@ public:
 			}
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4553,24 +4957,26 @@ public:
 			delete (m_capability_data);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("response_data");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'*'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'*'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			if (!(m_resp_cond_state = parser.get <IMAPParser::resp_cond_state>(line, &pos, true)))
-				if (!(m_resp_cond_bye = parser.get <IMAPParser::resp_cond_bye>(line, &pos, true)))
-					if (!(m_mailbox_data = parser.get <IMAPParser::mailbox_data>(line, &pos, true)))
-						if (!(m_message_data = parser.get <IMAPParser::message_data>(line, &pos, true)))
-							m_capability_data = parser.get <IMAPParser::capability_data>(line, &pos);
+			if (!(m_resp_cond_state = parser.get <IMAPParser::resp_cond_state>(line, &pos)))
+				if (!(m_resp_cond_bye = parser.get <IMAPParser::resp_cond_bye>(line, &pos)))
+					if (!(m_mailbox_data = parser.get <IMAPParser::mailbox_data>(line, &pos)))
+						if (!(m_message_data = parser.get <IMAPParser::message_data>(line, &pos)))
+							VIMAP_PARSER_GET(IMAPParser::capability_data, m_capability_data);
 
-			parser.check <CRLF>(line, &pos);
+			VIMAP_PARSER_CHECK(CRLF);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4606,16 +5012,18 @@ public:
 			delete (m_response_data);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("continue_req_or_response_data");
 
 			string::size_type pos = *currentPos;
 
-			if (!(m_continue_req = parser.get <IMAPParser::continue_req>(line, &pos, true)))
-				m_response_data = parser.get <IMAPParser::response_data>(line, &pos);
+			if (!(m_continue_req = parser.get <IMAPParser::continue_req>(line, &pos)))
+				VIMAP_PARSER_GET(IMAPParser::response_data, m_response_data);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4649,20 +5057,22 @@ public:
 			delete (m_resp_cond_bye);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("response_fatal");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'*'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'*'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			m_resp_cond_bye = parser.get <IMAPParser::resp_cond_bye>(line, &pos);
+			VIMAP_PARSER_GET(IMAPParser::resp_cond_bye, m_resp_cond_bye);
 
-			parser.check <CRLF>(line, &pos);
+			VIMAP_PARSER_CHECK(CRLF);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4693,18 +5103,20 @@ public:
 			delete (m_resp_cond_state);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("response_tagged");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <IMAPParser::xtag>(line, &pos);
-			parser.check <SPACE>(line, &pos);
-			m_resp_cond_state = parser.get <IMAPParser::resp_cond_state>(line, &pos);
-			parser.check <CRLF>(line, &pos);
+			VIMAP_PARSER_CHECK(IMAPParser::xtag);
+			VIMAP_PARSER_CHECK(SPACE);
+			VIMAP_PARSER_GET(IMAPParser::resp_cond_state, m_resp_cond_state);
+			VIMAP_PARSER_CHECK(CRLF);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4736,16 +5148,18 @@ public:
 			delete (m_response_fatal);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("response_done");
 
 			string::size_type pos = *currentPos;
 
-			if (!(m_response_tagged = parser.get <IMAPParser::response_tagged>(line, &pos, true)))
-				m_response_fatal = parser.get <IMAPParser::response_fatal>(line, &pos);
+			if (!(m_response_tagged = parser.get <IMAPParser::response_tagged>(line, &pos)))
+				VIMAP_PARSER_GET(IMAPParser::response_fatal, m_response_fatal);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4785,17 +5199,16 @@ public:
 			delete (m_response_done);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("response");
 
 			string::size_type pos = *currentPos;
-			string curLine = line;
 			bool partial = false;  // partial response
 
 			IMAPParser::continue_req_or_response_data* resp = NULL;
 
-			while ((resp = parser.get <IMAPParser::continue_req_or_response_data>(curLine, &pos, true)) != NULL)
+			while ((resp = parser.get <IMAPParser::continue_req_or_response_data>(line, &pos)) != NULL)
 			{
 				m_continue_req_or_response_data.push_back(resp);
 
@@ -4807,14 +5220,16 @@ public:
 				}
 
 				// We have read a CRLF, read another line
-				curLine = parser.readLine();
+				line = parser.readLine();
 				pos = 0;
 			}
 
 			if (!partial)
-				m_response_done = parser.get <IMAPParser::response_done>(curLine, &pos);
+				VIMAP_PARSER_GET(IMAPParser::response_done, m_response_done);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 
@@ -4866,21 +5281,23 @@ public:
 			delete (m_resp_cond_bye);
 		}
 
-		void go(IMAPParser& parser, string& line, string::size_type* currentPos)
+		bool go(IMAPParser& parser, string& line, string::size_type* currentPos)
 		{
 			DEBUG_ENTER_COMPONENT("greeting");
 
 			string::size_type pos = *currentPos;
 
-			parser.check <one_char <'*'> >(line, &pos);
-			parser.check <SPACE>(line, &pos);
+			VIMAP_PARSER_CHECK(one_char <'*'>);
+			VIMAP_PARSER_CHECK(SPACE);
 
-			if (!(m_resp_cond_auth = parser.get <IMAPParser::resp_cond_auth>(line, &pos, true)))
-				m_resp_cond_bye = parser.get <IMAPParser::resp_cond_bye>(line, &pos);
+			if (!(m_resp_cond_auth = parser.get <IMAPParser::resp_cond_auth>(line, &pos)))
+				VIMAP_PARSER_GET(IMAPParser::resp_cond_bye, m_resp_cond_bye);
 
-			parser.check <CRLF>(line, &pos);
+			VIMAP_PARSER_CHECK(CRLF);
 
 			*currentPos = pos;
+
+			return true;
 		}
 
 	private:
@@ -4905,10 +5322,15 @@ public:
 		string::size_type pos = 0;
 		string line = readLine();
 
+		arenaScope scope(*this);
+
 		m_literalHandler = lh;
 		response* resp = get <response>(line, &pos);
 		m_literalHandler = NULL;
 
+		if (!resp)
+			throw exceptions::invalid_response("", makeErrorResponseLine(line));
+
 		return (resp);
 	}
 
@@ -4918,7 +5340,36 @@ public:
 		string::size_type pos = 0;
 		string line = readLine();
 
-		return get <greeting>(line, &pos);
+		arenaScope scope(*this);
+
+		greeting* greet = get <greeting>(line, &pos);
+
+		if (!greet)
+			throw exceptions::invalid_response("", makeErrorResponseLine(line));
+
+		return (greet);
+	}
+
+
+	//
+	// Error reporting
+	//
+
+	/** Record the position at which a terminal failed to parse. Only
+	  * the furthest position in the current line is kept: this is the
+	  * most likely location of the syntax error once all alternatives
+	  * have been tried.
+	  *
+	  * @param comp name of the component
+	  * @param pos position in the current line
+	  */
+	void setErrorPosition(const char* comp, const string::size_type pos)
+	{
+		if (m_errorComponent == NULL || pos >= m_errorPos)
+		{
+			m_errorComponent = comp;
+			m_errorPos = pos;
+		}
 	}
 
 
@@ -4927,41 +5378,71 @@ public:
 	//
 
 	template <class TYPE>
-	TYPE* get(string& line, string::size_type* currentPos,
-	          const bool noThrow = false)
+	TYPE* get(string& line, string::size_type* currentPos)
 	{
-		component* resp = new TYPE;
-		return internalGet <TYPE>(resp, line, currentPos, noThrow);
+		component* resp = new (m_arena) TYPE;
+		return internalGet <TYPE>(resp, line, currentPos);
 	}
 
 
 	template <class TYPE, class ARG1_TYPE, class ARG2_TYPE>
 	TYPE* getWithArgs(string& line, string::size_type* currentPos,
-	                  ARG1_TYPE arg1, ARG2_TYPE arg2, const bool noThrow = false)
+	                  ARG1_TYPE arg1, ARG2_TYPE arg2)
 	{
-		component* resp = new TYPE(arg1, arg2);
-		return internalGet <TYPE>(resp, line, currentPos, noThrow);
+		component* resp = new (m_arena) TYPE(arg1, arg2);
+		return internalGet <TYPE>(resp, line, currentPos);
 	}
 
 
 private:
 
+	// Allocate the components of a response from a new arena
+	class arenaScope
+	{
+	public:
+
+		arenaScope(IMAPParser& parser)
+			: m_parser(parser), m_oldArena(parser.m_arena)
+		{
+			m_parser.m_arena = arena::create();
+		}
+
+		~arenaScope()
+		{
+			// The arena lives until the response is deleted
+			m_parser.m_arena->release();
+			m_parser.m_arena = m_oldArena;
+		}
+
+	private:
+
+		IMAPParser& m_parser;
+		arena* m_oldArena;
+	};
+
+
 	template <class TYPE>
-	TYPE* internalGet(component* resp, string& line, string::size_type* currentPos,
-	                  const bool noThrow = false)
+	TYPE* internalGet(component* resp, string& line, string::size_type* currentPos)
 	{
 		const string::size_type oldPos = *currentPos;
+		bool ok = false;
 
 		try
 		{
-			resp->go(*this, line, currentPos);
+			ok = resp->go(*this, line, currentPos);
 		}
 		catch (...)
+		{
+			// I/O error or time-out while reading a literal or a line
+			delete (resp);
+			throw;
+		}
+
+		if (!ok)
 		{
 			*currentPos = oldPos;
 
 			delete (resp);
-			if (!noThrow) throw;
 			return (NULL);
 		}
 
@@ -4969,6 +5450,15 @@ private:
 	}
 
 
+	const string makeErrorResponseLine(const string& line) const
+	{
+		if (m_errorComponent == NULL)
+			return component::makeResponseLine("", line, 0);
+
+		return component::makeResponseLine(m_errorComponent, line, std::min(m_errorPos, line.length()));
+	}
+
+
 public:
 
 	//
@@ -4976,21 +5466,15 @@ public:
 	//
 
 	template <class TYPE>
-	bool check(string& line, string::size_type* currentPos,
-	                 const bool noThrow = false)
+	bool check(string& line, string::size_type* currentPos)
 	{
 		const string::size_type oldPos = *currentPos;
 
-		try
-		{
-			TYPE term;
-			term.go(*this, line, currentPos);
-		}
-		catch (...)
+		TYPE term;
+
+		if (!term.go(*this, line, currentPos))
 		{
 			*currentPos = oldPos;
-
-			if (!noThrow) throw;
 			return false;
 		}
 
@@ -4998,21 +5482,15 @@ public:
 	}
 
 	template <class TYPE, class ARG_TYPE>
-	bool checkWithArg(string& line, string::size_type* currentPos,
-	                        const ARG_TYPE arg, const bool noThrow = false)
+	bool checkWithArg(string& line, string::size_type* currentPos, const ARG_TYPE arg)
 	{
 		const string::size_type oldPos = *currentPos;
 
-		try
-		{
-			TYPE term(arg);
-			term.go(*this, line, currentPos);
-		}
-		catch (...)
+		TYPE term(arg);
+
+		if (!term.go(*this, line, currentPos))
 		{
 			*currentPos = oldPos;
-
-			if (!noThrow) throw;
 			return false;
 		}
 
@@ -5039,6 +5517,11 @@ private:
 
 	string m_lastLine;
 
+	const char* m_errorComponent;
+	string::size_type m_errorPos;
+
+	arena* m_arena;
+
 public:
 
 	//
@@ -5062,6 +5545,10 @@ public:
 
 		m_lastLine = line;
 
+		// Errors recorded for the previous line are now irrelevant
+		m_errorComponent = NULL;
+		m_errorPos = 0;
+
 #if DEBUG_RESPONSE
 		std::cout << std::endl << "Read line:" << std::endl << line << std::endl;
 #endif
@@ -41,6 +41,7 @@ namespace pop3 {
 
 class POP3Store;
 class POP3Message;
+class POP3UIDStore;
 
 
 /** POP3 folder implementation.
@@ -125,8 +126,29 @@ public:
 
 	std::vector <int> getMessageNumbersStartingOnUID(const message::uid& uid);
 
+	/** Compare the messages currently on the server with a set of
+	  * UIDs seen previously. This is useful for clients which leave
+	  * messages on the server and poll it regularly.
+	  *
+	  * Returned messages already have their UID fetched. The caller is
+	  * responsible for updating the set of seen UIDs afterwards.
+	  *
+	  * @param seen UIDs of the messages already seen
+	  * @param newMessages will receive the messages whose UID is not
+	  * in the set of seen UIDs
+	  * @param removedUIDs will receive the UIDs from the set which do
+	  * not exist anymore on the server
+	  * @throw exceptions::command_error if the server does not
+	  * support the UIDL command
+	  */
+	void getUIDChanges(const POP3UIDStore& seen,
+		std::vector <ref <message> >& newMessages, std::vector <message::uid>& removedUIDs);
+
 private:
 
+	void fetchMessageSize(ref <POP3Store> store, ref <POP3Message> msg);
+	void fetchMessageUID(ref <POP3Store> store, ref <POP3Message> msg);
+
 	void registerMessage(POP3Message* msg);
 	void unregisterMessage(POP3Message* msg);
 
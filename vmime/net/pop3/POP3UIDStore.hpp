@@ -0,0 +1,119 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_NET_POP3_POP3UIDSTORE_HPP_INCLUDED
+#define VMIME_NET_POP3_POP3UIDSTORE_HPP_INCLUDED
+
+
+#include <set>
+
+#include "vmime/config.hpp"
+#include "vmime/types.hpp"
+
+#include "vmime/net/message.hpp"
+
+#include "vmime/utility/stream.hpp"
+
+
+namespace vmime {
+namespace net {
+namespace pop3 {
+
+
+/** Set of message UIDs which have already been seen on a POP3 server,
+  * for clients which leave messages on the server. It can be saved to
+  * and loaded from a file, between two sessions.
+  *
+  * Use it with POP3Folder::getUIDChanges() to know which messages are
+  * new since the last time, and which have been removed from the server.
+  */
+
+class POP3UIDStore : public object
+{
+public:
+
+	POP3UIDStore();
+
+	/** Test whether the specified UID is in the set.
+	  *
+	  * @param uid message UID
+	  * @return true if the UID has been seen, false otherwise
+	  */
+	bool contains(const message::uid& uid) const;
+
+	/** Add a UID to the set.
+	  *
+	  * @param uid message UID
+	  */
+	void add(const message::uid& uid);
+
+	/** Remove a UID from the set.
+	  *
+	  * @param uid message UID
+	  */
+	void remove(const message::uid& uid);
+
+	/** Remove all the UIDs from the set.
+	  */
+	void clear();
+
+	/** Return the number of UIDs in the set.
+	  *
+	  * @return number of UIDs
+	  */
+	int getUIDCount() const;
+
+	/** Return all the UIDs in the set, sorted.
+	  *
+	  * @return UIDs
+	  */
+	const std::vector <message::uid> getUIDs() const;
+
+	/** Replace the contents of the set with the UIDs previously
+	  * written by save().
+	  *
+	  * @param is input stream
+	  * @throw exceptions::invalid_argument if the data is not valid
+	  */
+	void load(utility::inputStream& is);
+
+	/** Write the UIDs of the set to a stream, in a compact format:
+	  * UIDs are sorted and each one only stores the characters which
+	  * differ from the previous one.
+	  *
+	  * @param os output stream
+	  */
+	void save(utility::outputStream& os) const;
+
+private:
+
+	std::set <message::uid> m_uids;
+};
+
+
+} // pop3
+} // net
+} // vmime
+
+
+#endif // VMIME_NET_POP3_POP3UIDSTORE_HPP_INCLUDED
@@ -26,6 +26,7 @@
 
 
 #include <map>
+#include <vector>
 
 #include "vmime/config.hpp"
 #include "vmime/types.hpp"
@@ -55,6 +56,31 @@ public:
 	  */
 	static void parseMultiListOrUidlResponse
 		(const string& response, std::map <int, string>& result);
+
+	/** Parse a response of type ([integer] [string] \n)*, keeping
+	  * the order of the lines. See parseMultiListOrUidlResponse().
+	  *
+	  * @param response raw response string as returned by the server
+	  * @param result list of (message number, data) pairs
+	  */
+	static void parseMultiListOrUidlResponse
+		(const string& response, std::vector <std::pair <int, string> >& result);
+
+private:
+
+	/** Parse a line of a LIST or UIDL response.
+	  *
+	  * @param begin beginning of the line
+	  * @param end end of the line (excluding the line break)
+	  * @param number message number
+	  * @param data message data (either UID or size)
+	  * @return true if the line is valid, false otherwise
+	  */
+	static bool parseListOrUidlLine
+		(const char* begin, const char* end, int& number, string& data);
+
+	template <typename CONTAINER>
+	static void parseLines(const string& response, CONTAINER& result);
 };
 
 
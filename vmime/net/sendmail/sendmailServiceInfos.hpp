@@ -49,6 +49,8 @@ public:
 	struct props
 	{
 		serviceInfos::property PROPERTY_BINPATH;
+
+		serviceInfos::property PROPERTY_OPTIONS_BATCH;
 	};
 
 	const props& getProperties() const;
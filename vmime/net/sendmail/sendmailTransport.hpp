@@ -33,6 +33,8 @@
 
 #include "vmime/net/sendmail/sendmailServiceInfos.hpp"
 
+#include "vmime/utility/childProcess.hpp"
+
 
 #if VMIME_BUILTIN_PLATFORM_POSIX
 
@@ -43,6 +45,11 @@ namespace sendmail {
 
 
 /** Sendmail local transport service.
+  *
+  * By default, a new sendmail process is started for each message. If the
+  * "options.batch" property is set, a single process is started when the
+  * service is connected and messages are sent to it using the SMTP protocol
+  * over its standard input/output ("sendmail -bs").
   */
 
 class sendmailTransport : public transport
@@ -75,11 +82,43 @@ private:
 	void internalSend(const std::vector <string> args, utility::inputStream& is,
 		const utility::stream::size_type size, utility::progressListener* progress);
 
+	void internalSendBatch(const mailbox& expeditor, const mailboxList& recipients,
+		utility::inputStream& is, const utility::stream::size_type size,
+		utility::progressListener* progress);
+
+	/** Send a SMTP command to the sendmail process (batch mode).
+	  *
+	  * @param buffer command, without end-of-line
+	  */
+	void sendRequest(const string& buffer);
+
+	/** Read a SMTP response from the sendmail process (batch mode).
+	  *
+	  * @param text will receive the full text of the response
+	  * @return response code
+	  */
+	int readResponse(string& text);
+
+	/** Send a SMTP command to the sendmail process and check its
+	  * response (batch mode). If the response code is not in the
+	  * same class (first digit) as the expected one, the transaction
+	  * is aborted.
+	  *
+	  * @param command SMTP command
+	  * @param expectedCode expected response code
+	  * @throw exceptions::command_error if the response code is
+	  * not the expected one
+	  */
+	void sendCommand(const string& command, const int expectedCode);
+
 
 	string m_sendmailPath;
 
 	bool m_connected;
 
+	ref <utility::childProcess> m_proc;  // batch mode only
+	string m_responseBuffer;
+
 
 	// Service infos
 	static sendmailServiceInfos sm_infos;
@@ -93,6 +93,20 @@ public:
 	  */
 	virtual void sendRaw(const char* buffer, const size_type count) = 0;
 
+	/** Send (raw) data from several buffers to the socket. This has the same
+	  * effect as calling sendRaw() for each buffer, but implementations may
+	  * send the data in fewer network packets (or TLS records).
+	  *
+	  * @param buffers data to send
+	  * @param counts number of bytes to send from each buffer
+	  * @param bufferCount number of buffers
+	  */
+	virtual void sendRawMultiple(const char* const* buffers, const size_type* counts, const int bufferCount)
+	{
+		for (int i = 0 ; i < bufferCount ; ++i)
+			sendRaw(buffers[i], counts[i]);
+	}
+
 	/** Return the preferred maximum block size when reading
 	  * from or writing to this stream.
 	  *
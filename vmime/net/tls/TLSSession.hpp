@@ -69,6 +69,24 @@ public:
 	  */
 	ref <security::cert::certificateVerifier> getCertificateVerifier();
 
+	/** Enable session resumption for this session. The resumption data
+	  * stored in the TLSSessionCache under the specified key (if any) is
+	  * offered to the server during the handshake, and the data for the
+	  * new session is stored back into the cache.
+	  *
+	  * @param key cache key, as returned by TLSSessionCache::makeKey(),
+	  * or an empty string to disable session resumption
+	  */
+	void setCacheKey(const string& key);
+
+	/** Return the key under which resumption data for this session
+	  * is stored in the TLSSessionCache.
+	  *
+	  * @return cache key, or an empty string if session resumption
+	  * is disabled for this session
+	  */
+	const string getCacheKey() const;
+
 private:
 
 	TLSSession(const TLSSession&);
@@ -83,6 +101,8 @@ private:
 #endif // LIBGNUTLS_VERSION
 
 	ref <security::cert::certificateVerifier> m_certVerifier;
+
+	string m_cacheKey;
 };
 
 
@@ -0,0 +1,165 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_NET_TLS_TLSSESSIONCACHE_HPP_INCLUDED
+#define VMIME_NET_TLS_TLSSESSIONCACHE_HPP_INCLUDED
+
+
+#include "vmime/types.hpp"
+
+#include "vmime/utility/sync/criticalSection.hpp"
+
+#include <map>
+
+
+namespace vmime {
+namespace net {
+namespace tls {
+
+
+/** Process-wide cache of TLS session resumption data.
+  *
+  * When a TLS session is given a cache key (see TLSSession::setCacheKey()),
+  * the resumption data (session ID or session ticket) obtained from the
+  * server is stored here after the handshake. It is then offered to the
+  * server on the next handshake with the same key, which lets the server
+  * resume the previous session instead of performing a full handshake.
+  *
+  * Entries are keyed by (host, port, service). When the cache is full,
+  * the least recently stored entry is discarded.
+  */
+
+class TLSSessionCache
+{
+private:
+
+	TLSSessionCache();
+
+public:
+
+	static TLSSessionCache* getInstance();
+
+	/** Build the key identifying a server in the cache.
+	  *
+	  * @param host server host name or address
+	  * @param port server port
+	  * @param service service name (eg. "imap", "smtps")
+	  * @return cache key
+	  */
+	static const string makeKey(const string& host, const port_t port, const string& service);
+
+	/** Retrieve the resumption data stored for a server.
+	  *
+	  * @param key cache key, as returned by makeKey()
+	  * @param data will receive the resumption data
+	  * @return true if data was found for this key, false otherwise
+	  */
+	bool retrieve(const string& key, string& data) const;
+
+	/** Store the resumption data for a server, replacing any
+	  * previously stored data.
+	  *
+	  * @param key cache key, as returned by makeKey()
+	  * @param data resumption data
+	  */
+	void store(const string& key, const string& data);
+
+	/** Remove the resumption data stored for a server.
+	  *
+	  * @param key cache key, as returned by makeKey()
+	  */
+	void remove(const string& key);
+
+	/** Remove all entries from the cache.
+	  */
+	void clear();
+
+	/** Set the maximum number of servers for which resumption data
+	  * is kept. Zero disables the cache.
+	  *
+	  * @param count maximum number of entries
+	  */
+	void setMaxEntries(const unsigned int count);
+
+	/** Return the maximum number of servers for which resumption
+	  * data is kept.
+	  *
+	  * @return maximum number of entries
+	  */
+	unsigned int getMaxEntries() const;
+
+	/** Return the number of handshakes in which the server resumed
+	  * a cached session, ie. the number of cache hits.
+	  *
+	  * @return number of resumed handshakes
+	  */
+	unsigned long getHitCount() const;
+
+	/** Return the number of handshakes performed on cached sessions
+	  * that required a full handshake, ie. the number of cache misses
+	  * (including the ones where the server refused to resume).
+	  *
+	  * @return number of full handshakes
+	  */
+	unsigned long getMissCount() const;
+
+	/** Update the hit/miss counters after a handshake performed
+	  * on a session with a cache key. Called by TLSSocket.
+	  *
+	  * @param resumed true if the server resumed the cached session,
+	  * false if a full handshake was performed
+	  */
+	void registerHandshake(const bool resumed);
+
+private:
+
+	/** Remove the least recently stored entry. The cache must
+	  * be locked and not be empty.
+	  */
+	void removeOldest();
+
+
+	struct entry
+	{
+		string data;
+		unsigned long serial;
+	};
+
+	std::map <string, entry> m_entries;
+
+	unsigned int m_maxEntries;
+	unsigned long m_serial;
+
+	unsigned long m_hitCount;
+	unsigned long m_missCount;
+
+	ref <utility::sync::criticalSection> m_lock;
+};
+
+
+} // tls
+} // net
+} // vmime
+
+
+#endif // VMIME_NET_TLS_TLSSESSIONCACHE_HPP_INCLUDED
@@ -88,6 +88,7 @@ public:
 
 	void send(const string& buffer);
 	void sendRaw(const char* buffer, const size_type count);
+	void sendRawMultiple(const char* const* buffers, const size_type* counts, const int bufferCount);
 
 	size_type getBlockSize() const;
 
@@ -95,6 +96,11 @@ private:
 
 	void internalThrow();
 
+	/** Store the resumption data for the current session into the
+	  * session cache, if session resumption is enabled.
+	  */
+	void storeSessionData();
+
 #ifdef LIBGNUTLS_VERSION
 	static ssize_t gnutlsPushFunc(gnutls_transport_ptr trspt, const void* data, size_t len);
 	static ssize_t gnutlsPullFunc(gnutls_transport_ptr trspt, void* data, size_t len);
@@ -110,6 +116,7 @@ private:
 	bool m_connected;
 
 	char m_buffer[65536];
+	char m_sendBuffer[16384];  // one TLS record
 
 	bool m_handshaking;
 	ref <timeoutHandler> m_toHandler;
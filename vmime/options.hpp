@@ -33,6 +33,9 @@ namespace vmime
 
 
 /** A class to set global options for VMime.
+  *
+  * Options are read without locking: they must be set before other
+  * threads use the library.
   */
 
 class options
@@ -0,0 +1,156 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_PARALLELGENERATOR_HPP_INCLUDED
+#define VMIME_PARALLELGENERATOR_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/bodyPart.hpp"
+#include "vmime/options.hpp"
+#include "vmime/encoding.hpp"
+#include "vmime/contentHandler.hpp"
+
+#include "vmime/utility/outputStream.hpp"
+#include "vmime/utility/sync/criticalSection.hpp"
+
+#include <map>
+#include <set>
+
+
+namespace vmime
+{
+
+
+class body;
+
+
+/** Generates a message (or a body part), encoding the contents of its
+  * leaf parts concurrently.
+  *
+  * When the generator is prepared, the contents of leaf parts (for example,
+  * base64-encoded file attachments) are encoded into memory buffers by
+  * several threads. Headers and multipart boundaries are then laid out
+  * around these buffers, in order. After this, the exact size of the
+  * generated data is known before anything is written (this is useful
+  * for SMTP "SIZE" or IMAP "APPEND" literals), and generating only
+  * involves copying buffers.
+  *
+  * The generated data is the same as the output of component::generate().
+  * The message must not be modified while the generator is in use.
+  */
+
+class parallelGenerator : public object
+{
+public:
+
+	/** Construct a new generator.
+	  *
+	  * @param root part to generate (usually a message)
+	  * @param maxLineLength maximum line length for output
+	  */
+	parallelGenerator(ref <const bodyPart> root,
+		const string::size_type maxLineLength = options::getInstance()->message.maxLineLength());
+
+	~parallelGenerator();
+
+	/** Encode the contents of leaf parts and lay out the generated data.
+	  * If not called explicitly, this is done with a single thread by
+	  * getGeneratedSize() or generate().
+	  *
+	  * @param threadCount number of threads used for encoding contents,
+	  * including the calling thread
+	  */
+	void prepare(const unsigned int threadCount);
+
+	/** Return the number of bytes written by generate().
+	  *
+	  * @return size of generated data, in bytes
+	  */
+	utility::stream::size_type getGeneratedSize();
+
+	/** Generate RFC-2822/MIME data for the part.
+	  *
+	  * @param os output stream
+	  */
+	void generate(utility::outputStream& os);
+
+	/** Insert contents encoded in advance when laying out generated data.
+	  * This is used internally by body::generateImpl(), you should not
+	  * need to call it.
+	  *
+	  * @param os output stream the body is being generated into
+	  * @param b body being generated
+	  * @return true if contents have been inserted, or false if they
+	  * have to be generated as usual
+	  */
+	static bool generateEncodedContents(utility::outputStream& os, const body& b);
+
+private:
+
+	class encodingTask;
+	class layoutOutputStream;
+
+	friend class encodingTask;
+	friend class layoutOutputStream;
+
+	/** Contents of a leaf part. */
+	struct leaf
+	{
+		ref <const contentHandler> contents;
+		encoding enc;
+
+		string data;
+		bool encoded;
+	};
+
+	/** Generated data (headers, boundaries...) which precedes the
+	  * contents of a leaf part, or the end of data. */
+	struct segment
+	{
+		string data;
+		int leafIndex;
+	};
+
+	void findLeaves(ref <const bodyPart> part, std::set <const contentHandler*>& handlers);
+
+
+	ref <const bodyPart> m_root;
+	string::size_type m_maxLineLength;
+
+	bool m_prepared;
+
+	std::vector <leaf> m_leaves;
+	std::vector <segment> m_segments;
+
+	std::map <const body*, int> m_leafIndexes;
+
+	ref <utility::sync::criticalSection> m_lock;
+	std::vector <leaf>::size_type m_nextLeaf;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_PARALLELGENERATOR_HPP_INCLUDED
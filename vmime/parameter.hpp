@@ -136,6 +136,8 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
 
+	bool visitChildComponentsImpl(childVisitor& v);
+
 private:
 
 	void parse(const std::vector <valueChunk>& chunks);
@@ -30,6 +30,10 @@
 
 #include <algorithm>
 
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
 
 
 namespace vmime
@@ -87,6 +91,197 @@ public:
 		const unsigned int x = static_cast <unsigned int>(c);
 		return (x >= 0x20 && x <= 0x7E);
 	}
+
+
+	/** Character classes, which can be combined with a bitwise OR
+	  * to be used with is(), skipWhile() and findFirstOf().
+	  */
+	enum CharClass
+	{
+		CHAR_CLASS_SPACE = (1 << 0),      /**< Space, tab, CR or LF (see isSpace()). */
+		CHAR_CLASS_BLANK = (1 << 1),      /**< Space or tab (see isSpaceOrTab()). */
+		CHAR_CLASS_DIGIT = (1 << 2),      /**< '0' to '9'. */
+		CHAR_CLASS_ALPHA = (1 << 3),      /**< 'a' to 'z' and 'A' to 'Z'. */
+		CHAR_CLASS_EOL = (1 << 4),        /**< CR or LF. */
+		CHAR_CLASS_COLON = (1 << 5),      /**< ':' */
+		CHAR_CLASS_EQUAL = (1 << 6),      /**< '=' */
+		CHAR_CLASS_QUESTION = (1 << 7)    /**< '?' */
+	};
+
+	/** Classes of each character, as a combination of CharClass values.
+	  * This table is entirely computed at compile time.
+	  */
+	static const unsigned char charClassTable[256];
+
+
+	/** Test whether a character belongs to one of the specified classes.
+	  *
+	  * @param c character to test
+	  * @return true if the character is in one of the classes
+	  */
+	template <int CLASSES>
+	static bool is(const char c)
+	{
+		return (charClassTable[static_cast <unsigned char>(c)] & CLASSES) != 0;
+	}
+
+	/** Skip the characters which belong to the specified classes.
+	  *
+	  * @param p beginning of the data
+	  * @param end end of the data
+	  * @return pointer to the first character which is not in any of
+	  * the classes, or 'end' if there is none
+	  */
+	template <int CLASSES>
+	static const char* skipWhile(const char* p, const char* const end)
+	{
+#if defined(__SSE2__)
+		p = scanSSE2 <CLASSES, true>(p, end);
+#endif // __SSE2__
+
+		while (p < end && is <CLASSES>(*p))
+			++p;
+
+		return p;
+	}
+
+	/** Find the first character which belongs to one of the
+	  * specified classes.
+	  *
+	  * @param p beginning of the data
+	  * @param end end of the data
+	  * @return pointer to the first character which is in one of
+	  * the classes, or 'end' if there is none
+	  */
+	template <int CLASSES>
+	static const char* findFirstOf(const char* p, const char* const end)
+	{
+#if defined(__SSE2__)
+		p = scanSSE2 <CLASSES, false>(p, end);
+#endif // __SSE2__
+
+		while (p < end && !is <CLASSES>(*p))
+			++p;
+
+		return p;
+	}
+
+	/** Same as skipWhile(const char*, const char*), but work on
+	  * positions in a string.
+	  *
+	  * @param buffer data
+	  * @param pos start position
+	  * @param end end position
+	  * @return position of the first character which is not in any of
+	  * the classes, or 'end' if there is none
+	  */
+	template <int CLASSES>
+	static string::size_type skipWhile(const string& buffer,
+		const string::size_type pos, const string::size_type end)
+	{
+		if (pos >= end)
+			return pos;
+
+		const char* data = buffer.data();
+		return skipWhile <CLASSES>(data + pos, data + end) - data;
+	}
+
+	/** Same as findFirstOf(const char*, const char*), but work on
+	  * positions in a string.
+	  *
+	  * @param buffer data
+	  * @param pos start position
+	  * @param end end position
+	  * @return position of the first character which is in one of
+	  * the classes, or 'end' if there is none
+	  */
+	template <int CLASSES>
+	static string::size_type findFirstOf(const string& buffer,
+		const string::size_type pos, const string::size_type end)
+	{
+		if (pos >= end)
+			return pos;
+
+		const char* data = buffer.data();
+		return findFirstOf <CLASSES>(data + pos, data + end) - data;
+	}
+
+private:
+
+#if defined(__SSE2__)
+
+	/** Compute a mask of the bytes of 'v' which are in the classes.
+	  * Tests for classes which are not requested are removed by
+	  * the compiler.
+	  */
+	template <int CLASSES>
+	static __m128i matchSSE2(const __m128i v)
+	{
+		__m128i m = _mm_setzero_si128();
+
+		if (CLASSES & (CHAR_CLASS_SPACE | CHAR_CLASS_BLANK))
+		{
+			m = _mm_or_si128(m, _mm_or_si128
+				(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+		}
+
+		if (CLASSES & (CHAR_CLASS_SPACE | CHAR_CLASS_EOL))
+		{
+			m = _mm_or_si128(m, _mm_or_si128
+				(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+		}
+
+		if (CLASSES & CHAR_CLASS_DIGIT)
+		{
+			// Unsigned range check: (v - '0') <= 9
+			const __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d));
+		}
+
+		if (CLASSES & CHAR_CLASS_ALPHA)
+		{
+			// Fold to lower case, then: (v - 'a') <= 25
+			const __m128i a = _mm_sub_epi8
+				(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(a, _mm_set1_epi8(25)), a));
+		}
+
+		if (CLASSES & CHAR_CLASS_COLON)
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+
+		if (CLASSES & CHAR_CLASS_EQUAL)
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('=')));
+
+		if (CLASSES & CHAR_CLASS_QUESTION)
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('?')));
+
+		return m;
+	}
+
+	/** Scan 16 bytes at a time while at least 16 bytes remain.
+	  *
+	  * @return pointer to the first byte which stops the scan, or to
+	  * the remaining bytes (fewer than 16), which must be scanned
+	  * by the caller
+	  */
+	template <int CLASSES, bool SKIP>
+	static const char* scanSSE2(const char* p, const char* const end)
+	{
+		for ( ; end - p >= 16 ; p += 16)
+		{
+			const int match = _mm_movemask_epi8(matchSSE2 <CLASSES>
+				(_mm_loadu_si128(reinterpret_cast <const __m128i*>(p))));
+
+			const int stop = (SKIP ? (~match & 0xffff) : match);
+
+			if (stop != 0)
+				return p + __builtin_ctz(static_cast <unsigned int>(stop));
+		}
+
+		return p;
+	}
+
+#endif // __SSE2__
 };
 
 
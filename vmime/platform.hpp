@@ -30,6 +30,10 @@
 #include "vmime/exception.hpp"
 #include "vmime/charset.hpp"
 
+#include "vmime/utility/sync/criticalSection.hpp"
+#include "vmime/utility/sync/condition.hpp"
+#include "vmime/utility/sync/thread.hpp"
+
 #if VMIME_HAVE_MESSAGING_FEATURES
 	#include "vmime/net/socket.hpp"
 	#include "vmime/net/timeoutHandler.hpp"
@@ -102,6 +106,33 @@ public:
 		  */
 		virtual void wait() const = 0;
 
+		/** Create a new critical section, which can be used to
+		  * synchronize access to objects shared between threads.
+		  * The default implementation returns a
+		  * utility::sync::builtinCriticalSection.
+		  *
+		  * @return a new critical section object
+		  */
+		virtual ref <utility::sync::criticalSection> createCriticalSection();
+
+		/** Create a new condition, which can be used by a thread to wait
+		  * for a change made by another thread. The default implementation
+		  * throws exceptions::system_error.
+		  *
+		  * @return a new condition object
+		  * @throw exceptions::system_error if conditions are not supported
+		  */
+		virtual ref <utility::sync::condition> createCondition();
+
+		/** Create and start a new thread which executes the specified task.
+		  * The default implementation throws exceptions::system_error.
+		  *
+		  * @param task task to run in the new thread
+		  * @return a new thread object
+		  * @throw exceptions::system_error if the thread cannot be created
+		  */
+		virtual ref <utility::sync::thread> createThread(ref <utility::sync::runnable> task);
+
 #if VMIME_HAVE_MESSAGING_FEATURES
 		/** Return a pointer to the default socket factory for
 		  * this platform.
@@ -124,6 +155,15 @@ public:
 		  * @return child process factory
 		  */
 		virtual ref <utility::childProcessFactory> getChildProcessFactory() = 0;
+
+		/** Return the directory in which temporary files should be
+		  * created. The default implementation throws
+		  * exceptions::system_error.
+		  *
+		  * @return path of the temporary directory
+		  * @throw exceptions::system_error if the directory is not known
+		  */
+		virtual const utility::file::path getTemporaryDirectory();
 #endif
 
 	};
@@ -60,7 +60,9 @@ private:
 
 	sigset_t m_oldProcMask;
 	pid_t m_pid;
-	int m_pipe[2];
+
+	int m_stdInPipe[2];   // parent writes to m_stdInPipe[1]
+	int m_stdOutPipe[2];  // parent reads from m_stdOutPipe[0]
 
 	std::vector <string> m_argVector;
 	const char** m_argArray;
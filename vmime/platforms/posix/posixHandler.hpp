@@ -68,10 +68,18 @@ public:
 	ref <vmime::utility::fileSystemFactory> getFileSystemFactory();
 
 	ref <vmime::utility::childProcessFactory> getChildProcessFactory();
+
+	const vmime::utility::file::path getTemporaryDirectory();
 #endif
 
 	void wait() const;
 
+	ref <utility::sync::criticalSection> createCriticalSection();
+
+	ref <utility::sync::condition> createCondition();
+
+	ref <utility::sync::thread> createThread(ref <utility::sync::runnable> task);
+
 private:
 
 #if VMIME_HAVE_MESSAGING_FEATURES
@@ -52,6 +52,7 @@ public:
 
 	void send(const vmime::string& buffer);
 	void sendRaw(const char* buffer, const size_type count);
+	void sendRawMultiple(const char* const* buffers, const size_type* counts, const int bufferCount);
 
 	size_type getBlockSize() const;
 
@@ -75,6 +75,7 @@ public:
 	bool canWrite() const;
 
 	length_type getLength();
+	const datetime getLastModificationDate();
 
 	const path& getFullPath() const;
 
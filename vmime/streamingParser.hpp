@@ -0,0 +1,266 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_STREAMINGPARSER_HPP_INCLUDED
+#define VMIME_STREAMINGPARSER_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+
+#include "vmime/message.hpp"
+#include "vmime/headerField.hpp"
+#include "vmime/contentHandler.hpp"
+#include "vmime/encoding.hpp"
+
+#include "vmime/utility/file.hpp"
+#include "vmime/utility/inputStream.hpp"
+#include "vmime/utility/parserInputStreamAdapter.hpp"
+
+#include <vector>
+
+
+namespace vmime
+{
+
+
+/** Parses a message from a stream which is read only once, from the
+  * beginning to the end, such as a socket or a pipe.
+  *
+  * Unlike component::parse(), the whole stream is never loaded in memory:
+  * header fields and part boundaries are reported as events as soon as
+  * they are read, and the contents of the parts are kept in memory only
+  * while the memory budget allows it. Past the budget, the contents are
+  * written to a temporary file, and returned as content handlers which
+  * read back from this file. The file is deleted once all the content
+  * handlers referring to it have been released.
+  *
+  * Part boundaries are found with the same rules as message::parse().
+  * If a multipart part has no "boundary" parameter, the boundary is
+  * guessed from the first 64 KB of its contents only.
+  *
+  * The parser can be used in "pull" mode (call nextEvent() repeatedly),
+  * in "push" mode (call parse() with a handler), or to build a message
+  * object with parseMessage().
+  */
+
+class streamingParser : public object
+{
+public:
+
+	/** Events reported by the parser.
+	  */
+	enum EventType
+	{
+		EVENT_PART_BEGIN,    /**< Start of a part (the message itself is the part
+		                          of depth 0); its header fields follow. */
+		EVENT_HEADER_FIELD,  /**< Header field of the current part (see getHeaderField()). */
+		EVENT_PROLOG,        /**< Prolog of the current multipart part (see getContents()). */
+		EVENT_BODY,          /**< Contents of the current part, which is not a
+		                          multipart (see getContents()). */
+		EVENT_EPILOG,        /**< Epilog of the current multipart part (see getContents()). */
+		EVENT_PART_END,      /**< End of the current part. */
+		EVENT_END            /**< End of the message: no more events. */
+	};
+
+
+	/** Receives the events in "push" mode.
+	  */
+	class handler
+	{
+	public:
+
+		virtual ~handler() { }
+
+		virtual void onPartBegin(const int depth) = 0;
+		virtual void onHeaderField(ref <headerField> field) = 0;
+		virtual void onProlog(ref <contentHandler> contents) = 0;
+		virtual void onBody(ref <contentHandler> contents) = 0;
+		virtual void onEpilog(ref <contentHandler> contents) = 0;
+		virtual void onPartEnd() = 0;
+	};
+
+
+	/** Construct a new parser which reads from the specified stream.
+	  *
+	  * @param is input stream, which does not need to be seekable
+	  */
+	streamingParser(ref <utility::inputStream> is);
+
+	~streamingParser();
+
+	/** Set the maximum number of bytes kept in memory during the whole
+	  * parsing, not including a fixed-size read buffer. Header fields
+	  * are always kept in memory, and count against the budget. Contents
+	  * (bodies, prologs and epilogs) are written to the temporary file
+	  * when they do not fit in what remains. Header fields longer than
+	  * the budget are truncated. Default is 1 MB.
+	  *
+	  * @param budget number of bytes
+	  */
+	void setMemoryBudget(const utility::stream::size_type budget);
+
+	/** Return the maximum number of bytes kept in memory.
+	  *
+	  * @return number of bytes
+	  */
+	utility::stream::size_type getMemoryBudget() const;
+
+	/** Set the directory in which the temporary file is created.
+	  * Default is given by platform::handler::getTemporaryDirectory().
+	  *
+	  * @param dir path of an existing directory
+	  */
+	void setTemporaryDirectory(const utility::file::path& dir);
+
+	/** Read the stream up to the next event.
+	  *
+	  * @return type of the event
+	  * @throw exceptions::filesystem_exception if the temporary file
+	  * cannot be written
+	  */
+	EventType nextEvent();
+
+	/** Return the depth of the current part (0 for the message itself).
+	  *
+	  * @return depth of the current part
+	  */
+	int getDepth() const;
+
+	/** Return the header field of the last EVENT_HEADER_FIELD event.
+	  *
+	  * @return header field
+	  */
+	ref <headerField> getHeaderField() const;
+
+	/** Return the contents of the last EVENT_PROLOG, EVENT_BODY or
+	  * EVENT_EPILOG event. The contents of a body are encoded with
+	  * the encoding of the part (see contentHandler::getEncoding()).
+	  *
+	  * @return contents
+	  */
+	ref <contentHandler> getContents() const;
+
+	/** Read the whole stream and report the events to a handler.
+	  *
+	  * @param h handler
+	  */
+	void parse(handler& h);
+
+	/** Read the whole stream and build a message from it. The result
+	  * is the same as if message::parse() had been called on the
+	  * whole stream, except that parsed bounds are not set.
+	  *
+	  * @return parsed message
+	  */
+	ref <message> parseMessage();
+
+private:
+
+	class spoolFile;
+	class spoolInputStream;
+	class lookaheadStream;
+
+	/** Contents being read. */
+	struct contentsSink
+	{
+		string memory;
+		bool spilled;
+		utility::stream::size_type begin;   // offset in the temporary file
+		utility::stream::size_type length;
+	};
+
+	/** Terminator of a body, prolog or epilog. */
+	struct terminator
+	{
+		int level;          // index in the part stack, -1 for end of stream
+		bool close;         // true for a closing boundary ("--boundary--")
+	};
+
+	/** A part being parsed. */
+	struct partInfo
+	{
+		string boundarySep; // boundary, prefixed with "--"; empty if the part is not a multipart
+		bool guessBoundary; // multipart without a "boundary" parameter
+		bool closed;        // closing boundary has been found
+		bool hasContentType;
+		bool hasEncoding;
+		encoding enc;
+	};
+
+	enum State
+	{
+		STATE_START,
+		STATE_PART_BEGIN,
+		STATE_HEADER,
+		STATE_PROLOG,
+		STATE_BODY,
+		STATE_EPILOG,
+		STATE_PART_END,
+		STATE_END
+	};
+
+
+	bool fill();
+	utility::stream::size_type ensure(const utility::stream::size_type count);
+
+	bool readHeaderField(string& field, terminator& term);
+	bool matchBoundary(terminator& term);
+	ref <utility::parserInputStreamAdapter> lookahead(const utility::stream::size_type length);
+	ref <contentHandler> readContents(const encoding& enc, terminator& term);
+
+	void writeContents(contentsSink& sink, const char* data, const utility::stream::size_type count);
+
+	void onHeaderField(ref <headerField> field);
+
+	static const string extractContents(ref <const contentHandler> contents);
+
+
+	ref <utility::inputStream> m_stream;
+	bool m_streamEOF;
+
+	string m_buffer;
+	string::size_type m_bufferPos;
+
+	utility::stream::size_type m_budget;
+	utility::stream::size_type m_memoryUsed;
+
+	utility::file::path m_tempDir;
+	bool m_tempDirSet;
+	ref <spoolFile> m_spool;
+
+	ref <lookaheadStream> m_lookahead;
+	ref <utility::parserInputStreamAdapter> m_lookaheadParser;
+
+	State m_state;
+	std::vector <partInfo> m_parts;
+	terminator m_term;
+
+	ref <headerField> m_field;
+	ref <contentHandler> m_contents;
+};
+
+
+} // vmime
+
+
+#endif // VMIME_STREAMINGPARSER_HPP_INCLUDED
@@ -241,6 +241,8 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
 
+	bool visitChildComponentsImpl(childVisitor& v);
+
 private:
 
 	std::vector <ref <word> > m_words;
@@ -33,6 +33,12 @@ namespace vmime
 {
 
 
+/** Creates text part objects for the specified media type.
+  *
+  * Objects can be created from several threads at the same time, but
+  * types must be registered before other threads use the factory.
+  */
+
 class textPartFactory
 {
 protected:
@@ -45,8 +45,25 @@ public:
 	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 
+	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+
 	const std::vector <string> getAvailableProperties() const;
 
+	/** Decode base64 data from a memory buffer. This gives the same
+	  * result as decode(), without the need for an encoder object
+	  * or streams (used for decoding RFC-2047 encoded words).
+	  *
+	  * @param data encoded data
+	  * @param length number of bytes of encoded data
+	  * @param out string to which decoded bytes are appended
+	  * @return number of decoded bytes
+	  */
+	static string::size_type decodeBuffer(const string::value_type* data,
+		const string::size_type length, string& out);
+
 protected:
 
 	static const unsigned char sm_alphabet[];
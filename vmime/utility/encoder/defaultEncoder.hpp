@@ -44,6 +44,11 @@ public:
 
 	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
+
+	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
 };
 
 
@@ -43,6 +43,49 @@ class encoder : public object
 {
 public:
 
+	/** Typed counterpart of the encoder properties, used with the
+	  * const encode() and decode() methods.
+	  */
+	class options
+	{
+	public:
+
+		/** Construct default options.
+		  */
+		options();
+
+		/** Construct options from encoder properties.
+		  *
+		  * @param props encoder properties
+		  */
+		explicit options(const propertySet& props);
+
+		/** Store these options into encoder properties.
+		  *
+		  * @param props encoder properties
+		  */
+		void toProperties(propertySet& props) const;
+
+
+		/** Maximum line length ("maxlinelength" property), or
+		  * string::npos to use the default of the encoder. */
+		string::size_type maxLineLength;
+
+		/** Quoted-printable: the data is text ("text" property). */
+		bool text;
+
+		/** Quoted-printable: use RFC-2047 "Q" encoding ("rfc2047" property). */
+		bool rfc2047;
+
+		/** UUEncode: file name ("filename" property), "no_name"
+		  * by default. If empty, no file name nor mode is written. */
+		string filename;
+
+		/** UUEncode: file mode ("mode" property), 644 by default. */
+		int mode;
+	};
+
+
 	encoder();
 	virtual ~encoder();
 
@@ -66,6 +109,39 @@ public:
 	  */
 	virtual utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL) = 0;
 
+	/** Encode data, using the specified options instead of the
+	  * properties of the encoder. Built-in encoders do not modify
+	  * their state in this method, so a single instance can be shared
+	  * (see encoderFactory::getSharedEncoder()).
+	  *
+	  * The default implementation sets the properties of the encoder
+	  * from the options and calls the non-const encode() method: it
+	  * is not safe to share encoders which do not override it.
+	  *
+	  * @param in input data (decoded)
+	  * @param out output stream for encoded data
+	  * @param opts encoding options
+	  * @param progress progress listener, or NULL if you do not
+	  * want to receive progress notifications
+	  * @return number of bytes written into output stream
+	  */
+	virtual utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+
+	/** Decode data, using the specified options instead of the
+	  * properties of the encoder. No results are returned.
+	  *
+	  * @param in input data (encoded)
+	  * @param out output stream for decoded data
+	  * @param opts decoding options
+	  * @param progress progress listener, or NULL if you do not
+	  * want to receive progress notifications
+	  * @return number of bytes written into output stream
+	  * @see encode(utility::inputStream&, utility::outputStream&, const options&, utility::progressListener*) const
+	  */
+	virtual utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+
 	/** Return the properties of the encoder.
 	  *
 	  * @return properties of the encoder
@@ -35,6 +35,9 @@ namespace encoder {
 
 
 /** A factory to create 'encoder' objects for the specified encoding.
+  *
+  * Encoders can be created from several threads at the same time, but
+  * names must be registered before other threads use the factory.
   */
 
 class encoderFactory
@@ -48,6 +51,22 @@ public:
 
 	static encoderFactory* getInstance();
 
+	/** Built-in encodings, for which a shared encoder is available.
+	  */
+	enum Encoding
+	{
+		ENCODING_UNKNOWN = -1,       /**< Not a built-in encoding. */
+
+		ENCODING_7BIT,               /**< "7bit" (and "7-bit"). */
+		ENCODING_8BIT,               /**< "8bit" (and "8-bit"). */
+		ENCODING_BINARY,             /**< "binary". */
+		ENCODING_QUOTED_PRINTABLE,   /**< "quoted-printable". */
+		ENCODING_BASE64,             /**< "base64". */
+		ENCODING_UUENCODE,           /**< "uuencode". */
+
+		ENCODING_COUNT
+	};
+
 	/** Information about a registered encoder. */
 	class registeredEncoder : public object
 	{
@@ -92,6 +111,7 @@ private:
 
 
 	std::vector <ref <registeredEncoder> > m_encoders;
+	ref <encoder> m_sharedEncoders[ENCODING_COUNT];
 
 public:
 
@@ -114,6 +134,25 @@ public:
 	  */
 	ref <encoder> create(const string& name);
 
+	/** Return the built-in encoding corresponding to an encoding name.
+	  * This does not allocate any memory.
+	  *
+	  * @param name encoding name (eg. "base64"), case-insensitive
+	  * @return built-in encoding, or ENCODING_UNKNOWN if the name
+	  * does not designate a built-in encoding
+	  */
+	static Encoding getEncodingByName(const string& name);
+
+	/** Return the shared encoder instance for a built-in encoding.
+	  * Shared encoders must only be used with the const encode() and
+	  * decode() methods, which take their options as a parameter:
+	  * these can safely be called from multiple threads at once.
+	  *
+	  * @param enc built-in encoding
+	  * @return shared encoder, or NULL if 'enc' is ENCODING_UNKNOWN
+	  */
+	ref <const encoder> getSharedEncoder(const Encoding enc) const;
+
 	/** Return information about a registered encoder.
 	  *
 	  * @param name encoding name
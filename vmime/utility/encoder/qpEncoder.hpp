@@ -45,13 +45,45 @@ public:
 	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 
+	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+
 	const std::vector <string> getAvailableProperties() const;
 
 	static bool RFC2047_isEncodingNeededForChar(const unsigned char c);
 	static int RFC2047_getEncodedLength(const unsigned char c);
 
+	/** Decode quoted-printable data from a memory buffer. This gives
+	  * the same result as decode(), without the need for an encoder
+	  * object or streams (used for decoding RFC-2047 encoded words).
+	  *
+	  * @param data encoded data
+	  * @param length number of bytes of encoded data
+	  * @param out string to which decoded bytes are appended
+	  * @param rfc2047 if true, decode "_" as a space (RFC-2047 "Q"
+	  * encoding)
+	  * @return number of decoded bytes
+	  */
+	static string::size_type decodeBuffer(const string::value_type* data,
+		const string::size_type length, string& out, const bool rfc2047);
+
 protected:
 
+	/** Decode a chunk of quoted-printable data.
+	  *
+	  * @param data encoded data
+	  * @param length number of bytes of encoded data
+	  * @param out string to which decoded bytes are appended
+	  * @param rfc2047 if true, decode "_" as a space
+	  * @param last if false, an incomplete "=XX" sequence at the end
+	  * of the chunk is left undecoded, as more data will follow
+	  * @return number of bytes consumed from the input
+	  */
+	static string::size_type decodeChunk(const string::value_type* data,
+		const string::size_type length, string& out, const bool rfc2047, const bool last);
+
 	static const unsigned char sm_hexDigits[17];
 	static const unsigned char sm_hexDecodeTable[256];
 	static const unsigned char sm_RFC2047EncodeTable[128];
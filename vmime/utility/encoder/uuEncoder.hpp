@@ -45,7 +45,17 @@ public:
 	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out, utility::progressListener* progress = NULL);
 
+	utility::stream::size_type encode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+	utility::stream::size_type decode(utility::inputStream& in, utility::outputStream& out,
+		const options& opts, utility::progressListener* progress = NULL) const;
+
 	const std::vector <string> getAvailableProperties() const;
+
+private:
+
+	utility::stream::size_type decodeImpl(utility::inputStream& in, utility::outputStream& out,
+		propertySet* results, utility::progressListener* progress) const;
 };
 
 
@@ -35,6 +35,11 @@
 
 
 namespace vmime {
+
+
+class datetime;
+
+
 namespace utility {
 
 
@@ -149,6 +154,15 @@ public:
 	  */
 	virtual length_type getLength() = 0;
 
+	/** Return the date and time of the last modification of this file.
+	  * The default implementation throws an exception.
+	  *
+	  * @return modification date
+	  * @throw exceptions::filesystem_exception if an error occurs, or
+	  * if the date is not available
+	  */
+	virtual const datetime getLastModificationDate();
+
 	/** Return the full path of this file/directory.
 	  *
 	  * @return full path of the file
@@ -154,6 +154,64 @@ private:
 };
 
 
+/** A filtered output stream which decodes the data of a dot-terminated
+  * multi-line response (eg. POP3 RETR): leading dots are un-stuffed
+  * ("\n.." becomes "\n.") and the stream stops on the terminating line
+  * ("CRLF.CRLF" or "LF.LF"), which is not written. Both operations are
+  * done in a single pass over the data.
+  *
+  * Data written must not include the first line of the response (status
+  * line): the filter expects to be at the beginning of a line.
+  */
+
+class dotTerminatedFilteredOutputStream : public filteredOutputStream
+{
+public:
+
+	/** Construct a new filter for the specified output stream.
+	  *
+	  * @param os stream into which write decoded data
+	  */
+	dotTerminatedFilteredOutputStream(outputStream& os);
+
+	outputStream& getNextOutputStream();
+
+	void write(const value_type* const data, const size_type count);
+	void flush();
+
+	/** Return whether the terminating line has been found. Any data
+	  * written after it is ignored.
+	  *
+	  * @return true if the terminating line has been found,
+	  * false otherwise
+	  */
+	bool isTerminated() const;
+
+private:
+
+	void writePending();
+
+
+	enum State
+	{
+		STATE_LINE,         /**< Inside a line. */
+		STATE_CR,           /**< CR found at the end of the previous data. */
+		STATE_START,        /**< At the beginning of a line. */
+		STATE_DOT,          /**< Dot found at the beginning of a line. */
+		STATE_DOT_CR,       /**< Dot and CR found at the beginning of a line. */
+		STATE_TERMINATED    /**< Terminating line found. */
+	};
+
+	outputStream& m_stream;
+	State m_state;
+
+	// Data held back at the end of the previous write, until we know
+	// whether it is part of the terminating sequence (at most CRLF + ".\r")
+	value_type m_pending[4];
+	size_type m_pendingLength;
+};
+
+
 /** A filtered input stream which stops when a specified sequence
   * is found (eof() method will return 'true').
   */
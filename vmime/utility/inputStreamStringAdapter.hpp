@@ -48,6 +48,7 @@ public:
 	size_type skip(const size_type count);
 	size_type getPosition() const;
 	void seek(const size_type pos);
+	const string* getBuffer(size_type& offset, size_type& length) const;
 
 private:
 
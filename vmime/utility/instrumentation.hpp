@@ -0,0 +1,201 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_UTILITY_INSTRUMENTATION_HPP_INCLUDED
+#define VMIME_UTILITY_INSTRUMENTATION_HPP_INCLUDED
+
+
+#include "vmime/config.hpp"
+
+
+namespace vmime {
+namespace utility {
+
+
+/** Registry of counters and timers measuring how often some hot paths
+  * of the library are used: object creation, charset conversion, encoders
+  * and protocol round trips.
+  *
+  * Values are only recorded if the library has been built with
+  * instrumentation support (VMIME_HAVE_INSTRUMENTATION); else, the hooks
+  * compile to nothing and all the values stay at zero.
+  *
+  * Values are never reset: to measure a single operation, read them
+  * before and after the operation and compute the difference.
+  */
+
+class instrumentation
+{
+private:
+
+	instrumentation();
+
+public:
+
+	/** Counters.
+	  */
+	enum Counter
+	{
+		COUNTER_OBJECTS,              /**< Objects created (with vmime::create() or not),
+		                                   ie. reference managers allocated. */
+		COUNTER_CHARSET_CONVERTERS,   /**< Charset converters constructed. */
+		COUNTER_ICONV_OPENS,          /**< iconv conversion descriptors opened. */
+		COUNTER_ENCODERS,             /**< Encoders created by encoderFactory. */
+		COUNTER_IMAP_COMMANDS,        /**< Commands sent to IMAP servers. */
+		COUNTER_IMAP_RESPONSES,       /**< Responses read from IMAP servers. */
+		COUNTER_SMTP_COMMANDS,        /**< Commands sent to SMTP servers. */
+		COUNTER_SMTP_RESPONSES,       /**< Responses read from SMTP servers. */
+		COUNTER_POP3_COMMANDS,        /**< Commands sent to POP3 servers. */
+		COUNTER_POP3_RESPONSES,       /**< Responses read from POP3 servers. */
+
+		COUNTER_COUNT
+	};
+
+	/** Timers.
+	  */
+	enum Timer
+	{
+		TIMER_IMAP_RESPONSE,          /**< Time spent reading IMAP responses. */
+		TIMER_SMTP_RESPONSE,          /**< Time spent reading SMTP responses. */
+		TIMER_POP3_RESPONSE,          /**< Time spent reading POP3 responses. */
+
+		TIMER_COUNT
+	};
+
+
+	static instrumentation* getInstance();
+
+	/** Return whether the library has been built with
+	  * instrumentation support.
+	  *
+	  * @return true if values are recorded, false otherwise
+	  */
+	static bool isEnabled();
+
+	/** Return the name of a counter.
+	  *
+	  * @param counter counter
+	  * @return name of the counter (eg. "objects")
+	  */
+	static const char* getCounterName(const Counter counter);
+
+	/** Return the name of a timer.
+	  *
+	  * @param timer timer
+	  * @return name of the timer (eg. "imap.response")
+	  */
+	static const char* getTimerName(const Timer timer);
+
+	/** Return the value of a counter.
+	  *
+	  * @param counter counter
+	  * @return number of times the event occurred
+	  */
+	unsigned long getCounter(const Counter counter) const;
+
+	/** Return the number of measures recorded by a timer.
+	  *
+	  * @param timer timer
+	  * @return number of measures
+	  */
+	unsigned long getTimerCount(const Timer timer) const;
+
+	/** Return the total time recorded by a timer.
+	  *
+	  * @param timer timer
+	  * @return total time, in microseconds (it wraps around
+	  * on platforms where 'unsigned long' is 32-bit)
+	  */
+	unsigned long getTimerTotal(const Timer timer) const;
+
+	/** Increment a counter. Use the VMIME_INSTRUMENT_COUNT() macro
+	  * instead, so that nothing is done when instrumentation is disabled.
+	  *
+	  * @param counter counter
+	  */
+	void increment(const Counter counter);
+
+	/** Record a measure for a timer. Use the VMIME_INSTRUMENT_TIME() macro
+	  * instead, so that nothing is done when instrumentation is disabled.
+	  *
+	  * @param timer timer
+	  * @param usec measured time, in microseconds
+	  */
+	void addTime(const Timer timer, const unsigned long usec);
+
+
+	/** Measures the time elapsed between its construction and its
+	  * destruction, and records it for a timer.
+	  */
+	class scopedTimer
+	{
+	public:
+
+		scopedTimer(const Timer timer);
+		~scopedTimer();
+
+	private:
+
+		const Timer m_timer;
+		const unsigned long m_start;
+	};
+
+private:
+
+	static unsigned long getMicroseconds();
+
+
+	volatile unsigned long m_counters[COUNTER_COUNT];
+	volatile unsigned long m_timerCounts[TIMER_COUNT];
+	volatile unsigned long m_timerTotals[TIMER_COUNT];
+};
+
+
+} // utility
+} // vmime
+
+
+#if VMIME_HAVE_INSTRUMENTATION
+
+	/** Increment the specified counter (eg. COUNTER_OBJECTS).
+	  */
+	#define VMIME_INSTRUMENT_COUNT(counter) \
+		vmime::utility::instrumentation::getInstance()->increment \
+			(vmime::utility::instrumentation::counter)
+
+	/** Record the time spent until the end of the current scope
+	  * for the specified timer (eg. TIMER_IMAP_RESPONSE).
+	  */
+	#define VMIME_INSTRUMENT_TIME(timer) \
+		vmime::utility::instrumentation::scopedTimer vmime_instrumentationTimer \
+			(vmime::utility::instrumentation::timer)
+
+#else
+
+	#define VMIME_INSTRUMENT_COUNT(counter)
+	#define VMIME_INSTRUMENT_TIME(timer)
+
+#endif // VMIME_HAVE_INSTRUMENTATION
+
+
+#endif // VMIME_UTILITY_INSTRUMENTATION_HPP_INCLUDED
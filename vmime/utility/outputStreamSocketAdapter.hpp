@@ -27,6 +27,8 @@
 
 #include "vmime/utility/outputStream.hpp"
 
+#include <vector>
+
 
 #if VMIME_HAVE_MESSAGING_FEATURES
 
@@ -43,6 +45,9 @@ namespace utility {
 
 
 /** An output stream that is connected to a socket.
+  *
+  * Written data is buffered, so that it is sent to the socket in blocks
+  * of the socket's preferred size. Call flush() to send buffered data.
   */
 
 class outputStreamSocketAdapter : public outputStream
@@ -50,6 +55,7 @@ class outputStreamSocketAdapter : public outputStream
 public:
 
 	outputStreamSocketAdapter(net::socket& sok);
+	~outputStreamSocketAdapter();
 
 	void write(const value_type* const data, const size_type count);
 	void flush();
@@ -61,6 +67,9 @@ private:
 	outputStreamSocketAdapter(const outputStreamSocketAdapter&);
 
 	net::socket& m_socket;
+
+	std::vector <value_type> m_buffer;
+	size_type m_bufferLength;
 };
 
 
@@ -66,6 +66,11 @@ public:
 		return m_stream->getPosition();
 	}
 
+	const string* getBuffer(size_type& offset, size_type& length) const
+	{
+		return m_stream->getBuffer(offset, length);
+	}
+
 	/** Get the byte at the current position without updating the
 	  * current position.
 	  *
@@ -132,6 +137,14 @@ public:
 		}
 	}
 
+	/** Return the bytes between the specified positions. If the
+	  * stream is held in memory, prefer parsing the contents in place
+	  * (see getBuffer()) to avoid the copy.
+	  *
+	  * @param begin start position
+	  * @param end end position
+	  * @return bytes between the specified positions
+	  */
 	const string extract(const size_type begin, const size_type end) const;
 
 	/** Skips bytes matching a predicate from the current position.
@@ -39,7 +39,9 @@ class random
 {
 public:
 
-	/** Return a new random number.
+	/** Return a new random number. This can be called from several
+	  * threads at the same time: concurrent calls never return the
+	  * same number.
 	  *
 	  * @return random number
 	  */
@@ -70,7 +72,7 @@ public:
 
 protected:
 
-	static unsigned int m_next;
+	static unsigned int m_seed;
 };
 
 
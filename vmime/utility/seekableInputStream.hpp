@@ -53,6 +53,23 @@ public:
 	  * beginning of the stream, at which to set the stream pointer.
 	  */
 	virtual void seek(const size_type pos) = 0;
+
+	/** Returns the string holding the contents of this stream, if the
+	  * stream is held in memory. This allows parsers to work directly
+	  * on the contents instead of copying them. The string may contain
+	  * more data than the stream: only the bytes between offset and
+	  * (offset + length) belong to the stream.
+	  *
+	  * @param offset will receive the index in the string of the
+	  * byte at position zero in this stream
+	  * @param length will receive the number of bytes in this stream
+	  * @return pointer to the string, or NULL if the contents of this
+	  * stream are not held in a string
+	  */
+	virtual const string* getBuffer(size_type& /* offset */, size_type& /* length */) const
+	{
+		return NULL;
+	}
 };
 
 
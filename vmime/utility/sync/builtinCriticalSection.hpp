@@ -0,0 +1,69 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_UTILITY_SYNC_BUILTINCRITICALSECTION_HPP_INCLUDED
+#define VMIME_UTILITY_SYNC_BUILTINCRITICALSECTION_HPP_INCLUDED
+
+
+#include "vmime/utility/sync/criticalSection.hpp"
+
+
+namespace vmime {
+namespace utility {
+namespace sync {
+
+
+/** Critical section implemented with the threading primitives VMime
+  * was built with (POSIX threads or Win32), which does not need a
+  * platform handler.
+  *
+  * This is used by global objects (such as charsetConverterPool), which
+  * may be used before a platform handler is set, or with a handler
+  * which does not implement createCriticalSection(). If VMime was built
+  * without thread support, lock() and unlock() do nothing.
+  */
+
+class builtinCriticalSection : public criticalSection
+{
+public:
+
+	builtinCriticalSection();
+	~builtinCriticalSection();
+
+	void lock();
+	void unlock();
+
+private:
+
+	struct impl;
+
+	impl* m_impl;
+};
+
+
+} // sync
+} // utility
+} // vmime
+
+
+#endif // VMIME_UTILITY_SYNC_BUILTINCRITICALSECTION_HPP_INCLUDED
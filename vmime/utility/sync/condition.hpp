@@ -0,0 +1,71 @@
+//
+// VMime library (http://www.vmime.org)
+// Copyright (C) 2002-2012 Vincent Richard <vincent@vincent-richard.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of
+// the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// Linking this library statically or dynamically with other modules is making
+// a combined work based on this library.  Thus, the terms and conditions of
+// the GNU General Public License cover the whole combination.
+//
+
+#ifndef VMIME_UTILITY_SYNC_CONDITION_HPP_INCLUDED
+#define VMIME_UTILITY_SYNC_CONDITION_HPP_INCLUDED
+
+
+#include "vmime/base.hpp"
+#include "vmime/utility/sync/criticalSection.hpp"
+
+
+namespace vmime {
+namespace utility {
+namespace sync {
+
+
+/** Critical section with a condition variable, used by a thread to wait
+  * for a change made by another thread. Instances are created by the
+  * platform handler (see platform::handler::createCondition()).
+  */
+
+class condition : public criticalSection
+{
+public:
+
+	virtual ~condition();
+
+	/** Leave the critical section and wait until another thread calls
+	  * notifyAll(), then enter the critical section again. The calling
+	  * thread must own the critical section. As wake-ups may be spurious,
+	  * the waited-for state should be tested again after this returns.
+	  */
+	virtual void wait() = 0;
+
+	/** Wake up all the threads waiting on this condition.
+	  */
+	virtual void notifyAll() = 0;
+
+protected:
+
+	condition();
+	condition(const condition&);
+};
+
+
+} // sync
+} // utility
+} // vmime
+
+
+#endif // VMIME_UTILITY_SYNC_CONDITION_HPP_INCLUDED
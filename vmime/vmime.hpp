@@ -56,6 +56,7 @@
 #include "vmime/emptyContentHandler.hpp"
 #include "vmime/stringContentHandler.hpp"
 #include "vmime/streamContentHandler.hpp"
+#include "vmime/cachedContentHandler.hpp"
 
 // Message components
 #include "vmime/message.hpp"
@@ -87,6 +88,12 @@
 // Message builder/parser
 #include "vmime/messageBuilder.hpp"
 #include "vmime/messageParser.hpp"
+#include "vmime/parallelGenerator.hpp"
+#include "vmime/componentInputStream.hpp"
+#include "vmime/streamingParser.hpp"
+#include "vmime/mimeEventParser.hpp"
+#include "vmime/messageTemplate.hpp"
+#include "vmime/batchParser.hpp"
 
 #include "vmime/fileAttachment.hpp"
 #include "vmime/defaultAttachment.hpp"
@@ -108,8 +115,11 @@
 
 // Utilities
 #include "vmime/utility/datetimeUtils.hpp"
+#include "vmime/utility/instrumentation.hpp"
 #include "vmime/utility/filteredStream.hpp"
 #include "vmime/charsetConverter.hpp"
+#include "vmime/charsetConverterPool.hpp"
+#include "vmime/encodedContentCache.hpp"
 
 // Security
 #include "vmime/security/authenticator.hpp"
@@ -131,6 +141,7 @@
 	#include "vmime/net/socket.hpp"
 
 	#include "vmime/net/serviceFactory.hpp"
+	#include "vmime/net/servicePool.hpp"
 	#include "vmime/net/store.hpp"
 	#include "vmime/net/transport.hpp"
 
@@ -151,6 +162,7 @@
 	#include "vmime/security/cert/defaultCertificateVerifier.hpp"
 
 	#include "vmime/net/tls/TLSSession.hpp"
+	#include "vmime/net/tls/TLSSessionCache.hpp"
 #endif // VMIME_HAVE_TLS_SUPPORT
 
 
@@ -142,6 +142,8 @@ protected:
 		 const string::size_type curLinePos = 0,
 		 string::size_type* newLinePos = NULL) const;
 
+	bool visitChildComponentsImpl(childVisitor& v);
+
 public:
 
 	using component::generate;
@@ -27,20 +27,13 @@
 
 #include "vmime/charset.hpp"
 
+#include "vmime/utility/encoder/encoder.hpp"
+
 
 namespace vmime
 {
 
 
-namespace utility {
-namespace encoder {
-
-class encoder;
-
-} // encoder
-} // utility
-
-
 /** Encodes words following RFC-2047.
   */
 
@@ -100,7 +93,8 @@ private:
 	charset m_charset;
 	Encoding m_encoding;
 
-	ref <utility::encoder::encoder> m_encoder;
+	ref <const utility::encoder::encoder> m_encoder;
+	utility::encoder::encoder::options m_encoderOptions;
 };
 
 